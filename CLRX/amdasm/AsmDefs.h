@@ -175,7 +175,8 @@ struct AsmSymbol
     };
     
     /** list of occurrences in expressions */
-    std::vector<AsmExprSymbolOccurrence> occurrencesInExprs;
+    std::vector<AsmExprSymbolOccurrence, AsmArenaAllocator<AsmExprSymbolOccurrence> >
+            occurrencesInExprs;
     
     /// empty constructor
     explicit AsmSymbol(bool _onceDefined = false) :
@@ -199,8 +200,22 @@ struct AsmSymbol
     ~AsmSymbol();
     
     /// adds occurrence in expression
-    void addOccurrenceInExpr(AsmExpression* expr, size_t argIndex, size_t opIndex)
-    { occurrencesInExprs.push_back({expr, argIndex, opIndex}); }
+    /**
+     * \param expr expression
+     * \param argIndex argument index
+     * \param opIndex operator index
+     * \param arena arena for new list of occurrences (if null, then heap is used)
+     */
+    void addOccurrenceInExpr(AsmExpression* expr, size_t argIndex, size_t opIndex,
+                AsmSharedArena* arena = nullptr)
+    {
+        if (arena != nullptr && occurrencesInExprs.capacity() == 0)
+        {
+            const AsmArenaAllocator<AsmExprSymbolOccurrence> alloc(arena);
+            occurrencesInExprs = decltype(occurrencesInExprs)(alloc);
+        }
+        occurrencesInExprs.push_back({expr, argIndex, opIndex});
+    }
     /// remove occurrence in expression
     void removeOccurrenceInExpr(AsmExpression* expr, size_t argIndex, size_t opIndex);
     /// clear list of occurrences in expression
@@ -295,9 +310,15 @@ private:
     size_t symOccursNum;
     bool relativeSymOccurs;
     bool baseExpr;
-    Array<AsmExprOp> ops;
-    std::unique_ptr<LineCol[]> messagePositions;    ///< for every potential message
-    std::unique_ptr<AsmExprArg[]> args;
+    MemoryArena* arena;     ///< arena that holds storage (or null if heap)
+    size_t storageSize;
+    size_t opsNum;
+    AsmExprArg* args;   ///< begin of storage
+    LineCol* messagePositions;    ///< for every potential message
+    AsmExprOp* ops;
+    
+    void allocateStorage(size_t opsNum, size_t opPosNum, size_t argsNum);
+    void freeStorage();
     
     AsmSourcePos getSourcePos(size_t msgPosIndex) const
     {
@@ -311,7 +332,7 @@ private:
                TempSymbolSnapshotMap* snapshotMap, const AsmSymbolEntry& symEntry,
                AsmSymbolEntry*& outSymEntry, const AsmSourcePos* topParentSourcePos);
     
-    AsmExpression();
+    explicit AsmExpression(MemoryArena* arena = nullptr);
     void setParams(size_t symOccursNum, bool relativeSymOccurs,
             size_t _opsNum, const AsmExprOp* ops, size_t opPosNum, const LineCol* opPos,
             size_t argsNum, const AsmExprArg* args, bool baseExpr = false);
@@ -329,7 +350,7 @@ public:
     
     /// return true if expression is empty
     bool isEmpty() const
-    { return ops.empty(); }
+    { return opsNum==0; }
 
     /// helper to create symbol snapshot. Creates initial expression for symbol snapshot
     AsmExpression* createForSnapshot(const AsmSourcePos* exprSourcePos) const;
@@ -346,7 +367,7 @@ public:
      * \return true if evaluated
      */
     bool evaluate(Assembler& assembler, uint64_t& value, cxuint& sectionId) const
-    { return evaluate(assembler, 0, ops.size(), value, sectionId); }
+    { return evaluate(assembler, 0, opsNum, value, sectionId); }
     
     /// try to evaluate expression
     /**
@@ -408,11 +429,11 @@ public:
     void substituteOccurrence(AsmExprSymbolOccurrence occurrence, uint64_t value,
                   cxuint sectionId = ASMSECT_ABS);
     /// get operators list
-    const Array<AsmExprOp>& getOps() const
-    { return ops; }
+    ArrayRange<const AsmExprOp> getOps() const
+    { return ArrayRange<const AsmExprOp>(ops, ops+opsNum); }
     /// get argument list
     const AsmExprArg* getArgs() const
-    { return args.get(); }
+    { return args; }
     /// get source position
     const AsmSourcePos& getSourcePos() const
     { return sourcePos; }
@@ -40,6 +40,137 @@ namespace CLRX
 
 class Assembler;
 
+/*
+ * memory arena for assembler's macro nodes and symbol occurrences
+ * (used internally by Assembler)
+ */
+
+/// memory arena shared by assembler objects allocated in it
+/** every object allocated in arena by AsmArenaObject and every AsmArenaAllocator
+ * that uses arena hold reference to it, hence arena is deleted with last of them
+ */
+class AsmSharedArena: public MemoryArena, public FastRefCountable
+{
+public:
+    /// constructor
+    explicit AsmSharedArena(size_t blockSize = 32768) : MemoryArena(blockSize)
+    { }
+};
+
+/// base class for objects that can be allocated in shared memory arena
+/** object created by 'new(arena) Type(...)' is allocated in arena (if arena is not
+ * null), object created by 'new Type(...)' is allocated in heap.
+ * Both objects can be deleted by 'delete'.
+ */
+class AsmArenaObject
+{
+public:
+    /// allocate object in heap
+    static void* operator new(size_t size)
+    { return operator new(size, nullptr); }
+    /// allocate object in arena (or in heap if arena is null)
+    static void* operator new(size_t size, AsmSharedArena* arena);
+    /// free object
+    static void operator delete(void* ptr);
+    /// free object (if constructor failed)
+    static void operator delete(void* ptr, AsmSharedArena* arena)
+    { operator delete(ptr); }
+    
+    /// get arena in which object has been allocated (or null if in heap)
+    static AsmSharedArena* getArena(const void* ptr);
+};
+
+/// STL allocator that allocates memory in shared memory arena (or in heap if no arena)
+template<typename T>
+class AsmArenaAllocator
+{
+private:
+    template<typename T2>
+    friend class AsmArenaAllocator;
+    AsmSharedArena* arena;
+public:
+    typedef T value_type;   ///< value type
+    /// allocator with arena is copied with container contents
+    typedef std::true_type propagate_on_container_copy_assignment;
+    /// allocator with arena is moved with container contents
+    typedef std::true_type propagate_on_container_move_assignment;
+    /// allocator with arena is swapped with container contents
+    typedef std::true_type propagate_on_container_swap;
+    
+    /// constructor (heap allocator)
+    AsmArenaAllocator() : arena(nullptr)
+    { }
+    /// constructor with arena
+    explicit AsmArenaAllocator(AsmSharedArena* _arena) : arena(_arena)
+    {
+        if (arena != nullptr)
+            arena->reference();
+    }
+    /// copy constructor
+    AsmArenaAllocator(const AsmArenaAllocator& alloc) : AsmArenaAllocator(alloc.arena)
+    { }
+    /// move constructor (takes reference from allocator)
+    AsmArenaAllocator(AsmArenaAllocator&& alloc) noexcept : arena(alloc.arena)
+    { alloc.arena = nullptr; }
+    /// copy constructor from allocator for other type
+    template<typename T2>
+    AsmArenaAllocator(const AsmArenaAllocator<T2>& alloc)
+                : AsmArenaAllocator(alloc.arena)
+    { }
+    /// destructor
+    ~AsmArenaAllocator()
+    {
+        if (arena != nullptr && arena->unreference())
+            delete arena;
+    }
+    /// copy assignment
+    AsmArenaAllocator& operator=(const AsmArenaAllocator& alloc)
+    {
+        if (alloc.arena != nullptr)
+            alloc.arena->reference();
+        if (arena != nullptr && arena->unreference())
+            delete arena;
+        arena = alloc.arena;
+        return *this;
+    }
+    /// move assignment (takes reference from allocator)
+    AsmArenaAllocator& operator=(AsmArenaAllocator&& alloc)
+    {
+        if (this == &alloc)
+            return *this;
+        if (arena != nullptr && arena->unreference())
+            delete arena;
+        arena = alloc.arena;
+        alloc.arena = nullptr;
+        return *this;
+    }
+    
+    /// allocate memory for n elements
+    T* allocate(size_t n)
+    {
+        if (arena != nullptr)
+            return reinterpret_cast<T*>(arena->allocate(n*sizeof(T)));
+        return reinterpret_cast<T*>(::operator new(n*sizeof(T)));
+    }
+    /// free memory of n elements
+    void deallocate(T* ptr, size_t n)
+    {
+        if (arena != nullptr)
+            arena->release(ptr, n*sizeof(T));
+        else
+            ::operator delete(ptr);
+    }
+    
+    /// equality operator
+    template<typename T2>
+    bool operator==(const AsmArenaAllocator<T2>& alloc) const
+    { return arena == alloc.arena; }
+    /// unequality operator
+    template<typename T2>
+    bool operator!=(const AsmArenaAllocator<T2>& alloc) const
+    { return arena != alloc.arena; }
+};
+
 /// line and column
 struct LineCol
 {
@@ -98,7 +229,8 @@ struct AsmFile: public AsmSource
 };
 
 /// descriptor assembler macro substitution
-struct AsmMacroSubst: public FastRefCountable
+/** can be allocated in arena (by new(arena) AsmMacroSubst(...)) */
+struct AsmMacroSubst: public FastRefCountable, public AsmArenaObject
 {
     ///  parent source for this source (for file is parent file or macro substitution,
     /// for macro substitution is parent substitution
@@ -119,7 +251,8 @@ struct AsmMacroSubst: public FastRefCountable
 };
 
 /// descriptor of macro source (used in source fields)
-struct AsmMacroSource: public AsmSource
+/** can be allocated in arena (by new(arena) AsmMacroSource(...)) */
+struct AsmMacroSource: public AsmSource, public AsmArenaObject
 {
     RefPtr<const AsmMacroSubst> macro;   ///< macro substition
     RefPtr<const AsmSource> source; ///< source of substituted content
@@ -200,6 +333,10 @@ public:
     AsmMacro(const AsmSourcePos& pos, const Array<AsmMacroArg>& args);
     /// constructor with rlvalue for arguments
     AsmMacro(const AsmSourcePos& pos, Array<AsmMacroArg>&& args);
+    /// constructor with content (for example loaded from include cache)
+    AsmMacro(const AsmSourcePos& pos, Array<AsmMacroArg>&& args,
+             std::vector<char>&& content, std::vector<SourceTrans>&& sourceTrans,
+             std::vector<LineTrans>&& colTrans);
     
     /// adds line to macro from source
     /**
@@ -385,7 +522,9 @@ public:
 /// assembler input layout filter
 /** filters input from comments and join splitted lines by backslash.
  * readLine returns prepared line which have only space (' ') and
- * non-space characters. */
+ * non-space characters. If filter reads from file, then file is mapped into memory
+ * and lines which does not require any transformation are returned directly
+ * from mapped file content. */
 class AsmStreamInputFilter: public AsmInputFilter
 {
 private:
@@ -399,10 +538,15 @@ private:
     };
     
     bool managed;
-    std::istream* stream;
+    std::istream* stream;   // null if input from mapped file
     LineMode mode;
     size_t stmtPos;
+    MappedFile mappedFile;
+    size_t mapPos;  // position in mapped file
     
+    void openMappedFile(const CString& filename);
+    const char* readPlainLine(size_t& lineSize);
+    size_t readFromMappedFile(char* dest, size_t maxSize);
 public:
     /// constructor with input stream and their filename
     explicit AsmStreamInputFilter(std::istream& is, const CString& filename = "");
@@ -441,10 +585,12 @@ private:
 public:
     /// constructor with input macro, source position and arguments map
     AsmMacroInputFilter(RefPtr<const AsmMacro> macro, const AsmSourcePos& pos,
-        const MacroArgMap& argMap, uint64_t macroCount, bool alternateMacro);
+        const MacroArgMap& argMap, uint64_t macroCount, bool alternateMacro,
+        AsmSharedArena* arena = nullptr);
     /// constructor with input macro, source position and rvalue of arguments map
     AsmMacroInputFilter(RefPtr<const AsmMacro> macro, const AsmSourcePos& pos,
-        MacroArgMap&& argMap, uint64_t macroCount, bool alternateMacro);
+        MacroArgMap&& argMap, uint64_t macroCount, bool alternateMacro,
+        AsmSharedArena* arena = nullptr);
     
     const char* readLine(Assembler& assembler, size_t& lineSize);
     /// add local argument
@@ -33,6 +33,8 @@
 #include <utility>
 #include <stack>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_set>
 #include <unordered_map>
 #include <CLRX/utils/Utilities.h>
@@ -294,6 +296,107 @@ public:
     size_t getInstructionSize(size_t codeSize, const cxbyte* code) const;
 };
 
+// interference graph for register allocator
+/* while building, edges are held in lower triangular bit matrix divided into
+ * tiles (tileNodesNum x tileNodesNum bits), tiles are allocated at first edge,
+ * after freezing, graph is held in CSR form (adjacency arrays),
+ * neighbors of every node are sorted */
+class AsmInterferenceGraph
+{
+public:
+    // neighbors of node (range in adjacency array)
+    struct Neighbors
+    {
+        const size_t* first;
+        const size_t* last;
+        
+        const size_t* begin() const
+        { return first; }
+        const size_t* end() const
+        { return last; }
+        size_t size() const
+        { return last-first; }
+    };
+    enum: size_t
+    {
+        tileNodesShift = 8,
+        tileNodesNum = size_t(1)<<tileNodesShift,   ///< nodes in tile row/column
+        tileWordsNum = (tileNodesNum*tileNodesNum)>>6   ///< words in tile (8 KB)
+    };
+private:
+    size_t nodesNum;
+    bool frozen;
+    // tiles of lower triangular bit matrix (only while building)
+    std::vector<std::unique_ptr<uint64_t[]> > bitTiles;
+    Array<size_t> adjStarts;    // degrees while building, offsets in adjNodes after
+    Array<size_t> adjNodes;
+    
+    static size_t tileIndex(size_t ta, size_t tb)
+    { return ((ta*(ta+1))>>1) + tb; }
+    // get tile word and bit (a > b), tile can be null
+    uint64_t* getTileWord(size_t a, size_t b, uint64_t& bit) const
+    {
+        uint64_t* tile = bitTiles[tileIndex(a>>tileNodesShift, b>>tileNodesShift)].get();
+        const size_t index = ((a&(tileNodesNum-1))<<tileNodesShift) +
+                    (b&(tileNodesNum-1));
+        bit = 1ULL<<(index&63);
+        return (tile != nullptr) ? tile + (index>>6) : nullptr;
+    }
+public:
+    AsmInterferenceGraph() : nodesNum(0), frozen(false)
+    { }
+    explicit AsmInterferenceGraph(size_t nodesNum) : nodesNum(0), frozen(false)
+    { resize(nodesNum); }
+    
+    // clear and prepare to building graph with nodesNum nodes
+    void resize(size_t nodesNum);
+    // clear graph
+    void clear()
+    { resize(0); }
+    
+    // add edge, returns true if edge has been added
+    bool addEdge(size_t a, size_t b)
+    {
+        if (a == b)
+            return false;
+        if (a < b)
+            std::swap(a, b);
+        uint64_t bit;
+        uint64_t* word = getTileWord(a, b, bit);
+        if (word == nullptr)
+        {
+            // allocate zeroed tile
+            std::unique_ptr<uint64_t[]>& tile = bitTiles[
+                    tileIndex(a>>tileNodesShift, b>>tileNodesShift)];
+            tile.reset(new uint64_t[tileWordsNum]());
+            word = getTileWord(a, b, bit);
+        }
+        if ((*word & bit) != 0)
+            return false;
+        *word |= bit;
+        adjStarts[a]++;
+        adjStarts[b]++;
+        return true;
+    }
+    // returns true if edge exists
+    bool hasEdge(size_t a, size_t b) const;
+    
+    // convert graph to CSR form and free bit matrix, after that edges can not be added
+    void freeze();
+    bool isFrozen() const
+    { return frozen; }
+    
+    // get nodes number
+    size_t size() const
+    { return nodesNum; }
+    // get degree of node
+    size_t getDegree(size_t node) const
+    { return frozen ? adjStarts[node+1]-adjStarts[node] : adjStarts[node]; }
+    // get neighbors of node (only for frozen graph)
+    Neighbors operator[](size_t node) const
+    { return { adjNodes.data() + adjStarts[node], adjNodes.data() + adjStarts[node+1] }; }
+};
+
 class AsmRegAllocator
 {
 public:
@@ -336,7 +439,7 @@ public:
     typedef std::pair<size_t, size_t> SSAReplace;
     typedef std::unordered_map<AsmSingleVReg, std::vector<SSAReplace> > SSAReplacesMap;
     // interference graph type
-    typedef Array<std::unordered_set<size_t> > InterGraph;
+    typedef AsmInterferenceGraph InterGraph;
     typedef std::unordered_map<AsmSingleVReg, std::vector<size_t> > VarIndexMap;
     struct LinearDep
     {
@@ -349,6 +452,12 @@ public:
         std::vector<size_t> prevVidxes;
         std::vector<size_t> nextVidxes;
     };
+    // engine used to color interference graph
+    enum class ColoringEngine
+    {
+        SET,    // ordered set of nodes (reference)
+        BUCKET  // bucket queue by saturation and color bitsets
+    };
 private:
     Assembler& assembler;
     std::vector<CodeBlock> codeBlocks;
@@ -358,6 +467,7 @@ private:
     VarIndexMap vregIndexMaps[MAX_REGTYPES_NUM]; // indices to igraph for 2 reg types
     InterGraph interGraphs[MAX_REGTYPES_NUM]; // for 2 register 
     Array<cxuint> graphColorMaps[MAX_REGTYPES_NUM];
+    cxuint graphColorsNums[MAX_REGTYPES_NUM]; // used registers for reg types
     std::unordered_map<size_t, LinearDep> linearDepMaps[MAX_REGTYPES_NUM];
     std::unordered_map<size_t, EqualToDep> equalToDepMaps[MAX_REGTYPES_NUM];
     std::unordered_map<size_t, size_t> equalSetMaps[MAX_REGTYPES_NUM];
@@ -372,12 +482,24 @@ public:
     void createInterferenceGraph(ISAUsageHandler& usageHandler);
     void colorInterferenceGraph();
     
+    // color graph by DSatur heuristic, gcMap holds already colored nodes
+    // returns number of used colors
+    static cxuint colorGraph(ColoringEngine engine, const InterGraph& interGraph,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            size_t maxColorsNum, cxuint colorsNum, Array<cxuint>& gcMap);
+    
     void allocateRegisters(cxuint sectionId);
     
     const std::vector<CodeBlock>& getCodeBlocks() const
     { return codeBlocks; }
     const SSAReplacesMap& getSSAReplacesMap() const
     { return ssaReplacesMap; }
+    const Array<cxuint>& getGraphColorMap(cxuint regType) const
+    { return graphColorMaps[regType]; }
+    // returns number of registers (colors) used by regType
+    cxuint getGraphColorsNum(cxuint regType) const
+    { return graphColorsNums[regType]; }
 };
 
 /// type of clause
@@ -399,6 +521,99 @@ struct AsmClause
     AsmSourcePos prevIfPos; ///< position of previous if-clause
 };
 
+/// cache of precompiled included files
+/** Included file is precompiled if it contains only macro definitions, assignments
+ * of absolute values (that refer only to symbols defined in this file) and reg-vars.
+ * Assembler that uses cache loads macros, symbols and reg-vars of that file instead
+ * of parsing it again. Entries are keyed by file path, timestamp of the file and
+ * assembler flags. Cache can be shared between assemblers working in many threads.
+ */
+class AsmIncludeCache: public NonCopyableAndNonMovable
+{
+private:
+    struct Entry
+    {
+        uint64_t timestamp;
+        uint64_t paramsKey;
+        Array<cxbyte> data;
+    };
+    std::mutex mutex;
+    std::unordered_map<CString, Entry> entries;
+public:
+    /// constructor
+    AsmIncludeCache();
+    
+    /// get precompiled data of file
+    /**
+     * \param filename path of file
+     * \param timestamp timestamp of file
+     * \param paramsKey key of assembler parameters
+     * \param data output precompiled data
+     * \return true if valid entry found
+     */
+    bool get(const CString& filename, uint64_t timestamp, uint64_t paramsKey,
+             Array<cxbyte>& data);
+    /// put precompiled data of file
+    void put(const CString& filename, uint64_t timestamp, uint64_t paramsKey,
+             Array<cxbyte>&& data);
+    /// get number of entries
+    size_t size();
+    /// clear cache
+    void clear();
+    
+    /// load cache from file (replaces current entries)
+    void loadFromFile(const char* filename);
+    /// save cache to file
+    void saveToFile(const char* filename);
+};
+
+/// on-disk cache of assembled binaries
+/** Every entry is file in cache directory named by hash of key and CLRX version.
+ * Key is any data that describes input of assembler (source code, options, device type).
+ * Entry holds also list of files read by source (included files) with hashes of their
+ * contents and list of files that was not found in earlier include paths. Entry is
+ * valid only if read files are not changed and missing files still do not exist.
+ * Entries are written atomically, hence cache can be shared between threads
+ * and processes.
+ */
+class AsmBinaryCache: public NonCopyableAndNonMovable
+{
+private:
+    std::string dirPath;
+public:
+    /// constructor (directory will be created at first put)
+    explicit AsmBinaryCache(const std::string& dirPath);
+    
+    /// get default cache directory ('.clrx/bincache' in home directory)
+    static std::string getDefaultDir();
+    
+    /// get cache directory
+    const std::string& getDir() const
+    { return dirPath; }
+    
+    /// get binary from cache
+    /**
+     * \param key key of entry
+     * \param binary output binary
+     * \param log output assembler messages (warnings)
+     * \return true if valid entry found
+     */
+    bool get(const std::string& key, Array<cxbyte>& binary, std::string& log) const;
+    /// put binary to cache (throws exception if entry can not be written)
+    /** relative paths of files are resolved against current directory
+     * \param key key of entry
+     * \param dependencies files read by assembler while assembling
+     * \param missingFiles files tried by assembler, but not found
+     * \param binary binary to put
+     * \param log assembler messages (warnings)
+     */
+    void put(const std::string& key, const std::vector<CString>& dependencies,
+             const std::vector<CString>& missingFiles, const Array<cxbyte>& binary,
+             const std::string& log);
+};
+
+struct AsmIncludeRecording;
+
 /// main class of assembler
 class Assembler: public NonCopyableAndNonMovable
 {
@@ -428,6 +643,11 @@ private:
     friend struct AsmROCmPseudoOps; // INTERNAL LOGIC
     friend struct GCNAsmUtils; // INTERNAL LOGIC
 
+    // storage for parsed expressions (must be destroyed after all expressions)
+    MemoryArena exprArena;
+    // storage for symbol occurrences and macro substitutions (shared with them),
+    // created at first use
+    AsmSharedArena* sharedArena;
     Array<CString> filenames;
     BinaryFormat format;
     GPUDeviceType deviceType;
@@ -478,6 +698,13 @@ private:
     
     std::stack<AsmClause> clauses;
     
+    AsmIncludeCache* includeCache;
+    std::unique_ptr<AsmIncludeRecording> includeRecording;
+    // files read by .include and .incbin
+    std::vector<CString> dependencies;
+    // files tried by .include and .incbin before found file (not existing)
+    std::vector<CString> missingDependencies;
+    
     cxuint currentKernel;
     cxuint& currentSection;
     uint64_t& currentOutPos;
@@ -493,9 +720,23 @@ private:
     AsmSourcePos getSourcePos(const char* linePtr) const
     { return getSourcePos(linePtr-line); }
     
+    AsmSharedArena* getSharedArena()
+    {
+        if (sharedArena == nullptr)
+            sharedArena = new AsmSharedArena();
+        return sharedArena;
+    }
+    
     void printWarning(const AsmSourcePos& pos, const char* message);
     void printError(const AsmSourcePos& pos, const char* message);
     
+    bool loadPrecompiledInclude(const char* pseudoOpPlace, const CString& filename,
+                const Array<cxbyte>& data);
+    void recordIncludeSymbol(const CString& symName);
+    void recordIncludeMacro(const CString& macroName);
+    void recordIncludeRegVar(const CString& rvName);
+    void finishIncludeRecording();
+    
     void printWarning(const char* linePtr, const char* message)
     { printWarning(getSourcePos(linePtr), message); }
     void printError(const char* linePtr, const char* message)
@@ -765,6 +1006,22 @@ public:
     /// get regvar by name
     bool getRegVar(const CString& name, const AsmRegVar*& regVar);
     
+    /// set include cache (null disables cache)
+    void setIncludeCache(AsmIncludeCache* cache)
+    { includeCache = cache; }
+    /// get include cache
+    AsmIncludeCache* getIncludeCache() const
+    { return includeCache; }
+    /// get key of current assembler parameters (used by include cache)
+    uint64_t getIncludeParamsKey() const;
+    /// get files read by assembler (by .include and .incbin)
+    const std::vector<CString>& getDependencies() const
+    { return dependencies; }
+    /// get files tried by .include and .incbin in earlier include paths, but not found
+    /** if any of these files will be created, then same source can include other file */
+    const std::vector<CString>& getMissingDependencies() const
+    { return missingDependencies; }
+    
     /// get global scope
     const AsmScope& getGlobalScope() const
     { return globalScope; }
@@ -799,6 +1056,59 @@ inline void ISAAssembler::printError(const AsmSourcePos& sourcePos, const char*
 inline void ISAAssembler::addCodeFlowEntry(cxuint sectionId, const AsmCodeFlowEntry& entry)
 { assembler.sections[sectionId].addCodeFlowEntry(entry); }
 
+/*
+ * batch assembling
+ */
+
+/// batch assembler job
+struct AsmBatchJob
+{
+    CString filename;   ///< source filename (or name of source if content is given)
+    /// source content (if not empty then used instead reading file)
+    std::string content;
+    BinaryFormat format;    ///< output binary format
+    GPUDeviceType deviceType;   ///< GPU device type
+    bool is64Bit;   ///< 64-bit binary
+    uint32_t driverVersion; ///< AMD driver version
+    uint32_t llvmVersion;   ///< LLVM version (GalliumCompute)
+    Flags flags;    ///< assembler flags
+    std::vector<CString> includeDirs;   ///< include directories
+    std::vector<Assembler::DefSym> defSyms; ///< initial defined symbols
+    
+    /// constructor
+    AsmBatchJob(const CString& _filename = CString(),
+                BinaryFormat _format = BinaryFormat::AMD,
+                GPUDeviceType _deviceType = GPUDeviceType::CAPE_VERDE,
+                Flags _flags = ASM_WARNINGS)
+            : filename(_filename), format(_format), deviceType(_deviceType),
+              is64Bit(false), driverVersion(0), llvmVersion(0), flags(_flags)
+    { }
+};
+
+/// batch assembler job result
+struct AsmBatchResult
+{
+    bool good;  ///< true if job succeeded
+    Array<cxbyte> binary;   ///< output binary
+    std::string messages;   ///< warnings and errors
+    std::string printOutput;    ///< output from '.print' pseudo-ops
+};
+
+/// assemble many independent jobs concurrently
+/** Jobs are distributed between worker threads that steal jobs each other if
+ * finish own jobs. Assembler's static tables are initialized once and shared safely
+ * between threads.
+ * \param jobsNum number of jobs
+ * \param jobs jobs
+ * \param results results (jobsNum entries, in order of jobs)
+ * \param threadsNum number of threads (0 - number of hardware threads)
+ * \param includeCache include cache shared by all jobs (can be null)
+ * \return true if all jobs succeeded
+ */
+extern bool assembleBatch(size_t jobsNum, const AsmBatchJob* jobs,
+            AsmBatchResult* results, cxuint threadsNum = 0,
+            AsmIncludeCache* includeCache = nullptr);
+
 };
 
 #endif
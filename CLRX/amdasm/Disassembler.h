@@ -70,13 +70,60 @@ enum: Flags
     DISASM_BUGGYFPLIT = 0x100,
     DISASM_CODEPOS = 0x200,   ///< print code position
     DISASM_HSACONFIG = 0x400,  ///< print HSA configuration
+    /// prepare and disassemble AMD binaries kernel by kernel (bounded memory usage)
+    DISASM_STREAMING = 0x800,
     
     ///< all disassembler flags (without config)
-    DISASM_ALL = FLAGS_ALL&(~(DISASM_CONFIG|DISASM_BUGGYFPLIT|DISASM_HSACONFIG))
+    DISASM_ALL = FLAGS_ALL&(~(DISASM_CONFIG|DISASM_BUGGYFPLIT|DISASM_HSACONFIG|
+                DISASM_STREAMING))
 };
 
 struct GCNDisasmUtils;
 
+enum: cxbyte
+{
+    GCNDISASM_REC_ILLEGAL = 1,  ///< illegal instruction (not in instruction table)
+    GCNDISASM_REC_LITERAL = 2,  ///< instruction has literal (in insnCode2)
+    GCNDISASM_REC_TARGET = 4,   ///< instruction is jump (target is set)
+    GCNDISASM_REC_FILL = 8,     ///< zero words (wordsNum is number of words)
+    GCNDISASM_REC_UNFINISHED = 16,  ///< unfinished instruction at end of code
+    GCNDISASM_REC_SDWA_DPP = 32 ///< instruction has SDWA or DPP word (in insnCode2)
+};
+
+/// no operand in operand field of GCNDisasmInsnRecord
+const uint16_t GCNDISASM_NO_OPERAND = 0xffff;
+
+/// structured (binary) record of decoded GCN instruction
+/** operand fields holds operand codes in GCN encoding form: 0-255 - scalar operand
+ * (SGPR, constant, special register), 256-511 - VGPR (VGPR-only fields have
+ * added 256, VOP3A destination is raw 8-bit field). Operand order: destination,
+ * source0, source1, source2, second (scalar) destination of VOP3B.
+ * For EXP first four fields are vector sources. */
+struct GCNDisasmInsnRecord
+{
+    size_t offset;      ///< offset of instruction (including start offset)
+    size_t target;      ///< jump target offset (if GCNDISASM_REC_TARGET)
+    uint32_t insnCode;  ///< first instruction word
+    uint32_t insnCode2; ///< second instruction word or literal
+    uint32_t wordsNum;  ///< size in words (or number of zero words for fill)
+    uint16_t instrIndex;    ///< index in GCN instruction table (if not illegal)
+    uint16_t opcode;    ///< opcode in encoding
+    uint16_t operands[5];   ///< operand fields
+    /// GCN encoding (see GCNDisassembler::getEncodingName), VOP3B for VOP3B instructions
+    cxbyte encoding;
+    cxbyte flags;   ///< record flags (GCNDISASM_REC_*)
+};
+
+/// sink for structured disassembler output
+class GCNDisasmSink
+{
+public:
+    /// destructor
+    virtual ~GCNDisasmSink();
+    /// put next decoded instruction
+    virtual void putInstruction(const GCNDisasmInsnRecord& record) = 0;
+};
+
 /// main class for
 class ISADisassembler: public NonCopyableAndNonMovable
 {
@@ -109,10 +156,15 @@ protected:
     std::vector<std::pair<size_t, CString> > namedLabels;   ///< named labels
     std::vector<CString> relSymbols;    ///< symbols used by relocations
     std::vector<std::pair<size_t, Relocation> > relocations;    ///< relocations
+    /// disassembler that holds named labels and relocation symbols (this by default)
+    const ISADisassembler* labelsOwner;
     FastOutputBuffer output;    ///< output buffer
     
     /// constructor
     explicit ISADisassembler(Disassembler& disassembler, cxuint outBufSize = 600);
+    /// constructor with own output stream
+    ISADisassembler(Disassembler& disassembler, std::ostream& outStream,
+                    cxuint outBufSize = 600);
     
     /// write location in the code
     void writeLocation(size_t pos);
@@ -176,6 +228,8 @@ public:
         relSymbols.clear();
         relocations.clear();
     }
+    /// free memory held by labels and relocations (after disassembling section)
+    void releaseLabelsAndRelocations();
     /// get numbered labels
     const std::vector<size_t>& getLabels() const
     { return labels; }
@@ -185,6 +239,12 @@ public:
     /// flush output
     void flushOutput()
     { return output.flush(); }
+    
+    /// decode code to structured records (without text formatting)
+    /** default implementation throws DisasmException (not supported) */
+    virtual void decodeInstructions(GCNDisasmSink& sink);
+    /// decode code to structured records and append them to vector
+    void decodeInstructions(std::vector<GCNDisasmInsnRecord>& records);
 };
 
 /// GCN architectur dissassembler
@@ -192,8 +252,15 @@ class GCNDisassembler: public ISADisassembler
 {
 private:
     bool instrOutOfCode;
+    std::vector<size_t> chunkStarts;    // start positions of chunks (in words)
     
     friend struct GCNDisasmUtils; // INTERNAL LOGIC
+    
+    // constructor for chunk disassembler (used in parallel disassembling)
+    GCNDisassembler(Disassembler& disassembler, std::ostream& outStream);
+    
+    void disassembleRange(size_t startPos, size_t endPos, LabelIter curLabel,
+            NamedLabelIter curNamedLabel, RelocIter curReloc, bool lastRange);
 public:
     /// constructor
     GCNDisassembler(Disassembler& disassembler);
@@ -204,6 +271,18 @@ public:
     void analyzeBeforeDisassemble();
     /// disassemble code
     void disassemble();
+    
+    using ISADisassembler::decodeInstructions;
+    /// decode code to structured records (without text formatting)
+    /** records are decoded by separate loop than text output (disassemble), that
+     * also resolves labels, relocations and splits code into chunks; both loops use
+     * same instruction size tables and instruction lookup */
+    void decodeInstructions(GCNDisasmSink& sink);
+    
+    /// get mnemonic of instruction from instruction table
+    static const char* getInstructionMnemonic(uint16_t instrIndex);
+    /// get name of GCN encoding
+    static const char* getEncodingName(cxbyte encoding);
 };
 
 /// single kernel input for disassembler
@@ -368,28 +447,59 @@ private:
         const ROCmDisasmInput* rocmInput;
         const RawCodeInput* rawInput;
     };
+    // main binary used to prepare kernel inputs during streaming disassembling
+    // (non-const, because kernel data is released after disassembling)
+    union {
+        AmdMainGPUBinary32* amdBinary32;
+        AmdMainGPUBinary64* amdBinary64;
+        AmdCL2MainGPUBinary32* amdCL2Binary32;
+        AmdCL2MainGPUBinary64* amdCL2Binary64;
+    };
+    bool streamKernels; // if true then input holds only global data
     std::ostream& output;
     Flags flags;
     size_t sectionCount;
+    cxuint threadsNum;
 public:
     /// constructor for 32-bit GPU binary
-    /**
+    /** streaming (DISASM_STREAMING) requires non-const binary, throws DisasmException
+     * if this flag is set
      * \param binary main GPU binary
      * \param output output stream
      * \param flags flags for disassembler
      */
     Disassembler(const AmdMainGPUBinary32& binary, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for 32-bit GPU binary
+    /** in streaming mode (DISASM_STREAMING) kernel data of lazy binary is released
+     * after disassembling kernel. Binary must not be used by other threads
+     * while disassembling
+     * \param binary main GPU binary
+     * \param output output stream
+     * \param flags flags for disassembler
+     */
+    Disassembler(AmdMainGPUBinary32& binary, std::ostream& output, Flags flags = 0);
     /// constructor for 64-bit GPU binary
-    /**
+    /** streaming (DISASM_STREAMING) requires non-const binary, throws DisasmException
+     * if this flag is set
      * \param binary main GPU binary
      * \param output output stream
      * \param flags flags for disassembler
      */
     Disassembler(const AmdMainGPUBinary64& binary, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for 64-bit GPU binary
+    /** in streaming mode (DISASM_STREAMING) kernel data of lazy binary is released
+     * after disassembling kernel. Binary must not be used by other threads
+     * while disassembling
+     * \param binary main GPU binary
+     * \param output output stream
+     * \param flags flags for disassembler
+     */
+    Disassembler(AmdMainGPUBinary64& binary, std::ostream& output, Flags flags = 0);
     /// constructor for AMD OpenCL 2.0 GPU binary 32-bit
-    /**
+    /** streaming (DISASM_STREAMING) requires non-const binary, throws DisasmException
+     * if this flag is set
      * \param binary main GPU binary
      * \param output output stream
      * \param flags flags for disassembler
@@ -397,8 +507,20 @@ public:
      */
     Disassembler(const AmdCL2MainGPUBinary32& binary, std::ostream& output,
                  Flags flags = 0, cxuint driverVersion = 0);
+    /// constructor for AMD OpenCL 2.0 GPU binary 32-bit
+    /** in streaming mode (DISASM_STREAMING) kernel data of lazy binary is released
+     * after disassembling kernel. Binary must not be used by other threads
+     * while disassembling
+     * \param binary main GPU binary
+     * \param output output stream
+     * \param flags flags for disassembler
+     * \param driverVersion driverVersion (0 - detected by disassembler)
+     */
+    Disassembler(AmdCL2MainGPUBinary32& binary, std::ostream& output,
+                 Flags flags = 0, cxuint driverVersion = 0);
     /// constructor for AMD OpenCL 2.0 GPU binary 64-bit
-    /**
+    /** streaming (DISASM_STREAMING) requires non-const binary, throws DisasmException
+     * if this flag is set
      * \param binary main GPU binary
      * \param output output stream
      * \param flags flags for disassembler
@@ -406,6 +528,17 @@ public:
      */
     Disassembler(const AmdCL2MainGPUBinary64& binary, std::ostream& output,
                  Flags flags = 0, cxuint driverVersion = 0);
+    /// constructor for AMD OpenCL 2.0 GPU binary 64-bit
+    /** in streaming mode (DISASM_STREAMING) kernel data of lazy binary is released
+     * after disassembling kernel. Binary must not be used by other threads
+     * while disassembling
+     * \param binary main GPU binary
+     * \param output output stream
+     * \param flags flags for disassembler
+     * \param driverVersion driverVersion (0 - detected by disassembler)
+     */
+    Disassembler(AmdCL2MainGPUBinary64& binary, std::ostream& output,
+                 Flags flags = 0, cxuint driverVersion = 0);
     /// constructor for ROCm GPU binary
     /**
      * \param binary main GPU binary
@@ -474,6 +607,17 @@ public:
     void setFlags(Flags flags)
     { this->flags = flags; }
     
+    /// get threads number used to disassemble code
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set threads number used to disassemble code
+    /** code is splitted into chunks that disassembled in parallel,
+     * output is identical to output from sequential disassembling.
+     * \param threadsNum threads number (0 - number of hardware threads, 1 - default)
+     */
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    
     /// get deviceType
     GPUDeviceType getDeviceType() const;
     
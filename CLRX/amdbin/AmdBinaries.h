@@ -61,6 +61,8 @@ enum : Flags {
     AMDBIN_INNER_CREATE_CALNOTES = 0x10000, ///< create CAL notes for AMD inner GPU binary
     
     AMDBIN_CREATE_ALL = ELF_CREATE_ALL | 0xffff0, ///< all AMD binaries creation flags
+    /// parse kernel informations and inner binaries at first access (not in CREATE_ALL)
+    AMDBIN_CREATE_LAZY = 0x100000,
     AMDBIN_INNER_SHIFT = 12 ///< shift for convert inner binary flags into elf binary flags
 };
 
@@ -417,14 +419,24 @@ public:
     typedef Array<std::pair<CString, size_t> > KernelInfoMap;
 protected:
     AmdMainType type;   ///< type of binaries
-    Array<KernelInfo> kernelInfos;    ///< kernel informations
+    /// kernel informations (in lazy mode filled at first access)
+    mutable Array<KernelInfo> kernelInfos;
     KernelInfoMap kernelInfosMap;   ///< kernel informations map
+    /// once flags for kernel informations (only in lazy mode, reset after releasing)
+    std::unique_ptr<ResettableOnceFlag[]> kernelInfoOnceFlags;
     
     CString driverInfo; ///< driver info string
     CString compileOptions; ///< compiler options string
     
     /// constructor
     explicit AmdMainBinaryBase(AmdMainType type);
+    
+    /// parse kernel information with specified index (used in lazy mode)
+    virtual void parseLazyKernelInfo(size_t index) const;
+    /// parse kernel information if not parsed yet (lazy mode)
+    void prepareKernelInfo(size_t index) const;
+    /// parse all kernel informations if not parsed yet (lazy mode)
+    void prepareKernelInfos() const;
 public:
     virtual ~AmdMainBinaryBase();
     
@@ -438,15 +450,30 @@ public:
     
     /// get kernel informations array
     const KernelInfo* getKernelInfos() const
-    { return kernelInfos.data(); }
+    {
+        if (kernelInfoOnceFlags)
+            prepareKernelInfos();
+        return kernelInfos.data();
+    }
     
     /// get kernel information with specified index
     const KernelInfo& getKernelInfo(size_t index) const
-    { return kernelInfos[index]; }
+    {
+        if (kernelInfoOnceFlags)
+            prepareKernelInfo(index);
+        return kernelInfos[index];
+    }
     
     /// get kernel information with specified kernel name (requires kernel info map)
     const KernelInfo& getKernelInfo(const char* name) const;
     
+    /// release kernel information with specified index (only in lazy mode)
+    /** kernel information will be parsed again at next access. In non-lazy mode
+     * does nothing. This method requires exclusive access to binary (no other thread
+     * can use it during this call) and any reference to this kernel information
+     * must not be used after this call */
+    void releaseKernelInfo(size_t index);
+    
     /// get driver info string
     const CString& getDriverInfo() const
     { return driverInfo; }
@@ -480,8 +507,13 @@ public:
     /// kernel header map type
     typedef Array<std::pair<CString, size_t> > KernelHeaderMap;
 protected:
-    Array<AmdInnerGPUBinary32> innerBinaries;   ///< inner binaries
+    /// inner binaries (in lazy mode created at first access)
+    mutable Array<AmdInnerGPUBinary32> innerBinaries;
     InnerBinaryMap innerBinaryMap;  ///< inner binary map
+    /// kernel names, sizes and codes of inner binaries (only in lazy mode)
+    Array<AmdGPUKernelHeader> innerBinaryCodes;
+    /// once flags for inner binaries (only in lazy mode, reset after releasing)
+    std::unique_ptr<ResettableOnceFlag[]> innerBinaryOnceFlags;
     std::unique_ptr<AmdGPUKernelMetadata[]> metadatas;  ///< AMD metadatas
     Array<AmdGPUKernelHeader> kernelHeaders;    ///< kernel headers
     KernelHeaderMap kernelHeaderMap;    ///< kernel header map
@@ -494,6 +526,11 @@ protected:
     /// initialize main gpu binary (internal use only)
     template<typename Types>
     void initMainGPUBinary(typename Types::ElfBinary& binary);
+    
+    /// parse kernel information from metadata (lazy mode)
+    void parseLazyKernelInfo(size_t index) const;
+    /// create inner binary if not created yet (lazy mode)
+    void prepareInnerBinary(size_t index) const;
 public:
     /// get number of inner binaries
     size_t getInnerBinariesNum() const
@@ -501,15 +538,33 @@ public:
     
     /// get inner binary with specified index
     AmdInnerGPUBinary32& getInnerBinary(size_t index)
-    { return innerBinaries[index]; }
+    {
+        if (innerBinaryOnceFlags)
+            prepareInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified index
     const AmdInnerGPUBinary32& getInnerBinary(size_t index) const
-    { return innerBinaries[index]; }
+    {
+        if (innerBinaryOnceFlags)
+            prepareInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified name (requires inner binary map)
     const AmdInnerGPUBinary32& getInnerBinary(const char* name) const;
     
+    /// get index of inner binary with specified name (requires inner binary map)
+    size_t getInnerBinaryIndex(const char* name) const;
+    
+    /// release inner binary with specified index (only in lazy mode)
+    /** inner binary will be created again at next access. In non-lazy mode
+     * does nothing. This method requires exclusive access to binary (no other thread
+     * can use it during this call) and any reference to this inner binary
+     * must not be used after this call */
+    void releaseInnerBinary(size_t index);
+    
     /// get metadata size for specified inner binary
     size_t getMetadataSize(size_t index) const
     { return metadatas[index].size; }
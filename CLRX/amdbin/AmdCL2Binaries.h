@@ -377,6 +377,9 @@ protected:
     template<typename Types>
     void initMainGPUBinary(typename Types::ElfBinary& elfBin);
     
+    /// parse kernel information from metadata (lazy mode)
+    void parseLazyKernelInfo(size_t index) const;
+    
     /// internal method to determine GPU device type
     template<typename Types>
     GPUDeviceType determineGPUDeviceTypeInt(const typename Types::ElfBinary& elfBin,
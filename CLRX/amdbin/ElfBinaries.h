@@ -70,7 +70,11 @@ enum : Flags {
     ELF_CREATE_SECTIONMAP = 1,  ///< create map of sections
     ELF_CREATE_SYMBOLMAP = 2,   ///< create map of symbols
     ELF_CREATE_DYNSYMMAP = 4,   ///< create map of dynamic symbols
-    ELF_CREATE_ALL = 0xf  ///< creation flags for ELF binaries
+    ELF_CREATE_ALL = 0xf,  ///< creation flags for ELF binaries
+    /** use hash index for section and symbol maps instead of sorting them
+     * (maps stay in index order, for duplicated names lookups return first entry).
+     * Not included in any *_CREATE_ALL flags */
+    ELF_CREATE_HASHINDEX = 0x1000000
 };
 
 /// Bin exception class
@@ -151,6 +155,14 @@ public:
     typedef Array<std::pair<const char*, size_t> > SectionIndexMap;
     /// symbol index map
     typedef Array<std::pair<const char*, size_t> > SymbolIndexMap;
+    /// slot of the open-addressing hash index of names
+    struct NameHashSlot
+    {
+        uint32_t hash;  ///< hash of name
+        uint32_t index; ///< index in map plus one (zero if slot is empty)
+    };
+    /// hash index of names (number of slots is power of two)
+    typedef Array<NameHashSlot> NameHashIndex;
 protected:
     Flags creationFlags;   ///< creation flags holder
     size_t binaryCodeSize;  ///< binary code size
@@ -165,6 +177,11 @@ protected:
     SectionIndexMap sectionIndexMap;    ///< section's index map
     SymbolIndexMap symbolIndexMap;      ///< symbol's index map
     SymbolIndexMap dynSymIndexMap;      ///< dynamic symbol's index map
+    NameHashIndex sectionHashIndex;     ///< section's hash index
+    NameHashIndex symbolHashIndex;      ///< symbol's hash index
+    NameHashIndex dynSymHashIndex;      ///< dynamic symbol's hash index
+    const uint32_t* symbolElfHash;  ///< ELF hash section for symbols (if present)
+    const uint32_t* dynSymElfHash;  ///< ELF hash section for dynamic symbols (if present)
     
     typename Types::Size symbolsNum;    ///< symbols number
     typename Types::Size dynSymbolsNum; ///< dynamic symbols number
@@ -201,6 +218,10 @@ public:
     bool hasDynSymbolMap() const
     { return (creationFlags & ELF_CREATE_DYNSYMMAP) != 0; }
     
+    /// returns true if maps are hash indexed (and ordered by index, not by name)
+    bool hasHashIndex() const
+    { return (creationFlags & ELF_CREATE_HASHINDEX) != 0; }
+    
     /// get size of binaries
     size_t getSize() const
     { return binaryCodeSize; }
@@ -332,6 +353,8 @@ public:
     /// get section iterator with specified name (requires section index map)
     SectionIndexMap::const_iterator getSectionIter(const char* name) const
     {
+        if (hasHashIndex())
+            return sectionIndexMap.begin() + getSectionIndex(name);
         SectionIndexMap::const_iterator it = binaryMapFind(
                     sectionIndexMap.begin(), sectionIndexMap.end(), name, CStringLess());
         if (it == sectionIndexMap.end())
@@ -359,6 +382,8 @@ public:
     /// get symbol iterator with specified name (requires symbol index map)
     SymbolIndexMap::const_iterator getSymbolIter(const char* name) const
     {
+        if (hasHashIndex())
+            return symbolIndexMap.begin() + getSymbolIndex(name);
         SymbolIndexMap::const_iterator it = binaryMapFind(
                     symbolIndexMap.begin(), symbolIndexMap.end(), name, CStringLess());
         if (it == symbolIndexMap.end())
@@ -369,6 +394,8 @@ public:
     /// get dynamic symbol iterator with specified name (requires dynamic symbol index map)
     SymbolIndexMap::const_iterator getDynSymbolIter(const char* name) const
     {
+        if (hasHashIndex())
+            return dynSymIndexMap.begin() + getDynSymbolIndex(name);
         SymbolIndexMap::const_iterator it = binaryMapFind(
                     dynSymIndexMap.begin(), dynSymIndexMap.end(), name, CStringLess());
         if (it == dynSymIndexMap.end())
@@ -888,6 +915,11 @@ public:
     /// generate binary
     void generate(FastOutputBuffer& fob);
     
+    /// generate binary as part of outer binary (inner binary)
+    /** binary is written at current position of output buffer and output is not
+     * flushed, thus output of outer binary is written in one pass */
+    void generateNested(FastOutputBuffer& fob);
+    
     /// generate binary
     void generate(std::ostream& os)
     {
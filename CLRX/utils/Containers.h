@@ -281,6 +281,54 @@ public:
     }
 };
 
+/// an array range (view of an array, does not hold elements)
+template<typename T>
+class ArrayRange
+{
+public:
+    typedef T* iterator;    ///< type of iterator
+    typedef T* const_iterator;    ///< type of constant iterator
+    typedef T element_type; ///< element type
+private:
+    T* ptr, *ptrEnd;
+public:
+    /// empty constructor
+    ArrayRange(): ptr(nullptr), ptrEnd(nullptr)
+    { }
+    /// constructor from range of elements
+    ArrayRange(T* b, T* e): ptr(b), ptrEnd(e)
+    { }
+    /// constructor from array
+    template<typename T2>
+    ArrayRange(const Array<T2>& array): ptr(array.begin()), ptrEnd(array.end())
+    { }
+    
+    /// returns true if empty
+    bool empty() const
+    { return ptrEnd==ptr; }
+    /// returns number of elements
+    size_t size() const
+    { return ptrEnd-ptr; }
+    /// get data
+    T* data() const
+    { return ptr; }
+    /// get iterator to first element
+    T* begin() const
+    { return ptr; }
+    /// get iterator to after last element
+    T* end() const
+    { return ptrEnd; }
+    /// get first element
+    T& front() const
+    { return *ptr; }
+    /// get last element
+    T& back() const
+    { return ptrEnd[-1]; }
+    /// operator of indexing
+    T& operator[] (size_t i) const
+    { return ptr[i]; }
+};
+
 /// binary find helper
 /**
  * \param begin iterator to first element
@@ -347,28 +347,51 @@ public:
 };
 
 /// fast and direct output buffer
+/** Output buffer writes to output stream or directly to memory of known size.
+ * In memory mode whole destination is buffer and data is written to it without
+ * any copying (exception is thrown if data doesn't fit to memory).
+ */
 class FastOutputBuffer: public NonCopyableAndNonMovable
 {
 private:
-    std::ostream& os;
-    cxuint endPos;
-    cxuint bufSize;
-    std::unique_ptr<char[]> buffer;
+    std::ostream* os;   // null if output to memory
+    size_t endPos;
+    size_t bufSize;
+    std::unique_ptr<char[]> bufferHolder;
+    char* buffer;
     uint64_t written;
+    
+    // called if too few free bytes in buffer
+    void makeSpace()
+    {
+        if (os == nullptr)
+            throw Exception("Output memory overflow");
+        flush();
+    }
 public:
     /// constructor with inBufSize and output
     /**
      * \param _bufSize max buffer size
      * \param output output stream
      */
-    FastOutputBuffer(cxuint _bufSize, std::ostream& output) : os(output), endPos(0),
-            bufSize(_bufSize), buffer(new char[_bufSize]), written(0)
+    FastOutputBuffer(cxuint _bufSize, std::ostream& output) : os(&output), endPos(0),
+            bufSize(_bufSize), bufferHolder(new char[_bufSize]),
+            buffer(bufferHolder.get()), written(0)
+    { }
+    /// constructor with output to memory
+    /**
+     * \param outSize size of output memory
+     * \param outPtr pointer to output memory
+     */
+    FastOutputBuffer(size_t outSize, char* outPtr) : os(nullptr), endPos(0),
+            bufSize(outSize), buffer(outPtr), written(0)
     { }
     /// destructor
     ~FastOutputBuffer()
     { 
         flush();
-        os.flush();
+        if (os != nullptr)
+            os->flush();
     }
     
     /// get written bytes number
@@ -378,7 +401,9 @@ public:
     /// write output buffer
     void flush()
     {
-        os.write(buffer.get(), endPos);
+        if (os == nullptr)
+            return; // data is already in output memory
+        os->write(buffer, endPos);
         endPos = 0;
     }
     
@@ -386,8 +411,8 @@ public:
     char* reserve(cxuint toReserve)
     {
         if (toReserve > bufSize-endPos)
-            flush();
-        return buffer.get() + endPos;
+            makeSpace();
+        return buffer + endPos;
     }
     
     /// finish reservation and go forward
@@ -402,12 +427,12 @@ public:
     {
         if (length > bufSize-endPos)
         {
-            flush();
-            os.write(string, length);
+            makeSpace();
+            os->write(string, length);
         }
         else
         {
-            ::memcpy(buffer.get()+endPos, string, length);
+            ::memcpy(buffer+endPos, string, length);
             endPos += length;
         }
         written += length;
@@ -431,7 +456,7 @@ public:
     void put(char c)
     {
         if (endPos == bufSize)
-            flush();
+            makeSpace();
         buffer[endPos++] = c;
         written++;
     }
@@ -439,11 +464,13 @@ public:
     /// fill (put num c character)
     void fill(size_t num, char c)
     {
+        if (num > bufSize-endPos && os == nullptr)
+            makeSpace();
         size_t count = num;
         while (count != 0)
         {
              size_t bufNum = std::min(size_t(bufSize-endPos), count);
-             ::memset(buffer.get()+endPos, c, bufNum);
+             ::memset(buffer+endPos, c, bufNum);
              count -= bufNum;
              endPos += bufNum;
              if (endPos == bufSize)
@@ -452,12 +479,69 @@ public:
         written += num;
     }
     
-    /// get output stream
+    /// returns true if output goes directly to memory
+    bool isMemoryOutput() const
+    { return os == nullptr; }
+    
+    /// get output stream (only if output goes to stream)
     const std::ostream& getOStream() const
-    { return os; }
-    /// get output stream
+    { return *os; }
+    /// get output stream (only if output goes to stream)
     std::ostream& getOStream()
-    { return os; }
+    { return *os; }
+};
+
+/// holder of fast output buffer for output of binary generators
+/** Output goes to array or vector (resized to output size and filled directly,
+ * without intermediate stream) or to output stream. Exceptions (failbit and badbit)
+ * of output stream are enabled during lifetime of holder. Buffer should be flushed
+ * by writer, because holder restores exceptions before destroying buffer.
+ */
+class FastOutputBufferHolder: public NonCopyableAndNonMovable
+{
+private:
+    std::ostream* os;
+    std::ios::iostate oldExceptions;
+    std::unique_ptr<FastOutputBuffer> buffer;
+public:
+    /// constructor (only one output pointer must be non-null)
+    /**
+     * \param outSize size of output (used for array and vector)
+     * \param osPtr pointer to output stream
+     * \param vPtr pointer to output vector
+     * \param aPtr pointer to output array
+     */
+    FastOutputBufferHolder(size_t outSize, std::ostream* osPtr, std::vector<char>* vPtr,
+            Array<cxbyte>* aPtr) : os(osPtr), oldExceptions(std::ios::goodbit)
+    {
+        if (aPtr != nullptr)
+        {
+            aPtr->resize(outSize);
+            buffer.reset(new FastOutputBuffer(outSize,
+                        reinterpret_cast<char*>(aPtr->data())));
+        }
+        else if (vPtr != nullptr)
+        {
+            vPtr->resize(outSize);
+            buffer.reset(new FastOutputBuffer(outSize, vPtr->data()));
+        }
+        else
+        {
+            buffer.reset(new FastOutputBuffer(256, *os));
+            oldExceptions = os->exceptions();
+            os->exceptions(std::ios::failbit | std::ios::badbit);
+        }
+    }
+    /// destructor
+    ~FastOutputBufferHolder()
+    {
+        if (os != nullptr)
+            os->exceptions(oldExceptions);
+    }
+    
+    /// get output buffer
+    FastOutputBuffer& getBuffer()
+    { return *buffer; }
 };
 
 };
@@ -30,8 +30,11 @@
 #include <cstdlib>
 #include <cstring>
 #include <cstdint>
+#include <functional>
 #include <mutex>
 #include <atomic>
+#include <thread>
+#include <type_traits>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/utils/CString.h>
 
@@ -108,6 +111,82 @@ enum: Flags {
     DYNLIB_GLOBAL = 8   ///< treats symbols globally
 };
 
+/// memory arena (region-based allocator)
+/** memory is allocated from big blocks and it is freed at once in destructor.
+ * The last allocation can be released (in stack order) to reuse memory
+ * by short-living objects. Other released small allocations (to 256 bytes)
+ * go to free lists (by size) and they are reused by next allocations of this size.
+ * Allocated memory is aligned to 16 bytes.
+ */
+class MemoryArena: public NonCopyableAndNonMovable
+{
+private:
+    struct Block;
+    Block* lastBlock;
+    cxbyte* blockStart;
+    cxbyte* current;
+    cxbyte* end;
+    size_t blockSize;
+    size_t allocsNum;
+    static const size_t freeListsNum = 16;
+    void* freeLists[freeListsNum];  // released allocations (16, 32, ..., 256 bytes)
+    
+    void* allocateSlow(size_t size);
+public:
+    /// constructor
+    /**
+     * \param blockSize size of single block
+     */
+    explicit MemoryArena(size_t blockSize = 32768);
+    /// destructor
+    ~MemoryArena();
+    
+    /// allocate memory
+    void* allocate(size_t size)
+    {
+        size = (size+15) & ~size_t(15);
+        allocsNum++;
+        const size_t listIndex = (size>>4)-1;
+        if (listIndex < freeListsNum && freeLists[listIndex] != nullptr)
+        {
+            // reuse released allocation
+            void* ptr = freeLists[listIndex];
+            freeLists[listIndex] = *reinterpret_cast<void**>(ptr);
+            return ptr;
+        }
+        if (size_t(end-current) >= size)
+        {
+            void* ptr = current;
+            current += size;
+            return ptr;
+        }
+        return allocateSlow(size);
+    }
+    /// release memory
+    /** memory is reused if it has been allocated at last or if size is small */
+    void release(void* ptr, size_t size)
+    {
+        size = (size+15) & ~size_t(15);
+        if (ptr >= blockStart && (cxbyte*)ptr+size == current)
+        {
+            current = (cxbyte*)ptr;
+            return;
+        }
+        const size_t listIndex = (size>>4)-1;
+        if (listIndex < freeListsNum)
+        {
+            // put to free list
+            *reinterpret_cast<void**>(ptr) = freeLists[listIndex];
+            freeLists[listIndex] = ptr;
+        }
+    }
+    /// free all memory
+    void clear();
+    /// get number of allocations
+    size_t getAllocationsNum() const
+    { return allocsNum; }
+};
+
 /// dynamic library class
 class DynLibrary: public NonCopyableAndNonMovable
 {
@@ -346,6 +425,19 @@ struct CStringHash
     }
 };
 
+/// compute 64-bit FNV-1a hash of data
+inline uint64_t hashFNV1a64(size_t size, const void* data)
+{
+    const cxbyte* bytes = reinterpret_cast<const cxbyte*>(data);
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++)
+    {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
 /// counts leading zeroes for 32-bit unsigned integer. For zero behavior is undefined
 inline cxuint CLZ32(uint32_t v);
 /// counts leading zeroes for 64-bit unsigned integer. For zero behavior is undefined
@@ -373,6 +465,34 @@ inline cxuint CLZ64(uint64_t v)
 #endif
 }
 
+/// counts trailing zeroes for 32-bit unsigned integer. For zero behavior is undefined
+inline cxuint CTZ32(uint32_t v);
+
+inline cxuint CTZ32(uint32_t v)
+{
+#ifdef __GNUC__
+    return __builtin_ctz(v);
+#else
+    cxuint count = 0;
+    for (; (v&1)==0; v>>=1, count++);
+    return count;
+#endif
+}
+
+/// counts trailing zeroes for 64-bit unsigned integer. For zero behavior is undefined
+inline cxuint CTZ64(uint64_t v);
+
+inline cxuint CTZ64(uint64_t v)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(v);
+#else
+    cxuint count = 0;
+    for (; (v&1)==0; v>>=1, count++);
+    return count;
+#endif
+}
+
 /// safely compares sum of two unsigned integers with other unsigned integer
 template<typename T, typename T2>
 inline bool usumGt(T a, T b, T2 c)
@@ -622,6 +742,8 @@ size_t itocstrCStyle<cxllong>(cxllong value, char* str, size_t maxSize, cxuint r
 { return iXtocstrCStyle(value, str, maxSize, radix, width, prefix); }
 
 /// format float value to string
+/** prints shortest digits that will be parsed back (by cstrtofXCStyle) to same value.
+ * integer values printed without exponent are printed exactly */
 extern size_t fXtocstrCStyle(uint64_t value, char* str, size_t maxSize,
         bool scientific, cxuint expBits, cxuint mantisaBits);
 
@@ -704,6 +826,50 @@ extern bool isFileExists(const char* path);
  */
 extern Array<cxbyte> loadDataFromFile(const char* filename);
 
+/// memory mapped file (read-only file mapped as copy-on-write)
+/** file content is mapped into memory without copying, pages are shared
+ * between processes until they are modified. If file can not be mapped (pipe, device),
+ * then content is loaded by loadDataFromFile.
+ */
+class MappedFile: public NonCopyableAndNonMovable
+{
+private:
+    cxbyte* content;
+    size_t contentSize;
+    bool mapped;
+#ifdef HAVE_WINDOWS
+    void* mapHandle;
+#endif
+    Array<cxbyte> loadedData;
+public:
+    MappedFile();
+    /** constructor - maps file
+     * \param filename filename
+     */
+    explicit MappedFile(const char* filename);
+    ~MappedFile();
+    
+    /** maps file
+     * \param filename filename
+     */
+    void open(const char* filename);
+    /// unmap file
+    void close();
+    
+    /// get file content
+    cxbyte* getData()
+    { return content; }
+    /// get file content
+    const cxbyte* getData() const
+    { return content; }
+    /// get file size
+    size_t getSize() const
+    { return contentSize; }
+    /// returns true if file is mapped (false if loaded to memory)
+    bool isMapped() const
+    { return mapped; }
+};
+
 /// convert to filesystem from unified path (with slashes)
 extern void filesystemPath(char* path);
 /// convert to filesystem from unified path (with slashes)
@@ -712,6 +878,9 @@ extern void filesystemPath(std::string& path);
 /// join two paths
 extern std::string joinPaths(const std::string& path1, const std::string& path2);
 
+/// get absolute path (relative path is joined with current directory)
+extern std::string getAbsolutePath(const std::string& path);
+
 /// get file timestamp in nanosecond since Unix epoch
 extern uint64_t getFileTimestamp(const char* filename);
 
@@ -731,6 +900,18 @@ extern std::string findMesaOCL();
 /// find LLVM config, returns path if found, otherwise returns empty string
 extern std::string findLLVMConfig();
 
+/// run jobs concurrently in pool of threads
+/** Jobs are divided between threads. A thread that finished own jobs steals jobs
+ * from other threads. First exception thrown by job is rethrown after finishing
+ * all threads.
+ * \param jobsNum number of jobs
+ * \param threadsNum number of threads (0 - number of hardware threads), never more
+ * threads than jobs are run
+ * \param jobFunc function called with index of job
+ */
+extern void runInThreadPool(size_t jobsNum, cxuint threadsNum,
+            const std::function<void(size_t)>& jobFunc);
+
 /*
  * Reference support
  */
@@ -855,6 +1036,9 @@ public:
     /// get elem from pointer
     T* operator->() const
     { return ptr; }
+    /// get pointer
+    T* get() const
+    { return ptr; }
     
     /// reset refpointer
     void reset()
@@ -976,14 +1160,73 @@ struct OnceFlag: std::atomic<int>
     { }
 };
 
+/// callOnce - portable wrapper for std::call_once
+/** other callers wait until call will be finished, hence data initialized by
+ * this call can be safely used by many threads */
 template<class Callable, class... Args>
 inline void callOnce(OnceFlag& flag, Callable&& f, Args&&... args)
 {
-    if (flag.exchange(1) == 0)
-        f(args...);
+    while (true)
+    {
+        int expected = 0;
+        // 0 - not called, 1 - in progress, 2 - done
+        if (flag.compare_exchange_strong(expected, 1))
+        {
+            try
+            { f(args...); }
+            catch(...)
+            {
+                flag.store(0); // retry in next call
+                throw;
+            }
+            flag.store(2);
+            return;
+        }
+        if (expected == 2)
+            return;
+        std::this_thread::yield();
+    }
 }
 #endif
 
+/// resettable once flag
+/** unlike OnceFlag, flag can be reset, then next callOnce calls function again.
+ * Used to prepare data that can be released (for example lazily parsed data) */
+class ResettableOnceFlag: public NonCopyableAndNonMovable
+{
+private:
+    std::atomic<bool> done;
+    std::mutex mutex;
+public:
+    /// constructor
+    ResettableOnceFlag() : done(false)
+    { }
+    
+    /// call function if it has not been called since creation or last reset
+    /** other callers wait until call will be finished, if call throws exception,
+     * then function will be called again at next call */
+    template<class Callable, class... Args>
+    void call(Callable&& f, Args&&... args)
+    {
+        if (done.load(std::memory_order_acquire))
+            return;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (done.load(std::memory_order_relaxed))
+            return;
+        f(args...);
+        done.store(true, std::memory_order_release);
+    }
+    
+    /// reset flag (no thread can call callOnce with this flag at this time)
+    void reset()
+    { done.store(false, std::memory_order_release); }
+};
+
+/// callOnce for resettable once flag
+template<class Callable, class... Args>
+inline void callOnce(ResettableOnceFlag& flag, Callable&& f, Args&&... args)
+{ flag.call(f, args...); }
+
 };
 
 #endif
@@ -0,0 +1,86 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <string>
+#include <sstream>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+
+using namespace CLRX;
+
+// assemble single job, all state is local, hence it can be called from many threads
+static void assembleBatchJob(const AsmBatchJob& job, AsmBatchResult& result,
+            AsmIncludeCache* includeCache)
+{
+    std::ostringstream msgStream;
+    std::ostringstream printStream;
+    result.good = false;
+    result.binary.clear();
+    try
+    {
+        std::unique_ptr<std::istringstream> input;
+        std::unique_ptr<Assembler> assembler;
+        if (!job.content.empty())
+        {
+            input.reset(new std::istringstream(job.content));
+            assembler.reset(new Assembler(job.filename, *input, job.flags, job.format,
+                        job.deviceType, msgStream, printStream));
+        }
+        else
+        {
+            Array<CString> filenames(1);
+            filenames[0] = job.filename;
+            assembler.reset(new Assembler(filenames, job.flags, job.format,
+                        job.deviceType, msgStream, printStream));
+        }
+        assembler->set64Bit(job.is64Bit);
+        assembler->setDriverVersion(job.driverVersion);
+        assembler->setLLVMVersion(job.llvmVersion);
+        assembler->setIncludeCache(includeCache);
+        for (const CString& includeDir: job.includeDirs)
+            assembler->addIncludeDir(includeDir);
+        for (const Assembler::DefSym& defSym: job.defSyms)
+            assembler->addInitialDefSym(defSym.first, defSym.second);
+
+        if (assembler->assemble())
+        {
+            assembler->writeBinary(result.binary);
+            result.good = true;
+        }
+    }
+    catch(const std::bad_alloc& ex)
+    { msgStream << "Out of memory" << std::endl; }
+    catch(const std::exception& ex)
+    { msgStream << ex.what() << std::endl; }
+    result.messages = msgStream.str();
+    result.printOutput = printStream.str();
+}
+
+bool CLRX::assembleBatch(size_t jobsNum, const AsmBatchJob* jobs,
+            AsmBatchResult* results, cxuint threadsNum, AsmIncludeCache* includeCache)
+{
+    runInThreadPool(jobsNum, threadsNum, [jobs, results, includeCache](size_t i)
+            { assembleBatchJob(jobs[i], results[i], includeCache); });
+    for (size_t i = 0; i < jobsNum; i++)
+        if (!results[i].good)
+            return false;
+    return true;
+}
@@ -40,10 +40,44 @@ static const uint64_t operatorWithMessage =
         (1ULL<<int(AsmExprOp::SHIFT_LEFT)) | (1ULL<<int(AsmExprOp::SHIFT_RIGHT)) |
         (1ULL<<int(AsmExprOp::SIGNED_SHIFT_RIGHT));
 
-AsmExpression::AsmExpression() : symOccursNum(0), relativeSymOccurs(false),
-            baseExpr(false)
+AsmExpression::AsmExpression(MemoryArena* _arena) : symOccursNum(0),
+            relativeSymOccurs(false), baseExpr(false), arena(_arena), storageSize(0),
+            opsNum(0), args(nullptr), messagePositions(nullptr), ops(nullptr)
 { }
 
+// allocate arguments, message positions and operators in single memory block
+void AsmExpression::allocateStorage(size_t _opsNum, size_t _opPosNum, size_t _argsNum)
+{
+    storageSize = sizeof(AsmExprArg)*_argsNum + sizeof(LineCol)*_opPosNum +
+            sizeof(AsmExprOp)*_opsNum;
+    cxbyte* storage = nullptr;
+    if (storageSize != 0)
+        storage = reinterpret_cast<cxbyte*>((arena != nullptr) ?
+                arena->allocate(storageSize) : ::operator new(storageSize));
+    opsNum = _opsNum;
+    args = reinterpret_cast<AsmExprArg*>(storage);
+    messagePositions = reinterpret_cast<LineCol*>(storage +
+                sizeof(AsmExprArg)*_argsNum);
+    ops = reinterpret_cast<AsmExprOp*>(storage + sizeof(AsmExprArg)*_argsNum +
+                sizeof(LineCol)*_opPosNum);
+}
+
+void AsmExpression::freeStorage()
+{
+    if (storageSize != 0)
+    {
+        if (arena != nullptr)
+            arena->release(args, storageSize);
+        else
+            ::operator delete(args);
+    }
+    storageSize = 0;
+    opsNum = 0;
+    args = nullptr;
+    messagePositions = nullptr;
+    ops = nullptr;
+}
+
 // set symbol occurrences, operators and arguments, line positions for messages
 void AsmExpression::setParams(size_t _symOccursNum,
           bool _relativeSymOccurs, size_t _opsNum, const AsmExprOp* _ops, size_t _opPosNum,
@@ -52,11 +86,11 @@ void AsmExpression::setParams(size_t _symOccursNum,
     symOccursNum = _symOccursNum;
     relativeSymOccurs = _relativeSymOccurs;
     baseExpr = _baseExpr;
-    args.reset(new AsmExprArg[_argsNum]);
-    ops.assign(_ops, _ops+_opsNum);
-    messagePositions.reset(new LineCol[_opPosNum]);
-    std::copy(_args, _args+_argsNum, args.get());
-    std::copy(_opPos, _opPos+_opPosNum, messagePositions.get());
+    freeStorage();
+    allocateStorage(_opsNum, _opPosNum, _argsNum);
+    std::copy(_ops, _ops+_opsNum, ops);
+    std::copy(_args, _args+_argsNum, args);
+    std::copy(_opPos, _opPos+_opPosNum, messagePositions);
 }
 
 AsmExpression::AsmExpression(const AsmSourcePos& _pos, size_t _symOccursNum,
@@ -64,22 +98,21 @@ AsmExpression::AsmExpression(const AsmSourcePos& _pos, size_t _symOccursNum,
           const LineCol* _opPos, size_t _argsNum, const AsmExprArg* _args,
           bool _baseExpr)
         : sourcePos(_pos), symOccursNum(_symOccursNum), relativeSymOccurs(_relSymOccurs),
-          baseExpr(_baseExpr), ops(_ops, _ops+_opsNum)
+          baseExpr(_baseExpr), arena(nullptr)
 {
-    args.reset(new AsmExprArg[_argsNum]);
-    messagePositions.reset(new LineCol[_opPosNum]);
-    std::copy(_args, _args+_argsNum, args.get());
-    std::copy(_opPos, _opPos+_opPosNum, messagePositions.get());
+    allocateStorage(_opsNum, _opPosNum, _argsNum);
+    std::copy(_ops, _ops+_opsNum, ops);
+    std::copy(_args, _args+_argsNum, args);
+    std::copy(_opPos, _opPos+_opPosNum, messagePositions);
 }
 
 AsmExpression::AsmExpression(const AsmSourcePos& _pos, size_t _symOccursNum,
             bool _relSymOccurs, size_t _opsNum, size_t _opPosNum, size_t _argsNum,
             bool _baseExpr)
         : sourcePos(_pos), symOccursNum(_symOccursNum), relativeSymOccurs(_relSymOccurs),
-          baseExpr(_baseExpr), ops(_opsNum)
+          baseExpr(_baseExpr), arena(nullptr)
 {
-    args.reset(new AsmExprArg[_argsNum]);
-    messagePositions.reset(new LineCol[_opPosNum]);
+    allocateStorage(_opsNum, _opPosNum, _argsNum);
 }
 
 AsmExpression::~AsmExpression()
@@ -87,7 +120,7 @@ AsmExpression::~AsmExpression()
     if (!baseExpr)
     {
         // delete all occurrences in expression at that place
-        for (size_t i = 0, j = 0; i < ops.size(); i++)
+        for (size_t i = 0, j = 0; i < opsNum; i++)
             if (ops[i] == AsmExprOp::ARG_SYMBOL)
             {
                 args[j].symbol->second.removeOccurrenceInExpr(this, j, i);
@@ -96,6 +129,7 @@ AsmExpression::~AsmExpression()
             else if (ops[i]==AsmExprOp::ARG_VALUE)
                 j++;
     }
+    freeStorage();
 }
 
 // helper for handling errors
@@ -799,22 +833,20 @@ class CLRX_INTERNAL CLRX::AsmExpression::TempSymbolSnapshotMap:
 
 AsmExpression* AsmExpression::createForSnapshot(const AsmSourcePos* exprSourcePos) const
 {
-    std::unique_ptr<AsmExpression> expr(new AsmExpression);
+    std::unique_ptr<AsmExpression> expr(new AsmExpression(arena));
     size_t argsNum = 0;
     size_t msgPosNum = 0;
-    for (AsmExprOp op: ops)
-        if (AsmExpression::isArg(op))
+    for (size_t i = 0; i < opsNum; i++)
+        if (AsmExpression::isArg(ops[i]))
             argsNum++;
-        else if (operatorWithMessage & (1ULL<<int(op)))
+        else if (operatorWithMessage & (1ULL<<int(ops[i])))
             msgPosNum++;
     expr->sourcePos = sourcePos;
     expr->sourcePos.exprSourcePos = exprSourcePos;
-    expr->ops = ops;
-    expr->args.reset(new AsmExprArg[argsNum]);
-    std::copy(args.get(), args.get()+argsNum, expr->args.get());
-    expr->messagePositions.reset(new LineCol[msgPosNum]);
-    std::copy(messagePositions.get(), messagePositions.get()+msgPosNum,
-              expr->messagePositions.get());
+    expr->allocateStorage(opsNum, msgPosNum, argsNum);
+    std::copy(ops, ops+opsNum, expr->ops);
+    std::copy(args, args+argsNum, expr->args);
+    std::copy(messagePositions, messagePositions+msgPosNum, expr->messagePositions);
     return expr.release();
 }
 
@@ -882,10 +914,10 @@ bool AsmExpression::makeSymbolSnapshot(Assembler& assembler,
         size_t opIndex = se.opIndex;
         size_t argIndex = se.argIndex;
         AsmExpression* expr = se.entry->second.expression;
-        const size_t opsSize = expr->ops.size();
+        const size_t opsSize = expr->opsNum;
         
-        AsmExprArg* args = expr->args.get();
-        AsmExprOp* ops = expr->ops.data();
+        AsmExprArg* args = expr->args;
+        AsmExprOp* ops = expr->ops;
         if (opIndex < opsSize)
         {
             for (; opIndex < opsSize; opIndex++)
@@ -937,7 +969,7 @@ bool AsmExpression::makeSymbolSnapshot(Assembler& assembler,
                     else // if not defined
                     {
                         args[argIndex].symbol->second.addOccurrenceInExpr(
-                                        expr, argIndex, opIndex);
+                                        expr, argIndex, opIndex, assembler.getSharedArena());
                         expr->symOccursNum++;
                     }
                     
@@ -1037,7 +1069,7 @@ AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
         size_t lineColPos;
     };
 
-    std::stack<ConExprOpEntry> stack;
+    std::stack<ConExprOpEntry, std::vector<ConExprOpEntry> > stack;
     std::vector<AsmExprOp> ops;
     std::vector<AsmExprArg> args;
     std::vector<LineCol> messagePositions;
@@ -1062,7 +1094,7 @@ AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
         XT_ARG = 2  // expected argument
     };
     ExpectedToken expectedToken = XT_FIRST;
-    std::unique_ptr<AsmExpression> expr(new AsmExpression);
+    std::unique_ptr<AsmExpression> expr(new AsmExpression(&assembler.exprArena));
     expr->sourcePos = assembler.getSourcePos(startString);
     
     while (linePtr != end)
@@ -1507,7 +1539,8 @@ AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
             for (size_t i = 0, j = 0; j < argsNum; i++)
                 if (ops[i] == AsmExprOp::ARG_SYMBOL)
                 {
-                    args[j].symbol->second.addOccurrenceInExpr(expr.get(), j, i);
+                    args[j].symbol->second.addOccurrenceInExpr(expr.get(), j, i,
+                                assembler.getSharedArena());
                     j++;
                 }
                 else if (ops[i]==AsmExprOp::ARG_VALUE)
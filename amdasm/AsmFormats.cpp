@@ -96,7 +96,7 @@ bool AsmFormatHandler::resolveLoHiRelocExpression(const AsmExpression* expr,
                 "code section");
         return false;
     }
-    const Array<AsmExprOp>& ops = expr->getOps();
+    const ArrayRange<const AsmExprOp> ops = expr->getOps();
     
     size_t relOpStart = 0;
     size_t relOpEnd = ops.size();
@@ -0,0 +1,612 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/MemAccess.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "AsmInternals.h"
+
+using namespace CLRX;
+
+/*
+ * serialization helpers (all values in little-endian)
+ */
+
+static void putU8(std::vector<cxbyte>& out, cxbyte value)
+{ out.push_back(value); }
+
+static void putU32(std::vector<cxbyte>& out, uint32_t value)
+{
+    for (cxuint i = 0; i < 4; i++)
+        out.push_back(value>>(i<<3));
+}
+
+static void putU64(std::vector<cxbyte>& out, uint64_t value)
+{
+    for (cxuint i = 0; i < 8; i++)
+        out.push_back(value>>(i<<3));
+}
+
+static void putBytes(std::vector<cxbyte>& out, size_t size, const cxbyte* data)
+{
+    putU64(out, size);
+    out.insert(out.end(), data, data+size);
+}
+
+static void putString(std::vector<cxbyte>& out, const CString& str)
+{ putBytes(out, str.size(), reinterpret_cast<const cxbyte*>(str.c_str())); }
+
+namespace
+{
+
+// reader of serialized data, throws exception if data is truncated
+struct CLRX_INTERNAL CacheDataReader
+{
+    const cxbyte* data;
+    size_t size;
+    size_t pos;
+    
+    CacheDataReader(size_t _size, const cxbyte* _data) : data(_data), size(_size), pos(0)
+    { }
+    
+    const cxbyte* getBytes(size_t n)
+    {
+        if (n > size-pos)
+            throw Exception("Include cache data is truncated");
+        const cxbyte* out = data+pos;
+        pos += n;
+        return out;
+    }
+    cxbyte getU8()
+    { return *getBytes(1); }
+    // values in cache data are not aligned
+    uint32_t getU32()
+    {
+        uint32_t value;
+        ::memcpy(&value, getBytes(4), 4);
+        return ULEV(value);
+    }
+    uint64_t getU64()
+    {
+        uint64_t value;
+        ::memcpy(&value, getBytes(8), 8);
+        return ULEV(value);
+    }
+    size_t getSize()
+    {
+        const uint64_t value = getU64();
+        if (value > size-pos)
+            throw Exception("Include cache data is truncated");
+        return value;
+    }
+    CString getString()
+    {
+        const size_t n = getSize();
+        const char* str = reinterpret_cast<const char*>(getBytes(n));
+        return CString(str, str+n);
+    }
+};
+
+}
+
+/*
+ * AsmIncludeCache
+ */
+
+static const char includeCacheMagic[8] = { 'C', 'L', 'R', 'X', 'I', 'N', 'C', 'C' };
+static const uint32_t includeCacheVersion = 1;
+
+AsmIncludeCache::AsmIncludeCache()
+{ }
+
+bool AsmIncludeCache::get(const CString& filename, uint64_t timestamp, uint64_t paramsKey,
+            Array<cxbyte>& data)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(filename);
+    if (it == entries.end() || it->second.timestamp != timestamp ||
+        it->second.paramsKey != paramsKey)
+        return false;
+    data = it->second.data;
+    return true;
+}
+
+void AsmIncludeCache::put(const CString& filename, uint64_t timestamp,
+            uint64_t paramsKey, Array<cxbyte>&& data)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = entries[filename];
+    entry.timestamp = timestamp;
+    entry.paramsKey = paramsKey;
+    entry.data = std::move(data);
+}
+
+size_t AsmIncludeCache::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+void AsmIncludeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
+
+void AsmIncludeCache::loadFromFile(const char* filename)
+{
+    const Array<cxbyte> content = loadDataFromFile(filename);
+    std::unordered_map<CString, Entry> newEntries;
+    try
+    {
+        CacheDataReader reader(content.size(), content.data());
+        if (::memcmp(reader.getBytes(8), includeCacheMagic, 8) != 0)
+            throw Exception("Wrong include cache magic");
+        if (reader.getU32() != includeCacheVersion)
+            throw Exception("Unsupported include cache version");
+        const uint32_t entriesNum = reader.getU32();
+        for (uint32_t i = 0; i < entriesNum; i++)
+        {
+            const CString name = reader.getString();
+            Entry& entry = newEntries[name];
+            entry.timestamp = reader.getU64();
+            entry.paramsKey = reader.getU64();
+            const size_t dataSize = reader.getSize();
+            const cxbyte* data = reader.getBytes(dataSize);
+            entry.data.assign(data, data+dataSize);
+        }
+    }
+    catch(const Exception& ex)
+    { throw Exception(std::string("Can't load include cache '")+filename+"': "+
+                ex.what()); }
+    std::lock_guard<std::mutex> lock(mutex);
+    entries = std::move(newEntries);
+}
+
+void AsmIncludeCache::saveToFile(const char* filename)
+{
+    std::vector<cxbyte> out(includeCacheMagic, includeCacheMagic+8);
+    putU32(out, includeCacheVersion);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        putU32(out, entries.size());
+        for (const auto& entry: entries)
+        {
+            putString(out, entry.first);
+            putU64(out, entry.second.timestamp);
+            putU64(out, entry.second.paramsKey);
+            putBytes(out, entry.second.data.size(), entry.second.data.data());
+        }
+    }
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs)
+        throw Exception(std::string("Can't open include cache file '")+filename+"'");
+    ofs.exceptions(std::ios::failbit | std::ios::badbit);
+    ofs.write(reinterpret_cast<const char*>(out.data()), out.size());
+}
+
+/*
+ * AsmBinaryCache
+ */
+
+static const char binaryCacheMagic[8] = { 'C', 'L', 'R', 'X', 'B', 'I', 'N', 'C' };
+static const uint32_t binaryCacheVersion = 2;
+
+// key with CLRX version (binaries from other version of assembler are not used)
+static std::string getBinaryCacheFullKey(const std::string& key)
+{ return std::string("CLRX " CLRX_VERSION "\n") + key; }
+
+static std::string getBinaryCacheEntryPath(const std::string& dirPath,
+            const std::string& fullKey)
+{
+    char name[24];
+    ::snprintf(name, 24, "%016llx", (unsigned long long)hashFNV1a64(fullKey.size(),
+                fullKey.c_str()));
+    return joinPaths(dirPath, name);
+}
+
+AsmBinaryCache::AsmBinaryCache(const std::string& _dirPath) : dirPath(_dirPath)
+{ }
+
+std::string AsmBinaryCache::getDefaultDir()
+{
+    const std::string path = getHomeDir();
+    if (path.empty())
+        return "";
+    return joinPaths(joinPaths(path, ".clrx"), "bincache");
+}
+
+bool AsmBinaryCache::get(const std::string& key, Array<cxbyte>& binary,
+            std::string& log) const
+{
+    const std::string fullKey = getBinaryCacheFullKey(key);
+    const std::string entryPath = getBinaryCacheEntryPath(dirPath, fullKey);
+    if (!isFileExists(entryPath.c_str()))
+        return false;
+    try
+    {
+        const Array<cxbyte> content = loadDataFromFile(entryPath.c_str());
+        CacheDataReader reader(content.size(), content.data());
+        if (::memcmp(reader.getBytes(8), binaryCacheMagic, 8) != 0 ||
+            reader.getU32() != binaryCacheVersion)
+            return false;
+        // compare whole key (hash in filename can collide)
+        const size_t keySize = reader.getSize();
+        if (keySize != fullKey.size() || ::memcmp(reader.getBytes(keySize),
+                    fullKey.c_str(), keySize) != 0)
+            return false;
+        const uint32_t depsNum = reader.getU32();
+        for (uint32_t i = 0; i < depsNum; i++)
+        {
+            // check whether dependency has not been changed
+            const CString depPath = reader.getString();
+            const uint64_t depSize = reader.getU64();
+            const uint64_t depHash = reader.getU64();
+            const Array<cxbyte> depContent = loadDataFromFile(depPath.c_str());
+            if (depContent.size() != depSize ||
+                hashFNV1a64(depContent.size(), depContent.data()) != depHash)
+                return false;
+        }
+        const uint32_t missingNum = reader.getU32();
+        for (uint32_t i = 0; i < missingNum; i++)
+            // new file can shadow file from later include path
+            if (isFileExists(reader.getString().c_str()))
+                return false;
+        const size_t logSize = reader.getSize();
+        const char* logData = reinterpret_cast<const char*>(reader.getBytes(logSize));
+        const size_t binarySize = reader.getSize();
+        const cxbyte* binaryData = reader.getBytes(binarySize);
+        binary.assign(binaryData, binaryData + binarySize);
+        log.assign(logData, logSize);
+        return true;
+    }
+    catch(const Exception&)
+    { return false; } // broken entry or dependency not found
+}
+
+void AsmBinaryCache::put(const std::string& key, const std::vector<CString>& dependencies,
+            const std::vector<CString>& missingFiles, const Array<cxbyte>& binary,
+            const std::string& log)
+{
+    const std::string fullKey = getBinaryCacheFullKey(key);
+    std::vector<cxbyte> out(binaryCacheMagic, binaryCacheMagic+8);
+    putU32(out, binaryCacheVersion);
+    putBytes(out, fullKey.size(), reinterpret_cast<const cxbyte*>(fullKey.c_str()));
+    // paths are absolute, because entry can be used in other current directory
+    putU32(out, dependencies.size());
+    for (const CString& depPath: dependencies)
+    {
+        const Array<cxbyte> depContent = loadDataFromFile(depPath.c_str());
+        putString(out, getAbsolutePath(depPath.c_str()).c_str());
+        putU64(out, depContent.size());
+        putU64(out, hashFNV1a64(depContent.size(), depContent.data()));
+    }
+    putU32(out, missingFiles.size());
+    for (const CString& missingPath: missingFiles)
+        putString(out, getAbsolutePath(missingPath.c_str()).c_str());
+    putBytes(out, log.size(), reinterpret_cast<const cxbyte*>(log.c_str()));
+    putBytes(out, binary.size(), binary.data());
+    
+    // create cache directory (with parent) at first write
+    if (!isFileExists(dirPath.c_str()))
+    {
+        const size_t sepPos = dirPath.find_last_of(CLRX_NATIVE_DIR_SEP);
+        if (sepPos != std::string::npos && sepPos != 0)
+        {
+            try
+            { makeDir(dirPath.substr(0, sepPos).c_str()); }
+            catch(const Exception&)
+            { } // parent directory already exists
+        }
+        try
+        { makeDir(dirPath.c_str()); }
+        catch(const Exception&)
+        { } // if not created, then opening entry file fails
+    }
+    
+    // write to temporary file and rename it to entry (reader never sees partial entry)
+    const std::string entryPath = getBinaryCacheEntryPath(dirPath, fullKey);
+    char tmpSuffix[40];
+    ::snprintf(tmpSuffix, 40, ".tmp%016llx", (unsigned long long)(
+            std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+            std::chrono::steady_clock::now().time_since_epoch().count()));
+    const std::string tmpPath = entryPath + tmpSuffix;
+    {
+        std::ofstream ofs(tmpPath.c_str(), std::ios::binary);
+        if (!ofs)
+            throw Exception(std::string("Can't open binary cache file '")+tmpPath+"'");
+        ofs.write(reinterpret_cast<const char*>(out.data()), out.size());
+        ofs.close();
+        if (!ofs)
+        {
+            ::remove(tmpPath.c_str());
+            throw Exception(std::string("Can't write binary cache file '")+tmpPath+"'");
+        }
+    }
+    if (::rename(tmpPath.c_str(), entryPath.c_str()) != 0)
+    {
+        // on Windows rename does not replace existing file
+        ::remove(entryPath.c_str());
+        if (::rename(tmpPath.c_str(), entryPath.c_str()) != 0)
+        {
+            ::remove(tmpPath.c_str());
+            throw Exception(std::string("Can't rename binary cache file '")+
+                        tmpPath+"'");
+        }
+    }
+}
+
+/*
+ * Assembler routines to precompile and load included files
+ */
+
+// parameters that have impact on parsing of included file
+uint64_t Assembler::getIncludeParamsKey() const
+{
+    return uint64_t(flags) | (uint64_t(alternateMacro)<<32) | (uint64_t(macroCase)<<33) |
+            (uint64_t(buggyFPLit)<<34) | (uint64_t(oldModParam)<<35) |
+            (uint64_t(deviceType)<<40);
+}
+
+void Assembler::recordIncludeSymbol(const CString& symName)
+{
+    if (!includeRecording || currentInputFilter != includeRecording->filter)
+        return;
+    if (symName == "." || ::strchr(symName.c_str(), ':') != nullptr)
+        includeRecording->valid = false; // only global symbols
+    else if (includeRecording->symbolSet.insert(symName).second)
+        includeRecording->symbols.push_back(symName);
+}
+
+void Assembler::recordIncludeMacro(const CString& macroName)
+{
+    if (includeRecording && currentInputFilter == includeRecording->filter)
+        includeRecording->macros.push_back(macroName);
+}
+
+void Assembler::recordIncludeRegVar(const CString& rvName)
+{
+    if (!includeRecording || currentInputFilter != includeRecording->filter)
+        return;
+    if (::strchr(rvName.c_str(), ':') != nullptr)
+        includeRecording->valid = false; // only global reg-vars
+    else
+        includeRecording->regVars.push_back(rvName);
+}
+
+/* serialize definitions of included file and put them to include cache.
+ * called when included file has been fully read */
+void Assembler::finishIncludeRecording()
+{
+    std::unique_ptr<AsmIncludeRecording> recording(std::move(includeRecording));
+    if (!recording->valid || clauses.size() != recording->clausesNum ||
+        currentScope != &globalScope)
+        return;
+    const RefPtr<const AsmSource> source = recording->filter->getSource();
+    std::vector<cxbyte> out;
+    // symbols
+    putU32(out, recording->symbols.size());
+    for (const CString& symName: recording->symbols)
+    {
+        auto it = globalScope.symbolMap.find(symName);
+        if (it == globalScope.symbolMap.end())
+            return;
+        const AsmSymbol& symbol = it->second;
+        if (!symbol.hasValue || symbol.sectionId != ASMSECT_ABS || symbol.regRange ||
+            symbol.base || symbol.snapshot || symbol.expression != nullptr)
+            return; // not constant, do not cache
+        putString(out, symName);
+        putU64(out, symbol.value);
+        putU8(out, symbol.onceDefined);
+    }
+    // reg-vars
+    putU32(out, recording->regVars.size());
+    for (const CString& rvName: recording->regVars)
+    {
+        auto it = globalScope.regVarMap.find(rvName);
+        if (it == globalScope.regVarMap.end())
+            return;
+        putString(out, rvName);
+        putU32(out, it->second.type);
+        putU32(out, it->second.size);
+    }
+    // macros
+    putU32(out, recording->macros.size());
+    for (const CString& macroName: recording->macros)
+    {
+        auto it = macroMap.find(macroName);
+        if (it == macroMap.end())
+            return;
+        const RefPtr<const AsmMacro>& macro = it->second;
+        const AsmSourcePos& pos = macro->getSourcePos();
+        if (pos.macro || pos.source != source)
+            return;
+        // all content must come from included file
+        for (size_t i = 0; i < macro->getSourceTransSize(); i++)
+            if (macro->getSourceTrans(i).source != source)
+                return;
+        putString(out, macroName);
+        putU64(out, pos.lineNo);
+        putU64(out, pos.colNo);
+        putU32(out, macro->getArgsNum());
+        for (size_t i = 0; i < macro->getArgsNum(); i++)
+        {
+            const AsmMacroArg& arg = macro->getArg(i);
+            putString(out, arg.name);
+            putString(out, arg.defaultValue);
+            putU8(out, cxbyte(arg.vararg) | (cxbyte(arg.required)<<1));
+        }
+        const std::vector<char>& content = macro->getContent();
+        putBytes(out, content.size(), reinterpret_cast<const cxbyte*>(content.data()));
+        putU32(out, macro->getSourceTransSize());
+        for (size_t i = 0; i < macro->getSourceTransSize(); i++)
+            putU64(out, macro->getSourceTrans(i).lineNo);
+        const std::vector<LineTrans>& colTrans = macro->getColTranslations();
+        putU64(out, colTrans.size());
+        for (const LineTrans& trans: colTrans)
+        {
+            putU64(out, trans.position);
+            putU64(out, trans.lineNo);
+        }
+    }
+    includeCache->put(recording->filename, recording->timestamp, recording->paramsKey,
+                Array<cxbyte>(out.begin(), out.end()));
+}
+
+namespace
+{
+
+struct CLRX_INTERNAL PrecompiledSymbol
+{
+    CString name;
+    uint64_t value;
+    bool onceDefined;
+};
+
+struct CLRX_INTERNAL PrecompiledMacro
+{
+    CString name;
+    LineNo lineNo;
+    ColNo colNo;
+    std::vector<AsmMacroArg> args;
+    std::vector<char> content;
+    std::vector<LineNo> sourceTransLines;
+    std::vector<LineTrans> colTrans;
+};
+
+}
+
+/* load definitions of included file from precompiled data.
+ * returns false if data can not be used (file must be parsed normally) */
+bool Assembler::loadPrecompiledInclude(const char* pseudoOpPlace, const CString& filename,
+            const Array<cxbyte>& data)
+{
+    std::vector<PrecompiledSymbol> symbols;
+    std::vector<std::pair<CString, AsmRegVar> > regVars;
+    std::vector<PrecompiledMacro> macros;
+    try
+    {
+        CacheDataReader reader(data.size(), data.data());
+        symbols.resize(reader.getU32());
+        for (PrecompiledSymbol& symbol: symbols)
+        {
+            symbol.name = reader.getString();
+            symbol.value = reader.getU64();
+            symbol.onceDefined = reader.getU8()!=0;
+        }
+        regVars.resize(reader.getU32());
+        for (auto& regVar: regVars)
+        {
+            regVar.first = reader.getString();
+            regVar.second.type = reader.getU32();
+            regVar.second.size = reader.getU32();
+        }
+        macros.resize(reader.getU32());
+        for (PrecompiledMacro& macro: macros)
+        {
+            macro.name = reader.getString();
+            macro.lineNo = reader.getU64();
+            macro.colNo = reader.getU64();
+            macro.args.resize(reader.getU32());
+            for (AsmMacroArg& arg: macro.args)
+            {
+                arg.name = reader.getString();
+                arg.defaultValue = reader.getString();
+                const cxbyte argFlags = reader.getU8();
+                arg.vararg = (argFlags&1)!=0;
+                arg.required = (argFlags&2)!=0;
+            }
+            const size_t contentSize = reader.getSize();
+            const char* content = reinterpret_cast<const char*>(
+                        reader.getBytes(contentSize));
+            macro.content.assign(content, content+contentSize);
+            macro.sourceTransLines.resize(reader.getU32());
+            for (LineNo& lineNo: macro.sourceTransLines)
+                lineNo = reader.getU64();
+            macro.colTrans.resize(reader.getSize());
+            for (LineTrans& trans: macro.colTrans)
+            {
+                trans.position = reader.getU64();
+                trans.lineNo = reader.getU64();
+            }
+        }
+        if (reader.pos != reader.size)
+            return false;
+    }
+    catch(const Exception&)
+    { return false; }
+    
+    // if any definition already exists, then included file must be parsed normally
+    for (const PrecompiledSymbol& symbol: symbols)
+        if (globalScope.symbolMap.find(symbol.name) != globalScope.symbolMap.end())
+            return false;
+    for (const auto& regVar: regVars)
+        if (globalScope.regVarMap.find(regVar.first) != globalScope.regVarMap.end())
+            return false;
+    for (const PrecompiledMacro& macro: macros)
+        if (macroMap.find(macro.name) != macroMap.end())
+            return false;
+    
+    // source of included file (likewise as in AsmStreamInputFilter)
+    const AsmSourcePos pos = getSourcePos(pseudoOpPlace);
+    RefPtr<const AsmSource> source;
+    if (!pos.macro)
+        source = RefPtr<const AsmSource>(new AsmFile(pos.source, pos.lineNo,
+                         pos.colNo, filename));
+    else // if inside macro
+        source = RefPtr<const AsmSource>(new AsmFile(
+            RefPtr<const AsmSource>(new(AsmArenaObject::getArena(pos.macro.get()))
+                    AsmMacroSource(pos.macro, pos.source)),
+                 pos.lineNo, pos.colNo, filename));
+    
+    for (const PrecompiledSymbol& symbol: symbols)
+        globalScope.symbolMap.insert(std::make_pair(symbol.name,
+                    AsmSymbol(ASMSECT_ABS, symbol.value, symbol.onceDefined)));
+    if (!regVars.empty())
+    {
+        initializeOutputFormat();
+        for (const auto& regVar: regVars)
+            globalScope.regVarMap.insert(regVar);
+    }
+    for (PrecompiledMacro& macro: macros)
+    {
+        std::vector<AsmMacro::SourceTrans> sourceTrans;
+        for (LineNo lineNo: macro.sourceTransLines)
+            sourceTrans.push_back({ lineNo, source });
+        const AsmSourcePos macroPos = { RefPtr<const AsmMacroSubst>(), source,
+                    macro.lineNo, macro.colNo, nullptr };
+        RefPtr<const AsmMacro> asmMacro(new AsmMacro(macroPos,
+                    Array<AsmMacroArg>(macro.args.begin(), macro.args.end()),
+                    std::move(macro.content), std::move(sourceTrans),
+                    std::move(macro.colTrans)));
+        macroMap.insert(std::make_pair(macro.name, std::move(asmMacro)));
+    }
+    return true;
+}
@@ -26,6 +26,7 @@
 #include <unordered_set>
 #include <utility>
 #include <memory>
+#include <vector>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdasm/Assembler.h>
 #include "GCNInternals.h"
@@ -316,6 +317,21 @@ struct CLRX_INTERNAL AsmPseudoOps: AsmParseUtils
     static bool checkPseudoOpName(const CString& string);
 };
 
+// state of recording of included file (for include cache)
+struct CLRX_INTERNAL AsmIncludeRecording
+{
+    AsmInputFilter* filter; // input filter of included file
+    CString filename;
+    uint64_t timestamp;
+    uint64_t paramsKey;
+    size_t clausesNum; // number of clauses before inclusion
+    bool valid; // if false then included file can not be cached
+    std::vector<CString> symbols; // in order of definition
+    std::unordered_set<CString> symbolSet;
+    std::vector<CString> macros;
+    std::vector<CString> regVars;
+};
+
 // macro helper to handle printing error
 
 #define PSEUDOOP_RETURN_BY_ERROR(STRING) \
@@ -448,7 +448,10 @@ void AsmPseudoOps::includeFile(Assembler& asmr, const char* pseudoOpPlace,
             return;
         }
         catch(const Exception& ex)
-        { failedOpen = true; }
+        {
+            failedOpen = true;
+            asmr.missingDependencies.push_back(sysfilename);
+        }
         
         // find in include paths
         for (const CString& incDir: asmr.includeDirs)
@@ -457,14 +460,18 @@ void AsmPseudoOps::includeFile(Assembler& asmr, const char* pseudoOpPlace,
             std::string incDirPath(incDir.c_str());
             // convert path to system path (with system dir separators)
             filesystemPath(incDirPath);
+            const std::string incFilename = joinPaths(
+                            std::string(incDirPath.c_str()), sysfilename);
             try
             {
-                asmr.includeFile(pseudoOpPlace, joinPaths(
-                            std::string(incDirPath.c_str()), sysfilename));
+                asmr.includeFile(pseudoOpPlace, incFilename);
                 break;
             }
             catch(const Exception& ex)
-            { failedOpen = true; }
+            {
+                failedOpen = true;
+                asmr.missingDependencies.push_back(incFilename);
+            }
         }
         // if not found
         if (failedOpen)
@@ -534,22 +541,27 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
     sysfilename = filename;
     filesystemPath(sysfilename);
     // try in this directory
+    std::string openedFilename = sysfilename;
     ifs.open(sysfilename.c_str(), std::ios::binary);
     if (!ifs)
     {
+        asmr.missingDependencies.push_back(sysfilename);
         // find in include paths
         for (const CString& incDir: asmr.includeDirs)
         {
             std::string incDirPath(incDir.c_str());
             filesystemPath(incDirPath);
-            ifs.open(joinPaths(incDirPath.c_str(), sysfilename).c_str(), std::ios::binary);
+            openedFilename = joinPaths(incDirPath.c_str(), sysfilename);
+            ifs.open(openedFilename.c_str(), std::ios::binary);
             if (ifs)
                 break;
+            asmr.missingDependencies.push_back(openedFilename);
         }
     }
     if (!ifs)
         ASM_RETURN_BY_ERROR(namePlace, (std::string("Binary file '") + filename +
                     "' not found or unavailable in any directory").c_str())
+    asmr.dependencies.push_back(openedFilename);
     // exception for checking file seeking
     bool seekingIsWorking = true;
     ifs.exceptions(std::ios::badbit | std::ios::failbit); // exceptions
@@ -902,8 +914,8 @@ void AsmPseudoOps::setSymbol(Assembler& asmr, const char* linePtr, bool reassign
         ASM_NOTGOOD_BY_ERROR(linePtr, "Expected symbol")
     if (!skipRequiredComma(asmr, linePtr))
         return;
-    if (good) // is good
-        asmr.assignSymbol(symName, strAtSymName, linePtr, reassign, baseExpr);
+    if (good && asmr.assignSymbol(symName, strAtSymName, linePtr, reassign, baseExpr))
+        asmr.recordIncludeSymbol(symName);
 }
 
 void AsmPseudoOps::setSymbolBind(Assembler& asmr, const char* linePtr, cxbyte bind)
@@ -1777,6 +1789,7 @@ void AsmPseudoOps::doMacro(Assembler& asmr, const char* pseudoOpPlace, const cha
         asmr.pushClause(pseudoOpPlace, AsmClauseType::MACRO);
         if (!asmr.putMacroContent(macro.constCast<AsmMacro>()))
             return;
+        asmr.recordIncludeMacro(macroName);
         asmr.macroMap.insert(std::make_pair(std::move(macroName), std::move(macro)));
     }
 }
@@ -2111,6 +2124,8 @@ void AsmPseudoOps::defRegVar(Assembler& asmr, const char* pseudoOpPlace,
         if (!asmr.addRegVar(name, var))
             asmr.printError(regNamePlace, (std::string("Reg-var '")+name.c_str()+
                         "' was already defined").c_str());
+        else
+            asmr.recordIncludeRegVar(name);
         
     } while(skipCommaForMultipleArgs(asmr, linePtr));
     
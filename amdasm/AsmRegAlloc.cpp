@@ -250,7 +250,9 @@ AsmRegVarUsage ISAUsageHandler::nextUsage()
 }
 
 AsmRegAllocator::AsmRegAllocator(Assembler& _assembler) : assembler(_assembler)
-{ }
+{
+    std::fill(graphColorsNums, graphColorsNums + MAX_REGTYPES_NUM, cxuint(0));
+}
 
 static inline bool codeBlockStartLess(const AsmRegAllocator::CodeBlock& c1,
                   const AsmRegAllocator::CodeBlock& c2)
@@ -1425,6 +1427,83 @@ static void addUsageDeps(const cxbyte* ldeps, const cxbyte* edeps, cxuint rvusNu
     }
 }
 
+void AsmInterferenceGraph::resize(size_t newNodesNum)
+{
+    nodesNum = newNodesNum;
+    frozen = false;
+    const size_t tilesNum = (nodesNum+tileNodesNum-1)>>tileNodesShift;
+    bitTiles.clear();
+    bitTiles.resize((tilesNum*(tilesNum+1))>>1);
+    adjStarts.resize(nodesNum+1);
+    std::fill(adjStarts.begin(), adjStarts.end(), size_t(0));
+    adjNodes.clear();
+}
+
+bool AsmInterferenceGraph::hasEdge(size_t a, size_t b) const
+{
+    if (a == b)
+        return false;
+    if (!frozen)
+    {
+        if (a < b)
+            std::swap(a, b);
+        uint64_t bit;
+        const uint64_t* word = getTileWord(a, b, bit);
+        return word != nullptr && (*word & bit) != 0;
+    }
+    const Neighbors nbs = (*this)[a];
+    return std::binary_search(nbs.begin(), nbs.end(), b);
+}
+
+void AsmInterferenceGraph::freeze()
+{
+    if (frozen)
+        return;
+    // convert degrees to offsets
+    size_t offset = 0;
+    for (size_t i = 0; i < nodesNum; i++)
+    {
+        const size_t degree = adjStarts[i];
+        adjStarts[i] = offset;
+        offset += degree;
+    }
+    adjStarts[nodesNum] = offset;
+    adjNodes.resize(offset);
+    Array<size_t> fillPos(adjStarts.begin(), adjStarts.end()-1);
+    /* tile rows and tiles in row in order, rows of tile in order,
+     * hence neighbors of every node are sorted */
+    const size_t tilesNum = (nodesNum+tileNodesNum-1)>>tileNodesShift;
+    for (size_t ta = 0; ta < tilesNum; ta++)
+        for (size_t tb = 0; tb <= ta; tb++)
+        {
+            std::unique_ptr<uint64_t[]>& tile = bitTiles[tileIndex(ta, tb)];
+            if (tile == nullptr)
+                continue;
+            const size_t aStart = ta<<tileNodesShift;
+            const size_t bStart = tb<<tileNodesShift;
+            const size_t rowsNum = std::min(size_t(tileNodesNum), nodesNum-aStart);
+            for (size_t la = 0; la < rowsNum; la++)
+            {
+                const size_t a = aStart + la;
+                const uint64_t* row = tile.get() + (la<<(tileNodesShift-6));
+                for (size_t w = 0; w < (tileNodesNum>>6); w++)
+                {
+                    uint64_t word = row[w];
+                    while (word != 0)
+                    {
+                        const size_t b = bStart + (w<<6) + (63 - CLZ64(word & -word));
+                        adjNodes[fillPos[a]++] = b;
+                        adjNodes[fillPos[b]++] = a;
+                        word &= word-1;
+                    }
+                }
+            }
+            tile.reset(); // free memory
+        }
+    std::vector<std::unique_ptr<uint64_t[]> >().swap(bitTiles);
+    frozen = true;
+}
+
 typedef std::unordered_map<size_t, EqualToDep>::const_iterator EqualToDepMapCIter;
 
 struct EqualStackEntry
@@ -1690,14 +1769,13 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
             auto liStart = liveBlockMap.lower_bound({ rangeStart, 0, 0 });
             auto liEnd = liveBlockMap.lower_bound({ rangeEnd, 0, 0 });
             // collect from this range, variable indices
-            std::set<size_t> varIndices;
+            std::vector<size_t> varIndices;
             for (auto lit2 = liStart; lit2 != liEnd; ++lit2)
-                varIndices.insert(lit2->vidx);
+                varIndices.push_back(lit2->vidx);
             // push to intergraph as full subgGraph
-            for (auto vit = varIndices.begin(); vit != varIndices.end(); ++vit)
-                for (auto vit2 = varIndices.begin(); vit2 != varIndices.end(); ++vit2)
-                    if (vit != vit2)
-                        interGraph[*vit].insert(*vit2);
+            for (size_t vi = 0; vi < varIndices.size(); vi++)
+                for (size_t vi2 = 0; vi2 < vi; vi2++)
+                    interGraph.addEdge(varIndices[vi], varIndices[vi2]);
             // go to next live blocks
             rangeStart = rangeEnd;
             for (; lit != liveBlockMap.end(); ++lit)
@@ -1707,6 +1785,7 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
                 break; // 
             rangeStart = std::max(rangeStart, lit->start);
         }
+        interGraph.freeze();
     }
     
     /*
@@ -1794,14 +1873,288 @@ struct CLRX_INTERNAL SDOLDOCompare
         : interGraph(_interGraph), sdoCounts(_sdoCounts)
     { }
     
+    // order: greatest saturation, greatest degree, smallest node index
     bool operator()(size_t a, size_t b) const
     {
-        if (sdoCounts[a] > sdoCounts[b])
-            return true;
-        return interGraph[a].size() > interGraph[b].size();
+        if (sdoCounts[a] != sdoCounts[b])
+            return sdoCounts[a] > sdoCounts[b];
+        if (interGraph[a].size() != interGraph[b].size())
+            return interGraph[a].size() > interGraph[b].size();
+        return a < b;
     }
 };
 
+/* DSatur coloring (bucket engine):
+ * choose uncolored node with greatest saturation (number of distinct colors of
+ * neighbors), then with greatest degree, then with smallest index.
+ * nodes from equal set get same color: smallest color that is not used by
+ * neighbors of any node from this set.
+ */
+
+static const std::vector<size_t>& getEqualNodes(size_t node,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            std::vector<size_t>& singleNode)
+{
+    auto equalSetMapIt = equalSetMap.find(node);
+    if (equalSetMapIt != equalSetMap.end())
+        // found, get equal set from equalSetList
+        return equalSetList[equalSetMapIt->second];
+    singleNode.assign(1, node); // only one node, if equalSet not found
+    return singleNode;
+}
+
+// reference engine: ordered set of nodes, neighbors are rescanned for every update
+static cxuint colorGraphBySet(const InterGraph& interGraph,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            size_t maxColorsNum, cxuint colorsNum, Array<cxuint>& gcMap)
+{
+    const size_t nodesNum = interGraph.size();
+    Array<size_t> sdoCounts(nodesNum);
+    std::fill(sdoCounts.begin(), sdoCounts.end(), 0);
+    // initial saturation from already colored nodes (real registers)
+    for (size_t node = 0; node < nodesNum; node++)
+        if (gcMap[node] == UINT_MAX)
+        {
+            std::unordered_set<cxuint> nbColors;
+            for (size_t nb: interGraph[node])
+                if (gcMap[nb] != UINT_MAX)
+                    nbColors.insert(gcMap[nb]);
+            sdoCounts[node] = nbColors.size();
+        }
+    
+    SDOLDOCompare compare(interGraph, sdoCounts);
+    std::set<size_t, SDOLDOCompare> nodeSet(compare);
+    for (size_t i = 0; i < nodesNum; i++)
+        if (gcMap[i] == UINT_MAX)
+            nodeSet.insert(i);
+    
+    while (!nodeSet.empty())
+    {
+        size_t node = *nodeSet.begin();
+        size_t color = 0;
+        std::vector<size_t> equalNodes;
+        equalNodes.push_back(node); // only one node, if equalSet not found
+        auto equalSetMapIt = equalSetMap.find(node);
+        if (equalSetMapIt != equalSetMap.end())
+            // found, get equal set from equalSetList
+            equalNodes = equalSetList[equalSetMapIt->second];
+        for (size_t nextNode: equalNodes)
+            if (gcMap[nextNode] == UINT_MAX)
+                nodeSet.erase(nextNode);
+        
+        for (color = 0; color <= colorsNum; color++)
+        {
+            // find first usable color (for all nodes from equal set)
+            bool thisSame = false;
+            for (size_t nextNode: equalNodes)
+            {
+                for (size_t nb: interGraph[nextNode])
+                    if (gcMap[nb] == color)
+                    {
+                        thisSame = true;
+                        break;
+                    }
+                if (thisSame)
+                    break;
+            }
+            if (!thisSame)
+                break;
+        }
+        if (color==colorsNum) // add new color if needed
+        {
+            if (colorsNum >= maxColorsNum)
+                throw AsmException("Too many register is needed");
+            colorsNum++;
+        }
+        
+        // update SDO for neighbors (before coloring node)
+        for (size_t node: equalNodes)
+        {
+            if (gcMap[node] != UINT_MAX)
+                continue;
+            for (size_t nb: interGraph[node])
+            {
+                bool colorExists = false;
+                for (size_t nb2: interGraph[nb])
+                    if (gcMap[nb2] == color)
+                    {
+                        colorExists = true;
+                        break;
+                    }
+                if (!colorExists && gcMap[nb] == UINT_MAX)
+                {
+                    nodeSet.erase(nb);  // before update we erase from nodeSet
+                    sdoCounts[nb]++;
+                    nodeSet.insert(nb); // after update, insert again
+                }
+            }
+            gcMap[node] = color;
+        }
+    }
+    return colorsNum;
+}
+
+// engine with bucket queue (by saturation) and bitsets of neighbor's colors
+static cxuint colorGraphByBuckets(const InterGraph& interGraph,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            size_t maxColorsNum, cxuint colorsNum, Array<cxuint>& gcMap)
+{
+    const size_t nodesNum = interGraph.size();
+    /* node (or equal set) with D neighbors gets color not greater than D,
+     * hence bitsets need only colors to greatest D (and already used colors) */
+    size_t maxNbsNum = 0;
+    for (size_t node = 0; node < nodesNum; node++)
+        maxNbsNum = std::max(maxNbsNum, interGraph.getDegree(node));
+    for (const std::vector<size_t>& equalSet: equalSetList)
+    {
+        size_t nbsNum = 0;
+        for (size_t node: equalSet)
+            nbsNum += interGraph.getDegree(node);
+        maxNbsNum = std::max(maxNbsNum, nbsNum);
+    }
+    const size_t colorsBound = std::max(size_t(colorsNum),
+                std::min(maxColorsNum, maxNbsNum+1));
+    // colors of neighbors for every node (bitset)
+    const size_t colorWordsNum = (colorsBound + 64)>>6;
+    Array<uint64_t> nbColors(nodesNum*colorWordsNum);
+    std::fill(nbColors.begin(), nbColors.end(), uint64_t(0));
+    Array<size_t> sdoCounts(nodesNum);
+    std::fill(sdoCounts.begin(), sdoCounts.end(), 0);
+    
+    // initial saturation from already colored nodes
+    for (size_t node = 0; node < nodesNum; node++)
+        if (gcMap[node] != UINT_MAX)
+        {
+            const cxuint color = gcMap[node];
+            for (size_t nb: interGraph[node])
+            {
+                uint64_t& word = nbColors[nb*colorWordsNum + (color>>6)];
+                if ((word & (1ULL<<(color&63))) == 0)
+                {
+                    word |= 1ULL<<(color&63);
+                    sdoCounts[nb]++;
+                }
+            }
+        }
+    
+    // rank of node: order by greatest degree and smallest index
+    Array<size_t> rankNodes(nodesNum);
+    for (size_t i = 0; i < nodesNum; i++)
+        rankNodes[i] = i;
+    std::stable_sort(rankNodes.begin(), rankNodes.end(), [&interGraph](size_t a, size_t b)
+            { return interGraph.getDegree(a) > interGraph.getDegree(b); });
+    Array<size_t> nodeRanks(nodesNum);
+    for (size_t i = 0; i < nodesNum; i++)
+        nodeRanks[rankNodes[i]] = i;
+    
+    /* buckets by saturation, every bucket is min-heap of ranks.
+     * entries are removed lazily (if node colored or saturation changed) */
+    std::vector<std::vector<size_t> > buckets(colorWordsNum*64 + 1);
+    size_t maxSdo = 0;
+    for (size_t rank = 0; rank < nodesNum; rank++)
+    {
+        const size_t node = rankNodes[rank];
+        if (gcMap[node] == UINT_MAX)
+        {
+            // ranks are in increasing order, hence bucket is already a heap
+            buckets[sdoCounts[node]].push_back(rank);
+            maxSdo = std::max(maxSdo, sdoCounts[node]);
+        }
+    }
+    
+    std::vector<size_t> singleNode;
+    Array<uint64_t> usedColors(colorWordsNum);
+    while (true)
+    {
+        // find node with greatest saturation
+        size_t node = SIZE_MAX;
+        while (true)
+        {
+            std::vector<size_t>& bucket = buckets[maxSdo];
+            if (bucket.empty())
+            {
+                if (maxSdo == 0)
+                    break;
+                maxSdo--;
+                continue;
+            }
+            std::pop_heap(bucket.begin(), bucket.end(), std::greater<size_t>());
+            const size_t candidate = rankNodes[bucket.back()];
+            bucket.pop_back();
+            if (gcMap[candidate] == UINT_MAX && sdoCounts[candidate] == maxSdo)
+            {
+                node = candidate;
+                break;
+            }
+        }
+        if (node == SIZE_MAX)
+            break; // all nodes colored
+        
+        const std::vector<size_t>& equalNodes = getEqualNodes(node, equalSetMap,
+                    equalSetList, singleNode);
+        // find first usable color
+        std::fill(usedColors.begin(), usedColors.end(), uint64_t(0));
+        for (size_t nextNode: equalNodes)
+        {
+            const uint64_t* nodeColors = nbColors.data() + nextNode*colorWordsNum;
+            for (size_t k = 0; k < colorWordsNum; k++)
+                usedColors[k] |= nodeColors[k];
+        }
+        cxuint color = 0;
+        for (size_t k = 0; k < colorWordsNum; k++)
+            if (usedColors[k] != UINT64_MAX)
+            {
+                const uint64_t freeBit = ~usedColors[k] & (usedColors[k]+1);
+                color = (k<<6) + 63 - CLZ64(freeBit);
+                break;
+            }
+        if (color >= colorsNum) // add new color if needed
+        {
+            if (colorsNum >= maxColorsNum)
+                throw AsmException("Too many register is needed");
+            color = colorsNum++;
+        }
+        
+        for (size_t nextNode: equalNodes)
+            if (gcMap[nextNode] == UINT_MAX)
+                gcMap[nextNode] = color;
+        // update SDO for neighbors
+        const size_t colorWord = color>>6;
+        const uint64_t colorBit = 1ULL<<(color&63);
+        for (size_t nextNode: equalNodes)
+            for (size_t nb: interGraph[nextNode])
+            {
+                uint64_t& word = nbColors[nb*colorWordsNum + colorWord];
+                if ((word & colorBit) != 0)
+                    continue;
+                word |= colorBit;
+                if (gcMap[nb] != UINT_MAX)
+                    continue;
+                const size_t sdo = ++sdoCounts[nb];
+                std::vector<size_t>& bucket = buckets[sdo];
+                bucket.push_back(nodeRanks[nb]);
+                std::push_heap(bucket.begin(), bucket.end(), std::greater<size_t>());
+                maxSdo = std::max(maxSdo, sdo);
+            }
+    }
+    return colorsNum;
+}
+
+cxuint AsmRegAllocator::colorGraph(ColoringEngine engine, const InterGraph& interGraph,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            size_t maxColorsNum, cxuint colorsNum, Array<cxuint>& gcMap)
+{
+    if (engine == ColoringEngine::SET)
+        return colorGraphBySet(interGraph, equalSetMap, equalSetList, maxColorsNum,
+                    colorsNum, gcMap);
+    return colorGraphByBuckets(interGraph, equalSetMap, equalSetList, maxColorsNum,
+                    colorsNum, gcMap);
+}
+
 /* algorithm to allocate regranges:
  * from smallest regranges to greatest regranges:
  *   choosing free register: from smallest free regranges
@@ -1822,19 +2175,10 @@ void AsmRegAllocator::colorInterferenceGraph()
         InterGraph& interGraph = interGraphs[regType];
         const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
         Array<cxuint>& gcMap = graphColorMaps[regType];
-        const std::vector<std::vector<size_t> >& equalSetList = equalSetLists[regType];
-        const std::unordered_map<size_t, size_t>& equalSetMap =  equalSetMaps[regType];
         
         const size_t nodesNum = interGraph.size();
         gcMap.resize(nodesNum);
         std::fill(gcMap.begin(), gcMap.end(), cxuint(UINT_MAX));
-        Array<size_t> sdoCounts(nodesNum);
-        std::fill(sdoCounts.begin(), sdoCounts.end(), 0);
-        
-        SDOLDOCompare compare(interGraph, sdoCounts);
-        std::set<size_t, SDOLDOCompare> nodeSet(compare);
-        for (size_t i = 0; i < nodesNum; i++)
-            nodeSet.insert(i);
         
         cxuint colorsNum = 0;
         // firstly, allocate real registers
@@ -1842,78 +2186,11 @@ void AsmRegAllocator::colorInterferenceGraph()
             if (entry.first.regVar == nullptr)
                 gcMap[entry.second[0]] = colorsNum++;
         
-        for (size_t colored = 0; colored < nodesNum; colored++)
-        {
-            size_t node = *nodeSet.begin();
-            if (gcMap[node] != UINT_MAX)
-                continue; // already colored
-            size_t color = 0;
-            std::vector<size_t> equalNodes;
-            equalNodes.push_back(node); // only one node, if equalSet not found
-            auto equalSetMapIt = equalSetMap.find(node);
-            if (equalSetMapIt != equalSetMap.end())
-                // found, get equal set from equalSetList
-                equalNodes = equalSetList[equalSetMapIt->second];
-            
-            for (color = 0; color <= colorsNum; color++)
-            {
-                // find first usable color
-                bool thisSame = false;
-                for (size_t nb: interGraph[node])
-                    if (gcMap[nb] == color)
-                    {
-                        thisSame = true;
-                        break;
-                    }
-                if (!thisSame)
-                    break;
-            }
-            if (color==colorsNum) // add new color if needed
-            {
-                if (colorsNum >= maxColorsNum)
-                    throw AsmException("Too many register is needed");
-                colorsNum++;
-            }
-            
-            for (size_t nextNode: equalNodes)
-                gcMap[nextNode] = color;
-            // update SDO for node
-            bool colorExists = false;
-            for (size_t node: equalNodes)
-            {
-                for (size_t nb: interGraph[node])
-                    if (gcMap[nb] == color)
-                    {
-                        colorExists = true;
-                        break;
-                    }
-                if (!colorExists)
-                    sdoCounts[node]++;
-            }
-            // update SDO for neighbors
-            for (size_t node: equalNodes)
-                for (size_t nb: interGraph[node])
-                {
-                    colorExists = false;
-                    for (size_t nb2: interGraph[nb])
-                        if (gcMap[nb2] == color)
-                        {
-                            colorExists = true;
-                            break;
-                        }
-                    if (!colorExists)
-                    {
-                        if (gcMap[nb] == UINT_MAX)
-                            nodeSet.erase(nb);  // before update we erase from nodeSet
-                        sdoCounts[nb]++;
-                        if (gcMap[nb] == UINT_MAX)
-                            nodeSet.insert(nb); // after update, insert again
-                    }
-                }
-            
-            for (size_t nextNode: equalNodes)
-                gcMap[nextNode] = color;
-        }
+        colorsNum = colorGraph(ColoringEngine::BUCKET, interGraph, equalSetMaps[regType],
+                   equalSetLists[regType], maxColorsNum, colorsNum, gcMap);
+        if (colorsNum > maxColorsNum)
+            throw AsmException("Too many register is needed");
+        graphColorsNums[regType] = colorsNum;
     }
 }
 
@@ -1928,6 +2205,7 @@ void AsmRegAllocator::allocateRegisters(cxuint sectionId)
         linearDepMaps[i].clear();
         equalToDepMaps[i].clear();
         graphColorMaps[i].clear();
+        graphColorsNums[i] = 0;
         equalSetMaps[i].clear();
         equalSetLists[i].clear();
     }
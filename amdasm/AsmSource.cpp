@@ -18,6 +18,7 @@
  */
 
 #include <CLRX/Config.h>
+#include <cstring>
 #include <string>
 #include <fstream>
 #include <vector>
@@ -26,6 +27,14 @@
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdasm/Assembler.h>
 #include "AsmInternals.h"
+#if defined(HAVE_ARCH_INTEL) && (defined(__SSE2__) || defined(HAVE_ARCH_X86_64))
+#  include <emmintrin.h>
+#  define CLRX_SCAN_SSE2 1
+#  if defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 5)
+#    include <immintrin.h>
+#    define CLRX_SCAN_AVX2 1
+#  endif
+#endif
 
 using namespace CLRX;
 
@@ -34,6 +43,50 @@ using namespace CLRX;
  * macro input filters counts incorectly columns (correct solution requires
  * cumbersome code changes) */
 
+// header of object allocated by AsmArenaObject (keeps 16-byte alignment)
+struct CLRX_INTERNAL AsmArenaObjectHeader
+{
+    AsmSharedArena* arena;
+    size_t size;
+};
+
+static const size_t arenaObjectHeaderSize = 16;
+
+void* AsmArenaObject::operator new(size_t size, AsmSharedArena* arena)
+{
+    size += arenaObjectHeaderSize;
+    AsmArenaObjectHeader* header = reinterpret_cast<AsmArenaObjectHeader*>(
+            (arena != nullptr) ? arena->allocate(size) : ::operator new(size));
+    header->arena = arena;
+    header->size = size;
+    if (arena != nullptr)
+        arena->reference();
+    return reinterpret_cast<cxbyte*>(header) + arenaObjectHeaderSize;
+}
+
+void AsmArenaObject::operator delete(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+    AsmArenaObjectHeader* header = reinterpret_cast<AsmArenaObjectHeader*>(
+            reinterpret_cast<cxbyte*>(ptr) - arenaObjectHeaderSize);
+    AsmSharedArena* arena = header->arena;
+    if (arena == nullptr)
+    {
+        ::operator delete(header);
+        return;
+    }
+    arena->release(header, header->size);
+    if (arena->unreference())
+        delete arena;
+}
+
+AsmSharedArena* AsmArenaObject::getArena(const void* ptr)
+{
+    return reinterpret_cast<const AsmArenaObjectHeader*>(
+            reinterpret_cast<const cxbyte*>(ptr) - arenaObjectHeaderSize)->arena;
+}
+
 AsmSource::~AsmSource()
 { }
 
@@ -55,6 +108,15 @@ AsmMacro::AsmMacro(const AsmSourcePos& _pos, Array<AsmMacroArg>&& _args)
         : contentLineNo(0), sourcePos(_pos), args(std::move(_args))
 { }
 
+AsmMacro::AsmMacro(const AsmSourcePos& _pos, Array<AsmMacroArg>&& _args,
+        std::vector<char>&& _content, std::vector<SourceTrans>&& _sourceTrans,
+        std::vector<LineTrans>&& _colTrans)
+        : contentLineNo(std::count(_content.begin(), _content.end(), '\n')),
+          sourcePos(_pos), args(std::move(_args)), content(std::move(_content)),
+          sourceTranslations(std::move(_sourceTrans)),
+          colTranslations(std::move(_colTrans))
+{ }
+
 void AsmMacro::addLine(RefPtr<const AsmMacroSubst> macro, RefPtr<const AsmSource> source,
            const std::vector<LineTrans>& colTrans, size_t lineSize, const char* line)
 {
@@ -86,7 +148,8 @@ void AsmMacro::addLine(RefPtr<const AsmMacroSubst> macro, RefPtr<const AsmSource
         }
         if (doAdd)
             sourceTranslations.push_back({contentLineNo, RefPtr<const AsmSource>(
-                new AsmMacroSource{macro, source})});
+                new(AsmArenaObject::getArena(macro.get()))
+                        AsmMacroSource{macro, source})});
     }
     contentLineNo++;
 }
@@ -151,30 +214,29 @@ LineCol AsmInputFilter::translatePos(size_t position) const
 
 static const size_t AsmParserLineMaxSize = 100;
 
-AsmStreamInputFilter::AsmStreamInputFilter(const CString& filename)
-    : AsmInputFilter(AsmInputFilterType::STREAM), managed(true),
-        stream(nullptr), mode(LineMode::NORMAL), stmtPos(0)
+void AsmStreamInputFilter::openMappedFile(const CString& filename)
 {
     try
+    { mappedFile.open(filename.c_str()); }
+    catch(const Exception&)
     {
-        source = RefPtr<const AsmSource>(new AsmFile(filename));
-        stream = new std::ifstream(filename.c_str(), std::ios::binary);
-        if (!*stream)
-            throw AsmException(std::string("Can't open source file '")+
+        throw AsmException(std::string("Can't open source file '")+
                     filename.c_str()+"'");
-        stream->exceptions(std::ios::badbit);
-        buffer.reserve(AsmParserLineMaxSize);
-    }
-    catch(...)
-    {
-        delete stream;
-        throw;
     }
 }
 
+AsmStreamInputFilter::AsmStreamInputFilter(const CString& filename)
+    : AsmInputFilter(AsmInputFilterType::STREAM), managed(true),
+        stream(nullptr), mode(LineMode::NORMAL), stmtPos(0), mapPos(0)
+{
+    source = RefPtr<const AsmSource>(new AsmFile(filename));
+    openMappedFile(filename);
+    buffer.reserve(AsmParserLineMaxSize);
+}
+
 AsmStreamInputFilter::AsmStreamInputFilter(std::istream& is, const CString& filename)
     : AsmInputFilter(AsmInputFilterType::STREAM),
-      managed(false), stream(&is), mode(LineMode::NORMAL), stmtPos(0)
+      managed(false), stream(&is), mode(LineMode::NORMAL), stmtPos(0), mapPos(0)
 {
     source = RefPtr<const AsmSource>(new AsmFile(filename));
     stream->exceptions(std::ios::badbit);
@@ -184,43 +246,32 @@ AsmStreamInputFilter::AsmStreamInputFilter(std::istream& is, const CString& file
 AsmStreamInputFilter::AsmStreamInputFilter(const AsmSourcePos& pos,
            const CString& filename)
     : AsmInputFilter(AsmInputFilterType::STREAM),
-      managed(true), stream(nullptr), mode(LineMode::NORMAL), stmtPos(0)
+      managed(true), stream(nullptr), mode(LineMode::NORMAL), stmtPos(0), mapPos(0)
 {
-    try
-    {
-        if (!pos.macro)
-            source = RefPtr<const AsmSource>(new AsmFile(pos.source, pos.lineNo,
-                             pos.colNo, filename));
-        else // if inside macro
-            source = RefPtr<const AsmSource>(new AsmFile(
-                RefPtr<const AsmSource>(new AsmMacroSource(pos.macro, pos.source)),
-                     pos.lineNo, pos.colNo, filename));
-        
-        // open file
-        stream = new std::ifstream(filename.c_str(), std::ios::binary);
-        if (!*stream)
-            throw AsmException(std::string("Can't open source file '")+
-                        filename.c_str()+"'");
-        stream->exceptions(std::ios::badbit);
-        buffer.reserve(AsmParserLineMaxSize);
-    }
-    catch(...)
-    {
-        delete stream;
-        throw;
-    }
+    if (!pos.macro)
+        source = RefPtr<const AsmSource>(new AsmFile(pos.source, pos.lineNo,
+                         pos.colNo, filename));
+    else // if inside macro
+        source = RefPtr<const AsmSource>(new AsmFile(
+            RefPtr<const AsmSource>(new(AsmArenaObject::getArena(pos.macro.get()))
+                    AsmMacroSource(pos.macro, pos.source)),
+                 pos.lineNo, pos.colNo, filename));
+    // open file
+    openMappedFile(filename);
+    buffer.reserve(AsmParserLineMaxSize);
 }
 
 AsmStreamInputFilter::AsmStreamInputFilter(const AsmSourcePos& pos, std::istream& is,
         const CString& filename) : AsmInputFilter(AsmInputFilterType::STREAM),
-        managed(false), stream(&is), mode(LineMode::NORMAL), stmtPos(0)
+        managed(false), stream(&is), mode(LineMode::NORMAL), stmtPos(0), mapPos(0)
 {
     if (!pos.macro)
         source = RefPtr<const AsmSource>(new AsmFile(pos.source, pos.lineNo,
                              pos.colNo, filename));
     else // if inside macro
         source = RefPtr<const AsmSource>(new AsmFile(
-            RefPtr<const AsmSource>(new AsmMacroSource(pos.macro, pos.source)),
+            RefPtr<const AsmSource>(new(AsmArenaObject::getArena(pos.macro.get()))
+                    AsmMacroSource(pos.macro, pos.source)),
                  pos.lineNo, pos.colNo, filename));
     stream->exceptions(std::ios::badbit);
     buffer.reserve(AsmParserLineMaxSize);
@@ -232,8 +283,212 @@ AsmStreamInputFilter::~AsmStreamInputFilter()
         delete stream;
 }
 
+/* scanning of line content for characters which must be handled by
+ * state machine of the filter. first bytes are checked by scalar code (tokens are
+ * usually short), later bytes by SSE2 or AVX2 (choosen at runtime) if available. */
+
+#ifdef CLRX_SCAN_AVX2
+static bool detectAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static const bool scanHasAVX2 = detectAVX2();
+#endif
+
+// matching characters from set
+template<char... Chars>
+struct CLRX_INTERNAL ScanCharMatch;
+
+template<>
+struct CLRX_INTERNAL ScanCharMatch<>
+{
+    static bool scalar(cxbyte c)
+    { return false; }
+#ifdef CLRX_SCAN_SSE2
+    static __m128i sse2(__m128i v)
+    { return _mm_setzero_si128(); }
+#endif
+#ifdef CLRX_SCAN_AVX2
+    __attribute__((target("avx2")))
+    static __m256i avx2(__m256i v)
+    { return _mm256_setzero_si256(); }
+#endif
+};
+
+template<char C, char... Chars>
+struct CLRX_INTERNAL ScanCharMatch<C, Chars...>
+{
+    static bool scalar(cxbyte c)
+    { return c == cxbyte(C) || ScanCharMatch<Chars...>::scalar(c); }
+#ifdef CLRX_SCAN_SSE2
+    static __m128i sse2(__m128i v)
+    {
+        return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(C)),
+                    ScanCharMatch<Chars...>::sse2(v));
+    }
+#endif
+#ifdef CLRX_SCAN_AVX2
+    __attribute__((target("avx2")))
+    static __m256i avx2(__m256i v)
+    {
+        return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(C)),
+                    ScanCharMatch<Chars...>::avx2(v));
+    }
+#endif
+};
+
+/// scanner finds first character from set or control spaces ('\t', '\n', '\v',
+/// '\f', '\r') if CtrlSpaces is true
+template<bool CtrlSpaces, char... Chars>
+struct CLRX_INTERNAL LineCharScanner
+{
+    typedef ScanCharMatch<Chars...> Match;
+    
+    static bool isInSet(cxbyte c)
+    { return (CtrlSpaces && cxbyte(c-9) <= 4) || Match::scalar(c); }
+    
+#ifdef CLRX_SCAN_SSE2
+    static const char* scanSSE2(const char* p, const char* end)
+    {
+        for (; end-p >= 16; p += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i found = Match::sse2(v);
+            if (CtrlSpaces)
+            {
+                // unsigned (c-9) <= 4
+                const __m128i x = _mm_sub_epi8(v, _mm_set1_epi8(9));
+                found = _mm_or_si128(found, _mm_cmpeq_epi8(
+                            _mm_min_epu8(x, _mm_set1_epi8(4)), x));
+            }
+            const uint32_t mask = _mm_movemask_epi8(found);
+            if (mask != 0)
+                return p + CTZ32(mask);
+        }
+        for (; p != end && !isInSet(*p); ++p);
+        return p;
+    }
+#endif
+#ifdef CLRX_SCAN_AVX2
+    __attribute__((target("avx2")))
+    static const char* scanAVX2(const char* p, const char* end)
+    {
+        for (; end-p >= 32; p += 32)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i found = Match::avx2(v);
+            if (CtrlSpaces)
+            {
+                // unsigned (c-9) <= 4
+                const __m256i x = _mm256_sub_epi8(v, _mm256_set1_epi8(9));
+                found = _mm256_or_si256(found, _mm256_cmpeq_epi8(
+                            _mm256_min_epu8(x, _mm256_set1_epi8(4)), x));
+            }
+            const uint32_t mask = _mm256_movemask_epi8(found);
+            if (mask != 0)
+                return p + CTZ32(mask);
+        }
+        return scanSSE2(p, end);
+    }
+#endif
+    
+    // find first character from set in range (or end if not found)
+    static const char* scan(const char* p, const char* end)
+    {
+        // short tokens are scanned by scalar code
+        const char* scalarEnd = p + std::min(end-p, ptrdiff_t(16));
+        for (; p != scalarEnd; ++p)
+            if (isInSet(*p))
+                return p;
+        if (p == end)
+            return p;
+#ifdef CLRX_SCAN_AVX2
+        if (scanHasAVX2)
+            return scanAVX2(p, end);
+#endif
+#ifdef CLRX_SCAN_SSE2
+        return scanSSE2(p, end);
+#else
+        for (; p != end && !isInSet(*p); ++p);
+        return p;
+#endif
+    }
+};
+
+// characters which requires transformation of line
+typedef LineCharScanner<true, ';', '#', '/', '"', '\'', '\\'> PlainLineScanner;
+// characters which must be handled by state machine in normal mode
+typedef LineCharScanner<true, ';', '*', '#', '"', '\'', '\\'> NormalScanner;
+typedef LineCharScanner<false, '*', '\n'> LongCommentScanner;
+typedef LineCharScanner<false, '"', '\\', '\n'> StringScanner;
+typedef LineCharScanner<false, '\'', '\\', '\n'> LStringScanner;
+
+/* try to return line directly from mapped file.
+ * returns nullptr if line requires transformation (comments, strings,
+ * line joining or non-space whitespaces) */
+const char* AsmStreamInputFilter::readPlainLine(size_t& lineSize)
+{
+    const char* content = reinterpret_cast<const char*>(mappedFile.getData());
+    const char* lineStart = content + mapPos;
+    const char* end = content + mappedFile.getSize();
+    const char* p = PlainLineScanner::scan(lineStart, end);
+    // slash without asterisk is not long comment
+    while (p != end && *p == '/' && (p+1 == end || p[1] != '*'))
+        p = PlainLineScanner::scan(p+1, end);
+    
+    if (p != end && *p != '\n' && *p != ';')
+        return nullptr;
+    colTranslations.clear();
+    colTranslations.push_back({ssize_t(-stmtPos), lineNo});
+    lineSize = p-lineStart;
+    if (p == end)
+        // last line without newline
+        mapPos = mappedFile.getSize();
+    else
+    {
+        mapPos = p+1-content;
+        if (*p == '\n')
+        {
+            lineNo++;
+            stmtPos = 0;
+        }
+        else // treat statement as separate line
+            stmtPos += p+1-lineStart;
+    }
+    return lineStart;
+}
+
+// copy content from mapped file to the end of physical line
+size_t AsmStreamInputFilter::readFromMappedFile(char* dest, size_t maxSize)
+{
+    const char* content = reinterpret_cast<const char*>(mappedFile.getData()) + mapPos;
+    size_t toRead = std::min(maxSize, mappedFile.getSize()-mapPos);
+    const char* newLine = reinterpret_cast<const char*>(::memchr(content, '\n', toRead));
+    if (newLine != nullptr)
+        toRead = newLine+1-content;
+    std::copy(content, content+toRead, dest);
+    mapPos += toRead;
+    return toRead;
+}
+
 const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSize)
 {
+    if (stream == nullptr && mode == LineMode::NORMAL && pos >= buffer.size())
+    {
+        // buffer is empty, try to get line directly from mapped file
+        buffer.clear();
+        pos = 0;
+        if (mapPos == mappedFile.getSize())
+        {
+            lineSize = 0;
+            return nullptr;
+        }
+        const char* line = readPlainLine(lineSize);
+        if (line != nullptr)
+            return line;
+    }
     colTranslations.clear();
     bool endOfLine = false;
     size_t lineStart = pos;
@@ -249,6 +504,16 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
         {
             case LineMode::NORMAL:
             {
+                // move characters which does not require any handling
+                const size_t runSize = NormalScanner::scan(buffer.data()+pos,
+                        buffer.data()+buffer.size()) - (buffer.data()+pos);
+                if (runSize != 0)
+                {
+                    ::memmove(buffer.data()+destPos, buffer.data()+pos, runSize);
+                    destPos += runSize;
+                    pos += runSize;
+                    backslash = false;
+                }
                 if (pos < buffer.size() && !isSpace(buffer[pos]) && buffer[pos] != ';')
                 {
                     // putting regular string (no spaces)
@@ -344,12 +609,17 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
             }
             case LineMode::LINE_COMMENT:
             {
-                while (pos < buffer.size() && buffer[pos] != '\n')
+                // skipping bytes until newline or buffer end
+                const char* newLine = reinterpret_cast<const char*>(::memchr(
+                        buffer.data()+pos, '\n', buffer.size()-pos));
+                const size_t skipSize = (newLine != nullptr) ?
+                        newLine - (buffer.data()+pos) : buffer.size()-pos;
+                if (skipSize != 0)
                 {
-                    // skipping bytes until newline or buffer end
-                    backslash = (buffer[pos] == '\\');
-                    pos++;
-                    buffer[destPos++] = ' ';
+                    backslash = (buffer[pos+skipSize-1] == '\\');
+                    std::fill(buffer.begin()+destPos, buffer.begin()+destPos+skipSize, ' ');
+                    pos += skipSize;
+                    destPos += skipSize;
                 }
                 if (pos < buffer.size())
                 {
@@ -378,6 +648,23 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                 while (pos < buffer.size() && buffer[pos] != '\n' &&
                     (!asterisk || buffer[pos] != '/'))
                 {
+                    if (!asterisk)
+                    {
+                        // skip characters other than asterisk and newline
+                        const size_t skipSize = LongCommentScanner::scan(
+                                buffer.data()+pos, buffer.data()+buffer.size()) -
+                                (buffer.data()+pos);
+                        if (skipSize != 0)
+                        {
+                            backslash = (buffer[pos+skipSize-1] == '\\');
+                            prevAsterisk = false;
+                            std::fill(buffer.begin()+destPos,
+                                      buffer.begin()+destPos+skipSize, ' ');
+                            pos += skipSize;
+                            destPos += skipSize;
+                            continue;
+                        }
+                    }
                     backslash = (buffer[pos] == '\\');
                     prevAsterisk = asterisk;
                     asterisk = (buffer[pos] == '*');
@@ -427,6 +714,20 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                 while (pos < buffer.size() && buffer[pos] != '\n' &&
                     ((backslash&1) || buffer[pos] != quoteChar))
                 {
+                    // move characters other than quote, backslash and newline
+                    const size_t runSize = ((mode == LineMode::STRING) ?
+                            StringScanner::scan(buffer.data()+pos,
+                                    buffer.data()+buffer.size()) :
+                            LStringScanner::scan(buffer.data()+pos,
+                                    buffer.data()+buffer.size())) - (buffer.data()+pos);
+                    if (runSize != 0)
+                    {
+                        ::memmove(buffer.data()+destPos, buffer.data()+pos, runSize);
+                        destPos += runSize;
+                        pos += runSize;
+                        backslash = 0;
+                        continue;
+                    }
                     if (buffer[pos] == '\\')
                         backslash++;
                     else
@@ -487,8 +788,14 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
             if (pos == buffer.size())
                 buffer.resize(std::max(AsmParserLineMaxSize, (pos>>1)+pos));
             
-            stream->read(buffer.data()+pos, buffer.size()-pos);
-            const size_t readed = stream->gcount();
+            size_t readed = 0;
+            if (stream != nullptr)
+            {
+                stream->read(buffer.data()+pos, buffer.size()-pos);
+                readed = stream->gcount();
+            }
+            else
+                readed = readFromMappedFile(buffer.data()+pos, buffer.size()-pos);
             buffer.resize(pos+readed);
             if (readed == 0)
             {
@@ -511,14 +818,14 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
 
 AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
          const AsmSourcePos& pos, const MacroArgMap& _argMap, uint64_t _macroCount,
-         bool _alternateMacro)
+         bool _alternateMacro, AsmSharedArena* arena)
         : AsmInputFilter(AsmInputFilterType::MACROSUBST), macro(_macro),
           argMap(_argMap), macroCount(_macroCount), contentLineNo(0), sourceTransIndex(0),
           realLinePos(0), alternateMacro(_alternateMacro)
 {
     if (macro->getSourceTransSize()!=0)
         source = macro->getSourceTrans(0).source;
-    macroSubst = RefPtr<const AsmMacroSubst>(new AsmMacroSubst(pos.macro,
+    macroSubst = RefPtr<const AsmMacroSubst>(new(arena) AsmMacroSubst(pos.macro,
                    pos.source, pos.lineNo, pos.colNo));
     curColTrans = macro->getColTranslations().data();
     buffer.reserve(AsmParserLineMaxSize);
@@ -529,7 +836,7 @@ AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
 
 AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
          const AsmSourcePos& pos, MacroArgMap&& _argMap, uint64_t _macroCount,
-         bool _alternateMacro)
+         bool _alternateMacro, AsmSharedArena* arena)
         : AsmInputFilter(AsmInputFilterType::MACROSUBST), macro(_macro),
           argMap(std::move(_argMap)), macroCount(_macroCount),
           contentLineNo(0), sourceTransIndex(0), realLinePos(0),
@@ -537,7 +844,7 @@ AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
 {
     if (macro->getSourceTransSize()!=0)
         source = macro->getSourceTrans(0).source;
-    macroSubst = RefPtr<const AsmMacroSubst>(new AsmMacroSubst(pos.macro,
+    macroSubst = RefPtr<const AsmMacroSubst>(new(arena) AsmMacroSubst(pos.macro,
                    pos.source, pos.lineNo, pos.colNo));
     curColTrans = macro->getColTranslations().data();
     buffer.reserve(AsmParserLineMaxSize);
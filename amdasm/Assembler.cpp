@@ -655,7 +655,8 @@ void AsmScope::stopUsingScope(AsmScope* scope)
 Assembler::Assembler(const CString& filename, std::istream& input, Flags _flags,
         BinaryFormat _format, GPUDeviceType _deviceType, std::ostream& msgStream,
         std::ostream& _printStream)
-        : format(_format),
+        : sharedArena(nullptr),
+          format(_format),
           deviceType(_deviceType),
           driverVersion(0), llvmVersion(0),
           _64bit(false),
@@ -668,6 +669,7 @@ Assembler::Assembler(const CString& filename, std::istream& input, Flags _flags,
           endOfAssembly(false),
           messageStream(msgStream),
           printStream(_printStream),
+          includeCache(nullptr),
           // value reference and section reference from first symbol: '.'
           currentSection(globalScope.symbolMap.begin()->second.sectionId),
           currentOutPos(globalScope.symbolMap.begin()->second.value)
@@ -693,7 +695,8 @@ Assembler::Assembler(const CString& filename, std::istream& input, Flags _flags,
 Assembler::Assembler(const Array<CString>& _filenames, Flags _flags,
         BinaryFormat _format, GPUDeviceType _deviceType, std::ostream& msgStream,
         std::ostream& _printStream)
-        : format(_format),
+        : sharedArena(nullptr),
+          format(_format),
           deviceType(_deviceType),
           driverVersion(0), llvmVersion(0),
           _64bit(false),
@@ -706,6 +709,7 @@ Assembler::Assembler(const Array<CString>& _filenames, Flags _flags,
           endOfAssembly(false),
           messageStream(msgStream),
           printStream(_printStream),
+          includeCache(nullptr),
           // value reference and section reference from first symbol: '.'
           currentSection(globalScope.symbolMap.begin()->second.sectionId),
           currentOutPos(globalScope.symbolMap.begin()->second.value)
@@ -753,6 +757,9 @@ Assembler::~Assembler()
     
     for (auto& entry: symbolSnapshots)
         delete entry;
+    // arena will be deleted with last object allocated in it
+    if (sharedArena != nullptr && sharedArena->unreference())
+        delete sharedArena;
 }
 
 // routine to parse string in assembly syntax
@@ -1129,6 +1136,10 @@ Assembler::ParseState Assembler::parseSymbol(const char*& linePtr,
         entry = nullptr;
         return Assembler::ParseState::MISSING;
     }
+    if (includeRecording &&
+        includeRecording->symbolSet.find(symName) == includeRecording->symbolSet.end())
+        // included file refers to symbol not defined in it
+        includeRecording->valid = false;
     if (symName == ".") // any usage of '.' causes format initialization
     {
         // special case ('.' - always global)
@@ -1676,6 +1687,8 @@ bool Assembler::isAbsoluteSymbol(const AsmSymbol& symbol) const
 
 void Assembler::printWarning(const AsmSourcePos& pos, const char* message)
 {
+    if (includeRecording) // included file with warnings will not be cached
+        includeRecording->valid = false;
     if ((flags & ASM_WARNINGS) == 0)
         return; // do nothing
     pos.print(messageStream);
@@ -1687,6 +1700,8 @@ void Assembler::printWarning(const AsmSourcePos& pos, const char* message)
 void Assembler::printError(const AsmSourcePos& pos, const char* message)
 {
     good = false;
+    if (includeRecording)
+        includeRecording->valid = false;
     pos.print(messageStream);
     messageStream.write(": Error: ", 9);
     messageStream.write(message, ::strlen(message));
@@ -1929,7 +1944,7 @@ Assembler::ParseState Assembler::makeMacroSubstitution(const char* linePtr)
     // create macro input filter and push to stack
     std::unique_ptr<AsmInputFilter> macroFilter(new AsmMacroInputFilter(macro,
             getSourcePos(macroStartPlace), std::move(argMap), macroCount++,
-            alternateMacro));
+            alternateMacro, getSharedArena()));
     asmInputFilters.push(macroFilter.release());
     currentInputFilter = asmInputFilters.top();
     macroSubstLevel++;
@@ -2225,11 +2240,34 @@ bool Assembler::includeFile(const char* pseudoOpPlace, const std::string& filena
 {
     if (inclusionLevel == 500)
         THIS_FAIL_BY_ERROR(pseudoOpPlace, "Inclusion level is greater than 500")
+    const bool useCache = includeCache!=nullptr && currentScope==&globalScope;
+    uint64_t timestamp = 0;
+    if (useCache)
+    {
+        // throws exception if file doesn't exist
+        timestamp = getFileTimestamp(filename.c_str());
+        Array<cxbyte> data;
+        if (includeCache->get(filename, timestamp, getIncludeParamsKey(), data) &&
+            loadPrecompiledInclude(pseudoOpPlace, filename, data))
+        {
+            dependencies.push_back(filename);
+            return true;
+        }
+    }
     std::unique_ptr<AsmInputFilter> newInputFilter(new AsmStreamInputFilter(
                 getSourcePos(pseudoOpPlace), filename));
+    dependencies.push_back(filename);
     asmInputFilters.push(newInputFilter.release());
     currentInputFilter = asmInputFilters.top();
     inclusionLevel++;
+    if (includeRecording) // nested inclusion, do not cache outer file
+        includeRecording->valid = false;
+    else if (useCache)
+    {
+        // record definitions of included file to put them to include cache
+        includeRecording.reset(new AsmIncludeRecording{ currentInputFilter, filename,
+                timestamp, getIncludeParamsKey(), clauses.size(), true });
+    }
     return true;
 }
 
@@ -2248,6 +2286,8 @@ bool Assembler::readLine()
                 inclusionLevel--;
             else if (currentInputFilter->getType() == AsmInputFilterType::REPEAT)
                 repetitionLevel--;
+            if (includeRecording && currentInputFilter == includeRecording->filter)
+                finishIncludeRecording();
             delete asmInputFilters.top();
             asmInputFilters.pop();
         }
@@ -2620,6 +2660,17 @@ void Assembler::printUnresolvedSymbols(AsmScope* thisScope)
     }
 }
 
+// pseudo-ops that can be used in cached included file (only definitions)
+static const char* includeCacheablePseudoOpNamesTbl[] =
+{ ".equ", ".equiv", ".macro", ".regvar", ".set" };
+
+static bool isIncludeCacheablePseudoOp(const CString& name)
+{
+    return std::binary_search(includeCacheablePseudoOpNamesTbl,
+            includeCacheablePseudoOpNamesTbl + sizeof(includeCacheablePseudoOpNamesTbl) /
+            sizeof(const char*), name.c_str(), CStringLess());
+}
+
 bool Assembler::assemble()
 {
     resolvingRelocs = false;
@@ -2653,6 +2704,8 @@ bool Assembler::assemble()
         skipSpacesToEnd(linePtr, end);
         if (linePtr == end)
             continue; // only empty line
+        if (includeRecording && currentInputFilter != includeRecording->filter)
+            includeRecording->valid = false;
         
         // statement start (except labels). in this time can point to labels
         const char* stmtPlace = linePtr;
@@ -2667,6 +2720,8 @@ bool Assembler::assemble()
             // labels
             linePtr++;
             skipSpacesToEnd(linePtr, end);
+            if (includeRecording) // labels are not cached
+                includeRecording->valid = false;
             initializeOutputFormat();
             if (firstName.front() >= '0' && firstName.front() <= '9')
             {
@@ -2769,12 +2824,16 @@ bool Assembler::assemble()
                 printError(linePtr, "Expected assignment expression");
                 continue;
             }
-            assignSymbol(firstName, stmtPlace, linePtr);
+            if (assignSymbol(firstName, stmtPlace, linePtr))
+                recordIncludeSymbol(firstName);
             continue;
         }
         // make firstname as lowercase
         toLowerString(firstName);
         
+        if (includeRecording && !isIncludeCacheablePseudoOp(firstName))
+            // other statements than definitions are not cached
+            includeRecording->valid = false;
         if (firstName.size() >= 2 && firstName[0] == '.') // check for pseudo-op
             parsePseudoOps(firstName, stmtPlace, linePtr);
         else if (firstName.size() >= 1 && isDigit(firstName[0]))
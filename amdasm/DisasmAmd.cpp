@@ -104,10 +104,73 @@ static void getAmdDisasmKernelInputFromBinary(const AmdInnerGPUBinary32* innerBi
     }
 }
 
+// get kernel input for kernel with index i
+// innerIndex - returns index of used inner binary (SIZE_MAX if no inner binary)
+template<typename AmdMainBinary>
+static void getAmdDisasmKernelInput(const AmdMainBinary& binary, cxuint i,
+           AmdDisasmKernelInput& kernelInput, Flags flags, GPUDeviceType deviceType,
+           size_t* innerIndex = nullptr)
+{
+    const KernelInfo& kernelInfo = binary.getKernelInfo(i);
+    const AmdInnerGPUBinary32* innerBin = nullptr;
+    size_t innerBinIndex = SIZE_MAX;
+    if (i < binary.getInnerBinariesNum())
+    {
+        innerBin = &binary.getInnerBinary(i);
+        innerBinIndex = i;
+    }
+    if (innerBin == nullptr || innerBin->getKernelName() != kernelInfo.kernelName)
+    {
+        // fallback if not in order
+        try
+        {
+            innerBinIndex = binary.getInnerBinaryIndex(kernelInfo.kernelName.c_str());
+            innerBin = &binary.getInnerBinary(innerBinIndex);
+        }
+        catch(const Exception& ex)
+        {
+            innerBin = nullptr;
+            innerBinIndex = SIZE_MAX;
+        }
+    }
+    if (innerIndex != nullptr)
+        *innerIndex = innerBinIndex;
+    // kernel metadata
+    kernelInput.metadataSize = binary.getMetadataSize(i);
+    kernelInput.metadata = binary.getMetadata(i);
+    
+    // kernel header
+    kernelInput.headerSize = 0;
+    kernelInput.header = nullptr;
+    const AmdGPUKernelHeader* khdr = nullptr;
+    if (i < binary.getKernelHeadersNum())
+        khdr = &binary.getKernelHeaderEntry(i);
+    if (khdr == nullptr || khdr->kernelName != kernelInfo.kernelName)
+    {
+        // fallback if not in order
+        try
+        { khdr = &binary.getKernelHeaderEntry(kernelInfo.kernelName.c_str()); }
+        catch(const Exception& ex) // failed
+        { khdr = nullptr; }
+    }
+    if (khdr != nullptr)
+    {
+        kernelInput.headerSize = khdr->size;
+        kernelInput.header = khdr->data;
+    }
+    
+    // get kernek input from inner binary
+    kernelInput.kernelName = kernelInfo.kernelName;
+    kernelInput.calNotes.clear();
+    const Flags innerFlags = flags |
+        (((flags&DISASM_CONFIG)!=0) ? DISASM_METADATA|DISASM_CALNOTES : 0);
+    getAmdDisasmKernelInputFromBinary(innerBin, kernelInput, innerFlags, deviceType);
+}
+
 // template for handling 32-bit and 64-bit bnaries
 template<typename AmdMainBinary>
 static AmdDisasmInput* getAmdDisasmInputFromBinary(const AmdMainBinary& binary,
-           Flags flags)
+           Flags flags, bool withKernels = true)
 {
     std::unique_ptr<AmdDisasmInput> input(new AmdDisasmInput);
     input->is64BitMode = (binary.getHeader().e_ident[EI_CLASS] == ELFCLASS64);
@@ -118,57 +181,13 @@ static AmdDisasmInput* getAmdDisasmInputFromBinary(const AmdMainBinary& binary,
     input->driverInfo = binary.getDriverInfo();
     input->globalDataSize = binary.getGlobalDataSize();
     input->globalData = binary.getGlobalData();
+    if (!withKernels)
+        return input.release();
+    
     const size_t kernelInfosNum = binary.getKernelInfosNum();
-    const size_t kernelHeadersNum = binary.getKernelHeadersNum();
-    const size_t innerBinariesNum = binary.getInnerBinariesNum();
     input->kernels.resize(kernelInfosNum);
-    
-    const Flags innerFlags = flags |
-        (((flags&DISASM_CONFIG)!=0) ? DISASM_METADATA|DISASM_CALNOTES : 0);
     for (cxuint i = 0; i < kernelInfosNum; i++)
-    {
-        const KernelInfo& kernelInfo = binary.getKernelInfo(i);
-        const AmdInnerGPUBinary32* innerBin = nullptr;
-        if (i < innerBinariesNum)
-            innerBin = &binary.getInnerBinary(i);
-        if (innerBin == nullptr || innerBin->getKernelName() != kernelInfo.kernelName)
-        {
-            // fallback if not in order
-            try
-            { innerBin = &binary.getInnerBinary(kernelInfo.kernelName.c_str()); }
-            catch(const Exception& ex)
-            { innerBin = nullptr; }
-        }
-        AmdDisasmKernelInput& kernelInput = input->kernels[i];
-        // kernel metadata
-        kernelInput.metadataSize = binary.getMetadataSize(i);
-        kernelInput.metadata = binary.getMetadata(i);
-        
-        // kernel header
-        kernelInput.headerSize = 0;
-        kernelInput.header = nullptr;
-        const AmdGPUKernelHeader* khdr = nullptr;
-        if (i < kernelHeadersNum)
-            khdr = &binary.getKernelHeaderEntry(i);
-        if (khdr == nullptr || khdr->kernelName != kernelInfo.kernelName)
-        {
-            // fallback if not in order
-            try
-            { khdr = &binary.getKernelHeaderEntry(kernelInfo.kernelName.c_str()); }
-            catch(const Exception& ex) // failed
-            { khdr = nullptr; }
-        }
-        if (khdr != nullptr)
-        {
-            kernelInput.headerSize = khdr->size;
-            kernelInput.header = khdr->data;
-        }
-        
-        // get kernek input from inner binary
-        kernelInput.kernelName = kernelInfo.kernelName;
-        getAmdDisasmKernelInputFromBinary(innerBin, kernelInput, innerFlags,
-                  input->deviceType);
-    }
+        getAmdDisasmKernelInput(binary, i, input->kernels[i], flags, input->deviceType);
     return input.release();
 }
 
@@ -184,6 +203,16 @@ AmdDisasmInput* CLRX::getAmdDisasmInputFromBinary64(const AmdMainGPUBinary64& bi
     return getAmdDisasmInputFromBinary(binary, flags);
 }
 
+AmdDisasmInput* CLRX::getAmdDisasmGlobalInputFromBinary(const AmdMainGPUBinary32& binary)
+{
+    return getAmdDisasmInputFromBinary(binary, 0, false);
+}
+
+AmdDisasmInput* CLRX::getAmdDisasmGlobalInputFromBinary(const AmdMainGPUBinary64& binary)
+{
+    return getAmdDisasmInputFromBinary(binary, 0, false);
+}
+
 /* get AsmConfig */
 
 // AMD kernel argument types map (sorted by type names)
@@ -1497,8 +1526,9 @@ static void dumpAmdKernelConfig(std::ostream& output, const AmdKernelConfig& con
     }
 }
 
-void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
-       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+// disassemble global part of AMD binary (before kernels)
+static void disassembleAmdGlobal(std::ostream& output, const AmdDisasmInput* amdInput,
+            Flags flags)
 {
     if (amdInput->is64BitMode)
         output.write(".64bit\n", 7);
@@ -1507,7 +1537,6 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
     
     const bool doMetadata = ((flags & DISASM_METADATA) != 0);
     const bool doDumpData = ((flags & DISASM_DUMPDATA) != 0);
-    const bool doDumpCode = ((flags & DISASM_DUMPCODE) != 0);
     
     if (doMetadata)
     {
@@ -1528,31 +1557,85 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
         output.write(".globaldata\n", 12);
         printDisasmData(amdInput->globalDataSize, amdInput->globalData, output);
     }
+}
+
+// disassemble single kernel from AMD binary
+static void disassembleAmdKernel(std::ostream& output, const AmdDisasmInput* amdInput,
+        const AmdDisasmKernelInput& kinput, ISADisassembler* isaDisassembler,
+        size_t& sectionCount, Flags flags)
+{
+    output.write(".kernel ", 8);
+    output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
+    output.put('\n');
+    if ((flags & DISASM_CONFIG) == 0) // if not config
+        dumpAmdKernelDatas(output, kinput, flags);
+    else
+    {
+        // dump in human readable configuration
+        AmdKernelConfig config = getAmdKernelConfig(kinput.metadataSize,
+                kinput.metadata, kinput.calNotes, amdInput->driverInfo,
+                kinput.header);
+        dumpAmdKernelConfig(output, config);
+    }
     
+    if ((flags & DISASM_DUMPCODE) != 0 && kinput.code != nullptr && kinput.codeSize != 0)
+    {
+        // input kernel code (main disassembly)
+        output.write("    .text\n", 10);
+        isaDisassembler->setInput(kinput.codeSize, kinput.code);
+        isaDisassembler->beforeDisassemble();
+        isaDisassembler->disassemble();
+        sectionCount++;
+    }
+}
+
+void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
+       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+{
+    disassembleAmdGlobal(output, amdInput, flags);
     for (const AmdDisasmKernelInput& kinput: amdInput->kernels)
+        disassembleAmdKernel(output, amdInput, kinput, isaDisassembler,
+                    sectionCount, flags);
+}
+
+template<typename AmdMainBinary>
+static void disassembleAmdStreamInt(std::ostream& output, const AmdDisasmInput* amdInput,
+       AmdMainBinary& binary, ISADisassembler* isaDisassembler,
+       size_t& sectionCount, Flags flags)
+{
+    disassembleAmdGlobal(output, amdInput, flags);
+    const size_t kernelInfosNum = binary.getKernelInfosNum();
+    // only one kernel input at time
+    AmdDisasmKernelInput kinput;
+    for (cxuint i = 0; i < kernelInfosNum; i++)
     {
-        output.write(".kernel ", 8);
-        output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
-        output.put('\n');
-        if ((flags & DISASM_CONFIG) == 0) // if not config
-            dumpAmdKernelDatas(output, kinput, flags);
-        else
-        {
-            // dump in human readable configuration
-            AmdKernelConfig config = getAmdKernelConfig(kinput.metadataSize,
-                    kinput.metadata, kinput.calNotes, amdInput->driverInfo,
-                    kinput.header);
-            dumpAmdKernelConfig(output, config);
-        }
-        
-        if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
-        {
-            // input kernel code (main disassembly)
-            output.write("    .text\n", 10);
-            isaDisassembler->setInput(kinput.codeSize, kinput.code);
-            isaDisassembler->beforeDisassemble();
-            isaDisassembler->disassemble();
-            sectionCount++;
-        }
+        size_t innerIndex = SIZE_MAX;
+        getAmdDisasmKernelInput(binary, i, kinput, flags, amdInput->deviceType,
+                    &innerIndex);
+        disassembleAmdKernel(output, amdInput, kinput, isaDisassembler,
+                    sectionCount, flags);
+        // kernel boundary: free labels, kernel data (lazy binary) and push output
+        isaDisassembler->releaseLabelsAndRelocations();
+        binary.releaseKernelInfo(i);
+        if (innerIndex != SIZE_MAX)
+            binary.releaseInnerBinary(innerIndex);
+        isaDisassembler->flushOutput();
+        output.flush();
     }
 }
+
+void CLRX::disassembleAmdStream(std::ostream& output, const AmdDisasmInput* amdInput,
+       AmdMainGPUBinary32& binary, ISADisassembler* isaDisassembler,
+       size_t& sectionCount, Flags flags)
+{
+    disassembleAmdStreamInt(output, amdInput, binary, isaDisassembler,
+                sectionCount, flags);
+}
+
+void CLRX::disassembleAmdStream(std::ostream& output, const AmdDisasmInput* amdInput,
+       AmdMainGPUBinary64& binary, ISADisassembler* isaDisassembler,
+       size_t& sectionCount, Flags flags)
+{
+    disassembleAmdStreamInt(output, amdInput, binary, isaDisassembler,
+                sectionCount, flags);
+}
@@ -50,58 +50,121 @@ struct CLRX_INTERNAL AmdCL2Types64: Elf64Types
     typedef AmdCL2GPUKernelArgEntry64 KernelArgEntry;
 };
 
-// generate AMD CL2.0 disasm input from main binary
+// AMD CL2.0 disasm input builder (global input and kernel inputs)
 template<typename AmdCL2Types>
-static AmdCL2DisasmInput* getAmdCL2DisasmInputFromBinary(
-            const typename AmdCL2Types::AmdCL2MainBinary& binary, cxuint driverVersion)
+class CLRX_INTERNAL AmdCL2DisasmInputBuilder
 {
-    std::unique_ptr<AmdCL2DisasmInput> input(new AmdCL2DisasmInput);
-    input->is64BitMode = (binary.getHeader().e_ident[EI_CLASS] == ELFCLASS64);
+private:
+    typedef typename AmdCL2Types::AmdCL2MainBinary AmdCL2MainBinary;
+    typedef std::vector<std::pair<size_t, size_t> > SortedRelocs;
     
-    input->deviceType = binary.determineGPUDeviceType(input->archMinor,
-                  input->archStepping, driverVersion);
+    const AmdCL2MainBinary& binary;
+    bool isInnerNewBinary;
+    SortedRelocs sortedRelocs; // by offset
+    typename SortedRelocs::const_iterator sortedRelocIter;
+    const cxbyte* textPtr;
+    // section indices (undefined if not exists)
+    uint16_t gDataSectionIdx;
+    uint16_t rwDataSectionIdx;
+    uint16_t bssDataSectionIdx;
+public:
+    explicit AmdCL2DisasmInputBuilder(const AmdCL2MainBinary& _binary)
+        : binary(_binary), textPtr(nullptr), gDataSectionIdx(SHN_UNDEF),
+          rwDataSectionIdx(SHN_UNDEF), bssDataSectionIdx(SHN_UNDEF)
+    {
+        isInnerNewBinary = binary.hasInnerBinary() &&
+                binary.getDriverVersion()>=191205;
+        sortedRelocIter = sortedRelocs.begin();
+    }
+    
+    // get global input (without kernels)
+    void getGlobalInput(AmdCL2DisasmInput& input, cxuint driverVersion);
+    // prepare sorted text relocations (must be called before getting kernel inputs)
+    void prepareTextRelocations();
+    // get input for kernel with index i (kernels must be get in order)
+    void getKernelInput(cxuint i, AmdCL2DisasmKernelInput& kinput);
+    // check whether all text relocations has been assigned to kernels
+    void checkTextRelocations() const
+    {
+        if (sortedRelocIter != sortedRelocs.end())
+            throw DisasmException("Code relocation offset outside kernel code");
+    }
+};
+
+template<typename AmdCL2Types>
+void AmdCL2DisasmInputBuilder<AmdCL2Types>::getGlobalInput(AmdCL2DisasmInput& input,
+            cxuint driverVersion)
+{
+    input.is64BitMode = (binary.getHeader().e_ident[EI_CLASS] == ELFCLASS64);
+    
+    input.deviceType = binary.determineGPUDeviceType(input.archMinor,
+                  input.archStepping, driverVersion);
     if (driverVersion == 0)
-        input->driverVersion = binary.getDriverVersion();
+        input.driverVersion = binary.getDriverVersion();
     else
-        input->driverVersion = driverVersion;
+        input.driverVersion = driverVersion;
     
-    input->compileOptions = binary.getCompileOptions();
-    input->aclVersionString = binary.getAclVersionString();
-    bool isInnerNewBinary = binary.hasInnerBinary() &&
-                binary.getDriverVersion()>=191205;
+    input.compileOptions = binary.getCompileOptions();
+    input.aclVersionString = binary.getAclVersionString();
     
-    input->samplerInitSize = 0;
-    input->samplerInit = nullptr;
-    input->globalDataSize = 0;
-    input->globalData = nullptr;
-    input->rwDataSize = 0;
-    input->rwData = nullptr;
-    input->bssAlignment = input->bssSize = 0;
-    std::vector<std::pair<size_t, size_t> > sortedRelocs; // by offset
-    const cxbyte* textPtr = nullptr;
-    const size_t kernelInfosNum = binary.getKernelInfosNum();
+    input.samplerInitSize = 0;
+    input.samplerInit = nullptr;
+    input.globalDataSize = 0;
+    input.globalData = nullptr;
+    input.rwDataSize = 0;
+    input.rwData = nullptr;
+    input.bssAlignment = input.bssSize = 0;
     
-    // set section indices as undefined
-    uint16_t gDataSectionIdx = SHN_UNDEF;
-    uint16_t rwDataSectionIdx = SHN_UNDEF;
-    uint16_t bssDataSectionIdx = SHN_UNDEF;
+    if (!isInnerNewBinary)
+        return;
+    const AmdCL2InnerGPUBinary& innerBin = binary.getInnerBinary();
+    input.globalDataSize = innerBin.getGlobalDataSize();
+    input.globalData = innerBin.getGlobalData();
+    input.rwDataSize = innerBin.getRwDataSize();
+    input.rwData = innerBin.getRwData();
+    input.samplerInitSize = innerBin.getSamplerInitSize();
+    input.samplerInit = innerBin.getSamplerInit();
+    input.bssAlignment = innerBin.getBssAlignment();
+    input.bssSize = innerBin.getBssSize();
     
+    // if no kernels and data
+    if (binary.getKernelInfosNum()==0)
+        return;
+    
+    // relocations for global data section (sampler symbols)
+    const size_t relaNum = innerBin.getGlobalDataRelaEntriesNum();
+    // section index for samplerinit (will be used for comparing sampler symbol section
+    uint16_t samplerInitSecIndex = SHN_UNDEF;
+    try
+    { samplerInitSecIndex = innerBin.getSectionIndex(".hsaimage_samplerinit"); }
+    catch(const Exception& ex)
+    { }
+    
+    // store sampler relocations to samplerRelocs
+    for (size_t i = 0; i < relaNum; i++)
+    {
+        const Elf64_Rela& rel = innerBin.getGlobalDataRelaEntry(i);
+        size_t symIndex = ELF64_R_SYM(ULEV(rel.r_info));
+        const Elf64_Sym& sym = innerBin.getSymbol(symIndex);
+        // check symbol type, section and value
+        if (ELF64_ST_TYPE(sym.st_info) != 12)
+            throw DisasmException("Wrong sampler symbol");
+        uint64_t value = ULEV(sym.st_value);
+        if (ULEV(sym.st_shndx) != samplerInitSecIndex)
+            throw DisasmException("Wrong section for sampler symbol");
+        if ((value&7) != 0)
+            throw DisasmException("Wrong value of sampler symbol");
+        input.samplerRelocs.push_back({ size_t(ULEV(rel.r_offset)),
+            size_t(value>>3) });
+    }
+}
+
+template<typename AmdCL2Types>
+void AmdCL2DisasmInputBuilder<AmdCL2Types>::prepareTextRelocations()
+{
     if (isInnerNewBinary)
     {
         const AmdCL2InnerGPUBinary& innerBin = binary.getInnerBinary();
-        input->globalDataSize = innerBin.getGlobalDataSize();
-        input->globalData = innerBin.getGlobalData();
-        input->rwDataSize = innerBin.getRwDataSize();
-        input->rwData = innerBin.getRwData();
-        input->samplerInitSize = innerBin.getSamplerInitSize();
-        input->samplerInit = innerBin.getSamplerInit();
-        input->bssAlignment = innerBin.getBssAlignment();
-        input->bssSize = innerBin.getBssSize();
-        
-        // if no kernels and data
-        if (kernelInfosNum==0)
-            return input.release();
-        
         // get and sort relocations by offset
         size_t relaNum = innerBin.getTextRelaEntriesNum();
         for (size_t i = 0; i < relaNum; i++)
@@ -127,158 +190,147 @@ static AmdCL2DisasmInput* getAmdCL2DisasmInputFromBinary(
         { bssDataSectionIdx = innerBin.getSectionIndex(".hsabss_global_agent"); }
         catch(const Exception& ex)
         { }
-        // relocations for global data section (sampler symbols)
-        relaNum = innerBin.getGlobalDataRelaEntriesNum();
-        // section index for samplerinit (will be used for comparing sampler symbol section
-        uint16_t samplerInitSecIndex = SHN_UNDEF;
+    }
+    sortedRelocIter = sortedRelocs.begin();
+}
+
+template<typename AmdCL2Types>
+void AmdCL2DisasmInputBuilder<AmdCL2Types>::getKernelInput(cxuint i,
+            AmdCL2DisasmKernelInput& kinput)
+{
+    const KernelInfo& kernelInfo = binary.getKernelInfo(i);
+    kinput.kernelName = kernelInfo.kernelName;
+    kinput.metadataSize = binary.getMetadataSize(i);
+    kinput.metadata = binary.getMetadata(i);
+    
+    kinput.isaMetadataSize = 0;
+    kinput.isaMetadata = nullptr;
+    // setup isa metadata content
+    const AmdCL2GPUKernelMetadata* isaMetadata = nullptr;
+    if (i < binary.getISAMetadatasNum())
+        isaMetadata = &binary.getISAMetadataEntry(i);
+    if (isaMetadata == nullptr || isaMetadata->kernelName != kernelInfo.kernelName)
+    {
+        // fallback if not in order
         try
-        { samplerInitSecIndex = innerBin.getSectionIndex(".hsaimage_samplerinit"); }
-        catch(const Exception& ex)
-        { }
-        
-        // store sampler relocations to samplerRelocs
-        for (size_t i = 0; i < relaNum; i++)
-        {
-            const Elf64_Rela& rel = innerBin.getGlobalDataRelaEntry(i);
-            size_t symIndex = ELF64_R_SYM(ULEV(rel.r_info));
-            const Elf64_Sym& sym = innerBin.getSymbol(symIndex);
-            // check symbol type, section and value
-            if (ELF64_ST_TYPE(sym.st_info) != 12)
-                throw DisasmException("Wrong sampler symbol");
-            uint64_t value = ULEV(sym.st_value);
-            if (ULEV(sym.st_shndx) != samplerInitSecIndex)
-                throw DisasmException("Wrong section for sampler symbol");
-            if ((value&7) != 0)
-                throw DisasmException("Wrong value of sampler symbol");
-            input->samplerRelocs.push_back({ size_t(ULEV(rel.r_offset)),
-                size_t(value>>3) });
-        }
+        { isaMetadata = &binary.getISAMetadataEntry(
+                        kernelInfo.kernelName.c_str()); }
+        catch(const Exception& ex) // failed
+        { isaMetadata = nullptr; }
+    }
+    if (isaMetadata!=nullptr)
+    {
+        kinput.isaMetadataSize = isaMetadata->size;
+        kinput.isaMetadata = isaMetadata->data;
     }
-    else if (kernelInfosNum==0)
-        return input.release();
     
-    input->kernels.resize(kernelInfosNum);
-    auto sortedRelocIter = sortedRelocs.begin();
+    kinput.code = nullptr;
+    kinput.codeSize = 0;
+    kinput.setup = nullptr;
+    kinput.setupSize = 0;
+    kinput.stub = nullptr;
+    kinput.stubSize = 0;
+    kinput.textRelocs.clear();
+    if (!binary.hasInnerBinary())
+        return; // nothing else to set
     
-    // preparing kernel inputs
-    for (cxuint i = 0; i < kernelInfosNum; i++)
+    // get kernel code, setup and stub content
+    const AmdCL2InnerGPUBinaryBase& innerBin = binary.getInnerBinaryBase();
+    const AmdCL2GPUKernel* kernelData = nullptr;
+    if (i < innerBin.getKernelsNum())
+        kernelData = &innerBin.getKernelData(i);
+    if (kernelData==nullptr || kernelData->kernelName != kernelInfo.kernelName)
+        kernelData = &innerBin.getKernelData(kernelInfo.kernelName.c_str());
+    
+    if (kernelData!=nullptr)
     {
-        const KernelInfo& kernelInfo = binary.getKernelInfo(i);
-        AmdCL2DisasmKernelInput& kinput = input->kernels[i];
-        kinput.kernelName = kernelInfo.kernelName;
-        kinput.metadataSize = binary.getMetadataSize(i);
-        kinput.metadata = binary.getMetadata(i);
-        
-        kinput.isaMetadataSize = 0;
-        kinput.isaMetadata = nullptr;
-        // setup isa metadata content
-        const AmdCL2GPUKernelMetadata* isaMetadata = nullptr;
-        if (i < binary.getISAMetadatasNum())
-            isaMetadata = &binary.getISAMetadataEntry(i);
-        if (isaMetadata == nullptr || isaMetadata->kernelName != kernelInfo.kernelName)
-        {
-            // fallback if not in order
-            try
-            { isaMetadata = &binary.getISAMetadataEntry(
-                            kernelInfo.kernelName.c_str()); }
-            catch(const Exception& ex) // failed
-            { isaMetadata = nullptr; }
-        }
-        if (isaMetadata!=nullptr)
-        {
-            kinput.isaMetadataSize = isaMetadata->size;
-            kinput.isaMetadata = isaMetadata->data;
-        }
-        
-        kinput.code = nullptr;
-        kinput.codeSize = 0;
-        kinput.setup = nullptr;
-        kinput.setupSize = 0;
-        kinput.stub = nullptr;
-        kinput.stubSize = 0;
-        if (!binary.hasInnerBinary())
-            continue; // nothing else to set
-        
-        // get kernel code, setup and stub content
-        const AmdCL2InnerGPUBinaryBase& innerBin = binary.getInnerBinaryBase();
-        const AmdCL2GPUKernel* kernelData = nullptr;
+        // if set kernel code and kernel setup (AMD HSA config)
+        kinput.code = kernelData->code;
+        kinput.codeSize = kernelData->codeSize;
+        kinput.setup = kernelData->setup;
+        kinput.setupSize = kernelData->setupSize;
+    }
+    if (!isInnerNewBinary)
+    {
+        // old drivers
+        const AmdCL2OldInnerGPUBinary& oldInnerBin = binary.getOldInnerBinary();
+        const AmdCL2GPUKernelStub* kstub = nullptr;
         if (i < innerBin.getKernelsNum())
-            kernelData = &innerBin.getKernelData(i);
-        if (kernelData==nullptr || kernelData->kernelName != kernelInfo.kernelName)
-            kernelData = &innerBin.getKernelData(kernelInfo.kernelName.c_str());
-        
-        if (kernelData!=nullptr)
-        {
-            // if set kernel code and kernel setup (AMD HSA config)
-            kinput.code = kernelData->code;
-            kinput.codeSize = kernelData->codeSize;
-            kinput.setup = kernelData->setup;
-            kinput.setupSize = kernelData->setupSize;
-        }
-        if (!isInnerNewBinary)
+            kstub = &oldInnerBin.getKernelStub(i);
+        if (kstub==nullptr || kernelData->kernelName != kernelInfo.kernelName)
+            kstub = &oldInnerBin.getKernelStub(kernelInfo.kernelName.c_str());
+        if (kstub!=nullptr)
         {
-            // old drivers
-            const AmdCL2OldInnerGPUBinary& oldInnerBin = binary.getOldInnerBinary();
-            const AmdCL2GPUKernelStub* kstub = nullptr;
-            if (i < innerBin.getKernelsNum())
-                kstub = &oldInnerBin.getKernelStub(i);
-            if (kstub==nullptr || kernelData->kernelName != kernelInfo.kernelName)
-                kstub = &oldInnerBin.getKernelStub(kernelInfo.kernelName.c_str());
-            if (kstub!=nullptr)
-            {
-                kinput.stubSize = kstub->size;
-                kinput.stub = kstub->data;
-            }
+            kinput.stubSize = kstub->size;
+            kinput.stub = kstub->data;
         }
-        else
+        return;
+    }
+    
+    // relocations
+    const AmdCL2InnerGPUBinary& newInnerBin = binary.getInnerBinary();
+    
+    if (sortedRelocIter != sortedRelocs.end() &&
+            sortedRelocIter->first < size_t(kinput.code-textPtr))
+        throw DisasmException("Code relocation offset outside kernel code");
+    
+    if (sortedRelocIter != sortedRelocs.end())
+    {
+        size_t end = kinput.code+kinput.codeSize-textPtr;
+        for (; sortedRelocIter != sortedRelocs.end() &&
+            sortedRelocIter->first<=end; ++sortedRelocIter)
         {
-            // relocations
-            const AmdCL2InnerGPUBinary& innerBin = binary.getInnerBinary();
-            
-            if (sortedRelocIter != sortedRelocs.end() &&
-                    sortedRelocIter->first < size_t(kinput.code-textPtr))
-                throw DisasmException("Code relocation offset outside kernel code");
-            
-            if (sortedRelocIter != sortedRelocs.end())
-            {
-                size_t end = kinput.code+kinput.codeSize-textPtr;
-                for (; sortedRelocIter != sortedRelocs.end() &&
-                    sortedRelocIter->first<=end; ++sortedRelocIter)
-                {
-                    // add relocations
-                    const Elf64_Rela& rela = innerBin.getTextRelaEntry(
-                                sortedRelocIter->second);
-                    uint32_t symIndex = ELF64_R_SYM(ULEV(rela.r_info));
-                    int64_t addend = ULEV(rela.r_addend);
-                    cxuint rsym = 0;
-                    // check this symbol
-                    const Elf64_Sym& sym = innerBin.getSymbol(symIndex);
-                    uint16_t symShndx = ULEV(sym.st_shndx);
-                    if (symShndx!=gDataSectionIdx && symShndx!=rwDataSectionIdx &&
-                        symShndx!=bssDataSectionIdx)
-                        throw DisasmException("Symbol is not placed in global or "
-                                "rwdata data or bss is illegal");
-                    addend += ULEV(sym.st_value);
-                    rsym = (symShndx==rwDataSectionIdx) ? 1 : 
-                        ((symShndx==bssDataSectionIdx) ? 2 : 0);
-                    // determine relocation type
-                    RelocType relocType;
-                    uint32_t rtype = ELF64_R_TYPE(ULEV(rela.r_info));
-                    if (rtype==1)
-                        relocType = RELTYPE_LOW_32BIT;
-                    else if (rtype==2)
-                        relocType = RELTYPE_HIGH_32BIT;
-                    else
-                        throw DisasmException("Unknown relocation type");
-                    // put text relocs. compute offset by subtracting current code offset
-                    kinput.textRelocs.push_back(AmdCL2RelaEntry{sortedRelocIter->first-
-                        (kinput.code-textPtr), relocType, rsym, addend });
-                }
-            }
+            // add relocations
+            const Elf64_Rela& rela = newInnerBin.getTextRelaEntry(
+                        sortedRelocIter->second);
+            uint32_t symIndex = ELF64_R_SYM(ULEV(rela.r_info));
+            int64_t addend = ULEV(rela.r_addend);
+            cxuint rsym = 0;
+            // check this symbol
+            const Elf64_Sym& sym = newInnerBin.getSymbol(symIndex);
+            uint16_t symShndx = ULEV(sym.st_shndx);
+            if (symShndx!=gDataSectionIdx && symShndx!=rwDataSectionIdx &&
+                symShndx!=bssDataSectionIdx)
+                throw DisasmException("Symbol is not placed in global or "
+                        "rwdata data or bss is illegal");
+            addend += ULEV(sym.st_value);
+            rsym = (symShndx==rwDataSectionIdx) ? 1 : 
+                ((symShndx==bssDataSectionIdx) ? 2 : 0);
+            // determine relocation type
+            RelocType relocType;
+            uint32_t rtype = ELF64_R_TYPE(ULEV(rela.r_info));
+            if (rtype==1)
+                relocType = RELTYPE_LOW_32BIT;
+            else if (rtype==2)
+                relocType = RELTYPE_HIGH_32BIT;
+            else
+                throw DisasmException("Unknown relocation type");
+            // put text relocs. compute offset by subtracting current code offset
+            kinput.textRelocs.push_back(AmdCL2RelaEntry{sortedRelocIter->first-
+                (kinput.code-textPtr), relocType, rsym, addend });
         }
     }
-    if (sortedRelocIter != sortedRelocs.end())
-        throw DisasmException("Code relocation offset outside kernel code");
+}
+
+// generate AMD CL2.0 disasm input from main binary
+template<typename AmdCL2Types>
+static AmdCL2DisasmInput* getAmdCL2DisasmInputFromBinary(
+            const typename AmdCL2Types::AmdCL2MainBinary& binary, cxuint driverVersion,
+            bool withKernels = true)
+{
+    std::unique_ptr<AmdCL2DisasmInput> input(new AmdCL2DisasmInput);
+    AmdCL2DisasmInputBuilder<AmdCL2Types> builder(binary);
+    builder.getGlobalInput(*input, driverVersion);
+    const size_t kernelInfosNum = binary.getKernelInfosNum();
+    if (!withKernels || kernelInfosNum==0)
+        return input.release();
+    
+    // preparing kernel inputs
+    builder.prepareTextRelocations();
+    input->kernels.resize(kernelInfosNum);
+    for (cxuint i = 0; i < kernelInfosNum; i++)
+        builder.getKernelInput(i, input->kernels[i]);
+    builder.checkTextRelocations();
     return input.release();
 }
 
@@ -296,6 +348,18 @@ AmdCL2DisasmInput* CLRX::getAmdCL2DisasmInputFromBinary64(
     return getAmdCL2DisasmInputFromBinary<AmdCL2Types64>(binary, driverVersion);
 }
 
+AmdCL2DisasmInput* CLRX::getAmdCL2DisasmGlobalInputFromBinary(
+                const AmdCL2MainGPUBinary32& binary, cxuint driverVersion)
+{
+    return getAmdCL2DisasmInputFromBinary<AmdCL2Types32>(binary, driverVersion, false);
+}
+
+AmdCL2DisasmInput* CLRX::getAmdCL2DisasmGlobalInputFromBinary(
+                const AmdCL2MainGPUBinary64& binary, cxuint driverVersion)
+{
+    return getAmdCL2DisasmInputFromBinary<AmdCL2Types64>(binary, driverVersion, false);
+}
+
 // internal AMD OpenCL 2.0 Kernel setup (part of AMD HSA config)
 struct CLRX_INTERNAL IntAmdCL2SetupData
 {
@@ -763,15 +827,15 @@ static void dumpAmdCL2ArgsAndSamplers(std::ostream& output,
     }
 }
 
-void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdCL2Input,
-       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+// disassemble global part of AMD OpenCL 2.0 binary (before kernels)
+static void disassembleAmdCL2Global(std::ostream& output,
+        const AmdCL2DisasmInput* amdCL2Input, std::vector<size_t>& samplerOffsets,
+        Flags flags)
 {
     const bool doMetadata = ((flags & DISASM_METADATA) != 0);
     const bool doDumpData = ((flags & DISASM_DUMPDATA) != 0);
-    const bool doDumpCode = ((flags & DISASM_DUMPCODE) != 0);
     const bool doDumpConfig = ((flags & DISASM_CONFIG) != 0);
     const bool doSetup = ((flags & DISASM_SETUP) != 0);
-    const bool doHSAConfig = ((flags & DISASM_HSACONFIG) != 0);
     
     if (amdCL2Input->is64BitMode)
         output.write(".64bit\n", 7);
@@ -869,7 +933,6 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
     }
     
     // prepare sampler offsets
-    std::vector<size_t> samplerOffsets;
     if (doDumpConfig)
     {
         for (auto reloc: amdCL2Input->samplerRelocs)
@@ -879,91 +942,158 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
             samplerOffsets[reloc.second] = reloc.first;
         }
     }
+}
+
+// disassemble single kernel from AMD OpenCL 2.0 binary
+static void disassembleAmdCL2Kernel(std::ostream& output,
+        const AmdCL2DisasmInput* amdCL2Input, const AmdCL2DisasmKernelInput& kinput,
+        const std::vector<size_t>& samplerOffsets, ISADisassembler* isaDisassembler,
+        size_t& sectionCount, Flags flags)
+{
+    const bool doMetadata = ((flags & DISASM_METADATA) != 0);
+    const bool doDumpCode = ((flags & DISASM_DUMPCODE) != 0);
+    const bool doDumpConfig = ((flags & DISASM_CONFIG) != 0);
+    const bool doSetup = ((flags & DISASM_SETUP) != 0);
+    const bool doHSAConfig = ((flags & DISASM_HSACONFIG) != 0);
     
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(amdCL2Input->deviceType);
     const cxuint maxSgprsNum = getGPUMaxRegistersNum(arch, REGTYPE_SGPR, 0);
     
-    for (const AmdCL2DisasmKernelInput& kinput: amdCL2Input->kernels)
+    output.write(".kernel ", 8);
+    output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
+    output.put('\n');
+    if (doMetadata && !doDumpConfig)
     {
-        output.write(".kernel ", 8);
-        output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
-        output.put('\n');
-        if (doMetadata && !doDumpConfig)
+        if (kinput.metadata != nullptr && kinput.metadataSize != 0)
         {
-            if (kinput.metadata != nullptr && kinput.metadataSize != 0)
-            {
-                // if kernel metadata available
-                output.write("    .metadata\n", 14);
-                printDisasmData(kinput.metadataSize, kinput.metadata, output, true);
-            }
-            if (kinput.isaMetadata != nullptr && kinput.isaMetadataSize != 0)
-            {
-                // if kernel isametadata available
-                output.write("    .isametadata\n", 17);
-                printDisasmData(kinput.isaMetadataSize, kinput.isaMetadata, output, true);
-            }
+            // if kernel metadata available
+            output.write("    .metadata\n", 14);
+            printDisasmData(kinput.metadataSize, kinput.metadata, output, true);
         }
-        if (doSetup && !doDumpConfig)
+        if (kinput.isaMetadata != nullptr && kinput.isaMetadataSize != 0)
         {
-            if (kinput.stub != nullptr && kinput.stubSize != 0)
-            {
-                // if kernel setup available
-                output.write("    .stub\n", 10);
-                printDisasmData(kinput.stubSize, kinput.stub, output, true);
-            }
-            if (kinput.setup != nullptr && kinput.setupSize != 0)
-            {
-                // if kernel setup available
-                output.write("    .setup\n", 11);
-                printDisasmData(kinput.setupSize, kinput.setup, output, true);
-            }
+            // if kernel isametadata available
+            output.write("    .isametadata\n", 17);
+            printDisasmData(kinput.isaMetadataSize, kinput.isaMetadata, output, true);
         }
-        
-        if (doDumpConfig)
+    }
+    if (doSetup && !doDumpConfig)
+    {
+        if (kinput.stub != nullptr && kinput.stubSize != 0)
         {
-            const bool isGCN14 = getGPUArchitectureFromDeviceType(
-                        amdCL2Input->deviceType) >= GPUArchitecture::GCN1_4;
-            AmdCL2KernelConfig config{};
-            // get kernel config
-            if (amdCL2Input->is64BitMode)
-                config = genKernelConfig<AmdCL2Types64>(kinput.metadataSize,
-                        kinput.metadata, kinput.setupSize,
-                        (doHSAConfig ? nullptr : kinput.setup), samplerOffsets,
-                        kinput.textRelocs, isGCN14);
-            else
-                config = genKernelConfig<AmdCL2Types32>(kinput.metadataSize,
-                        kinput.metadata, kinput.setupSize,
-                        (doHSAConfig ? nullptr : kinput.setup), samplerOffsets,
-                        kinput.textRelocs, isGCN14);
-            
-            dumpAmdCL2KernelConfig(output, config, doHSAConfig);
-            if (doHSAConfig)
-            {
-                // print as HSA config
-                dumpAMDHSAConfig(output, maxSgprsNum, arch,
-                     *reinterpret_cast<const AmdHsaKernelConfig*>(kinput.setup));
-                output.write("    .hsaconfig\n", 15);
-            }
-            
-            dumpAmdCL2ArgsAndSamplers(output, config);
+            // if kernel setup available
+            output.write("    .stub\n", 10);
+            printDisasmData(kinput.stubSize, kinput.stub, output, true);
         }
+        if (kinput.setup != nullptr && kinput.setupSize != 0)
+        {
+            // if kernel setup available
+            output.write("    .setup\n", 11);
+            printDisasmData(kinput.setupSize, kinput.setup, output, true);
+        }
+    }
+    
+    if (doDumpConfig)
+    {
+        const bool isGCN14 = getGPUArchitectureFromDeviceType(
+                    amdCL2Input->deviceType) >= GPUArchitecture::GCN1_4;
+        AmdCL2KernelConfig config{};
+        // get kernel config
+        if (amdCL2Input->is64BitMode)
+            config = genKernelConfig<AmdCL2Types64>(kinput.metadataSize,
+                    kinput.metadata, kinput.setupSize,
+                    (doHSAConfig ? nullptr : kinput.setup), samplerOffsets,
+                    kinput.textRelocs, isGCN14);
+        else
+            config = genKernelConfig<AmdCL2Types32>(kinput.metadataSize,
+                    kinput.metadata, kinput.setupSize,
+                    (doHSAConfig ? nullptr : kinput.setup), samplerOffsets,
+                    kinput.textRelocs, isGCN14);
         
-        if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
+        dumpAmdCL2KernelConfig(output, config, doHSAConfig);
+        if (doHSAConfig)
         {
-            // input kernel code (main disassembly)
-            isaDisassembler->clearRelocations();
-            isaDisassembler->addRelSymbol(".gdata");
-            isaDisassembler->addRelSymbol(".ddata"); // rw data
-            isaDisassembler->addRelSymbol(".bdata"); // .bss data
-            for (const AmdCL2RelaEntry& entry: kinput.textRelocs)
-                isaDisassembler->addRelocation(entry.offset, entry.type, 
-                               cxuint(entry.symbol), entry.addend);
-    
-            output.write("    .text\n", 10);
-            isaDisassembler->setInput(kinput.codeSize, kinput.code);
-            isaDisassembler->beforeDisassemble();
-            isaDisassembler->disassemble();
-            sectionCount++;
+            // print as HSA config
+            dumpAMDHSAConfig(output, maxSgprsNum, arch,
+                 *reinterpret_cast<const AmdHsaKernelConfig*>(kinput.setup));
+            output.write("    .hsaconfig\n", 15);
         }
+        
+        dumpAmdCL2ArgsAndSamplers(output, config);
+    }
+    
+    if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
+    {
+        // input kernel code (main disassembly)
+        isaDisassembler->clearRelocations();
+        isaDisassembler->addRelSymbol(".gdata");
+        isaDisassembler->addRelSymbol(".ddata"); // rw data
+        isaDisassembler->addRelSymbol(".bdata"); // .bss data
+        for (const AmdCL2RelaEntry& entry: kinput.textRelocs)
+            isaDisassembler->addRelocation(entry.offset, entry.type, 
+                           cxuint(entry.symbol), entry.addend);
+
+        output.write("    .text\n", 10);
+        isaDisassembler->setInput(kinput.codeSize, kinput.code);
+        isaDisassembler->beforeDisassemble();
+        isaDisassembler->disassemble();
+        sectionCount++;
     }
 }
+
+void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdCL2Input,
+       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+{
+    std::vector<size_t> samplerOffsets;
+    disassembleAmdCL2Global(output, amdCL2Input, samplerOffsets, flags);
+    for (const AmdCL2DisasmKernelInput& kinput: amdCL2Input->kernels)
+        disassembleAmdCL2Kernel(output, amdCL2Input, kinput, samplerOffsets,
+                    isaDisassembler, sectionCount, flags);
+}
+
+template<typename AmdCL2Types>
+static void disassembleAmdCL2StreamInt(std::ostream& output,
+        const AmdCL2DisasmInput* amdCL2Input,
+        typename AmdCL2Types::AmdCL2MainBinary& binary,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+{
+    std::vector<size_t> samplerOffsets;
+    disassembleAmdCL2Global(output, amdCL2Input, samplerOffsets, flags);
+    const size_t kernelInfosNum = binary.getKernelInfosNum();
+    if (kernelInfosNum==0)
+        return;
+    
+    AmdCL2DisasmInputBuilder<AmdCL2Types> builder(binary);
+    builder.prepareTextRelocations();
+    // only one kernel input at time
+    AmdCL2DisasmKernelInput kinput;
+    for (cxuint i = 0; i < kernelInfosNum; i++)
+    {
+        builder.getKernelInput(i, kinput);
+        disassembleAmdCL2Kernel(output, amdCL2Input, kinput, samplerOffsets,
+                    isaDisassembler, sectionCount, flags);
+        // kernel boundary: free labels and relocations, kernel info (lazy binary)
+        // and push output
+        isaDisassembler->releaseLabelsAndRelocations();
+        binary.releaseKernelInfo(i);
+        isaDisassembler->flushOutput();
+        output.flush();
+    }
+    builder.checkTextRelocations();
+}
+
+void CLRX::disassembleAmdCL2Stream(std::ostream& output,
+        const AmdCL2DisasmInput* amdCL2Input, AmdCL2MainGPUBinary32& binary,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+{
+    disassembleAmdCL2StreamInt<AmdCL2Types32>(output, amdCL2Input, binary,
+                isaDisassembler, sectionCount, flags);
+}
+
+void CLRX::disassembleAmdCL2Stream(std::ostream& output,
+        const AmdCL2DisasmInput* amdCL2Input, AmdCL2MainGPUBinary64& binary,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+{
+    disassembleAmdCL2StreamInt<AmdCL2Types64>(output, amdCL2Input, binary,
+                isaDisassembler, sectionCount, flags);
+}
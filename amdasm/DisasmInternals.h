@@ -57,6 +57,39 @@ extern CLRX_INTERNAL void disassembleAmdCL2(std::ostream& output,
         const AmdCL2DisasmInput* amdCL2Input, ISADisassembler* isaDisassembler,
         size_t& sectionCount, Flags flags);
 
+/* streaming disassembling: global input is prepared before disassembling,
+ * kernel inputs are prepared (and released) one by one while disassembling */
+
+// prepare AMD OpenCL input without kernels
+extern CLRX_INTERNAL AmdDisasmInput* getAmdDisasmGlobalInputFromBinary(
+            const AmdMainGPUBinary32& binary);
+extern CLRX_INTERNAL AmdDisasmInput* getAmdDisasmGlobalInputFromBinary(
+            const AmdMainGPUBinary64& binary);
+
+// prepare AMD OpenCL 2.0 input without kernels
+extern CLRX_INTERNAL AmdCL2DisasmInput* getAmdCL2DisasmGlobalInputFromBinary(
+            const AmdCL2MainGPUBinary32& binary, cxuint driverVersion);
+extern CLRX_INTERNAL AmdCL2DisasmInput* getAmdCL2DisasmGlobalInputFromBinary(
+            const AmdCL2MainGPUBinary64& binary, cxuint driverVersion);
+
+// disassemble Amd OpenCL 1.0 binary kernel by kernel
+// (kernel data of lazy binary is released after disassembling kernel)
+extern CLRX_INTERNAL void disassembleAmdStream(std::ostream& output,
+        const AmdDisasmInput* amdInput, AmdMainGPUBinary32& binary,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags);
+extern CLRX_INTERNAL void disassembleAmdStream(std::ostream& output,
+        const AmdDisasmInput* amdInput, AmdMainGPUBinary64& binary,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags);
+
+// disassemble Amd OpenCL 2.0 binary kernel by kernel
+// (kernel data of lazy binary is released after disassembling kernel)
+extern CLRX_INTERNAL void disassembleAmdCL2Stream(std::ostream& output,
+        const AmdCL2DisasmInput* amdCL2Input, AmdCL2MainGPUBinary32& binary,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags);
+extern CLRX_INTERNAL void disassembleAmdCL2Stream(std::ostream& output,
+        const AmdCL2DisasmInput* amdCL2Input, AmdCL2MainGPUBinary64& binary,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags);
+
 // disassemble ROCm binary input
 extern CLRX_INTERNAL void disassembleROCm(std::ostream& output,
        const ROCmDisasmInput* rocmInput, ISADisassembler* isaDisassembler,
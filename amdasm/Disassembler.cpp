@@ -40,15 +40,51 @@ DisasmException::DisasmException(const std::string& message) : Exception(message
 
 ISADisassembler::ISADisassembler(Disassembler& _disassembler, cxuint outBufSize)
         : disassembler(_disassembler), startOffset(0), labelStartOffset(0),
-          dontPrintLabelsAfterCode(false), output(outBufSize, _disassembler.getOutput())
+          dontPrintLabelsAfterCode(false), labelsOwner(this),
+          output(outBufSize, _disassembler.getOutput())
+{ }
+
+ISADisassembler::ISADisassembler(Disassembler& _disassembler, std::ostream& outStream,
+        cxuint outBufSize)
+        : disassembler(_disassembler), startOffset(0), labelStartOffset(0),
+          dontPrintLabelsAfterCode(false), labelsOwner(this),
+          output(outBufSize, outStream)
 { }
 
 ISADisassembler::~ISADisassembler()
 { }
 
+void ISADisassembler::decodeInstructions(GCNDisasmSink& sink)
+{
+    throw DisasmException("Structured disassembling is not supported");
+}
+
+GCNDisasmSink::~GCNDisasmSink()
+{ }
+
+// sink that appends records to vector
+class CLRX_INTERNAL GCNDisasmVectorSink: public GCNDisasmSink
+{
+private:
+    std::vector<GCNDisasmInsnRecord>& records;
+public:
+    explicit GCNDisasmVectorSink(std::vector<GCNDisasmInsnRecord>& _records)
+        : records(_records)
+    { }
+    void putInstruction(const GCNDisasmInsnRecord& record)
+    { records.push_back(record); }
+};
+
+void ISADisassembler::decodeInstructions(std::vector<GCNDisasmInsnRecord>& records)
+{
+    GCNDisasmVectorSink sink(records);
+    decodeInstructions(sink);
+}
+
 void ISADisassembler::writeLabelsToPosition(size_t pos, LabelIter& labelIter,
               NamedLabelIter& namedLabelIter)
 {
+    const auto& namedLabels = labelsOwner->namedLabels;
     pos += startOffset; // fix
     if ((namedLabelIter != namedLabels.end() && namedLabelIter->first <= pos) ||
             (labelIter != labels.end() && *labelIter <= pos))
@@ -143,6 +179,7 @@ void ISADisassembler::writeLabelsToPosition(size_t pos, LabelIter& labelIter,
 void ISADisassembler::writeLabelsToEnd(size_t start, LabelIter labelIter,
                    NamedLabelIter namedLabelIter)
 {
+    const auto& namedLabels = labelsOwner->namedLabels;
     size_t pos = startOffset + start;
     while (namedLabelIter != namedLabels.end() || labelIter != labels.end())
     {
@@ -205,6 +242,7 @@ void ISADisassembler::writeLabelsToEnd(size_t start, LabelIter labelIter,
 
 void ISADisassembler::writeLocation(size_t pos)
 {
+    const auto& namedLabels = labelsOwner->namedLabels;
     const auto namedLabelIt = binaryMapFind(namedLabels.begin(), namedLabels.end(), pos);
     if (namedLabelIt != namedLabels.end())
     {
@@ -235,7 +273,7 @@ bool ISADisassembler::writeRelocation(size_t pos, RelocIter& relocIter)
         (reloc.type==RELTYPE_LOW_32BIT || reloc.type==RELTYPE_HIGH_32BIT))
         output.write(1, "(");
     /// write name+value
-    output.writeString(relSymbols[reloc.symbol].c_str());
+    output.writeString(labelsOwner->relSymbols[reloc.symbol].c_str());
     char* buf = output.reserve(50);
     size_t bufPos = 0;
     if (reloc.addend != 0)
@@ -268,11 +306,79 @@ void ISADisassembler::clearNumberedLabels()
     labels.clear();
 }
 
+void ISADisassembler::releaseLabelsAndRelocations()
+{
+    // swap with empty vectors to really free memory
+    std::vector<size_t>().swap(labels);
+    std::vector<std::pair<size_t, CString> >().swap(namedLabels);
+    std::vector<CString>().swap(relSymbols);
+    std::vector<std::pair<size_t, Relocation> >().swap(relocations);
+}
+
+// sort numbered labels and remove duplicates
+static void sortLabels(std::vector<size_t>& labels)
+{
+    const size_t labelsNum = labels.size();
+    if (labelsNum < 256)
+    {
+        // too small for anything else
+        std::sort(labels.begin(), labels.end());
+        labels.resize(std::unique(labels.begin(), labels.end()) - labels.begin());
+        return;
+    }
+    size_t minLabel = SIZE_MAX, maxLabel = 0;
+    size_t labelsOr = 0;
+    for (size_t label: labels)
+    {
+        minLabel = std::min(minLabel, label);
+        maxLabel = std::max(maxLabel, label);
+        labelsOr |= label;
+    }
+    const size_t range = maxLabel - minLabel;
+    
+    // labels are jump targets, hence usually dword aligned
+    if ((labelsOr & 3) == 0 && (range>>2) < (labelsNum<<6))
+    {
+        /* dense labels: one bit per dword. bitmap is not greater than labels,
+         * sorted labels without duplicates are read by bit scanning */
+        std::vector<uint64_t> bitmap(((range>>2)>>6) + 1, 0);
+        for (size_t label: labels)
+        {
+            const size_t wordPos = (label-minLabel)>>2;
+            bitmap[wordPos>>6] |= uint64_t(1)<<(wordPos&63);
+        }
+        size_t outPos = 0;
+        for (size_t i = 0; i < bitmap.size(); i++)
+            for (uint64_t bits = bitmap[i]; bits != 0; bits &= bits-1)
+                labels[outPos++] = minLabel + (((i<<6) + CTZ64(bits))<<2);
+        labels.resize(outPos);
+        return;
+    }
+    
+    // sparse labels: LSD radix sort by bytes of (label-minLabel)
+    std::vector<size_t> temp(labelsNum);
+    for (cxuint shift = 0; shift < sizeof(size_t)*8 && (range>>shift) != 0; shift += 8)
+    {
+        size_t counts[256] = { 0 };
+        for (size_t label: labels)
+            counts[((label-minLabel)>>shift)&0xff]++;
+        size_t sum = 0;
+        for (size_t& count: counts)
+        {
+            const size_t c = count;
+            count = sum;
+            sum += c;
+        }
+        for (size_t label: labels)
+            temp[counts[((label-minLabel)>>shift)&0xff]++] = label;
+        labels.swap(temp);
+    }
+    labels.resize(std::unique(labels.begin(), labels.end()) - labels.begin());
+}
+
 void ISADisassembler::prepareLabelsAndRelocations()
 {
-    std::sort(labels.begin(), labels.end());
-    const auto newEnd = std::unique(labels.begin(), labels.end());
-    labels.resize(newEnd-labels.begin());
+    sortLabels(labels);
     mapSort(namedLabels.begin(), namedLabels.end());
     mapSort(relocations.begin(), relocations.end());
 }
@@ -286,41 +392,124 @@ void ISADisassembler::beforeDisassemble()
 
 Disassembler::Disassembler(const AmdMainGPUBinary32& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
+    if ((flags & DISASM_STREAMING) != 0)
+        throw DisasmException("Streaming disassembling requires non-const binary");
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary32(binary, flags);
 }
 
+Disassembler::Disassembler(AmdMainGPUBinary32& binary, std::ostream& _output,
+            Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
+            amdInput(nullptr), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    if ((flags & DISASM_STREAMING) != 0)
+    {
+        // kernel inputs will be prepared during disassembling
+        amdBinary32 = &binary;
+        streamKernels = true;
+        amdInput = getAmdDisasmGlobalInputFromBinary(binary);
+    }
+    else
+        amdInput = getAmdDisasmInputFromBinary32(binary, flags);
+}
+
 Disassembler::Disassembler(const AmdMainGPUBinary64& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
+    if ((flags & DISASM_STREAMING) != 0)
+        throw DisasmException("Streaming disassembling requires non-const binary");
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary64(binary, flags);
 }
 
+Disassembler::Disassembler(AmdMainGPUBinary64& binary, std::ostream& _output,
+            Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
+            amdInput(nullptr), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    if ((flags & DISASM_STREAMING) != 0)
+    {
+        // kernel inputs will be prepared during disassembling
+        amdBinary64 = &binary;
+        streamKernels = true;
+        amdInput = getAmdDisasmGlobalInputFromBinary(binary);
+    }
+    else
+        amdInput = getAmdDisasmInputFromBinary64(binary, flags);
+}
+
 Disassembler::Disassembler(const AmdCL2MainGPUBinary32& binary, std::ostream& _output,
            Flags _flags, cxuint driverVersion) : fromBinary(true),
-            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr), output(_output),
-            flags(_flags), sectionCount(0)
+            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr),
+            amdBinary32(nullptr), streamKernels(false), output(_output), flags(_flags),
+            sectionCount(0), threadsNum(1)
 {
+    if ((flags & DISASM_STREAMING) != 0)
+        throw DisasmException("Streaming disassembling requires non-const binary");
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdCL2Input = getAmdCL2DisasmInputFromBinary32(binary, driverVersion);
 }
 
+Disassembler::Disassembler(AmdCL2MainGPUBinary32& binary, std::ostream& _output,
+           Flags _flags, cxuint driverVersion) : fromBinary(true),
+            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr),
+            amdBinary32(nullptr), streamKernels(false), output(_output), flags(_flags),
+            sectionCount(0), threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    if ((flags & DISASM_STREAMING) != 0)
+    {
+        // kernel inputs will be prepared during disassembling
+        amdCL2Binary32 = &binary;
+        streamKernels = true;
+        amdCL2Input = getAmdCL2DisasmGlobalInputFromBinary(binary, driverVersion);
+    }
+    else
+        amdCL2Input = getAmdCL2DisasmInputFromBinary32(binary, driverVersion);
+}
+
 Disassembler::Disassembler(const AmdCL2MainGPUBinary64& binary, std::ostream& _output,
            Flags _flags, cxuint driverVersion) : fromBinary(true),
-            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr), output(_output),
-            flags(_flags), sectionCount(0)
+            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr),
+            amdBinary32(nullptr), streamKernels(false), output(_output), flags(_flags),
+            sectionCount(0), threadsNum(1)
 {
+    if ((flags & DISASM_STREAMING) != 0)
+        throw DisasmException("Streaming disassembling requires non-const binary");
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdCL2Input = getAmdCL2DisasmInputFromBinary64(binary, driverVersion);
 }
 
+Disassembler::Disassembler(AmdCL2MainGPUBinary64& binary, std::ostream& _output,
+           Flags _flags, cxuint driverVersion) : fromBinary(true),
+            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr),
+            amdBinary32(nullptr), streamKernels(false), output(_output), flags(_flags),
+            sectionCount(0), threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    if ((flags & DISASM_STREAMING) != 0)
+    {
+        // kernel inputs will be prepared during disassembling
+        amdCL2Binary64 = &binary;
+        streamKernels = true;
+        amdCL2Input = getAmdCL2DisasmGlobalInputFromBinary(binary, driverVersion);
+    }
+    else
+        amdCL2Input = getAmdCL2DisasmInputFromBinary64(binary, driverVersion);
+}
+
 Disassembler::Disassembler(const ROCmBinary& binary, std::ostream& _output, Flags _flags)
          : fromBinary(true), binaryFormat(BinaryFormat::ROCM),
-           rocmInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+           rocmInput(nullptr), amdBinary32(nullptr), streamKernels(false),
+           output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     rocmInput = getROCmDisasmInputFromBinary(binary);
@@ -328,21 +517,24 @@ Disassembler::Disassembler(const ROCmBinary& binary, std::ostream& _output, Flag
 
 Disassembler::Disassembler(const AmdDisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMD),
-            amdInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdInput(disasmInput), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
 
 Disassembler::Disassembler(const AmdCL2DisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMDCL2),
-            amdCL2Input(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdCL2Input(disasmInput), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
 
 Disassembler::Disassembler(const ROCmDisasmInput* disasmInput, std::ostream& _output,
                  Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::ROCM),
-            rocmInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            rocmInput(disasmInput), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -350,7 +542,8 @@ Disassembler::Disassembler(const ROCmDisasmInput* disasmInput, std::ostream& _ou
 Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary,
            std::ostream& _output, Flags _flags, cxuint llvmVersion) :
            fromBinary(true), binaryFormat(BinaryFormat::GALLIUM),
-           galliumInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+           galliumInput(nullptr), amdBinary32(nullptr), streamKernels(false),
+           output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     galliumInput = getGalliumDisasmInputFromBinary(deviceType, binary, llvmVersion);
@@ -358,7 +551,8 @@ Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary
 
 Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream& _output,
              Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::GALLIUM),
-            galliumInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            galliumInput(disasmInput), amdBinary32(nullptr), streamKernels(false),
+            output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -366,7 +560,8 @@ Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream&
 Disassembler::Disassembler(GPUDeviceType deviceType, size_t rawCodeSize,
            const cxbyte* rawCode, std::ostream& _output, Flags _flags)
        : fromBinary(true), binaryFormat(BinaryFormat::RAWCODE),
-         output(_output), flags(_flags), sectionCount(0)
+         amdBinary32(nullptr), streamKernels(false), output(_output), flags(_flags),
+         sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     rawInput = new RawCodeInput{ deviceType, rawCodeSize, rawCode };
@@ -624,11 +819,26 @@ void Disassembler::disassemble()
     switch(binaryFormat)
     {
         case BinaryFormat::AMD:
-            disassembleAmd(output, amdInput, isaDisassembler.get(), sectionCount, flags);
+            if (!streamKernels)
+                disassembleAmd(output, amdInput, isaDisassembler.get(),
+                               sectionCount, flags);
+            else if (amdInput->is64BitMode)
+                disassembleAmdStream(output, amdInput, *amdBinary64,
+                               isaDisassembler.get(), sectionCount, flags);
+            else
+                disassembleAmdStream(output, amdInput, *amdBinary32,
+                               isaDisassembler.get(), sectionCount, flags);
             break;
         case BinaryFormat::AMDCL2:
-            disassembleAmdCL2(output, amdCL2Input, isaDisassembler.get(),
+            if (!streamKernels)
+                disassembleAmdCL2(output, amdCL2Input, isaDisassembler.get(),
                               sectionCount, flags);
+            else if (amdCL2Input->is64BitMode)
+                disassembleAmdCL2Stream(output, amdCL2Input, *amdCL2Binary64,
+                              isaDisassembler.get(), sectionCount, flags);
+            else
+                disassembleAmdCL2Stream(output, amdCL2Input, *amdCL2Binary32,
+                              isaDisassembler.get(), sectionCount, flags);
             break;
         case BinaryFormat::ROCM:
             disassembleROCm(output, rocmInput, isaDisassembler.get(), flags);
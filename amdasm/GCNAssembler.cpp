@@ -30,91 +30,17 @@
 
 using namespace CLRX;
 
-static OnceFlag clrxGCNAssemblerOnceFlag;
-static Array<GCNAsmInstruction> gcnInstrSortedTable;
-
-static void initializeGCNAssembler()
+// find slot for mnemonic (without suffix), returns null if not found
+static inline const GCNMnemonicSlot* findGCNMnemonicSlot(const char* name, size_t length)
 {
-    size_t tableSize = 0;
-    while (gcnInstrsTable[tableSize].mnemonic!=nullptr)
-        tableSize++;
-    gcnInstrSortedTable.resize(tableSize);
-    for (cxuint i = 0; i < tableSize; i++)
-    {
-        const GCNInstruction& insn = gcnInstrsTable[i];
-        gcnInstrSortedTable[i] = {insn.mnemonic, insn.encoding, insn.mode,
-                    insn.code, UINT16_MAX, insn.archMask};
-    }
-    
-    // sort GCN instruction table by mnemonic, encoding and architecture
-    std::sort(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-            [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-            {
-                // compare mnemonic and if mnemonic
-                int r = ::strcmp(instr1.mnemonic, instr2.mnemonic);
-                return (r < 0) || (r==0 && instr1.encoding < instr2.encoding) ||
-                            (r == 0 && instr1.encoding == instr2.encoding &&
-                             instr1.archMask < instr2.archMask);
-            });
-    
-    cxuint j = 0;
-    std::unique_ptr<uint16_t[]> oldArchMasks(new uint16_t[tableSize]);
-    /* join VOP3A instr with VOP2/VOPC/VOP1 instr together to faster encoding. */
-    for (cxuint i = 0; i < tableSize; i++)
-    {
-        GCNAsmInstruction insn = gcnInstrSortedTable[i];
-        if (insn.encoding == GCNENC_VOP3A || insn.encoding == GCNENC_VOP3B)
-        {
-            // check duplicates
-            cxuint k = j-1;
-            while (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                    (oldArchMasks[k] & insn.archMask)!=insn.archMask) k--;
-            
-            if (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                (oldArchMasks[k] & insn.archMask)==insn.archMask)
-            {
-                // we found duplicate, we apply
-                if (gcnInstrSortedTable[k].code2==UINT16_MAX)
-                {
-                    // if second slot for opcode is not filled
-                    gcnInstrSortedTable[k].code2 = insn.code1;
-                    gcnInstrSortedTable[k].archMask = oldArchMasks[k] & insn.archMask;
-                }
-                else
-                {
-                    // if filled we create new entry
-                    oldArchMasks[j] = gcnInstrSortedTable[j].archMask;
-                    gcnInstrSortedTable[j] = gcnInstrSortedTable[k];
-                    gcnInstrSortedTable[j].archMask = oldArchMasks[k] & insn.archMask;
-                    gcnInstrSortedTable[j++].code2 = insn.code1;
-                }
-            }
-            else // not found
-            {
-                oldArchMasks[j] = insn.archMask;
-                gcnInstrSortedTable[j++] = insn;
-            }
-        }
-        else if (insn.encoding == GCNENC_VINTRP)
-        {
-            // check duplicates
-            cxuint k = j-1;
-            oldArchMasks[j] = insn.archMask;
-            gcnInstrSortedTable[j++] = insn;
-            while (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                    gcnInstrSortedTable[k].encoding!=GCNENC_VOP3A) k--;
-            if (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                gcnInstrSortedTable[k].encoding==GCNENC_VOP3A)
-                // we found VINTRP duplicate, set up second code (VINTRP)
-                gcnInstrSortedTable[k].code2 = insn.code1;
-        }
-        else // normal instruction
-        {
-            oldArchMasks[j] = insn.archMask;
-            gcnInstrSortedTable[j++] = insn;
-        }
-    }
-    gcnInstrSortedTable.resize(j); // final size
+    const uint64_t hash = gcnMnemonicHash(name, length);
+    const uint32_t disp = gcnMnemonicDisps[(hash>>32) % gcnMnemonicDispsNum];
+    const GCNMnemonicSlot& slot = gcnMnemonicSlots[
+                gcnMnemonicSlotIndex(hash, disp, gcnMnemonicSlotsMask)];
+    if (slot.mnemonic == nullptr || slot.length != length ||
+        ::memcmp(slot.mnemonic, name, length) != 0)
+        return nullptr;
+    return &slot;
 }
 
 // GCN Usage handler
@@ -353,9 +279,7 @@ void GCNUsageHandler::getUsageDependencies(cxuint rvusNum, const AsmRegVarUsage*
 GCNAssembler::GCNAssembler(Assembler& assembler): ISAAssembler(assembler),
         regs({0, 0}), curArchMask(1U<<cxuint(
                     getGPUArchitectureFromDeviceType(assembler.getDeviceType())))
-{
-    callOnce(clrxGCNAssemblerOnceFlag, initializeGCNAssembler);
-}
+{ }
 
 GCNAssembler::~GCNAssembler()
 { }
@@ -3851,55 +3775,46 @@ void GCNAssembler::assemble(const CString& inMnemonic, const char* mnemPlace,
             const char* linePtr, const char* lineEnd, std::vector<cxbyte>& output,
             ISAUsageHandler* usageHandler)
 {
-    CString mnemonic;
     size_t inMnemLen = inMnemonic.size();
+    size_t mnemLen = inMnemLen;
     GCNEncSize gcnEncSize = GCNEncSize::UNKNOWN;
     GCNVOPEnc vopEnc = GCNVOPEnc::NORMAL;
     // checking encoding suffixes (_e64, _e32,_dpp, _sdwa)
     if (inMnemLen>4 && ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e64")==0)
     {
         gcnEncSize = GCNEncSize::BIT64;
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     }
     else if (inMnemLen>4 && ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e32")==0)
     {
         gcnEncSize = GCNEncSize::BIT32;
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     }
     else if (inMnemLen>6 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_dpp")==0)
     {
         vopEnc = GCNVOPEnc::DPP;
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     }
     else if (inMnemLen>7 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-5, "_sdwa")==0)
     {
         vopEnc = GCNVOPEnc::SDWA;
-        mnemonic = inMnemonic.substr(0, inMnemLen-5);
+        mnemLen = inMnemLen-5;
     }
-    else
-        mnemonic = inMnemonic;
-    
-    // find instruction by mnemonic
-    auto it = binaryFind(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-               GCNAsmInstruction{mnemonic.c_str()},
-               [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-               { return ::strcmp(instr1.mnemonic, instr2.mnemonic)<0; });
-    
-    // find matched entry
-    if (it != gcnInstrSortedTable.end() && (it->archMask & curArchMask)==0)
-        // if not match current arch mask
-        for (++it ;it != gcnInstrSortedTable.end() &&
-               ::strcmp(it->mnemonic, mnemonic.c_str())==0 &&
-               (it->archMask & curArchMask)==0; ++it);
-
-    if (it == gcnInstrSortedTable.end() || ::strcmp(it->mnemonic, mnemonic.c_str())!=0)
+    
+    // find instruction by mnemonic (without suffix) in perfect hash index
+    const GCNMnemonicSlot* slot = findGCNMnemonicSlot(inMnemonic.c_str(), mnemLen);
+    // get entry for current architecture
+    const uint16_t insnIndex = (slot != nullptr) ?
+            slot->archIndices[31-CLZ32(curArchMask)] : UINT16_MAX;
+    if (insnIndex == UINT16_MAX)
     {
         // unrecognized mnemonic
         printError(mnemPlace, "Unknown instruction");
         return;
     }
+    const GCNAsmInstruction* it = gcnInstrSortedTable + insnIndex;
     
     resetInstrRVUs();
     setCurrentRVU(0);
@@ -4118,26 +4033,21 @@ bool GCNAssembler::resolveCode(const AsmSourcePos& sourcePos, cxuint targetSecti
 // check whether name is mnemonic (currently unused anywhere)
 bool GCNAssembler::checkMnemonic(const CString& inMnemonic) const
 {
-    CString mnemonic;
     size_t inMnemLen = inMnemonic.size();
+    size_t mnemLen = inMnemLen;
     // checking for encoding suffixes
     if (inMnemLen>4 &&
         (::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e64")==0 ||
             ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e32")==0))
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     else if (inMnemLen>6 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_dpp")==0)
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     else if (inMnemLen>7 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-5, "_sdwa")==0)
-        mnemonic = inMnemonic.substr(0, inMnemLen-5);
-    else
-        mnemonic = inMnemonic;
+        mnemLen = inMnemLen-5;
     
-    return std::binary_search(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-               GCNAsmInstruction{mnemonic.c_str()},
-               [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-               { return ::strcmp(instr1.mnemonic, instr2.mnemonic)<0; });
+    return findGCNMnemonicSlot(inMnemonic.c_str(), mnemLen) != nullptr;
 }
 
 void GCNAssembler::setAllocatedRegisters(const cxuint* inRegs, Flags inRegFlags)
@@ -4226,134 +4136,13 @@ bool GCNAssembler::parseRegisterType(const char*& linePtr, const char* end, cxui
     return false;
 }
 
-static const bool gcnSize11Table[16] =
-{
-    false, // GCNENC_SMRD, // 0000
-    false, // GCNENC_SMRD, // 0001
-    false, // GCNENC_VINTRP, // 0010
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_NONE, // 0101 - illegal
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    true,  // GCNENC_EXP,   // 1110
-    false // GCNENC_NONE   // 1111 - illegal
-};
-
-static const bool gcnSize12Table[16] =
-{
-    true,  // GCNENC_SMEM, // 0000
-    true,  // GCNENC_EXP, // 0001
-    false, // GCNENC_NONE, // 0010 - illegal
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_VINTRP, // 0101
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    false, // GCNENC_NONE,  // 1110 - illegal
-    false // GCNENC_NONE   // 1111 - illegal
-};
-
 // get instruction size, used by register allocation to skip instruction
 size_t GCNAssembler::getInstructionSize(size_t codeSize, const cxbyte* code) const
 {
     if (codeSize < 4)
         return 0; // no instruction
-    bool isGCN11 = (curArchMask & ARCH_RX2X0)!=0;
-    bool isGCN12 = (curArchMask & ARCH_GCN_1_2_4)!=0;
     const uint32_t insnCode = ULEV(*reinterpret_cast<const uint32_t*>(code));
-    uint32_t words = 1;
-    if ((insnCode & 0x80000000U) != 0)
-    {
-        if ((insnCode & 0x40000000U) == 0)
-        {
-            // SOP???
-            if  ((insnCode & 0x30000000U) == 0x30000000U)
-            {
-                // SOP1/SOPK/SOPC/SOPP
-                const uint32_t encPart = (insnCode & 0x0f800000U);
-                if (encPart == 0x0e800000U)
-                {
-                    // SOP1
-                    if ((insnCode&0xff) == 0xff) // literal
-                        words++;
-                }
-                else if (encPart == 0x0f000000U)
-                {
-                    // SOPC
-                    if ((insnCode&0xff) == 0xff ||
-                        (insnCode&0xff00) == 0xff00) // literal
-                        words++;
-                }
-                else if (encPart != 0x0f800000U)
-                {
-                    // SOPK
-                    const cxuint opcode = (insnCode>>23)&0x1f;
-                    if ((!isGCN12 && opcode == 21) ||
-                        (isGCN12 && opcode == 20))
-                        words++; // additional literal
-                }
-            }
-            else
-            {
-                // SOP2
-                if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                    words++;  // literal
-            }
-        }
-        else
-        {
-            // SMRD and others
-            const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-            if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                (isGCN12 && gcnSize12Table[encPart]))
-                words++;
-        }
-    }
-    else
-    {
-        // some vector instructions
-        if ((insnCode & 0x7e000000U) == 0x7c000000U)
-        {
-            // VOPC
-            if ((insnCode&0x1ff) == 0xff || // literal
-                // SDWA, DDP
-                (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                words++;
-        }
-        else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-        {
-            // VOP1
-            if ((insnCode&0x1ff) == 0xff || // literal
-                // SDWA, DDP
-                (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                words++;
-        }
-        else
-        {
-            // VOP2
-            const cxuint opcode = (insnCode >> 25)&0x3f;
-            if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
-                (isGCN12 && (opcode == 23 || opcode == 24 ||
-                opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                words++;  // inline 32-bit constant
-            else if ((insnCode&0x1ff) == 0xff || // literal
-                // SDWA, DDP
-                (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                words++;  // literal
-        }
-    }
-    return words<<2;
+    const GCNInsnSizeEntry& sizeEntry =
+            gcnInsnSizeTables[31-CLZ32(curArchMask)][insnCode>>23];
+    return getGCNInsnWordsNum(sizeEntry, insnCode)<<2;
 }
@@ -23,6 +23,8 @@
 #include <cstring>
 #include <mutex>
 #include <memory>
+#include <sstream>
+#include <thread>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/GPUId.h>
 #include <CLRX/amdasm/Disassembler.h>
@@ -126,16 +128,6 @@ struct CLRX_INTERNAL GCNDisasmUtils
 
 using namespace CLRX;
 
-static OnceFlag clrxGCNDisasmOnceFlag;
-static std::unique_ptr<GCNInstruction[]> gcnInstrTableByCode = nullptr;
-
-// GCN encoding space
-struct CLRX_INTERNAL GCNEncodingSpace
-{
-    cxuint offset;  // first position instrunctions list
-    cxuint instrsNum;   // instruction list
-};
-
 // encoding names table
 static const char* gcnEncodingNames[GCNENC_MAXVAL+1] =
 {
@@ -143,174 +135,32 @@ static const char* gcnEncodingNames[GCNENC_MAXVAL+1] =
     "VOP3A", "VOP3B", "VINTRP", "DS", "MUBUF", "MTBUF", "MIMG", "EXP", "FLAT"
 };
 
-// table hold of GNC encoding regions in main instruction list
-// instruciton position is sum of encoding offset and instruction opcode
-static const GCNEncodingSpace gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3+2] =
-{
-    { 0, 0 },
-    { 0, 0x80 }, /* GCNENC_SOPC, opcode = (7bit)<<16 */
-    { 0x0080, 0x80 }, /* GCNENC_SOPP, opcode = (7bit)<<16 */
-    { 0x0100, 0x100 }, /* GCNENC_SOP1, opcode = (8bit)<<8 */
-    { 0x0200, 0x80 }, /* GCNENC_SOP2, opcode = (7bit)<<23 */
-    { 0x0280, 0x20 }, /* GCNENC_SOPK, opcode = (5bit)<<23 */
-    { 0x02a0, 0x40 }, /* GCNENC_SMRD, opcode = (6bit)<<22 */
-    { 0x02e0, 0x100 }, /* GCNENC_VOPC, opcode = (8bit)<<27 */
-    { 0x03e0, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 */
-    { 0x04e0, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 */
-    { 0x0520, 0x200 }, /* GCNENC_VOP3A, opcode = (9bit)<<17 */
-    { 0x0520, 0x200 }, /* GCNENC_VOP3B, opcode = (9bit)<<17 */
-    { 0x0720, 0x4 }, /* GCNENC_VINTRP, opcode = (2bit)<<16 */
-    { 0x0724, 0x100 }, /* GCNENC_DS, opcode = (8bit)<<18 */
-    { 0x0824, 0x80 }, /* GCNENC_MUBUF, opcode = (7bit)<<18 */
-    { 0x08a4, 0x8 }, /* GCNENC_MTBUF, opcode = (3bit)<<16 */
-    { 0x08ac, 0x80 }, /* GCNENC_MIMG, opcode = (7bit)<<18 */
-    { 0x092c, 0x1 }, /* GCNENC_EXP, opcode = none */
-    { 0x092d, 0x80 }, /* GCNENC_FLAT, opcode = (8bit)<<18 (???8bit) */
-    { 0x09ad, 0x200 }, /* GCNENC_VOP3A, opcode = (9bit)<<17 (GCN1.1) */
-    { 0x09ad, 0x200 },  /* GCNENC_VOP3B, opcode = (9bit)<<17 (GCN1.1) */
-    { 0x0bad, 0x0 },
-    { 0x0bad, 0x80 }, /* GCNENC_SOPC, opcode = (7bit)<<16 (GCN1.2) */
-    { 0x0c2d, 0x80 }, /* GCNENC_SOPP, opcode = (7bit)<<16 (GCN1.2) */
-    { 0x0cad, 0x100 }, /* GCNENC_SOP1, opcode = (8bit)<<8 (GCN1.2) */
-    { 0x0dad, 0x80 }, /* GCNENC_SOP2, opcode = (7bit)<<23 (GCN1.2) */
-    { 0x0e2d, 0x20 }, /* GCNENC_SOPK, opcode = (5bit)<<23 (GCN1.2) */
-    { 0x0e4d, 0x100 }, /* GCNENC_SMEM, opcode = (8bit)<<18 (GCN1.2) */
-    { 0x0f4d, 0x100 }, /* GCNENC_VOPC, opcode = (8bit)<<27 (GCN1.2) */
-    { 0x104d, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 (GCN1.2) */
-    { 0x114d, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 (GCN1.2) */
-    { 0x118d, 0x400 }, /* GCNENC_VOP3A, opcode = (10bit)<<16 (GCN1.2) */
-    { 0x118d, 0x400 }, /* GCNENC_VOP3B, opcode = (10bit)<<16 (GCN1.2) */
-    { 0x158d, 0x4 }, /* GCNENC_VINTRP, opcode = (2bit)<<16 (GCN1.2) */
-    { 0x1591, 0x100 }, /* GCNENC_DS, opcode = (8bit)<<18 (GCN1.2) */
-    { 0x1691, 0x80 }, /* GCNENC_MUBUF, opcode = (7bit)<<18 (GCN1.2) */
-    { 0x1711, 0x10 }, /* GCNENC_MTBUF, opcode = (4bit)<<16 (GCN1.2) */
-    { 0x1721, 0x80 }, /* GCNENC_MIMG, opcode = (7bit)<<18 (GCN1.2) */
-    { 0x17a1, 0x1 }, /* GCNENC_EXP, opcode = none (GCN1.2) */
-    { 0x17a2, 0x80 }, /* GCNENC_FLAT, opcode = (8bit)<<18 (???8bit) */
-    { 0x1822, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 (RXVEGA) */
-    { 0x1862, 0x400 }, /* GCNENC_VOP3B, opcode = (10bit)<<17  (RXVEGA) */
-    { 0x1c62, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 (RXVEGA) */
-    { 0x1d62, 0x80 }, /* GCNENC_FLAT_SCRATCH, opcode = (8bit)<<18 (???8bit) RXVEGA */
-    { 0x1de2, 0x80 }  /* GCNENC_FLAT_GLOBAL, opcode = (8bit)<<18 (???8bit) RXVEGA */
-};
-
-// total instruction table length
-static const size_t gcnInstrTableByCodeLength = 0x1e62;
-
-// create main instruction table
-static void initializeGCNDisassembler()
-{
-    gcnInstrTableByCode.reset(new GCNInstruction[gcnInstrTableByCodeLength]);
-    for (cxuint i = 0; i < gcnInstrTableByCodeLength; i++)
-    {
-        gcnInstrTableByCode[i].mnemonic = nullptr;
-        gcnInstrTableByCode[i].mode = GCN_STDMODE;
-        // except VOP3 decoding routines ignores encoding (we can set None for encoding)
-        gcnInstrTableByCode[i].encoding = GCNENC_NONE;
-    }
-    
-    // fill up main instruction table
-    for (cxuint i = 0; gcnInstrsTable[i].mnemonic != nullptr; i++)
-    {
-        const GCNInstruction& instr = gcnInstrsTable[i];
-        const GCNEncodingSpace& encSpace = gcnInstrTableByCodeSpaces[instr.encoding];
-        if ((instr.archMask & ARCH_GCN_1_0_1) != 0)
-        {
-            if (gcnInstrTableByCode[encSpace.offset + instr.code].mnemonic == nullptr)
-                gcnInstrTableByCode[encSpace.offset + instr.code] = instr;
-            else if((instr.archMask & ARCH_RX2X0) != 0)
-            {
-                /* otherwise we for GCN1.1 */
-                const GCNEncodingSpace& encSpace2 =
-                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
-                gcnInstrTableByCode[encSpace2.offset + instr.code] = instr;
-            }
-            // otherwise we ignore this entry
-        }
-        if ((instr.archMask & ARCH_GCN_1_2_4) != 0)
-        {
-            // for GCN 1.2/1.4
-            const GCNEncodingSpace& encSpace3 = gcnInstrTableByCodeSpaces[
-                        GCNENC_MAXVAL+3+instr.encoding];
-            if (gcnInstrTableByCode[encSpace3.offset + instr.code].mnemonic == nullptr)
-                gcnInstrTableByCode[encSpace3.offset + instr.code] = instr;
-            else if((instr.archMask & ARCH_RXVEGA) != 0 &&
-                (instr.encoding == GCNENC_VOP2 || instr.encoding == GCNENC_VOP1 ||
-                instr.encoding == GCNENC_VOP3A || instr.encoding == GCNENC_VOP3B))
-            {
-                /* otherwise we for GCN1.4 */
-                const bool encNoVOP2 = instr.encoding != GCNENC_VOP2;
-                const bool encVOP1 = instr.encoding == GCNENC_VOP1;
-                // choose FLAT_GLOBAL or FLAT_SCRATCH space
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 + encNoVOP2 + encVOP1];
-                gcnInstrTableByCode[encSpace4.offset + instr.code] = instr;
-            }
-            else if((instr.archMask & ARCH_RXVEGA) != 0 &&
-                instr.encoding == GCNENC_FLAT && (instr.mode & GCN_FLAT_MODEMASK) != 0)
-            {
-                /* FLAT SCRATCH and GLOBAL instructions */
-                const cxuint encFlatMode = (instr.mode & GCN_FLAT_MODEMASK)-1;
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 + encFlatMode];
-                gcnInstrTableByCode[encSpace4.offset + instr.code] = instr;
-            }
-            // otherwise we ignore this entry
-        }
-    }
-}
-
 GCNDisassembler::GCNDisassembler(Disassembler& disassembler)
         : ISADisassembler(disassembler), instrOutOfCode(false)
-{
-    callOnce(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
-}
+{ }
+
+GCNDisassembler::GCNDisassembler(Disassembler& disassembler, std::ostream& outStream)
+        : ISADisassembler(disassembler, outStream), instrOutOfCode(false)
+{ }
 
 GCNDisassembler::~GCNDisassembler()
 { }
 
-// gcn encoding sizes table: true - if 8 byte encoding, false - 4 byte encoding
-// for GCN1.0/1.1
-static const bool gcnSize11Table[16] =
+// returns true if SOPP instruction is jump (to relative address)
+static inline bool isGCNSOPPJump(cxuint opcode, bool isGCN11, bool isGCN12)
 {
-    false, // GCNENC_SMRD, // 0000
-    false, // GCNENC_SMRD, // 0001
-    false, // GCNENC_VINTRP, // 0010
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_NONE, // 0101 - illegal
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    true,  // GCNENC_EXP,   // 1110
-    false // GCNENC_NONE   // 1111 - illegal
-};
+    return opcode == 2 || (opcode >= 4 && opcode <= 9) ||
+        // GCN1.1 and GCN1.2 opcodes
+        ((isGCN11 || isGCN12) && (opcode >= 23 && opcode <= 26));
+}
 
-// for GCN1.2/1.4
-static const bool gcnSize12Table[16] =
+// returns true if SOPK instruction is jump (branch fork or call)
+static inline bool isGCNSOPKJump(cxuint opcode, bool isGCN12, bool isGCN14)
 {
-    true,  // GCNENC_SMEM, // 0000
-    true,  // GCNENC_EXP, // 0001
-    false, // GCNENC_NONE, // 0010 - illegal
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_VINTRP, // 0101
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    false, // GCNENC_NONE,  // 1110 - illegal
-    false // GCNENC_NONE   // 1111 - illegal
-};
+    return (!isGCN12 && opcode == 17) ||
+        (isGCN12 && opcode == 16) || // if branch fork
+        (isGCN14 && opcode == 21); // if s_call_b64
+}
 
 void GCNDisassembler::analyzeBeforeDisassemble()
 {
@@ -322,153 +172,50 @@ void GCNDisassembler::analyzeBeforeDisassemble()
     const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
     const bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
     const bool isGCN14 = (arch == GPUArchitecture::GCN1_4);
+    const GCNInsnSizeEntry* sizeTable = gcnInsnSizeTables[cxuint(arch)];
+    
+    // determine chunk size for parallel disassembling
+    chunkStarts.clear();
+    size_t chunkWords = SIZE_MAX;
+    cxuint threadsNum = disassembler.getThreadsNum();
+    if (threadsNum == 0)
+        threadsNum = std::max(std::thread::hardware_concurrency(), 1U);
+    if (threadsNum > 1)
+        // 4 chunks per thread to balance work, but not smaller than minimal size
+        chunkWords = std::max(codeWordsNum / (threadsNum*4), size_t(8192));
+    size_t nextChunkPos = 0;
+    
     size_t pos;
     for (pos = 0; pos < codeWordsNum; pos++)
     {
         /* scan all instructions and get jump addresses */
         const uint32_t insnCode = ULEV(codeWords[pos]);
-        if ((insnCode & 0x80000000U) != 0)
+        // chunk can not begin at zero word, because zeroes are grouped in '.fill'
+        if (pos >= nextChunkPos && insnCode != 0)
         {
-            if ((insnCode & 0x40000000U) == 0)
-            {
-                // SOP???
-                if  ((insnCode & 0x30000000U) == 0x30000000U)
-                {
-                    // SOP1/SOPK/SOPC/SOPP
-                    const uint32_t encPart = (insnCode & 0x0f800000U);
-                    if (encPart == 0x0e800000U)
-                    {
-                        // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                            pos++;
-                    }
-                    else if (encPart == 0x0f000000U)
-                    {
-                        // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                            pos++;
-                    }
-                    else if (encPart == 0x0f800000U)
-                    {
-                        // SOPP
-                        const cxuint opcode = (insnCode>>16)&0x7f;
-                        if (opcode == 2 || (opcode >= 4 && opcode <= 9) ||
-                            // GCN1.1 and GCN1.2 opcodes
-                            ((isGCN11 || isGCN12) &&
-                                    (opcode >= 23 && opcode <= 26))) // if jump
-                            labels.push_back(startOffset +
-                                    ((pos+int16_t(insnCode&0xffff)+1)<<2));
-                    }
-                    else
-                    {
-                        // SOPK
-                        const cxuint opcode = (insnCode>>23)&0x1f;
-                        if ((!isGCN12 && opcode == 17) ||
-                            (isGCN12 && opcode == 16) || // if branch fork
-                            (isGCN14 && opcode == 21)) // if s_call_b64
-                            labels.push_back(startOffset +
-                                    ((pos+int16_t(insnCode&0xffff)+1)<<2));
-                        else if ((!isGCN12 && opcode == 21) ||
-                            (isGCN12 && opcode == 20))
-                            pos++; // additional literal
-                    }
-                }
-                else
-                {
-                    // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                        pos++;  // literal
-                }
-            }
-            else
-            {
-                // SMRD and others
-                const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN12 && gcnSize12Table[encPart]))
-                    pos++;
-            }
+            chunkStarts.push_back(pos);
+            nextChunkPos = (chunkWords != SIZE_MAX) ? pos + chunkWords : SIZE_MAX;
         }
-        else
+        const GCNInsnSizeEntry& sizeEntry = sizeTable[insnCode>>23];
+        if (sizeEntry.encoding == GCNENC_SOPP)
         {
-            // some vector instructions
-            if ((insnCode & 0x7e000000U) == 0x7c000000U)
-            {
-                // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
-            }
-            else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-            {
-                // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
-            }
-            else
-            {
-                // VOP2
-                const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
-                    (isGCN12 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                    pos++;  // inline 32-bit constant
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;  // literal
-            }
+            if (isGCNSOPPJump((insnCode>>16)&0x7f, isGCN11, isGCN12))
+                labels.push_back(startOffset +
+                        ((pos+int16_t(insnCode&0xffff)+1)<<2));
         }
+        else if (sizeEntry.encoding == GCNENC_SOPK)
+        {
+            if (isGCNSOPKJump((insnCode>>23)&0x1f, isGCN12, isGCN14))
+                labels.push_back(startOffset +
+                        ((pos+int16_t(insnCode&0xffff)+1)<<2));
+        }
+        // skip literal or second dword
+        pos += getGCNInsnWordsNum(sizeEntry, insnCode)-1;
     }
     
     instrOutOfCode = (pos != codeWordsNum);
 }
 
-static const cxbyte gcnEncoding11Table[16] =
-{
-    GCNENC_SMRD, // 0000
-    GCNENC_SMRD, // 0001
-    GCNENC_VINTRP, // 0010
-    GCNENC_NONE, // 0011 - illegal
-    GCNENC_VOP3A, // 0100
-    GCNENC_NONE, // 0101 - illegal
-    GCNENC_DS,   // 0110
-    GCNENC_FLAT, // 0111
-    GCNENC_MUBUF, // 1000
-    GCNENC_NONE,  // 1001 - illegal
-    GCNENC_MTBUF, // 1010
-    GCNENC_NONE,  // 1011 - illegal
-    GCNENC_MIMG,  // 1100
-    GCNENC_NONE,  // 1101 - illegal
-    GCNENC_EXP,   // 1110
-    GCNENC_NONE   // 1111 - illegal
-};
-
-static const cxbyte gcnEncoding12Table[16] =
-{
-    GCNENC_SMEM, // 0000
-    GCNENC_EXP, // 0001
-    GCNENC_NONE, // 0010 - illegal
-    GCNENC_NONE, // 0011 - illegal
-    GCNENC_VOP3A, // 0100
-    GCNENC_VINTRP, // 0101
-    GCNENC_DS,   // 0110
-    GCNENC_FLAT, // 0111
-    GCNENC_MUBUF, // 1000
-    GCNENC_NONE,  // 1001 - illegal
-    GCNENC_MTBUF, // 1010
-    GCNENC_NONE,  // 1011 - illegal
-    GCNENC_MIMG,  // 1100
-    GCNENC_NONE,  // 1101 - illegal
-    GCNENC_NONE,  // 1110 - illegal
-    GCNENC_NONE   // 1111 - illegal
-};
-
-
 struct CLRX_INTERNAL GCNEncodingOpcodeBits
 {
     cxbyte bitPos;
@@ -523,6 +270,59 @@ static const GCNEncodingOpcodeBits gcnEncodingOpcode12Table[GCNENC_MAXVAL+1] =
     { 18, 7 } /* GCNENC_FLAT, opcode = (8bit)<<18 (???8bit) */
 };
 
+/* find instruction in table by code. returns nullptr if instruction is illegal.
+ * defaultEncoding - encoding of first entry (used to decode illegal instruction) */
+static const GCNInstruction* findGCNInstruction(uint32_t insnCode, cxbyte gcnEncoding,
+            bool isGCN124, bool isGCN14, uint16_t curArchMask, cxuint& opcode,
+            cxbyte& defaultEncoding)
+{
+    const GCNEncodingOpcodeBits* encodingOpcodeTable = 
+            (isGCN124) ? gcnEncodingOpcode12Table : gcnEncodingOpcodeTable;
+    opcode = (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
+            ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
+    
+    const GCNEncodingSpace& encSpace = 
+        (isGCN124) ? gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
+          gcnInstrTableByCodeSpaces[gcnEncoding];
+    const GCNInstruction* gcnInsn = gcnInstrTableByCode +
+            encSpace.offset + opcode;
+    defaultEncoding = gcnInsn->encoding;
+    
+    if (!isGCN124 && gcnInsn->mnemonic != nullptr &&
+        (curArchMask & gcnInsn->archMask) == 0 &&
+        gcnEncoding == GCNENC_VOP3A)
+    {    /* new overrides (VOP3A) */
+        const GCNEncodingSpace& encSpace2 =
+                gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
+        gcnInsn = gcnInstrTableByCode + encSpace2.offset + opcode;
+    }
+    else if (isGCN14 && gcnInsn->mnemonic != nullptr &&
+        (curArchMask & gcnInsn->archMask) == 0 &&
+        (gcnEncoding == GCNENC_VOP3A || gcnEncoding == GCNENC_VOP2 ||
+            gcnEncoding == GCNENC_VOP1))
+    {
+        /* new overrides (VOP1/VOP3A/VOP2 for GCN 1.4) */
+        const GCNEncodingSpace& encSpace4 =
+                gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 +
+                        (gcnEncoding != GCNENC_VOP2) +
+                        (gcnEncoding == GCNENC_VOP1)];
+        gcnInsn = gcnInstrTableByCode + encSpace4.offset + opcode;
+    }
+    else if (isGCN14 && gcnEncoding == GCNENC_FLAT && ((insnCode>>14)&3)==3)
+        return nullptr; // reserved segment (no instruction space)
+    else if (isGCN14 && gcnEncoding == GCNENC_FLAT && ((insnCode>>14)&3)!=0)
+    {
+        // GLOBAL_/SCRATCH_* instructions
+        const GCNEncodingSpace& encSpace4 =
+            gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 +
+                ((insnCode>>14)&3)-1];
+        gcnInsn = gcnInstrTableByCode + encSpace4.offset + opcode;
+    }
+    if (gcnInsn->mnemonic == nullptr || (curArchMask & gcnInsn->archMask) == 0)
+        return nullptr; // illegal
+    return gcnInsn;
+}
+
 // put chars to buffer (helper)
 static inline void putChars(char*& buf, const char* input, size_t size)
 {
@@ -3016,31 +2816,103 @@ void GCNDisassembler::disassemble()
           [](const std::pair<size_t,CString>& a, const std::pair<size_t, CString>& b)
           { return a.first < b.first; });
     
+    const size_t codeWordsNum = (inputSize>>2);
+    
+    if ((inputSize&3) != 0)
+        output.write(64,
+           "        /* WARNING: Code size is not aligned to 4-byte word! */\n");
+    if (instrOutOfCode)
+        output.write(54, "        /* WARNING: Unfinished instruction at end! */\n");
+    
+    if (chunkStarts.size() <= 1)
+    {
+        // sequential disassembling
+        disassembleRange(0, codeWordsNum, curLabel, curNamedLabel, curReloc, true);
+        disassembler.getOutput().flush();
+        return;
+    }
+    
+    /* parallel disassembling: every chunk is disassembled by own disassembler
+     * to own output, outputs are joined in original order */
+    const size_t chunksNum = chunkStarts.size();
+    std::unique_ptr<std::ostringstream[]> chunkOutputs(new std::ostringstream[chunksNum]);
+    runInThreadPool(chunksNum, disassembler.getThreadsNum(), [&](size_t i)
+    {
+        const size_t chunkStart = chunkStarts[i];
+        const size_t chunkEnd = (i+1 < chunksNum) ? chunkStarts[i+1] : codeWordsNum;
+        const bool lastChunk = (i+1 == chunksNum);
+        const size_t startPos = startOffset + (chunkStart<<2);
+        const size_t endPos = startOffset + (chunkEnd<<2);
+        
+        GCNDisassembler chunkDasm(disassembler, chunkOutputs[i]);
+        chunkDasm.setInput(inputSize, input, startOffset, labelStartOffset);
+        chunkDasm.dontPrintLabelsAfterCode = dontPrintLabelsAfterCode;
+        // labels at chunk start already printed by previous chunk
+        LabelIter labelStart = (i == 0) ? curLabel :
+                std::upper_bound(labels.begin(), labels.end(), startPos);
+        LabelIter labelEnd = lastChunk ? labels.end() :
+                std::upper_bound(labels.begin(), labels.end(), endPos);
+        chunkDasm.labels.assign(labelStart, std::max(labelStart, labelEnd));
+        /* named labels and symbols are used to print locations anywhere in code,
+         * chunk reads them from this disassembler instead of copying them */
+        chunkDasm.labelsOwner = this;
+        RelocIter relocStart = (i == 0) ? curReloc :
+            std::lower_bound(relocations.begin(), relocations.end(),
+                std::make_pair(startPos, Relocation()),
+                [](const std::pair<size_t,Relocation>& a,
+                   const std::pair<size_t, Relocation>& b)
+                { return a.first < b.first; });
+        RelocIter relocEnd = lastChunk ? relocations.end() :
+            std::lower_bound(relocations.begin(), relocations.end(),
+                std::make_pair(endPos, Relocation()),
+                [](const std::pair<size_t,Relocation>& a,
+                   const std::pair<size_t, Relocation>& b)
+                { return a.first < b.first; });
+        chunkDasm.relocations.assign(relocStart, relocEnd);
+        
+        NamedLabelIter namedLabelStart = (i == 0) ? curNamedLabel :
+            std::upper_bound(namedLabels.begin(), namedLabels.end(),
+                std::make_pair(startPos, CString()),
+                [](const std::pair<size_t,CString>& a,
+                   const std::pair<size_t, CString>& b)
+                { return a.first < b.first; });
+        chunkDasm.disassembleRange(chunkStart, chunkEnd, chunkDasm.labels.begin(),
+                namedLabelStart, chunkDasm.relocations.begin(), lastChunk);
+    });
+    
+    for (size_t i = 0; i < chunksNum; i++)
+    {
+        const std::string chunkOut = chunkOutputs[i].str();
+        output.write(chunkOut.size(), chunkOut.c_str());
+        chunkOutputs[i].str(std::string()); // free memory
+    }
+    output.flush();
+    disassembler.getOutput().flush();
+}
+
+void GCNDisassembler::disassembleRange(size_t startPos, size_t endPos,
+            LabelIter curLabel, NamedLabelIter curNamedLabel, RelocIter curReloc,
+            bool lastRange)
+{
     const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
 
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
                 disassembler.getDeviceType());
     // set up GCN indicators
-    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
     const bool isGCN124 = (arch >= GPUArchitecture::GCN1_2);
     const bool isGCN14 = (arch >= GPUArchitecture::GCN1_4);
     const uint16_t curArchMask = 
             1U<<int(getGPUArchitectureFromDeviceType(disassembler.getDeviceType()));
     const size_t codeWordsNum = (inputSize>>2);
-    
-    if ((inputSize&3) != 0)
-        output.write(64,
-           "        /* WARNING: Code size is not aligned to 4-byte word! */\n");
-    if (instrOutOfCode)
-        output.write(54, "        /* WARNING: Unfinished instruction at end! */\n");
+    const GCNInsnSizeEntry* sizeTable = gcnInsnSizeTables[cxuint(arch)];
     
     bool prevIsTwoWord = false;
     
-    size_t pos = 0;
+    size_t pos = startPos;
     while (true)
     {
         writeLabelsToPosition(pos<<2, curLabel, curNamedLabel);
-        if (pos >= codeWordsNum)
+        if (pos >= endPos)
             break;
         
         const size_t oldPos = pos;
@@ -3066,129 +2938,11 @@ void GCNDisassembler::disassemble()
         uint32_t insnCode2 = 0;
         
         
-        /* determine GCN encoding */
-        if ((insnCode & 0x80000000U) != 0)
-        {
-            if ((insnCode & 0x40000000U) == 0)
-            {
-                // SOP???
-                if  ((insnCode & 0x30000000U) == 0x30000000U)
-                {
-                    // SOP1/SOPK/SOPC/SOPP
-                    const uint32_t encPart = (insnCode & 0x0f800000U);
-                    if (encPart == 0x0e800000U)
-                    {
-                        // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                        gcnEncoding = GCNENC_SOP1;
-                    }
-                    else if (encPart == 0x0f000000U)
-                    {
-                        // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                        gcnEncoding = GCNENC_SOPC;
-                    }
-                    else if (encPart == 0x0f800000U) // SOPP
-                        gcnEncoding = GCNENC_SOPP;
-                    else // SOPK
-                    {
-                        gcnEncoding = GCNENC_SOPK;
-                        const uint32_t opcode = ((insnCode>>23)&0x1f);
-                        if ((!isGCN124 && opcode == 21) ||
-                            (isGCN124 && opcode == 20))
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                    }
-                }
-                else
-                {
-                    // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                    {
-                        // literal
-                        if (pos < codeWordsNum)
-                            insnCode2 = ULEV(codeWords[pos++]);
-                    }
-                    gcnEncoding = GCNENC_SOP2;
-                }
-            }
-            else
-            {
-                // SMRD and others
-                const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN124 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN124 && gcnSize12Table[encPart]))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                if (isGCN124)
-                    gcnEncoding = gcnEncoding12Table[encPart];
-                else
-                    gcnEncoding = gcnEncoding11Table[encPart];
-                if (gcnEncoding == GCNENC_FLAT && !isGCN11 && !isGCN124)
-                    gcnEncoding = GCNENC_NONE; // illegal if not GCN1.1
-            }
-        }
-        else
-        {
-            // some vector instructions
-            if ((insnCode & 0x7e000000U) == 0x7c000000U)
-            {
-                // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOPC;
-            }
-            else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-            {
-                // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOP1;
-            }
-            else
-            {
-                // VOP2
-                const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN124 && (opcode == 32 || opcode == 33)) ||
-                    (isGCN124 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOP2;
-            }
-        }
+        /* determine GCN encoding and size */
+        const GCNInsnSizeEntry& sizeEntry = sizeTable[insnCode>>23];
+        gcnEncoding = sizeEntry.encoding;
+        if (getGCNInsnWordsNum(sizeEntry, insnCode) == 2 && pos < codeWordsNum)
+            insnCode2 = ULEV(codeWords[pos++]);
         
         prevIsTwoWord = (oldPos+2 == pos);
         
@@ -3257,63 +3011,15 @@ void GCNDisassembler::disassemble()
         }
         else
         {
-            const GCNEncodingOpcodeBits* encodingOpcodeTable = 
-                    (isGCN124) ? gcnEncodingOpcode12Table : gcnEncodingOpcodeTable;
-            const cxuint opcode =
-                    (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
-                    ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
-            
             /* decode instruction and put to output */
-            const GCNEncodingSpace& encSpace = 
-                (isGCN124) ? gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
-                  gcnInstrTableByCodeSpaces[gcnEncoding];
-            const GCNInstruction* gcnInsn = gcnInstrTableByCode.get() +
-                    encSpace.offset + opcode;
-            
-            const GCNInstruction defaultInsn = { nullptr, gcnInsn->encoding, GCN_STDMODE,
+            cxuint opcode;
+            cxbyte defaultEncoding;
+            const GCNInstruction* gcnInsn = findGCNInstruction(insnCode, gcnEncoding,
+                    isGCN124, isGCN14, curArchMask, opcode, defaultEncoding);
+            const GCNInstruction defaultInsn = { nullptr, defaultEncoding, GCN_STDMODE,
                         0, 0 };
             cxuint spacesToAdd = 16;
-            bool isIllegal = false;
-            if (!isGCN124 && gcnInsn->mnemonic != nullptr &&
-                (curArchMask & gcnInsn->archMask) == 0 &&
-                gcnEncoding == GCNENC_VOP3A)
-            {    /* new overrides (VOP3A) */
-                const GCNEncodingSpace& encSpace2 =
-                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace2.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (isGCN14 && gcnInsn->mnemonic != nullptr &&
-                (curArchMask & gcnInsn->archMask) == 0 &&
-                (gcnEncoding == GCNENC_VOP3A || gcnEncoding == GCNENC_VOP2 ||
-                    gcnEncoding == GCNENC_VOP1))
-            {
-                /* new overrides (VOP1/VOP3A/VOP2 for GCN 1.4) */
-                const GCNEncodingSpace& encSpace4 =
-                        gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 +
-                                (gcnEncoding != GCNENC_VOP2) +
-                                (gcnEncoding == GCNENC_VOP1)];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (isGCN14 && gcnEncoding == GCNENC_FLAT && ((insnCode>>14)&3)!=0)
-            {
-                // GLOBAL_/SCRATCH_* instructions
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 +
-                        ((insnCode>>14)&3)-1];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (gcnInsn->mnemonic == nullptr ||
-                (curArchMask & gcnInsn->archMask) == 0)
-                isIllegal = true;
+            const bool isIllegal = (gcnInsn == nullptr);
             
             if (!isIllegal)
             {
@@ -3429,8 +3135,222 @@ void GCNDisassembler::disassemble()
         }
         output.put('\n');
     }
-    if (!dontPrintLabelsAfterCode)
+    if (lastRange && !dontPrintLabelsAfterCode)
         writeLabelsToEnd(codeWordsNum<<2, curLabel, curNamedLabel);
     output.flush();
-    disassembler.getOutput().flush();
+}
+
+/* structured disassembling */
+
+// set operand fields of record from instruction words
+static void setGCNRecordOperands(GCNDisasmInsnRecord& record, bool isGCN124,
+            bool isGCN14)
+{
+    const uint32_t insnCode = record.insnCode;
+    const uint32_t insnCode2 = record.insnCode2;
+    uint16_t* ops = record.operands;
+    switch(record.encoding)
+    {
+        case GCNENC_SOPC:
+            ops[1] = insnCode&0xff;
+            ops[2] = (insnCode>>8)&0xff;
+            break;
+        case GCNENC_SOP1:
+            ops[0] = (insnCode>>16)&0x7f;
+            ops[1] = insnCode&0xff;
+            break;
+        case GCNENC_SOP2:
+            ops[0] = (insnCode>>16)&0x7f;
+            ops[1] = insnCode&0xff;
+            ops[2] = (insnCode>>8)&0xff;
+            break;
+        case GCNENC_SOPK:
+            ops[0] = (insnCode>>16)&0x7f;
+            break;
+        case GCNENC_SMRD:
+            if (isGCN124)
+            {
+                // SMEM: offset in second word
+                ops[0] = (insnCode>>6)&0x7f;
+                ops[1] = (insnCode&0x3f)<<1;
+            }
+            else
+            {
+                ops[0] = (insnCode>>15)&0x7f;
+                ops[1] = ((insnCode>>9)&0x3f)<<1;
+                if ((insnCode&0x100) == 0) // SOFFSET (not immediate)
+                    ops[2] = insnCode&0xff;
+            }
+            break;
+        case GCNENC_VOPC:
+            ops[1] = insnCode&0x1ff;
+            ops[2] = 256 + ((insnCode>>9)&0xff);
+            break;
+        case GCNENC_VOP1:
+            ops[0] = 256 + ((insnCode>>17)&0xff);
+            ops[1] = insnCode&0x1ff;
+            break;
+        case GCNENC_VOP2:
+            ops[0] = 256 + ((insnCode>>17)&0xff);
+            ops[1] = insnCode&0x1ff;
+            ops[2] = 256 + ((insnCode>>9)&0xff);
+            break;
+        case GCNENC_VOP3A:
+            // destination can be VGPR or SGPR (depends on instruction)
+            ops[0] = insnCode&0xff;
+            ops[1] = insnCode2&0x1ff;
+            ops[2] = (insnCode2>>9)&0x1ff;
+            ops[3] = (insnCode2>>18)&0x1ff;
+            break;
+        case GCNENC_VOP3B:
+            // VGPR destination and SGPR destination (carry or VCC)
+            ops[0] = 256 + (insnCode&0xff);
+            ops[1] = insnCode2&0x1ff;
+            ops[2] = (insnCode2>>9)&0x1ff;
+            ops[3] = (insnCode2>>18)&0x1ff;
+            ops[4] = (insnCode>>8)&0x7f;
+            break;
+        case GCNENC_VINTRP:
+            ops[0] = 256 + ((insnCode>>18)&0xff);
+            ops[1] = 256 + (insnCode&0xff);
+            break;
+        case GCNENC_DS:
+            ops[0] = 256 + (insnCode2>>24);
+            ops[1] = 256 + (insnCode2&0xff);
+            ops[2] = 256 + ((insnCode2>>8)&0xff);
+            ops[3] = 256 + ((insnCode2>>16)&0xff);
+            break;
+        case GCNENC_MUBUF:
+        case GCNENC_MTBUF:
+            ops[0] = 256 + ((insnCode2>>8)&0xff);
+            ops[1] = 256 + (insnCode2&0xff);
+            ops[2] = ((insnCode2>>16)&0x1f)<<2;
+            ops[3] = insnCode2>>24;
+            break;
+        case GCNENC_MIMG:
+            ops[0] = 256 + ((insnCode2>>8)&0xff);
+            ops[1] = 256 + (insnCode2&0xff);
+            ops[2] = ((insnCode2>>16)&0x1f)<<2;
+            ops[3] = ((insnCode2>>21)&0x1f)<<2;
+            break;
+        case GCNENC_EXP:
+            for (cxuint i = 0; i < 4; i++)
+                ops[i] = 256 + ((insnCode2>>(i<<3))&0xff);
+            break;
+        case GCNENC_FLAT:
+            ops[0] = 256 + (insnCode2>>24);
+            ops[1] = 256 + (insnCode2&0xff);
+            ops[2] = 256 + ((insnCode2>>8)&0xff);
+            if (isGCN14) // SADDR
+                ops[3] = (insnCode2>>16)&0x7f;
+            break;
+        default:
+            break;
+    }
+}
+
+void GCNDisassembler::decodeInstructions(GCNDisasmSink& sink)
+{
+    const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                disassembler.getDeviceType());
+    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
+    const bool isGCN124 = (arch >= GPUArchitecture::GCN1_2);
+    const bool isGCN14 = (arch >= GPUArchitecture::GCN1_4);
+    const uint16_t curArchMask = 1U<<int(arch);
+    const size_t codeWordsNum = (inputSize>>2);
+    const GCNInsnSizeEntry* sizeTable = gcnInsnSizeTables[cxuint(arch)];
+    
+    GCNDisasmInsnRecord record;
+    for (size_t pos = 0; pos < codeWordsNum; )
+    {
+        const size_t insnPos = pos;
+        const uint32_t insnCode = ULEV(codeWords[pos++]);
+        record.offset = startOffset + (insnPos<<2);
+        record.target = 0;
+        record.insnCode = insnCode;
+        record.insnCode2 = 0;
+        record.wordsNum = 1;
+        record.instrIndex = UINT16_MAX;
+        record.opcode = 0;
+        std::fill(record.operands, record.operands+5, GCNDISASM_NO_OPERAND);
+        record.encoding = GCNENC_NONE;
+        record.flags = 0;
+        if (insnCode == 0)
+        {
+            // zero words are grouped like in text output (.fill)
+            for (; pos < codeWordsNum && codeWords[pos]==0; pos++);
+            record.wordsNum = pos - insnPos;
+            record.flags = GCNDISASM_REC_FILL;
+            sink.putInstruction(record);
+            continue;
+        }
+        
+        const GCNInsnSizeEntry& sizeEntry = sizeTable[insnCode>>23];
+        record.encoding = sizeEntry.encoding;
+        if (getGCNInsnWordsNum(sizeEntry, insnCode) == 2)
+        {
+            if (pos < codeWordsNum)
+            {
+                record.insnCode2 = ULEV(codeWords[pos++]);
+                record.wordsNum = 2;
+                if ((sizeEntry.sizeFlags & GCNSIZE_2WORDS) == 0)
+                {
+                    // second word depends on source operand: SDWA/DPP word or literal
+                    const bool extWord = (sizeEntry.sizeFlags & GCNSIZE_VSRC0_EXT) != 0 &&
+                            (insnCode & 0x1ff)-0xf9U < 2U;
+                    record.flags |= extWord ? GCNDISASM_REC_SDWA_DPP :
+                            GCNDISASM_REC_LITERAL;
+                }
+                else if (record.encoding == GCNENC_VOP2 ||
+                        record.encoding == GCNENC_SOPK)
+                    // V_MADMK, V_MADAK and S_SETREG_IMM32 have 32-bit constant
+                    record.flags |= GCNDISASM_REC_LITERAL;
+            }
+            else
+                record.flags |= GCNDISASM_REC_UNFINISHED;
+        }
+        if (record.encoding == GCNENC_NONE)
+        {
+            record.flags |= GCNDISASM_REC_ILLEGAL;
+            sink.putInstruction(record);
+            continue;
+        }
+        
+        cxuint opcode;
+        cxbyte defaultEncoding;
+        const GCNInstruction* gcnInsn = findGCNInstruction(insnCode, record.encoding,
+                    isGCN124, isGCN14, curArchMask, opcode, defaultEncoding);
+        record.opcode = opcode;
+        if (gcnInsn != nullptr)
+        {
+            record.instrIndex = gcnInstrIndexByCode[gcnInsn - gcnInstrTableByCode];
+            // VOP3A and VOP3B have same size entry, type is given by instruction
+            if (gcnInsn->encoding == GCNENC_VOP3B)
+                record.encoding = GCNENC_VOP3B;
+        }
+        else
+            record.flags |= GCNDISASM_REC_ILLEGAL;
+        setGCNRecordOperands(record, isGCN124, isGCN14);
+        
+        // jump target (same as labels collected by analyzeBeforeDisassemble)
+        if ((record.encoding == GCNENC_SOPP &&
+                    isGCNSOPPJump(opcode, isGCN11, isGCN124)) ||
+            (record.encoding == GCNENC_SOPK && isGCNSOPKJump(opcode, isGCN124, isGCN14)))
+        {
+            record.target = startOffset + ((insnPos+int16_t(insnCode&0xffff)+1)<<2);
+            record.flags |= GCNDISASM_REC_TARGET;
+        }
+        sink.putInstruction(record);
+    }
+}
+
+const char* GCNDisassembler::getInstructionMnemonic(uint16_t instrIndex)
+{
+    return gcnInstrsTable[instrIndex].mnemonic;
+}
+
+const char* GCNDisassembler::getEncodingName(cxbyte encoding)
+{
+    return (encoding <= GCNENC_MAXVAL) ? gcnEncodingNames[encoding] : nullptr;
 }
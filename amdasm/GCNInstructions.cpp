@@ -2642,3 +2642,54 @@ const GCNInstruction CLRX::gcnInstrsTable[] =
         GCN_MUBUF_MX2|GCN_MATOMIC|GCN_FLAT_GLOBAL, 108,  ARCH_RXVEGA  },
     { nullptr, GCNENC_NONE, 0, 0, 0 }
 };
+
+// table hold of GNC encoding regions in main instruction list
+// instruciton position is sum of encoding offset and instruction opcode
+const GCNEncodingSpace CLRX::gcnInstrTableByCodeSpaces[gcnInstrTableByCodeSpacesNum] =
+{
+    { 0, 0 },
+    { 0, 0x80 }, /* GCNENC_SOPC, opcode = (7bit)<<16 */
+    { 0x0080, 0x80 }, /* GCNENC_SOPP, opcode = (7bit)<<16 */
+    { 0x0100, 0x100 }, /* GCNENC_SOP1, opcode = (8bit)<<8 */
+    { 0x0200, 0x80 }, /* GCNENC_SOP2, opcode = (7bit)<<23 */
+    { 0x0280, 0x20 }, /* GCNENC_SOPK, opcode = (5bit)<<23 */
+    { 0x02a0, 0x40 }, /* GCNENC_SMRD, opcode = (6bit)<<22 */
+    { 0x02e0, 0x100 }, /* GCNENC_VOPC, opcode = (8bit)<<27 */
+    { 0x03e0, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 */
+    { 0x04e0, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 */
+    { 0x0520, 0x200 }, /* GCNENC_VOP3A, opcode = (9bit)<<17 */
+    { 0x0520, 0x200 }, /* GCNENC_VOP3B, opcode = (9bit)<<17 */
+    { 0x0720, 0x4 }, /* GCNENC_VINTRP, opcode = (2bit)<<16 */
+    { 0x0724, 0x100 }, /* GCNENC_DS, opcode = (8bit)<<18 */
+    { 0x0824, 0x80 }, /* GCNENC_MUBUF, opcode = (7bit)<<18 */
+    { 0x08a4, 0x8 }, /* GCNENC_MTBUF, opcode = (3bit)<<16 */
+    { 0x08ac, 0x80 }, /* GCNENC_MIMG, opcode = (7bit)<<18 */
+    { 0x092c, 0x1 }, /* GCNENC_EXP, opcode = none */
+    { 0x092d, 0x80 }, /* GCNENC_FLAT, opcode = (8bit)<<18 (???8bit) */
+    { 0x09ad, 0x200 }, /* GCNENC_VOP3A, opcode = (9bit)<<17 (GCN1.1) */
+    { 0x09ad, 0x200 },  /* GCNENC_VOP3B, opcode = (9bit)<<17 (GCN1.1) */
+    { 0x0bad, 0x0 },
+    { 0x0bad, 0x80 }, /* GCNENC_SOPC, opcode = (7bit)<<16 (GCN1.2) */
+    { 0x0c2d, 0x80 }, /* GCNENC_SOPP, opcode = (7bit)<<16 (GCN1.2) */
+    { 0x0cad, 0x100 }, /* GCNENC_SOP1, opcode = (8bit)<<8 (GCN1.2) */
+    { 0x0dad, 0x80 }, /* GCNENC_SOP2, opcode = (7bit)<<23 (GCN1.2) */
+    { 0x0e2d, 0x20 }, /* GCNENC_SOPK, opcode = (5bit)<<23 (GCN1.2) */
+    { 0x0e4d, 0x100 }, /* GCNENC_SMEM, opcode = (8bit)<<18 (GCN1.2) */
+    { 0x0f4d, 0x100 }, /* GCNENC_VOPC, opcode = (8bit)<<27 (GCN1.2) */
+    { 0x104d, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 (GCN1.2) */
+    { 0x114d, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 (GCN1.2) */
+    { 0x118d, 0x400 }, /* GCNENC_VOP3A, opcode = (10bit)<<16 (GCN1.2) */
+    { 0x118d, 0x400 }, /* GCNENC_VOP3B, opcode = (10bit)<<16 (GCN1.2) */
+    { 0x158d, 0x4 }, /* GCNENC_VINTRP, opcode = (2bit)<<16 (GCN1.2) */
+    { 0x1591, 0x100 }, /* GCNENC_DS, opcode = (8bit)<<18 (GCN1.2) */
+    { 0x1691, 0x80 }, /* GCNENC_MUBUF, opcode = (7bit)<<18 (GCN1.2) */
+    { 0x1711, 0x10 }, /* GCNENC_MTBUF, opcode = (4bit)<<16 (GCN1.2) */
+    { 0x1721, 0x80 }, /* GCNENC_MIMG, opcode = (7bit)<<18 (GCN1.2) */
+    { 0x17a1, 0x1 }, /* GCNENC_EXP, opcode = none (GCN1.2) */
+    { 0x17a2, 0x80 }, /* GCNENC_FLAT, opcode = (8bit)<<18 (???8bit) */
+    { 0x1822, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 (RXVEGA) */
+    { 0x1862, 0x400 }, /* GCNENC_VOP3B, opcode = (10bit)<<17  (RXVEGA) */
+    { 0x1c62, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 (RXVEGA) */
+    { 0x1d62, 0x80 }, /* GCNENC_FLAT_SCRATCH, opcode = (8bit)<<18 (???8bit) RXVEGA */
+    { 0x1de2, 0x80 }  /* GCNENC_FLAT_GLOBAL, opcode = (8bit)<<18 (???8bit) RXVEGA */
+};
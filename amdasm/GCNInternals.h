@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <string>
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
 
 namespace CLRX
 {
@@ -235,6 +236,92 @@ struct CLRX_INTERNAL GCNAsmInstruction
 
 CLRX_INTERNAL extern const GCNInstruction gcnInstrsTable[];
 
+// flags of GCN instruction size (conditions of second dword)
+enum : cxbyte
+{
+    GCNSIZE_2WORDS = 1,     /// always two dwords
+    GCNSIZE_SSRC0_LIT = 2,  /// literal if SSRC0 is 0xff
+    GCNSIZE_SSRC1_LIT = 4,  /// literal if SSRC1 is 0xff
+    GCNSIZE_VSRC0_LIT = 8,  /// literal if VOP SRC0 is 0xff
+    GCNSIZE_VSRC0_EXT = 16  /// SDWA or DPP word if VOP SRC0 is 0xf9 or 0xfa
+};
+
+// encoding and size of instruction determined from first dword
+struct CLRX_INTERNAL GCNInsnSizeEntry
+{
+    cxbyte encoding;
+    cxbyte sizeFlags;
+};
+
+/* encodings and sizes of instructions for every architecture,
+ * indexed by 9 highest bits of first dword of instruction */
+CLRX_INTERNAL extern const GCNInsnSizeEntry gcnInsnSizeTables[
+            cxuint(GPUArchitecture::GPUARCH_MAX)+1][512];
+
+// GCN encoding space
+struct CLRX_INTERNAL GCNEncodingSpace
+{
+    cxuint offset;  // first position instrunctions list
+    cxuint instrsNum;   // instruction list
+};
+
+// number of encoding spaces in instruction table by code
+const cxuint gcnInstrTableByCodeSpacesNum = 2*(GCNENC_MAXVAL+1)+2+3+2;
+// total instruction table length
+const size_t gcnInstrTableByCodeLength = 0x1e62;
+
+CLRX_INTERNAL extern const GCNEncodingSpace gcnInstrTableByCodeSpaces[
+            gcnInstrTableByCodeSpacesNum];
+
+/* tables below are generated at build time by GCNTablesGen
+ * (main instruction table, table by code and assembler index) */
+
+// instructions by code (position is sum of encoding space offset and opcode)
+CLRX_INTERNAL extern const GCNInstruction gcnInstrTableByCode[gcnInstrTableByCodeLength];
+// indices in main instruction table (gcnInstrsTable) for gcnInstrTableByCode
+CLRX_INTERNAL extern const uint16_t gcnInstrIndexByCode[gcnInstrTableByCodeLength];
+
+// instructions sorted by mnemonic with joined VOP3 codes (for assembler)
+CLRX_INTERNAL extern const GCNAsmInstruction gcnInstrSortedTable[];
+
+/* perfect hash index of mnemonics (hash and displace method).
+ * every mnemonic have own slot that holds indices to gcnInstrSortedTable
+ * of first entries for every GPU architecture */
+struct CLRX_INTERNAL GCNMnemonicSlot
+{
+    const char* mnemonic;
+    size_t length;
+    // index of first entry in sorted table for architecture (UINT16_MAX if none)
+    uint16_t archIndices[cxuint(GPUArchitecture::GPUARCH_MAX)+1];
+};
+
+CLRX_INTERNAL extern const GCNMnemonicSlot gcnMnemonicSlots[];
+// displacements for buckets: (multiplier<<16) | addend
+CLRX_INTERNAL extern const uint32_t gcnMnemonicDisps[];
+CLRX_INTERNAL extern const size_t gcnMnemonicDispsNum;
+CLRX_INTERNAL extern const size_t gcnMnemonicSlotsMask;
+
+// 64-bit FNV-1a hash
+static inline uint64_t gcnMnemonicHash(const char* name, size_t length)
+{ return hashFNV1a64(length, name); }
+
+static inline size_t gcnMnemonicSlotIndex(uint64_t hash, uint32_t disp, size_t mask)
+{
+    return (uint32_t(hash) + (disp>>16)*(uint32_t(hash>>32)|1U) + (disp&0xffffU)) & mask;
+}
+
+// get number of dwords of instruction (without branches)
+static inline cxuint getGCNInsnWordsNum(const GCNInsnSizeEntry& entry, uint32_t insnCode)
+{
+    const uint32_t src0 = insnCode & 0x1ff;
+    const cxuint conds = GCNSIZE_2WORDS |
+            (cxuint((insnCode & 0xff) == 0xff) * GCNSIZE_SSRC0_LIT) |
+            (cxuint((insnCode & 0xff00) == 0xff00) * GCNSIZE_SSRC1_LIT) |
+            (cxuint(src0 == 0xff) * GCNSIZE_VSRC0_LIT) |
+            (cxuint(src0-0xf9U < 2U) * GCNSIZE_VSRC0_EXT);
+    return 1 + ((entry.sizeFlags & conds) != 0);
+}
+
 };
 
 #endif
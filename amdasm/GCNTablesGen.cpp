@@ -0,0 +1,584 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/* generator of GCN instruction tables for assembler and disassembler
+ * (run at build time, tables are built from main instruction table).
+ * usage: GCNTablesGen OUTPUTFILE */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "GCNInternals.h"
+
+using namespace CLRX;
+
+// gcn encoding sizes table: true - if 8 byte encoding, false - 4 byte encoding
+// for GCN1.0/1.1
+static const bool gcnSize11Table[16] =
+{
+    false, // GCNENC_SMRD, // 0000
+    false, // GCNENC_SMRD, // 0001
+    false, // GCNENC_VINTRP, // 0010
+    false, // GCNENC_NONE, // 0011 - illegal
+    true,  // GCNENC_VOP3A, // 0100
+    false, // GCNENC_NONE, // 0101 - illegal
+    true,  // GCNENC_DS,   // 0110
+    true,  // GCNENC_FLAT, // 0111
+    true,  // GCNENC_MUBUF, // 1000
+    false, // GCNENC_NONE,  // 1001 - illegal
+    true,  // GCNENC_MTBUF, // 1010
+    false, // GCNENC_NONE,  // 1011 - illegal
+    true,  // GCNENC_MIMG,  // 1100
+    false, // GCNENC_NONE,  // 1101 - illegal
+    true,  // GCNENC_EXP,   // 1110
+    false // GCNENC_NONE   // 1111 - illegal
+};
+
+// for GCN1.2/1.4
+static const bool gcnSize12Table[16] =
+{
+    true,  // GCNENC_SMEM, // 0000
+    true,  // GCNENC_EXP, // 0001
+    false, // GCNENC_NONE, // 0010 - illegal
+    false, // GCNENC_NONE, // 0011 - illegal
+    true,  // GCNENC_VOP3A, // 0100
+    false, // GCNENC_VINTRP, // 0101
+    true,  // GCNENC_DS,   // 0110
+    true,  // GCNENC_FLAT, // 0111
+    true,  // GCNENC_MUBUF, // 1000
+    false, // GCNENC_NONE,  // 1001 - illegal
+    true,  // GCNENC_MTBUF, // 1010
+    false, // GCNENC_NONE,  // 1011 - illegal
+    true,  // GCNENC_MIMG,  // 1100
+    false, // GCNENC_NONE,  // 1101 - illegal
+    false, // GCNENC_NONE,  // 1110 - illegal
+    false // GCNENC_NONE   // 1111 - illegal
+};
+
+static const cxbyte gcnEncoding11Table[16] =
+{
+    GCNENC_SMRD, // 0000
+    GCNENC_SMRD, // 0001
+    GCNENC_VINTRP, // 0010
+    GCNENC_NONE, // 0011 - illegal
+    GCNENC_VOP3A, // 0100
+    GCNENC_NONE, // 0101 - illegal
+    GCNENC_DS,   // 0110
+    GCNENC_FLAT, // 0111
+    GCNENC_MUBUF, // 1000
+    GCNENC_NONE,  // 1001 - illegal
+    GCNENC_MTBUF, // 1010
+    GCNENC_NONE,  // 1011 - illegal
+    GCNENC_MIMG,  // 1100
+    GCNENC_NONE,  // 1101 - illegal
+    GCNENC_EXP,   // 1110
+    GCNENC_NONE   // 1111 - illegal
+};
+
+static const cxbyte gcnEncoding12Table[16] =
+{
+    GCNENC_SMEM, // 0000
+    GCNENC_EXP, // 0001
+    GCNENC_NONE, // 0010 - illegal
+    GCNENC_NONE, // 0011 - illegal
+    GCNENC_VOP3A, // 0100
+    GCNENC_VINTRP, // 0101
+    GCNENC_DS,   // 0110
+    GCNENC_FLAT, // 0111
+    GCNENC_MUBUF, // 1000
+    GCNENC_NONE,  // 1001 - illegal
+    GCNENC_MTBUF, // 1010
+    GCNENC_NONE,  // 1011 - illegal
+    GCNENC_MIMG,  // 1100
+    GCNENC_NONE,  // 1101 - illegal
+    GCNENC_NONE,  // 1110 - illegal
+    GCNENC_NONE   // 1111 - illegal
+};
+
+// determine encoding and size of instruction from 9 highest bits
+static GCNInsnSizeEntry getGCNInsnSizeEntry(GPUArchitecture arch, uint32_t insnCode)
+{
+    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
+    const bool isGCN124 = (arch >= GPUArchitecture::GCN1_2);
+    // SDWA and DPP words only for GCN1.2/1.4
+    const cxbyte vsrc0Flags = GCNSIZE_VSRC0_LIT | (isGCN124 ? GCNSIZE_VSRC0_EXT : 0);
+    if ((insnCode & 0x80000000U) != 0)
+    {
+        if ((insnCode & 0x40000000U) == 0)
+        {
+            // SOP???
+            if  ((insnCode & 0x30000000U) == 0x30000000U)
+            {
+                // SOP1/SOPK/SOPC/SOPP
+                const uint32_t encPart = (insnCode & 0x0f800000U);
+                if (encPart == 0x0e800000U)
+                    return { GCNENC_SOP1, GCNSIZE_SSRC0_LIT };
+                else if (encPart == 0x0f000000U)
+                    return { GCNENC_SOPC, GCNSIZE_SSRC0_LIT|GCNSIZE_SSRC1_LIT };
+                else if (encPart == 0x0f800000U)
+                    return { GCNENC_SOPP, 0 };
+                // SOPK, s_setreg_imm32_b32 have additional literal
+                const cxuint opcode = (insnCode>>23)&0x1f;
+                const bool imm32 = (!isGCN124 && opcode == 21) ||
+                            (isGCN124 && opcode == 20);
+                return { GCNENC_SOPK, cxbyte(imm32 ? GCNSIZE_2WORDS : 0) };
+            }
+            // SOP2
+            return { GCNENC_SOP2, GCNSIZE_SSRC0_LIT|GCNSIZE_SSRC1_LIT };
+        }
+        // SMRD and others
+        const uint32_t encPart = (insnCode&0x3c000000U)>>26;
+        if (isGCN124)
+            return { gcnEncoding12Table[encPart],
+                    cxbyte(gcnSize12Table[encPart] ? GCNSIZE_2WORDS : 0) };
+        if (encPart == 7 && !isGCN11)
+            return { GCNENC_NONE, 0 }; // FLAT is illegal if not GCN1.1
+        return { gcnEncoding11Table[encPart],
+                    cxbyte(gcnSize11Table[encPart] ? GCNSIZE_2WORDS : 0) };
+    }
+    // some vector instructions
+    if ((insnCode & 0x7e000000U) == 0x7c000000U)
+        return { GCNENC_VOPC, vsrc0Flags };
+    else if ((insnCode & 0x7e000000U) == 0x7e000000U)
+        return { GCNENC_VOP1, vsrc0Flags };
+    // VOP2
+    const cxuint opcode = (insnCode >> 25)&0x3f;
+    if ((!isGCN124 && (opcode == 32 || opcode == 33)) ||
+        (isGCN124 && (opcode == 23 || opcode == 24 ||
+        opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
+        return { GCNENC_VOP2, GCNSIZE_2WORDS };  // inline 32-bit constant
+    return { GCNENC_VOP2, vsrc0Flags };
+}
+
+static std::vector<GCNInstruction> instrTableByCode;
+// indices in main instruction table (gcnInstrsTable) for instrTableByCode
+static std::vector<uint16_t> instrIndexByCode;
+
+// put instruction from main instruction table to table by code
+static inline void putGCNInstrByCode(size_t pos, cxuint instrIndex)
+{
+    instrTableByCode[pos] = gcnInstrsTable[instrIndex];
+    instrIndexByCode[pos] = instrIndex;
+}
+
+// create instruction table by code (for disassembler)
+static void generateGCNInstrTableByCode()
+{
+    // except VOP3 decoding routines ignores encoding (we can set None for encoding)
+    instrTableByCode.assign(gcnInstrTableByCodeLength,
+                { nullptr, GCNENC_NONE, GCN_STDMODE, 0, 0 });
+    instrIndexByCode.assign(gcnInstrTableByCodeLength, UINT16_MAX);
+    
+    // fill up main instruction table
+    for (cxuint i = 0; gcnInstrsTable[i].mnemonic != nullptr; i++)
+    {
+        const GCNInstruction& instr = gcnInstrsTable[i];
+        const GCNEncodingSpace& encSpace = gcnInstrTableByCodeSpaces[instr.encoding];
+        if ((instr.archMask & ARCH_GCN_1_0_1) != 0)
+        {
+            if (instrTableByCode[encSpace.offset + instr.code].mnemonic == nullptr)
+                putGCNInstrByCode(encSpace.offset + instr.code, i);
+            else if((instr.archMask & ARCH_RX2X0) != 0)
+            {
+                /* otherwise we for GCN1.1 */
+                const GCNEncodingSpace& encSpace2 =
+                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
+                putGCNInstrByCode(encSpace2.offset + instr.code, i);
+            }
+            // otherwise we ignore this entry
+        }
+        if ((instr.archMask & ARCH_GCN_1_2_4) != 0)
+        {
+            // for GCN 1.2/1.4
+            const GCNEncodingSpace& encSpace3 = gcnInstrTableByCodeSpaces[
+                        GCNENC_MAXVAL+3+instr.encoding];
+            if (instrTableByCode[encSpace3.offset + instr.code].mnemonic == nullptr)
+                putGCNInstrByCode(encSpace3.offset + instr.code, i);
+            else if((instr.archMask & ARCH_RXVEGA) != 0 &&
+                (instr.encoding == GCNENC_VOP2 || instr.encoding == GCNENC_VOP1 ||
+                instr.encoding == GCNENC_VOP3A || instr.encoding == GCNENC_VOP3B))
+            {
+                /* otherwise we for GCN1.4 */
+                const bool encNoVOP2 = instr.encoding != GCNENC_VOP2;
+                const bool encVOP1 = instr.encoding == GCNENC_VOP1;
+                // choose FLAT_GLOBAL or FLAT_SCRATCH space
+                const GCNEncodingSpace& encSpace4 =
+                    gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 + encNoVOP2 + encVOP1];
+                putGCNInstrByCode(encSpace4.offset + instr.code, i);
+            }
+            else if((instr.archMask & ARCH_RXVEGA) != 0 &&
+                instr.encoding == GCNENC_FLAT && (instr.mode & GCN_FLAT_MODEMASK) != 0)
+            {
+                /* FLAT SCRATCH and GLOBAL instructions */
+                const cxuint encFlatMode = (instr.mode & GCN_FLAT_MODEMASK)-1;
+                const GCNEncodingSpace& encSpace4 =
+                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 + encFlatMode];
+                putGCNInstrByCode(encSpace4.offset + instr.code, i);
+            }
+            // otherwise we ignore this entry
+        }
+    }
+}
+
+static std::vector<GCNAsmInstruction> instrSortedTable;
+
+// create sorted instruction table (for assembler)
+static void generateGCNInstrSortedTable()
+{
+    size_t tableSize = 0;
+    while (gcnInstrsTable[tableSize].mnemonic!=nullptr)
+        tableSize++;
+    instrSortedTable.resize(tableSize);
+    for (cxuint i = 0; i < tableSize; i++)
+    {
+        const GCNInstruction& insn = gcnInstrsTable[i];
+        instrSortedTable[i] = {insn.mnemonic, insn.encoding, insn.mode,
+                    insn.code, UINT16_MAX, insn.archMask};
+    }
+    
+    // sort GCN instruction table by mnemonic, encoding and architecture
+    std::sort(instrSortedTable.begin(), instrSortedTable.end(),
+            [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
+            {
+                // compare mnemonic and if mnemonic
+                int r = ::strcmp(instr1.mnemonic, instr2.mnemonic);
+                return (r < 0) || (r==0 && instr1.encoding < instr2.encoding) ||
+                            (r == 0 && instr1.encoding == instr2.encoding &&
+                             instr1.archMask < instr2.archMask);
+            });
+    
+    cxuint j = 0;
+    std::vector<uint16_t> oldArchMasks(tableSize);
+    /* join VOP3A instr with VOP2/VOPC/VOP1 instr together to faster encoding. */
+    for (cxuint i = 0; i < tableSize; i++)
+    {
+        GCNAsmInstruction insn = instrSortedTable[i];
+        if (insn.encoding == GCNENC_VOP3A || insn.encoding == GCNENC_VOP3B)
+        {
+            // check duplicates
+            cxuint k = j-1;
+            while (::strcmp(instrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                    (oldArchMasks[k] & insn.archMask)!=insn.archMask) k--;
+            
+            if (::strcmp(instrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                (oldArchMasks[k] & insn.archMask)==insn.archMask)
+            {
+                // we found duplicate, we apply
+                if (instrSortedTable[k].code2==UINT16_MAX)
+                {
+                    // if second slot for opcode is not filled
+                    instrSortedTable[k].code2 = insn.code1;
+                    instrSortedTable[k].archMask = oldArchMasks[k] & insn.archMask;
+                }
+                else
+                {
+                    // if filled we create new entry
+                    oldArchMasks[j] = instrSortedTable[j].archMask;
+                    instrSortedTable[j] = instrSortedTable[k];
+                    instrSortedTable[j].archMask = oldArchMasks[k] & insn.archMask;
+                    instrSortedTable[j++].code2 = insn.code1;
+                }
+            }
+            else // not found
+            {
+                oldArchMasks[j] = insn.archMask;
+                instrSortedTable[j++] = insn;
+            }
+        }
+        else if (insn.encoding == GCNENC_VINTRP)
+        {
+            // check duplicates
+            cxuint k = j-1;
+            oldArchMasks[j] = insn.archMask;
+            instrSortedTable[j++] = insn;
+            while (::strcmp(instrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                    instrSortedTable[k].encoding!=GCNENC_VOP3A) k--;
+            if (::strcmp(instrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                instrSortedTable[k].encoding==GCNENC_VOP3A)
+                // we found VINTRP duplicate, set up second code (VINTRP)
+                instrSortedTable[k].code2 = insn.code1;
+        }
+        else // normal instruction
+        {
+            oldArchMasks[j] = insn.archMask;
+            instrSortedTable[j++] = insn;
+        }
+    }
+    instrSortedTable.resize(j); // final size
+}
+
+static std::vector<GCNMnemonicSlot> mnemonicSlots;
+static std::vector<uint32_t> mnemonicDisps;
+
+// limits for perfect hash search: slots number and tried displacements per bucket
+static const size_t maxMnemonicSlotsNum = 0x10000;
+static const uint32_t maxDispTriesNum = 0x10000;
+
+// create perfect hash index of mnemonics (for assembler)
+// returns false if perfect hash not found in limits
+static bool generateGCNMnemonicIndex()
+{
+    // collect unique mnemonics (sorted table is sorted by mnemonic)
+    std::vector<size_t> firstEntries;
+    for (size_t i = 0; i < instrSortedTable.size(); i++)
+        if (i == 0 || ::strcmp(instrSortedTable[i-1].mnemonic,
+                    instrSortedTable[i].mnemonic) != 0)
+            firstEntries.push_back(i);
+    const size_t mnemsNum = firstEntries.size();
+    std::vector<uint64_t> hashes(mnemsNum);
+    for (size_t i = 0; i < mnemsNum; i++)
+    {
+        const char* mnem = instrSortedTable[firstEntries[i]].mnemonic;
+        hashes[i] = gcnMnemonicHash(mnem, ::strlen(mnem));
+    }
+    
+    const size_t bucketsNum = (mnemsNum+3)>>2;
+    std::vector<std::vector<size_t> > buckets(bucketsNum);
+    for (size_t i = 0; i < mnemsNum; i++)
+        buckets[(hashes[i]>>32) % bucketsNum].push_back(i);
+    // place largest buckets first
+    std::vector<size_t> bucketOrder(bucketsNum);
+    for (size_t i = 0; i < bucketsNum; i++)
+        bucketOrder[i] = i;
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+            [&buckets](size_t b1, size_t b2)
+            { return buckets[b1].size() > buckets[b2].size(); });
+    
+    size_t slotsNum = 1;
+    while (slotsNum < mnemsNum + (mnemsNum>>1))
+        slotsNum <<= 1;
+    mnemonicDisps.assign(bucketsNum, 0);
+    std::vector<size_t> slotOwners;
+    std::vector<size_t> bucketSlots;
+    while (true)
+    {
+        if (slotsNum > maxMnemonicSlotsNum)
+            return false; // can't find perfect hash
+        const size_t mask = slotsNum-1;
+        const uint32_t dispLimit = std::min(slotsNum, size_t(0x10000));
+        // limit of tried displacements per bucket (multiplier and addend)
+        const uint32_t dispTriesLimit = std::min(uint64_t(dispLimit)*dispLimit,
+                    uint64_t(maxDispTriesNum));
+        slotOwners.assign(slotsNum, SIZE_MAX);
+        bool allPlaced = true;
+        for (size_t b: bucketOrder)
+        {
+            const std::vector<size_t>& bucket = buckets[b];
+            mnemonicDisps[b] = 0;
+            if (bucket.empty())
+                continue;
+            bool placed = false;
+            for (uint32_t t = 0; t < dispTriesLimit && !placed; t++)
+            {
+                const uint32_t disp = ((t / dispLimit)<<16) | (t % dispLimit);
+                bucketSlots.clear();
+                for (size_t k: bucket)
+                {
+                    const size_t slot = gcnMnemonicSlotIndex(hashes[k], disp, mask);
+                    if (slotOwners[slot] != SIZE_MAX ||
+                        std::find(bucketSlots.begin(), bucketSlots.end(), slot) !=
+                                bucketSlots.end())
+                        break;
+                    bucketSlots.push_back(slot);
+                }
+                if (bucketSlots.size() != bucket.size())
+                    continue;
+                for (size_t k = 0; k < bucket.size(); k++)
+                    slotOwners[bucketSlots[k]] = bucket[k];
+                mnemonicDisps[b] = disp;
+                placed = true;
+            }
+            if (!placed)
+            {
+                allPlaced = false;
+                break;
+            }
+        }
+        if (allPlaced)
+            break;
+        slotsNum <<= 1; // retry with greater table
+    }
+    
+    mnemonicSlots.resize(slotsNum);
+    for (size_t i = 0; i < slotsNum; i++)
+    {
+        GCNMnemonicSlot& slot = mnemonicSlots[i];
+        slot.mnemonic = nullptr;
+        slot.length = 0;
+        std::fill(slot.archIndices, slot.archIndices +
+                    cxuint(GPUArchitecture::GPUARCH_MAX)+1, UINT16_MAX);
+        if (slotOwners[i] == SIZE_MAX)
+            continue;
+        const size_t first = firstEntries[slotOwners[i]];
+        const size_t end = (slotOwners[i]+1 < mnemsNum) ?
+                firstEntries[slotOwners[i]+1] : instrSortedTable.size();
+        slot.mnemonic = instrSortedTable[first].mnemonic;
+        slot.length = ::strlen(slot.mnemonic);
+        // first entry (in sorted order) that matches to architecture
+        for (size_t k = first; k < end; k++)
+            for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+                if (slot.archIndices[arch] == UINT16_MAX &&
+                    (instrSortedTable[k].archMask & (1U<<arch)) != 0)
+                    slot.archIndices[arch] = k;
+    }
+    return true;
+}
+
+/*
+ * writing tables
+ */
+
+static void writeMnemonic(std::ostream& os, const char* mnemonic)
+{
+    if (mnemonic != nullptr)
+        os << '"' << mnemonic << '"';
+    else
+        os << "nullptr";
+}
+
+static void writeGCNInsnSizeTables(std::ostream& os)
+{
+    os << "const GCNInsnSizeEntry CLRX::gcnInsnSizeTables["
+            "cxuint(GPUArchitecture::GPUARCH_MAX)+1][512] =\n{\n";
+    for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+    {
+        os << "    {\n";
+        for (uint32_t i = 0; i < 512; i++)
+        {
+            const GCNInsnSizeEntry entry = getGCNInsnSizeEntry(
+                        GPUArchitecture(arch), i<<23);
+            os << ((i&7) == 0 ? "        " : " ") << "{ " << cxuint(entry.encoding) <<
+                    ", " << cxuint(entry.sizeFlags) << " }" << (i+1 < 512 ? "," : "") <<
+                    ((i&7) == 7 ? "\n" : "");
+        }
+        os << "    }" << (arch < cxuint(GPUArchitecture::GPUARCH_MAX) ? "," : "") << "\n";
+    }
+    os << "};\n\n";
+}
+
+static void writeGCNInstrTableByCode(std::ostream& os)
+{
+    os << "const GCNInstruction CLRX::gcnInstrTableByCode[gcnInstrTableByCodeLength] =\n"
+            "{\n";
+    for (size_t i = 0; i < instrTableByCode.size(); i++)
+    {
+        const GCNInstruction& instr = instrTableByCode[i];
+        os << "    { ";
+        writeMnemonic(os, instr.mnemonic);
+        os << ", " << cxuint(instr.encoding) << ", " << instr.mode << ", " <<
+                instr.code << ", " << instr.archMask << " }" <<
+                (i+1 < instrTableByCode.size() ? ",\n" : "\n");
+    }
+    os << "};\n\n";
+    
+    os << "const uint16_t CLRX::gcnInstrIndexByCode[gcnInstrTableByCodeLength] =\n{\n";
+    for (size_t i = 0; i < instrIndexByCode.size(); i++)
+        os << ((i&7) == 0 ? "    " : " ") << instrIndexByCode[i] <<
+                (i+1 < instrIndexByCode.size() ? "," : "") << ((i&7) == 7 ? "\n" : "");
+    os << "\n};\n\n";
+}
+
+static void writeGCNAsmTables(std::ostream& os)
+{
+    os << "const GCNAsmInstruction CLRX::gcnInstrSortedTable[] =\n{\n";
+    for (size_t i = 0; i < instrSortedTable.size(); i++)
+    {
+        const GCNAsmInstruction& instr = instrSortedTable[i];
+        os << "    { ";
+        writeMnemonic(os, instr.mnemonic);
+        os << ", " << cxuint(instr.encoding) << ", " << instr.mode << ", " <<
+                instr.code1 << ", " << instr.code2 << ", " << instr.archMask << " }" <<
+                (i+1 < instrSortedTable.size() ? ",\n" : "\n");
+    }
+    os << "};\n\n";
+    
+    os << "const GCNMnemonicSlot CLRX::gcnMnemonicSlots[] =\n{\n";
+    for (size_t i = 0; i < mnemonicSlots.size(); i++)
+    {
+        const GCNMnemonicSlot& slot = mnemonicSlots[i];
+        os << "    { ";
+        writeMnemonic(os, slot.mnemonic);
+        os << ", " << slot.length << ", {";
+        for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+            os << " " << slot.archIndices[arch] <<
+                    (arch < cxuint(GPUArchitecture::GPUARCH_MAX) ? "," : "");
+        os << " } }" << (i+1 < mnemonicSlots.size() ? ",\n" : "\n");
+    }
+    os << "};\n\n";
+    
+    os << "const uint32_t CLRX::gcnMnemonicDisps[] =\n{\n";
+    for (size_t i = 0; i < mnemonicDisps.size(); i++)
+        os << ((i&7) == 0 ? "    " : " ") << mnemonicDisps[i] << "U" <<
+                (i+1 < mnemonicDisps.size() ? "," : "") << ((i&7) == 7 ? "\n" : "");
+    os << "\n};\n\n"
+            "const size_t CLRX::gcnMnemonicDispsNum = " << mnemonicDisps.size() << ";\n"
+            "const size_t CLRX::gcnMnemonicSlotsMask = " << mnemonicSlots.size()-1 << ";\n";
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: GCNTablesGen OUTPUTFILE" << std::endl;
+        return 1;
+    }
+    // indices to main instruction table are stored in 16-bit fields
+    // (UINT16_MAX is reserved for 'no instruction')
+    size_t instrsNum = 0;
+    while (gcnInstrsTable[instrsNum].mnemonic != nullptr)
+        instrsNum++;
+    if (instrsNum >= UINT16_MAX)
+    {
+        std::cerr << "Too many instructions in main table (" << instrsNum <<
+                "), 16-bit indices are too small" << std::endl;
+        return 1;
+    }
+    generateGCNInstrTableByCode();
+    generateGCNInstrSortedTable();
+    if (!generateGCNMnemonicIndex())
+    {
+        std::cerr << "Can't find perfect hash for GCN mnemonics" << std::endl;
+        return 1;
+    }
+    
+    std::ofstream ofs(argv[1], std::ios::binary);
+    if (!ofs)
+    {
+        std::cerr << "Can't open output file '" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+    ofs << "/* GCN instruction tables - generated by GCNTablesGen, do not edit! */\n\n"
+            "#include <CLRX/Config.h>\n"
+            "#include \"amdasm/GCNInternals.h\"\n\n"
+            "using namespace CLRX;\n\n";
+    writeGCNInsnSizeTables(ofs);
+    writeGCNInstrTableByCode(ofs);
+    writeGCNAsmTables(ofs);
+    ofs.flush();
+    if (!ofs)
+    {
+        std::cerr << "Can't write output file '" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+    return 0;
+}
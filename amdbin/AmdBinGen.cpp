@@ -620,7 +620,7 @@ public:
     void operator()(FastOutputBuffer& fob) const
     {
         for (TempAmdKernelData& kernel: tempDatas)
-            kernel.elfBinGen.generate(fob);
+            kernel.elfBinGen.generateNested(fob);
     }
 };
 
@@ -1804,41 +1804,14 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
         throw BinGenException("Binary size is too big!");
     /****
      * prepare for write binary to output
+     * array and vector are filled directly, without intermediate stream
      ****/
-    std::unique_ptr<std::ostream> outStreamHolder;
-    std::ostream* os = nullptr;
-    if (aPtr != nullptr)
-    {
-        aPtr->resize(binarySize);
-        outStreamHolder.reset(
-            new ArrayOStream(binarySize, reinterpret_cast<char*>(aPtr->data())));
-        os = outStreamHolder.get();
-    }
-    else if (vPtr != nullptr)
-    {
-        vPtr->resize(binarySize);
-        outStreamHolder.reset(new VectorOStream(*vPtr));
-        os = outStreamHolder.get();
-    }
-    else // from argument
-        os = osPtr;
-    
-    const std::ios::iostate oldExceptions = os->exceptions();
-    FastOutputBuffer fob(256, *os);
-    try
-    {
-        os->exceptions(std::ios::failbit | std::ios::badbit);
-        if (input->is64Bit)
-            elfBinGen64->generate(fob);
-        else
-            elfBinGen32->generate(fob);
-    }
-    catch(...)
-    {
-        os->exceptions(oldExceptions);
-        throw;
-    }
-    os->exceptions(oldExceptions);
+    FastOutputBufferHolder fobHolder(size_t(binarySize), osPtr, vPtr, aPtr);
+    FastOutputBuffer& fob = fobHolder.getBuffer();
+    if (input->is64Bit)
+        elfBinGen64->generate(fob);
+    else
+        elfBinGen32->generate(fob);
     assert(fob.getWritten() == binarySize);
 }
 
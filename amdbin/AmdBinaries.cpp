@@ -22,7 +22,7 @@
 #include <cstring>
 #include <climits>
 #include <cstdint>
-#include <map>
+#include <algorithm>
 #include <mutex>
 #include <utility>
 #include <vector>
@@ -31,6 +31,7 @@
 #include <CLRX/utils/MemAccess.h>
 #include <CLRX/amdbin/AmdBinaries.h>
 #include <CLRX/utils/GPUId.h>
+#include "BinInternals.h"
 
 /* INFO: in this file is used ULEV function for conversion
  * from LittleEndian and unaligned access to other memory access policy and endianness
@@ -616,102 +617,253 @@ AmdMainBinaryBase::AmdMainBinaryBase(AmdMainType _type) : type(_type)
 AmdMainBinaryBase::~AmdMainBinaryBase()
 { }
 
+void AmdMainBinaryBase::parseLazyKernelInfo(size_t index) const
+{ }
+
+void AmdMainBinaryBase::prepareKernelInfo(size_t index) const
+{
+    callOnce(kernelInfoOnceFlags[index], [this, index]()
+            { parseLazyKernelInfo(index); });
+}
+
+void AmdMainBinaryBase::prepareKernelInfos() const
+{
+    for (size_t i = 0; i < kernelInfos.size(); i++)
+        prepareKernelInfo(i);
+}
+
+void AmdMainBinaryBase::releaseKernelInfo(size_t index)
+{
+    if (!kernelInfoOnceFlags)
+        return; // not lazy mode
+    KernelInfo& kernelInfo = kernelInfos[index];
+    kernelInfo.argInfos.clear();
+    /* reset once flag, this kernel info will be parsed at next access
+     * (access is exclusive, hence no thread waits on this flag) */
+    kernelInfoOnceFlags[index].reset();
+}
+
 const KernelInfo& AmdMainBinaryBase::getKernelInfo(const char* name) const
 {
     KernelInfoMap::const_iterator it = binaryMapFind(
         kernelInfosMap.begin(), kernelInfosMap.end(), name);
     if (it == kernelInfosMap.end())
         throw BinException("Can't find kernel name");
-    return kernelInfos[it->second];
+    return getKernelInfo(it->second);
 }
 
 static const cxuint vectorIdTable[17] =
 { UINT_MAX, 0, 1, 2, 3, UINT_MAX, UINT_MAX, UINT_MAX, 4,
   UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, 5 };
 
-static KernelArgType determineKernelArgType(const char* typeString,
+/* perfect hash tables of names used in AMD GPU kernel metadata (keywords and
+ * argument type names). hash: (name[0] + 5*name[1] + 2*length) & 15.
+ * found entry must be verified by comparing whole name */
+
+struct CLRX_INTERNAL MetadataNameEntry
+{
+    const char* name;
+    cxuint value;
+};
+
+enum : cxuint
+{
+    METADATA_VALUE = 0,
+    METADATA_POINTER,
+    METADATA_IMAGE,
+    METADATA_SAMPLER,
+    METADATA_CONSTARG,
+    METADATA_COUNTER,
+    METADATA_REFLECTION
+};
+
+static const MetadataNameEntry metadataKeywordTable[16] =
+{
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { "image", METADATA_IMAGE },
+    { "value", METADATA_VALUE },
+    { "sampler", METADATA_SAMPLER },
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { "pointer", METADATA_POINTER },
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { "counter", METADATA_COUNTER },
+    { nullptr, 0 },
+    { "constarg", METADATA_CONSTARG },
+    { "reflection", METADATA_REFLECTION }
+};
+
+// value - index of first type in gpuArgTypeTable
+static const MetadataNameEntry metadataArgTypeTable[16] =
+{
+    { "u16", 2*6 },
+    { "u8", 0 },
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { "i16", 3*6 },
+    { "i8", 1*6 },
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { nullptr, 0 },
+    { "u64", 6*6 },
+    { "u32", 4*6 },
+    { "double", 9*6 },
+    { "float", 8*6 },
+    { "i64", 7*6 },
+    { "i32", 5*6 },
+    { nullptr, 0 }
+};
+
+// find name in perfect hash table, returns nullptr if not found
+static const MetadataNameEntry* findMetadataName(const MetadataNameEntry* table,
+            const char* name, size_t length)
+{
+    if (length < 2)
+        return nullptr;
+    const MetadataNameEntry& entry = table[(cxuint(cxbyte(name[0])) +
+            5*cxuint(cxbyte(name[1])) + 2*length) & 15];
+    if (entry.name == nullptr || ::strncmp(entry.name, name, length) != 0 ||
+        entry.name[length] != 0)
+        return nullptr;
+    return &entry;
+}
+
+// keywords in order of checking, name in metadata can be shortened (prefix of keyword)
+static const MetadataNameEntry metadataKeywordsInOrder[7] =
+{
+    { "value", METADATA_VALUE },
+    { "pointer", METADATA_POINTER },
+    { "image", METADATA_IMAGE },
+    { "sampler", METADATA_SAMPLER },
+    { "constarg", METADATA_CONSTARG },
+    { "counter", METADATA_COUNTER },
+    { "reflection", METADATA_REFLECTION }
+};
+
+// find keyword of metadata line, returns nullptr if line should be skipped
+static const MetadataNameEntry* findMetadataKeyword(const char* name, size_t length)
+{
+    const MetadataNameEntry* entry = findMetadataName(metadataKeywordTable,
+                name, length);
+    if (entry != nullptr)
+        return entry;
+    // shortened keyword: first keyword that begins with name
+    for (const MetadataNameEntry& keyword: metadataKeywordsInOrder)
+        if (::strncmp(keyword.name, name, length) == 0)
+            return &keyword;
+    return nullptr;
+}
+
+static KernelArgType determineKernelArgType(const char* typeString, size_t typeLength,
            cxuint vectorSize, LineNo lineNo)
 {
-    KernelArgType outType;
-    
     if (vectorSize > 16)
         throw ParseException(lineNo, "Wrong vector size");
     const cxuint vectorId = vectorIdTable[vectorSize];
     if (vectorId == UINT_MAX)
         throw ParseException(lineNo, "Wrong vector size");
     
-    if (::strncmp(typeString, "float:", 6) == 0)
-        outType = gpuArgTypeTable[8*6+vectorId];
-    else if (::strncmp(typeString, "double:", 7) == 0)
-        outType = gpuArgTypeTable[9*6+vectorId];
-    else if ((typeString[0] == 'i' || typeString[0] == 'u'))
-    {
-        /* indexBase - choose between unsigned/signed */
-        const cxuint indexBase = (typeString[0] == 'i')?6:0;
-        if (typeString[1] == '8')
-        {   // 8-bit type
-            if (typeString[2] != ':')
-                throw ParseException(lineNo, "Can't parse type");
-            outType = gpuArgTypeTable[indexBase+vectorId];
-        }
-        else
-        {
-            // 16,32,64 bit types
-            if (typeString[1] == '1' && typeString[2] == '6')
-                outType = gpuArgTypeTable[indexBase+2*6+vectorId];
-            else if (typeString[1] == '3' && typeString[2] == '2')
-                outType = gpuArgTypeTable[indexBase+4*6+vectorId];
-            else if (typeString[1] == '6' && typeString[2] == '4')
-                outType = gpuArgTypeTable[indexBase+6*6+vectorId];
-            else // if not determined
-                throw ParseException(lineNo, "Can't parse type");
-            if (typeString[3] != ':')
-                throw ParseException(lineNo, "Can't parse type");
-        }
-    }
-    else
+    const MetadataNameEntry* entry = findMetadataName(metadataArgTypeTable,
+                typeString, typeLength);
+    if (entry == nullptr)
         throw ParseException(lineNo, "Can't parse type");
-    
-    return outType;
+    return gpuArgTypeTable[entry->value+vectorId];
 }
 
-static inline CString stringFromCStringDelim(const char* c1, size_t maxSize, char delim)
+// returns end of metadata field (pointer to ':', '\n' or end of metadata)
+static inline const char* findMetadataFieldEnd(const char* kptr, const char* kend)
 {
-    size_t i = 0;
-    for (i = 0; i < maxSize && c1[i] != delim; i++);
-    return CString(c1, i);
+    while (kptr < kend && *kptr != ':' && *kptr != '\n') kptr++;
+    return kptr;
 }
 
-/* metadata string that stored in rodata section in main GPU binary holds needed kernel
- * argument info (arg type and arg name). this function just retrieve that data */
-static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
-          const char* kernelDesc, KernelInfo& kernelInfo)
+/* internal table of kernel arguments collected from metadata, names are
+ * pointers into metadata (no string allocations), indexed by name hash index */
+class CLRX_INTERNAL InitKernelArgTable
 {
-    // internal structure to hold kernel arguments info in map
-    struct InitKernelArgMapEntry
+public:
+    struct Entry
     {
-        uint32_t index;
         KernelArgType argType;
         KernelArgType origArgType;
         KernelPtrSpace ptrSpace;
         uint32_t ptrAccess;
         const char* nameStr;
-        
-        InitKernelArgMapEntry() : index(0), argType(KernelArgType::VOID),
-            origArgType(KernelArgType::VOID),
-            ptrSpace(KernelPtrSpace::NONE), ptrAccess(0), nameStr(nullptr)
-        { }
+        size_t nameLength;
+    };
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        uint32_t index;
     };
-    typedef std::map<CString, InitKernelArgMapEntry> InitKernelArgMap;
+    std::vector<Entry> entries;
+    Array<Slot> hashIndex;
     
+    size_t findSlot(const char* name, size_t length, uint32_t hash) const
+    {
+        return findNameHashSlot(hashIndex, hash, [this, name, length](size_t index)
+            {
+                const Entry& entry = entries[index];
+                return entry.nameLength == length &&
+                        ::memcmp(entry.nameStr, name, length) == 0;
+            });
+    }
+public:
+    // maxArgsNum must be not less than number of arguments to insert
+    explicit InitKernelArgTable(size_t maxArgsNum)
+    {
+        initNameHashIndex(hashIndex, maxArgsNum);
+        entries.reserve(maxArgsNum);
+    }
+    
+    size_t size() const
+    { return entries.size(); }
+    
+    Entry& operator[](size_t index)
+    { return entries[index]; }
+    const Entry& operator[](size_t index) const
+    { return entries[index]; }
+    
+    // returns nullptr if argument not found
+    Entry* find(const char* name, size_t length)
+    {
+        const Slot& slot = hashIndex[findSlot(name, length, hashOfName(name, length))];
+        return (slot.index != 0) ? &entries[slot.index-1] : nullptr;
+    }
+    
+    // returns nullptr if argument already exists
+    Entry* insert(const char* name, size_t length, KernelArgType argType,
+                KernelPtrSpace ptrSpace = KernelPtrSpace::NONE)
+    {
+        const uint32_t hash = hashOfName(name, length);
+        Slot& slot = hashIndex[findSlot(name, length, hash)];
+        if (slot.index != 0)
+            return nullptr;
+        entries.push_back({ argType, KernelArgType::VOID, ptrSpace, 0, name, length });
+        slot = { hash, uint32_t(entries.size()) };
+        return &entries.back();
+    }
+};
+
+/* metadata string that stored in rodata section in main GPU binary holds needed kernel
+ * argument info (arg type and arg name). this function just retrieve that data */
+// kernel name must be set by caller
+static void parseAmdGpuKernelMetadata(size_t metadataSize, const char* kernelDesc,
+          KernelInfo& kernelInfo)
+{
+    typedef InitKernelArgTable::Entry InitKernelArgEntry;
     /* parse kernel description */
     LineNo lineNo = 1;
-    uint32_t argIndex = 0;
-    
-    InitKernelArgMap initKernelArgs;
     
     const char* kptr = kernelDesc;
     const char* kend = kernelDesc + metadataSize;
+    // every argument needs own line
+    InitKernelArgTable initKernelArgs(std::count(kptr, kend, '\n')+1);
     // first phase (value/pointer/image/sampler)
     while (kptr < kend)
     {
@@ -721,51 +873,46 @@ static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
         if (kptr >= kend)
             throw ParseException(lineNo, "This is not KernelDesc line");
         
-        const char* tokPtr = kptr;
-        while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
+        const char* tokPtr = findMetadataFieldEnd(kptr, kend);
         if (tokPtr >= kend)
             throw ParseException(lineNo, "Is not KernelDesc line");
         
-        if (::strncmp(kptr, "value", tokPtr-kptr) == 0)
+        const MetadataNameEntry* keyword = findMetadataKeyword(kptr, tokPtr-kptr);
+        switch (keyword != nullptr ? keyword->value : UINT_MAX)
         {
-            // value
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not value line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after name");
-            
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
+            case METADATA_VALUE:
             {
-                InitKernelArgMapEntry entry;
-                entry.index = argIndex++;
-                entry.nameStr = kptr;
-                std::pair<InitKernelArgMap::iterator, bool> result = 
-                    initKernelArgs.insert(std::make_pair(CString(kptr, tokPtr), entry));
-                if (!result.second)
+                // value
+                if (*tokPtr == '\n')
+                    throw ParseException(lineNo, "This is not value line");
+                
+                kptr = ++tokPtr;
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                if (tokPtr >= kend || *tokPtr =='\n')
+                    throw ParseException(lineNo, "No separator after name");
+                
+                // extract arg name
+                InitKernelArgEntry* argEntry = initKernelArgs.insert(kptr, tokPtr-kptr,
+                            KernelArgType::VOID);
+                if (argEntry == nullptr)
                     throw ParseException(lineNo, "Argument has been duplicated");
-                argIt = result.first;
-            }
-            ///
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after type");
-            // get arg type
-            const char* argType = kptr;
-            ///
-            if (tokPtr-kptr != 6 || ::strncmp(argType, "struct", 6)!=0)
-            {
-                // regular type
+                ///
                 kptr = ++tokPtr;
-                while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
                 if (tokPtr >= kend || *tokPtr =='\n')
-                    throw ParseException(lineNo, "No separator after vector size");
-                // get vector size
+                    throw ParseException(lineNo, "No separator after type");
+                // get arg type
+                const char* argType = kptr;
+                const size_t argTypeLength = tokPtr-kptr;
+                ///
+                if (argTypeLength != 6 || ::strncmp(argType, "struct", 6)!=0)
                 {
+                    // regular type
+                    kptr = ++tokPtr;
+                    tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                    if (tokPtr >= kend || *tokPtr =='\n')
+                        throw ParseException(lineNo, "No separator after vector size");
+                    // get vector size
                     const char* outEnd;
                     cxuint vectorSize = 0;
                     try
@@ -774,272 +921,257 @@ static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
                     { throw ParseException(lineNo, ex.what()); }
                     if (outEnd != tokPtr)
                         throw ParseException(lineNo, "Garbages after integer");
-                    argIt->second.argType = determineKernelArgType(argType,
-                           vectorSize, lineNo);
+                    argEntry->argType = determineKernelArgType(argType, argTypeLength,
+                               vectorSize, lineNo);
+                    kptr = tokPtr;
                 }
-                kptr = tokPtr;
-            }
-            else // if structure
-                argIt->second.argType = KernelArgType::STRUCTURE;
-        }
-        else if (::strncmp(kptr, "pointer", tokPtr-kptr) == 0)
-        {
-            // pointer
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not pointer line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after name");
-            
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
-            {
-                InitKernelArgMapEntry entry;
-                entry.index = argIndex++;
-                entry.nameStr = kptr;
-                entry.argType = KernelArgType::POINTER;
-                std::pair<InitKernelArgMap::iterator, bool> result = 
-                    initKernelArgs.insert(std::make_pair(CString(kptr, tokPtr), entry));
-                if (!result.second)
-                    throw ParseException(lineNo, "Argument has been duplicated");
-                argIt = result.first;
+                else // if structure
+                    argEntry->argType = KernelArgType::STRUCTURE;
+                break;
             }
-            ///
-            ++tokPtr;
-            for (cxuint k = 0; k < 4; k++) // // skip four fields
+            case METADATA_POINTER:
             {
-                while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
+                // pointer
+                if (*tokPtr == '\n')
+                    throw ParseException(lineNo, "This is not pointer line");
+                
+                kptr = ++tokPtr;
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
                 if (tokPtr >= kend || *tokPtr =='\n')
-                    throw ParseException(lineNo, "No separator after field");
-                tokPtr++;
-            }
-            kptr = tokPtr;
-            // get pointer type (global/local/constant)
-            if (kptr+4 <= kend && *kptr == 'u' && kptr[1] == 'a' && kptr[2] == 'v' &&
-                kptr[3] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::GLOBAL; kptr += 4; }
-            else if (kptr+3 <= kend && *kptr == 'h' && kptr[1] == 'c' && kptr[2] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::CONSTANT; kptr += 3; }
-            else if (kptr+3 <= kend && *kptr == 'h' && kptr[1] == 'l' && kptr[2] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::LOCAL; kptr += 3; }
-            else if (kptr+2 <= kend && *kptr == 'c' && kptr[1] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::CONSTANT; kptr += 2; }
-            else //if not match
-                throw ParseException(lineNo, "Unknown pointer type");
-            
-            tokPtr = kptr;
-            for (cxuint k = 0; k < 2; k++) // // skip two fields
-            {
-                while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
+                    throw ParseException(lineNo, "No separator after name");
+                
+                // extract arg name
+                InitKernelArgEntry* argEntry = initKernelArgs.insert(kptr, tokPtr-kptr,
+                            KernelArgType::POINTER);
+                if (argEntry == nullptr)
+                    throw ParseException(lineNo, "Argument has been duplicated");
+                ///
+                ++tokPtr;
+                for (cxuint k = 0; k < 4; k++) // // skip four fields
+                {
+                    tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                    if (tokPtr >= kend || *tokPtr =='\n')
+                        throw ParseException(lineNo, "No separator after field");
+                    tokPtr++;
+                }
+                kptr = tokPtr;
+                // get pointer type (global/local/constant)
+                if (kptr+4 <= kend && *kptr == 'u' && kptr[1] == 'a' && kptr[2] == 'v' &&
+                    kptr[3] == ':')
+                { argEntry->ptrSpace = KernelPtrSpace::GLOBAL; kptr += 4; }
+                else if (kptr+3 <= kend && *kptr == 'h' && kptr[1] == 'c' && kptr[2] == ':')
+                { argEntry->ptrSpace = KernelPtrSpace::CONSTANT; kptr += 3; }
+                else if (kptr+3 <= kend && *kptr == 'h' && kptr[1] == 'l' && kptr[2] == ':')
+                { argEntry->ptrSpace = KernelPtrSpace::LOCAL; kptr += 3; }
+                else if (kptr+2 <= kend && *kptr == 'c' && kptr[1] == ':')
+                { argEntry->ptrSpace = KernelPtrSpace::CONSTANT; kptr += 2; }
+                else //if not match
+                    throw ParseException(lineNo, "Unknown pointer type");
+                
+                tokPtr = kptr;
+                for (cxuint k = 0; k < 2; k++) // // skip two fields
+                {
+                    tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                    if (tokPtr >= kend || *tokPtr =='\n')
+                        throw ParseException(lineNo, "No separator after field");
+                    tokPtr++;
+                }
+                // RO/RW
+                kptr = tokPtr;
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
                 if (tokPtr >= kend || *tokPtr =='\n')
-                    throw ParseException(lineNo, "No separator after field");
-                tokPtr++;
-            }
-            // RO/RW
-            kptr = tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after access qualifier");
-            if (kptr+3 <= kend && *kptr=='R' && kptr[1]=='O' && kptr[2]==':' &&
-                argIt->second.ptrSpace==KernelPtrSpace::GLOBAL)
-                argIt->second.ptrAccess |= KARG_PTR_CONST;
-            else if (kptr+3 <= kend && *kptr=='R' && kptr[1]=='W' && kptr[2]==':')
-                argIt->second.ptrAccess |= KARG_PTR_NORMAL;
-            /* volatile specifier */
-            kptr = ++tokPtr;
-            if (kptr+2 <= kend && kptr[1] == ':' && (*kptr == '0' || *kptr == '1'))
-            {
-                if (*kptr == '1')
-                    argIt->second.ptrAccess |= KARG_PTR_VOLATILE;
-                kptr += 2;
-            }
-            else // error
-                throw ParseException("Unknown value or end at volatile field");
-            
-            /* restrict specifier */
-            if (kptr+2 <= kend && kptr[1] == '\n' && (*kptr == '0' || *kptr == '1'))
-            {
-                if (*kptr == '1')
-                    argIt->second.ptrAccess |= KARG_PTR_RESTRICT;
-                kptr++;
+                    throw ParseException(lineNo, "No separator after access qualifier");
+                if (kptr+3 <= kend && *kptr=='R' && kptr[1]=='O' && kptr[2]==':' &&
+                    argEntry->ptrSpace==KernelPtrSpace::GLOBAL)
+                    argEntry->ptrAccess |= KARG_PTR_CONST;
+                else if (kptr+3 <= kend && *kptr=='R' && kptr[1]=='W' && kptr[2]==':')
+                    argEntry->ptrAccess |= KARG_PTR_NORMAL;
+                /* volatile specifier */
+                kptr = ++tokPtr;
+                if (kptr+2 <= kend && kptr[1] == ':' && (*kptr == '0' || *kptr == '1'))
+                {
+                    if (*kptr == '1')
+                        argEntry->ptrAccess |= KARG_PTR_VOLATILE;
+                    kptr += 2;
+                }
+                else // error
+                    throw ParseException("Unknown value or end at volatile field");
+                
+                /* restrict specifier */
+                if (kptr+2 <= kend && kptr[1] == '\n' && (*kptr == '0' || *kptr == '1'))
+                {
+                    if (*kptr == '1')
+                        argEntry->ptrAccess |= KARG_PTR_RESTRICT;
+                    kptr++;
+                }
+                else // error
+                    throw ParseException("Unknown value or end at restrict field");
+                break;
             }
-            else // error
-                throw ParseException("Unknown value or end at restrict field");
-        }
-        else if (::strncmp(kptr, "image", tokPtr-kptr) == 0)
-        {
-            // parse image arg
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not image line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr == '\n')
-                throw ParseException(lineNo, "No separator after name");
-            
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
-            InitKernelArgMapEntry entry;
-            entry.index = argIndex++;
-            entry.nameStr = kptr;
-            entry.ptrSpace = KernelPtrSpace::GLOBAL;
-            CString name(kptr, tokPtr);
-            
-            kptr = ++tokPtr;
-            // quick image type parsing (1D,1DA,1DB,2D,2DA,3D)
-            if (kptr+3 < kend)
+            case METADATA_IMAGE:
             {
-                if (kptr[1] != 'D')
-                    throw ParseException("Unknown image type");
-                if (*kptr == '1')
+                // parse image arg
+                if (*tokPtr == '\n')
+                    throw ParseException(lineNo, "This is not image line");
+                
+                kptr = ++tokPtr;
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                if (tokPtr >= kend || *tokPtr == '\n')
+                    throw ParseException(lineNo, "No separator after name");
+                
+                // extract arg name
+                const char* name = kptr;
+                const size_t nameLength = tokPtr-kptr;
+                KernelArgType argType = KernelArgType::VOID;
+                
+                kptr = ++tokPtr;
+                // quick image type parsing (1D,1DA,1DB,2D,2DA,3D)
+                if (kptr+3 < kend)
                 {
-                    // one dimensional image
-                    if (kptr[2] == 'A')
-                    { entry.argType = KernelArgType::IMAGE1D_ARRAY; kptr += 3; }
-                    else if (kptr[2] == 'B')
-                    { entry.argType = KernelArgType::IMAGE1D_BUFFER; kptr += 3; }
+                    if (kptr[1] != 'D')
+                        throw ParseException("Unknown image type");
+                    if (*kptr == '1')
+                    {
+                        // one dimensional image
+                        if (kptr[2] == 'A')
+                        { argType = KernelArgType::IMAGE1D_ARRAY; kptr += 3; }
+                        else if (kptr[2] == 'B')
+                        { argType = KernelArgType::IMAGE1D_BUFFER; kptr += 3; }
+                        else
+                        { argType = KernelArgType::IMAGE1D; kptr += 2; }
+                    }
+                    else if (*kptr == '2')
+                    {
+                        if (kptr[2] == 'A')
+                        { argType = KernelArgType::IMAGE2D_ARRAY; kptr += 3; }
+                        else
+                        { argType = KernelArgType::IMAGE2D; kptr += 2; }
+                    }
+                    else if (*kptr == '3')
+                    { argType = KernelArgType::IMAGE3D; kptr += 2; }
                     else
-                    { entry.argType = KernelArgType::IMAGE1D; kptr += 2; }
+                        throw ParseException("Unknown image type");
+                    if (kptr >= kend || *kptr != ':')
+                        throw ParseException("No separator after field");
                 }
-                else if (*kptr == '2')
+                else
+                    throw ParseException(lineNo, "No separator after field");
+                
+                InitKernelArgEntry* argEntry = initKernelArgs.insert(name, nameLength,
+                            argType, KernelPtrSpace::GLOBAL);
+                if (argEntry == nullptr)
+                    throw ParseException(lineNo, "Argument has been duplicated");
+                
+                ++kptr;
+                if (kptr+3 > kend || kptr[2] != ':')
+                    throw ParseException(lineNo, "Can't parse image access qualifier");
+                // handle img access qualifier: RO,WO,RW */
+                if (*kptr == 'R' && kptr[1] == 'O')
+                    argEntry->ptrAccess |= KARG_PTR_READ_ONLY;
+                else if (*kptr == 'W' && kptr[1] == 'O')
+                    argEntry->ptrAccess |= KARG_PTR_WRITE_ONLY;
+                else if (*kptr == 'R' && kptr[1] == 'W') //???
+                    argEntry->ptrAccess |= KARG_PTR_READ_WRITE;
+                else
+                    throw ParseException(lineNo, "Can't parse image access qualifier");
+                kptr += 3;
+                break;
+            }
+            case METADATA_SAMPLER:
+            {
+                // sampler (set up some argument as sampler
+                if (*tokPtr == '\n')
+                    throw ParseException(lineNo, "This is not sampler line");
+                
+                kptr = ++tokPtr;
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                if (tokPtr >= kend)
+                    throw ParseException(lineNo, "No separator after name");
+                
+                InitKernelArgEntry* argEntry = initKernelArgs.find(kptr, tokPtr-kptr);
+                if (argEntry != nullptr)
                 {
-                    if (kptr[2] == 'A')
-                    { entry.argType = KernelArgType::IMAGE2D_ARRAY; kptr += 3; }
-                    else
-                    { entry.argType = KernelArgType::IMAGE2D; kptr += 2; }
+                    argEntry->origArgType = argEntry->argType;
+                    argEntry->argType = KernelArgType::SAMPLER;
                 }
-                else if (*kptr == '3')
-                { entry.argType = KernelArgType::IMAGE3D; kptr += 2; }
-                else
-                    throw ParseException("Unknown image type");
-                if (kptr >= kend || *kptr != ':')
-                    throw ParseException("No separator after field");
+                
+                kptr = tokPtr;
+                break;
             }
-            else
-                throw ParseException(lineNo, "No separator after field");
-            
-            std::pair<InitKernelArgMap::iterator, bool> result = 
-                initKernelArgs.insert(std::make_pair(name, entry));
-            if (!result.second)
-                throw ParseException(lineNo, "Argument has been duplicated");
-            argIt = result.first;
-            
-            ++kptr;
-            if (kptr+3 > kend || kptr[2] != ':')
-                throw ParseException(lineNo, "Can't parse image access qualifier");
-            // handle img access qualifier: RO,WO,RW */
-            if (*kptr == 'R' && kptr[1] == 'O')
-                argIt->second.ptrAccess |= KARG_PTR_READ_ONLY;
-            else if (*kptr == 'W' && kptr[1] == 'O')
-                argIt->second.ptrAccess |= KARG_PTR_WRITE_ONLY;
-            else if (*kptr == 'R' && kptr[1] == 'W') //???
-                argIt->second.ptrAccess |= KARG_PTR_READ_WRITE;
-            else
-                throw ParseException(lineNo, "Can't parse image access qualifier");
-            kptr += 3;
-        }
-        else if (::strncmp(kptr, "sampler", tokPtr-kptr) == 0)
-        {
-            // sampler (set up some argument as sampler
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not sampler line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend)
-                throw ParseException(lineNo, "No separator after name");
-            
-            CString argName(kptr, tokPtr);
-            InitKernelArgMap::iterator argIt = initKernelArgs.find(argName);
-            if (argIt != initKernelArgs.end())
+            case METADATA_CONSTARG:
             {
-                argIt->second.origArgType = argIt->second.argType;
-                argIt->second.argType = KernelArgType::SAMPLER;
+                if (*tokPtr == '\n')
+                    throw ParseException(lineNo, "This is not constarg line");
+                
+                kptr = ++tokPtr;
+                // skip number
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                if (tokPtr >= kend || *tokPtr == '\n')
+                    throw ParseException(lineNo, "No separator after field");
+                
+                kptr = ++tokPtr;
+                while (tokPtr < kend && *tokPtr != '\n') tokPtr++;
+                if (tokPtr >= kend)
+                    throw ParseException(lineNo, "End of data");
+                
+                /// put constant
+                InitKernelArgEntry* argEntry = initKernelArgs.find(kptr, tokPtr-kptr);
+                if (argEntry == nullptr)
+                    throw ParseException(lineNo, "Can't find constant argument");
+                // set up const access type
+                argEntry->ptrAccess |= KARG_PTR_CONST;
+                kptr = tokPtr;
+                break;
             }
-            
-            kptr = tokPtr;
-        }
-        else if (::strncmp(kptr, "constarg", tokPtr-kptr) == 0)
-        {
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not constarg line");
-            
-            kptr = ++tokPtr;
-            // skip number
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr == '\n')
-                throw ParseException(lineNo, "No separator after field");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend)
-                throw ParseException(lineNo, "End of data");
-            
-            /// put constant
-            const CString thisName(kptr, tokPtr);
-            InitKernelArgMap::iterator argIt = initKernelArgs.find(thisName);
-            if (argIt == initKernelArgs.end())
-                throw ParseException(lineNo, "Can't find constant argument");
-            // set up const access type
-            argIt->second.ptrAccess |= KARG_PTR_CONST;
-            kptr = tokPtr;
-        }
-        else if (::strncmp(kptr, "counter", tokPtr-kptr) == 0)
-        {
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not constarg line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend)
-                throw ParseException(lineNo, "No separator after name");
-            
-            CString argName(kptr, tokPtr);
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
+            case METADATA_COUNTER:
             {
-                InitKernelArgMapEntry entry;
-                entry.index = argIndex++;
-                entry.nameStr = kptr;
-                entry.argType = KernelArgType::COUNTER32;
-                std::pair<InitKernelArgMap::iterator, bool> result = 
-                    initKernelArgs.insert(std::make_pair(CString(kptr, tokPtr), entry));
-                if (!result.second)
+                if (*tokPtr == '\n')
+                    throw ParseException(lineNo, "This is not constarg line");
+                
+                kptr = ++tokPtr;
+                tokPtr = findMetadataFieldEnd(tokPtr, kend);
+                if (tokPtr >= kend)
+                    throw ParseException(lineNo, "No separator after name");
+                
+                // extract arg name
+                if (initKernelArgs.insert(kptr, tokPtr-kptr,
+                            KernelArgType::COUNTER32) == nullptr)
                     throw ParseException(lineNo, "Argument has been duplicated");
-                argIt = result.first;
+                
+                kptr = tokPtr;
+                break;
             }
-            
-            kptr = tokPtr;
+            case METADATA_REFLECTION:
+                if (*tokPtr == '\n')
+                    throw ParseException(lineNo, "This is not reflection line");
+                break;
+            default:
+                break;
         }
-        else if (::strncmp(kptr, "reflection", tokPtr-kptr) == 0)
-        {
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not reflection line");
+        if (keyword != nullptr && keyword->value == METADATA_REFLECTION)
             break;
-        }
         
         while (kptr < kend && *kptr != '\n') kptr++;
         lineNo++;
         kptr++; // skip newline
     }
     
-    kernelInfo.kernelName.assign(symName+9, ::strlen(symName)-18);
-    kernelInfo.argInfos.resize(argIndex);
+    const size_t argsNum = initKernelArgs.size();
+    kernelInfo.argInfos.resize(argsNum);
     
-    for (const auto& e: initKernelArgs)
+    for (size_t i = 0; i < argsNum; i++)
     {
         /* initialize kernel arguments before set argument type from reflections */
-        AmdKernelArg& karg = kernelInfo.argInfos[e.second.index];
-        karg.argType = e.second.argType;
-        karg.ptrSpace = e.second.ptrSpace;
-        karg.ptrAccess = e.second.ptrAccess;
-        karg.argName = stringFromCStringDelim(e.second.nameStr, kend-e.second.nameStr, ':');
+        const InitKernelArgEntry& entry = initKernelArgs[i];
+        AmdKernelArg& karg = kernelInfo.argInfos[i];
+        karg.argType = entry.argType;
+        karg.ptrSpace = entry.ptrSpace;
+        karg.ptrAccess = entry.ptrAccess;
+        karg.argName.assign(entry.nameStr, entry.nameLength);
     }
     
     /* reflections holds argument type names, we just retrieve from arg type names! */
-    if (argIndex != 0)
+    if (argsNum != 0)
     {
         /* check whether not end */
         if (kptr >= kend)
@@ -1059,8 +1191,7 @@ static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
                 break; // end!!!
             kptr += 11;
             
-            const char* tokPtr = kptr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
+            const char* tokPtr = findMetadataFieldEnd(kptr, kend);
             if (tokPtr >= kend || *tokPtr == '\n')
                 throw ParseException(lineNo, "Is not KernelDesc line");
             
@@ -1073,26 +1204,25 @@ static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
             
             if (outEnd != tokPtr)
                 throw ParseException(lineNo, "Garbages after integer");
-            if (argIndex >= kernelInfo.argInfos.size())
+            if (argIndex >= argsNum)
                 throw ParseException(lineNo, "Argument index out of range");
             kptr = tokPtr+1;
             
+            const char* typeName = kptr;
+            while (kptr < kend && *kptr != '\n') kptr++;
+            const size_t typeNameLength = kptr-typeName;
+            
             AmdKernelArg& argInfo = kernelInfo.argInfos[argIndex];
-            argInfo.typeName = stringFromCStringDelim(kptr, kend-kptr, '\n');
+            argInfo.typeName.assign(typeName, typeNameLength);
             
-            if (argInfo.argName.compare(0, 8, "unknown_") == 0 &&
-                argInfo.typeName != "sampler_t" &&
-                argInfo.argType == KernelArgType::SAMPLER)
-            {
-                InitKernelArgMap::const_iterator argIt =
-                            initKernelArgs.find(argInfo.argName);
-                if (argIt != initKernelArgs.end() &&
-                    argIt->second.origArgType != KernelArgType::VOID)
-                    /* revert sampler type and restore original arg type */
-                    argInfo.argType = argIt->second.origArgType;
-            }    
+            const InitKernelArgEntry& entry = initKernelArgs[argIndex];
+            if (entry.nameLength >= 8 && ::strncmp(entry.nameStr, "unknown_", 8) == 0 &&
+                (typeNameLength != 9 || ::strncmp(typeName, "sampler_t", 9) != 0) &&
+                argInfo.argType == KernelArgType::SAMPLER &&
+                entry.origArgType != KernelArgType::VOID)
+                /* revert sampler type and restore original arg type */
+                argInfo.argType = entry.origArgType;
             
-            while (kptr < kend && *kptr != '\n') kptr++;
             lineNo++;
             kptr++;
         }
@@ -1131,6 +1261,7 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     const bool doKernelHeaders = (creationFlags & AMDBIN_CREATE_KERNELHEADERS) != 0;
     const bool doKernelInfo = (creationFlags & AMDBIN_CREATE_KERNELINFO) != 0;
     const bool doInfoStrings = (creationFlags & AMDBIN_CREATE_INFOSTRINGS) != 0;
+    const bool lazy = (creationFlags & AMDBIN_CREATE_LAZY) != 0;
     size_t compileOptionsEnd = 0;
     uint16_t compileOptionShIndex = SHN_UNDEF;
     
@@ -1212,6 +1343,11 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
         const typename Types::Shdr& textHdr = mainElf.getSectionHeader(textIndex);
         cxbyte* textContent = mainElf.getBinaryCode() + ULEV(textHdr.sh_offset);
         
+        if (lazy)
+        {
+            innerBinaryCodes.resize(choosenSyms.size());
+            innerBinaryOnceFlags.reset(new ResettableOnceFlag[choosenSyms.size()]);
+        }
         /* create table of innerBinaries */
         size_t ki = 0;
         for (auto it: choosenSyms)
@@ -1227,15 +1363,21 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
             if (usumGt(symvalue, symsize, ULEV(textHdr.sh_size)))
                 throw BinException("Inner binary offset+size out of range!");
             
-            innerBinaries[ki++] = AmdInnerGPUBinary32(CString(symName+9, len-16),
-                symsize, textContent+symvalue,
-                (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
+            if (lazy)
+                // inner binary will be created at first access
+                innerBinaryCodes[ki++] = { CString(symName+9, len-16),
+                            symsize, textContent+symvalue };
+            else
+                innerBinaries[ki++] = AmdInnerGPUBinary32(CString(symName+9, len-16),
+                    symsize, textContent+symvalue,
+                    (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
         }
         if ((creationFlags & AMDBIN_CREATE_INNERBINMAP) != 0)
         {
             innerBinaryMap.resize(innerBinaries.size());
             for (size_t i = 0; i < innerBinaries.size(); i++)
-                innerBinaryMap[i] = std::make_pair(innerBinaries[i].getKernelName(), i);
+                innerBinaryMap[i] = std::make_pair(lazy ? innerBinaryCodes[i].kernelName :
+                            innerBinaries[i].getKernelName(), i);
             mapSort(innerBinaryMap.begin(), innerBinaryMap.end());
         }
     }
@@ -1244,6 +1386,8 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     {
         kernelInfos.resize(choosenSymsMetadata.size());
         metadatas.reset(new AmdGPUKernelMetadata[kernelInfos.size()]);
+        if (lazy)
+            kernelInfoOnceFlags.reset(new ResettableOnceFlag[kernelInfos.size()]);
         
         typename Types::Size ki = 0;
         for (typename Types::Size it: choosenSymsMetadata)
@@ -1265,10 +1409,13 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
             if (usumGt(symvalue, symsize, ULEV(rodataHdr.sh_size)))
                 throw BinException("Metadata offset+size out of range");
             
-            // parse AMDGPU kernel metadata
-            parseAmdGpuKernelMetadata(symName, symsize,
-                  reinterpret_cast<const char*>(secContent + symvalue),
-                  kernelInfos[ki]);
+            // kernel name preceded by '__OpenCL_' and precedes '_metadata'
+            kernelInfos[ki].kernelName.assign(symName+9, ::strlen(symName)-18);
+            if (!lazy)
+                // parse AMDGPU kernel metadata
+                parseAmdGpuKernelMetadata(symsize,
+                      reinterpret_cast<const char*>(secContent + symvalue),
+                      kernelInfos[ki]);
             metadatas[ki].size = symsize;
             metadatas[ki].data = reinterpret_cast<char*>(secContent + symvalue);
             ki++;
@@ -1324,13 +1471,47 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     }
 }
 
+void AmdMainGPUBinaryBase::parseLazyKernelInfo(size_t index) const
+{
+    parseAmdGpuKernelMetadata(metadatas[index].size, metadatas[index].data,
+                kernelInfos[index]);
+}
+
+void AmdMainGPUBinaryBase::prepareInnerBinary(size_t index) const
+{
+    callOnce(innerBinaryOnceFlags[index], [this, index]()
+    {
+        const AmdGPUKernelHeader& code = innerBinaryCodes[index];
+        const Flags creationFlags = (type == AmdMainType::GPU_BINARY) ?
+                static_cast<const AmdMainGPUBinary32*>(this)->getCreationFlags() :
+                static_cast<const AmdMainGPUBinary64*>(this)->getCreationFlags();
+        innerBinaries[index] = AmdInnerGPUBinary32(code.kernelName, code.size, code.data,
+                (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
+    });
+}
+
 const AmdInnerGPUBinary32& AmdMainGPUBinaryBase::getInnerBinary(const char* name) const
+{
+    return getInnerBinary(getInnerBinaryIndex(name));
+}
+
+size_t AmdMainGPUBinaryBase::getInnerBinaryIndex(const char* name) const
 {
     InnerBinaryMap::const_iterator it = binaryMapFind(innerBinaryMap.begin(),
                   innerBinaryMap.end(), name);
     if (it == innerBinaryMap.end())
         throw BinException("Can't find inner binary");
-    return innerBinaries[it->second];
+    return it->second;
+}
+
+void AmdMainGPUBinaryBase::releaseInnerBinary(size_t index)
+{
+    if (!innerBinaryOnceFlags)
+        return; // not lazy mode
+    innerBinaries[index] = AmdInnerGPUBinary32();
+    /* reset once flag, this inner binary will be created at next access
+     * (access is exclusive, hence no thread waits on this flag) */
+    innerBinaryOnceFlags[index].reset();
 }
 
 const AmdGPUKernelHeader& AmdMainGPUBinaryBase::getKernelHeaderEntry(
@@ -332,9 +332,10 @@ static const cxuint vectorIdTable[17] =
 { UINT_MAX, 0, 1, 2, 3, UINT_MAX, UINT_MAX, UINT_MAX, 4,
   UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, 5 };
 
+// check metadata header, returns offset of kernel argument entries
 template<typename Types>
-static void getCL2KernelInfo(size_t metadataSize, cxbyte* metadata,
-             KernelInfo& kernelInfo, AmdGPUKernelHeader& kernelHeader, bool& crimson16)
+static size_t getCL2KernelHeader(size_t metadataSize, cxbyte* metadata,
+             AmdGPUKernelHeader& kernelHeader, bool& crimson16)
 {
     crimson16 = false;
     if (metadataSize < 8+32+32)
@@ -349,7 +350,6 @@ static void getCL2KernelInfo(size_t metadataSize, cxbyte* metadata,
     if (kernelHeader.size < sizeof(typename Types::MetadataHeader))
         throw BinException("Metadata header is too short");
     kernelHeader.data = metadata;
-    const uint32_t argsNum = ULEV(hdrStruc->argsNum);
     
     if (usumGt(ULEV(hdrStruc->firstNameLength), ULEV(hdrStruc->secondNameLength),
                 metadataSize-kernelHeader.size-2))
@@ -364,6 +364,18 @@ static void getCL2KernelInfo(size_t metadataSize, cxbyte* metadata,
         crimson16 = true;
         argOffset++;
     }
+    return argOffset;
+}
+
+template<typename Types>
+static void getCL2KernelInfo(size_t metadataSize, cxbyte* metadata,
+             KernelInfo& kernelInfo, AmdGPUKernelHeader& kernelHeader, bool& crimson16)
+{
+    const size_t argOffset = getCL2KernelHeader<Types>(metadataSize, metadata,
+                kernelHeader, crimson16);
+    const typename Types::MetadataHeader* hdrStruc =
+            reinterpret_cast<const typename Types::MetadataHeader*>(metadata);
+    const uint32_t argsNum = ULEV(hdrStruc->argsNum);
     const typename Types::KernelArgEntry* argPtr = reinterpret_cast<
             const typename Types::KernelArgEntry*>(metadata + argOffset);
     
@@ -543,6 +555,18 @@ const AmdCL2GPUKernelMetadata& AmdCL2MainGPUBinaryBase::getISAMetadataEntry(
     return isaMetadatas[it->second];
 }
 
+void AmdCL2MainGPUBinaryBase::parseLazyKernelInfo(size_t index) const
+{
+    AmdGPUKernelHeader kernelHeader;
+    bool crimson16 = false;
+    if (type == AmdMainType::GPU_CL2_64_BINARY)
+        getCL2KernelInfo<AmdCL2Types64>(metadatas[index].size, metadatas[index].data,
+                    kernelInfos[index], kernelHeader, crimson16);
+    else
+        getCL2KernelInfo<AmdCL2Types32>(metadatas[index].size, metadatas[index].data,
+                    kernelInfos[index], kernelHeader, crimson16);
+}
+
 template<typename Types>
 void AmdCL2MainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& elfBin)
 {
@@ -673,6 +697,9 @@ void AmdCL2MainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& elfBi
         }
         metadatas.reset(new AmdCL2GPUKernelMetadata[kernelInfos.size()]);
         isaMetadatas.resize(choosenISAMetadataSyms.size());
+        const bool lazy = (creationFlags & AMDBIN_CREATE_LAZY) != 0;
+        if (lazy)
+            kernelInfoOnceFlags.reset(new ResettableOnceFlag[kernelInfos.size()]);
         size_t ki = 0;
         // main loop
         for (size_t index: choosenMetadataSyms)
@@ -693,7 +720,11 @@ void AmdCL2MainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& elfBi
             
             cxbyte* metadata = binaryCode + ULEV(shdr.sh_offset) + mtOffset;
             bool crimson16 = false;
-            getCL2KernelInfo<Types>(mtSize, metadata, kernelInfos[ki],
+            if (lazy)
+                // kernel arguments will be parsed at first access
+                getCL2KernelHeader<Types>(mtSize, metadata, kernelHeaders[ki], crimson16);
+            else
+                getCL2KernelInfo<Types>(mtSize, metadata, kernelInfos[ki],
                                         kernelHeaders[ki], crimson16);
             size_t len = ::strlen(mtName);
             // set kernel name from symbol name (__OpenCL_&__OpenCL_[name]_kernel_metadata)
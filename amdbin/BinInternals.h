@@ -0,0 +1,77 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __CLRX_BININTERNALS_H__
+#define __CLRX_BININTERNALS_H__
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdbin/Elf.h>
+#include <CLRX/amdbin/ElfBinaries.h>
+
+namespace CLRX
+{
+
+/*
+ * open-addressing hash index of names (linear probing)
+ * names are kept by user in own table, slot of index holds hash of name and
+ * index of entry in that table plus one (zero if slot is empty).
+ * Slot type must have 'hash' (uint32_t) and 'index' (uint32_t) fields.
+ */
+
+// hash of name (name does not need to be null-terminated)
+static inline uint32_t hashOfName(const char* name, size_t length)
+{
+    const uint64_t hash = hashFNV1a64(length, name);
+    return uint32_t(hash ^ (hash>>32));
+}
+
+// prepare empty hash index for entriesNum entries (slots number is power of two)
+template<typename Slot>
+static void initNameHashIndex(Array<Slot>& hashIndex, size_t entriesNum)
+{
+    if (entriesNum >= UINT32_MAX)
+        throw BinException("Too many names to hash index");
+    size_t slotsNum = 2;
+    while (slotsNum < (entriesNum<<1))
+        slotsNum <<= 1;
+    hashIndex.resize(slotsNum);
+    std::fill(hashIndex.begin(), hashIndex.end(), Slot{ 0, 0 });
+}
+
+/* find slot of name in hash index. returns position of slot that holds entry for which
+ * isSameName(entry index) returns true or position of empty slot (name not found) */
+template<typename Slot, typename IsSameName>
+static inline size_t findNameHashSlot(const Array<Slot>& hashIndex, uint32_t hash,
+            IsSameName isSameName)
+{
+    const size_t mask = hashIndex.size()-1;
+    size_t pos = hash & mask;
+    for (; hashIndex[pos].index != 0; pos = (pos+1) & mask)
+        if (hashIndex[pos].hash == hash && isSameName(hashIndex[pos].index-1))
+            break;
+    return pos;
+}
+
+};
+
+#endif
@@ -22,6 +22,7 @@
 #include <cstring>
 #include <cstdint>
 #include <climits>
+#include <algorithm>
 #include <utility>
 #include <string>
 #include <cassert>
@@ -29,6 +30,7 @@
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/MemAccess.h>
 #include <CLRX/amdbin/AmdBinaries.h>
+#include "BinInternals.h"
 
 static const uint32_t elfMagicValue = 0x464c457fU;
 
@@ -59,6 +61,92 @@ static size_t unfinishedRegionOfStringTable(const cxbyte* table, size_t size)
     return (table[k]==0)?k+1:k;
 }
 
+/* ELF (SysV) hash function of name, used by .hash section */
+static inline uint32_t elfHashOfName(const char* inName)
+{
+    uint32_t h = 0, g;
+    const cxbyte* name = reinterpret_cast<const cxbyte*>(inName);
+    while(*name!=0)
+    {
+        h = (h<<4) + *name++;
+        g = h & 0xf0000000U;
+        if (g) h ^= g>>24;
+        h &= ~g;
+    }
+    return h;
+}
+
+/* create hash index for map ordered by index.
+ * for duplicated names only first entry is indexed */
+template<typename Slot>
+static void createNameHashIndex(const Array<std::pair<const char*, size_t> >& map,
+            Array<Slot>& hashIndex)
+{
+    initNameHashIndex(hashIndex, map.size());
+    for (size_t i = 0; i < map.size(); i++)
+    {
+        const char* name = map[i].first;
+        const uint32_t hash = hashOfName(name, ::strlen(name));
+        const size_t pos = findNameHashSlot(hashIndex, hash, [&map, name](size_t index)
+                { return ::strcmp(map[index].first, name) == 0; });
+        if (hashIndex[pos].index == 0)
+            hashIndex[pos] = { hash, uint32_t(i+1) };
+    }
+}
+
+/* find name in hash index, returns index in map or SIZE_MAX if not found */
+template<typename Slot>
+static size_t findInNameHashIndex(const Array<Slot>& hashIndex,
+            const Array<std::pair<const char*, size_t> >& map, const char* name)
+{
+    if (hashIndex.empty())
+        return SIZE_MAX;
+    const size_t pos = findNameHashSlot(hashIndex, hashOfName(name, ::strlen(name)),
+            [&map, name](size_t index)
+            { return ::strcmp(map[index].first, name) == 0; });
+    return (hashIndex[pos].index != 0) ? hashIndex[pos].index-1 : SIZE_MAX;
+}
+
+/* verify ELF hash section: all buckets and chains must point to symbols */
+static bool verifyElfHashTable(const uint32_t* elfHash, uint64_t hashSize,
+            uint64_t symbolsNum)
+{
+    if (hashSize < 8)
+        return false;
+    const uint32_t bucketsNum = ULEV(elfHash[0]);
+    const uint32_t chainsNum = ULEV(elfHash[1]);
+    if (bucketsNum == 0 || chainsNum != symbolsNum ||
+        hashSize < (uint64_t(2) + bucketsNum + chainsNum)*4)
+        return false;
+    for (size_t i = 0; i < size_t(bucketsNum) + chainsNum; i++)
+        if (ULEV(elfHash[2+i]) >= chainsNum)
+            return false;
+    return true;
+}
+
+/* find symbol in ELF hash section, returns symbol index or SIZE_MAX if not found.
+ * order of chains depends on generator, hence whole chain is scanned to return
+ * first symbol for duplicated names (like hash index) */
+static size_t findInElfHashTable(const uint32_t* elfHash,
+            const Array<std::pair<const char*, size_t> >& map, const char* name)
+{
+    // first symbol (STN_UNDEF) is not in hash chains
+    if (!map.empty() && ::strcmp(map[0].first, name) == 0)
+        return 0;
+    const uint32_t bucketsNum = ULEV(elfHash[0]);
+    const uint32_t chainsNum = ULEV(elfHash[1]);
+    const uint32_t* buckets = elfHash + 2;
+    const uint32_t* chains = buckets + bucketsNum;
+    size_t found = SIZE_MAX;
+    // chain length is limited by chains number (against cycles in chains)
+    uint32_t i = ULEV(buckets[elfHashOfName(name) % bucketsNum]);
+    for (uint32_t steps = 0; i != STN_UNDEF && steps < chainsNum;
+                i = ULEV(chains[i]), steps++)
+        if (i < found && ::strcmp(map[i].first, name) == 0)
+            found = i;
+    return found;
+}
+
 /* elf32 types */
 
 const cxbyte CLRX::Elf32Types::ELFCLASS = ELFCLASS32;
@@ -77,9 +165,9 @@ template<typename Types>
 ElfBinaryTemplate<Types>::ElfBinaryTemplate() : binaryCodeSize(0), binaryCode(nullptr),
         sectionStringTable(nullptr), symbolStringTable(nullptr),
         symbolTable(nullptr), dynSymStringTable(nullptr), dynSymTable(nullptr),
-        noteTable(nullptr), symbolsNum(0), dynSymbolsNum(0),
-        noteTableSize(0), dynamicsNum(0), symbolEntSize(0), dynSymEntSize(0),
-        dynamicEntSize(0)
+        noteTable(nullptr), symbolElfHash(nullptr), dynSymElfHash(nullptr),
+        symbolsNum(0), dynSymbolsNum(0), noteTableSize(0), dynamicsNum(0),
+        symbolEntSize(0), dynSymEntSize(0), dynamicEntSize(0)
 { }
 
 template<typename Types>
@@ -92,9 +180,9 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
         binaryCodeSize(_binaryCodeSize), binaryCode(_binaryCode),
         sectionStringTable(nullptr), symbolStringTable(nullptr),
         symbolTable(nullptr), dynSymStringTable(nullptr), dynSymTable(nullptr),
-        noteTable(nullptr), symbolsNum(0), dynSymbolsNum(0),
-        noteTableSize(0), dynamicsNum(0), symbolEntSize(0), dynSymEntSize(0),
-        dynamicEntSize(0)     
+        noteTable(nullptr), symbolElfHash(nullptr), dynSymElfHash(nullptr),
+        symbolsNum(0), dynSymbolsNum(0), noteTableSize(0), dynamicsNum(0),
+        symbolEntSize(0), dynSymEntSize(0), dynamicEntSize(0)
 {
     if (binaryCodeSize < sizeof(typename Types::Ehdr))
         throw BinException("Binary is too small!!!");
@@ -157,6 +245,7 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
         const typename Types::Shdr* dynSymTableHdr = nullptr;
         const typename Types::Shdr* noteTableHdr = nullptr;
         const typename Types::Shdr* dynamicTableHdr = nullptr;
+        const typename Types::Shdr* hashTableHdr = nullptr;
         
         cxuint shnum = ULEV(ehdr->e_shnum);
         if ((creationFlags & ELF_CREATE_SECTIONMAP) != 0)
@@ -194,10 +283,17 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                 noteTableHdr = &shdr;
             if (ULEV(shdr.sh_type) == SHT_DYNAMIC)
                 dynamicTableHdr = &shdr;
+            if (ULEV(shdr.sh_type) == SHT_HASH)
+                hashTableHdr = &shdr;
         }
-        // sort section's map (really is array of sections)
+        // sort section's map (really is array of sections) or create hash index
         if ((creationFlags & ELF_CREATE_SECTIONMAP) != 0)
-            mapSort(sectionIndexMap.begin(), sectionIndexMap.end(), CStringLess());
+        {
+            if (hasHashIndex())
+                createNameHashIndex(sectionIndexMap, sectionHashIndex);
+            else
+                mapSort(sectionIndexMap.begin(), sectionIndexMap.end(), CStringLess());
+        }
         
         if (symTableHdr != nullptr)
         {
@@ -237,7 +333,7 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                     symbolIndexMap[i] = std::make_pair(symname, i);
             }
             // sort symbol's map (really is array of symbols)
-            if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0)
+            if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0 && !hasHashIndex())
                 mapSort(symbolIndexMap.begin(), symbolIndexMap.end(), CStringLess());
         }
         if (dynSymTableHdr != nullptr)
@@ -280,9 +376,34 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                     dynSymIndexMap[i] = std::make_pair(symname, i);
             }
             // sort dynamic symbol's map (really is array of dynamic symbols)
-            if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0)
+            if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0 && !hasHashIndex())
                 mapSort(dynSymIndexMap.begin(), dynSymIndexMap.end(), CStringLess());
         }
+        if (hasHashIndex())
+        {
+            // use ELF hash section if it is valid for its symbol table
+            if (hashTableHdr != nullptr)
+            {
+                const typename Types::Shdr* hashSymHdr =
+                        &getSectionHeader(ULEV(hashTableHdr->sh_link));
+                const uint32_t* elfHash = reinterpret_cast<const uint32_t*>(
+                        binaryCode + ULEV(hashTableHdr->sh_offset));
+                const uint64_t hashSize = ULEV(hashTableHdr->sh_size);
+                if (hashSymHdr == symTableHdr &&
+                    (creationFlags & ELF_CREATE_SYMBOLMAP) != 0 &&
+                    verifyElfHashTable(elfHash, hashSize, symbolsNum))
+                    symbolElfHash = elfHash;
+                else if (hashSymHdr == dynSymTableHdr &&
+                    (creationFlags & ELF_CREATE_DYNSYMMAP) != 0 &&
+                    verifyElfHashTable(elfHash, hashSize, dynSymbolsNum))
+                    dynSymElfHash = elfHash;
+            }
+            // otherwise hash names and create own hash index
+            if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0 && symbolElfHash == nullptr)
+                createNameHashIndex(symbolIndexMap, symbolHashIndex);
+            if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0 && dynSymElfHash == nullptr)
+                createNameHashIndex(dynSymIndexMap, dynSymHashIndex);
+        }
         if (noteTableHdr != nullptr)
         {
             noteTable = binaryCode + ULEV(noteTableHdr->sh_offset);
@@ -306,7 +427,15 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
 template<typename Types>
 uint16_t ElfBinaryTemplate<Types>::getSectionIndex(const char* name) const
 {
-    if (hasSectionMap())
+    if (hasSectionMap() && hasHashIndex())
+    {
+        // find in section hash index
+        const size_t index = findInNameHashIndex(sectionHashIndex, sectionIndexMap, name);
+        if (index == SIZE_MAX)
+            throw BinException(std::string("Can't find Elf")+Types::bitName+" Section");
+        return index;
+    }
+    else if (hasSectionMap())
     {
         // find in section map (sorted array)
         SectionIndexMap::const_iterator it = binaryMapFind(
@@ -330,6 +459,15 @@ uint16_t ElfBinaryTemplate<Types>::getSectionIndex(const char* name) const
 template<typename Types>
 typename Types::Size ElfBinaryTemplate<Types>::getSymbolIndex(const char* name) const
 {
+    if (hasHashIndex())
+    {
+        const size_t index = (symbolElfHash != nullptr) ?
+                findInElfHashTable(symbolElfHash, symbolIndexMap, name) :
+                findInNameHashIndex(symbolHashIndex, symbolIndexMap, name);
+        if (index == SIZE_MAX)
+            throw BinException(std::string("Can't find Elf")+Types::bitName+" Symbol");
+        return index;
+    }
     SymbolIndexMap::const_iterator it = binaryMapFind(
                     symbolIndexMap.begin(), symbolIndexMap.end(), name, CStringLess());
     if (it == symbolIndexMap.end())
@@ -340,6 +478,15 @@ typename Types::Size ElfBinaryTemplate<Types>::getSymbolIndex(const char* name)
 template<typename Types>
 typename Types::Size ElfBinaryTemplate<Types>::getDynSymbolIndex(const char* name) const
 {
+    if (hasHashIndex())
+    {
+        const size_t index = (dynSymElfHash != nullptr) ?
+                findInElfHashTable(dynSymElfHash, dynSymIndexMap, name) :
+                findInNameHashIndex(dynSymHashIndex, dynSymIndexMap, name);
+        if (index == SIZE_MAX)
+            throw BinException(std::string("Can't find Elf")+Types::bitName+" DynSymbol");
+        return index;
+    }
     SymbolIndexMap::const_iterator it = binaryMapFind(
                     dynSymIndexMap.begin(), dynSymIndexMap.end(), name, CStringLess());
     if (it == dynSymIndexMap.end())
@@ -405,19 +552,7 @@ static std::unique_ptr<uint32_t[]> calculateHashValuesForSymbols(bool addNullSym
     if (addNullSymbol)
         hashCodes[0] = 0;
     for (size_t i = 0; i < symbols.size(); i++)
-    {
-        // main routine of hash
-        uint32_t h = 0, g;
-        const cxbyte* name = reinterpret_cast<const cxbyte*>(symbols[i].name);
-        while(*name!=0)
-        {
-            h = (h<<4) + *name++;
-            g = h & 0xf0000000U;
-            if (g) h ^= g>>24;
-            h &= ~g;
-        }
-        hashCodes[i+addNullSymbol] = h;
-    }
+        hashCodes[i+addNullSymbol] = elfHashOfName(symbols[i].name);
     return hashCodes;
 }
 
@@ -583,11 +718,18 @@ void ElfBinaryGenTemplate<Types>::computeSize()
     for (size_t i = 0; i < regions.size(); i++)
     {
         ElfRegionTemplate<Types>& region = regions[i];
-        if (region.align > 1)
+        // file alignment of section can be greater than region alignment
+        const typename Types::Word fileAlign = std::max(region.align,
+                typename Types::Word((region.type==ElfRegionType::SECTION) ?
+                        region.section.align : 0));
+        if (fileAlign > 1)
         {
             // fix alignment
-            if ((size&(region.align-1))!=0)
-                size += region.align - (size&(region.align-1));
+            if ((size&(fileAlign-1))!=0)
+                size += fileAlign - (size&(fileAlign-1));
+        }
+        if (region.align > 1)
+        {
             if ((address&(region.align-1))!=0)
                 address += region.align - (address&(region.align-1));
         }
@@ -799,6 +941,15 @@ static void createHashTable(uint32_t bucketsNum, uint32_t hashNum, bool skipFirs
 
 template<typename Types>
 void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
+{
+    generateNested(fob);
+    fob.flush();
+    if (!fob.isMemoryOutput())
+        fob.getOStream().flush();
+}
+
+template<typename Types>
+void ElfBinaryGenTemplate<Types>::generateNested(FastOutputBuffer& fob)
 {
     computeSize();
     const uint64_t startOffset = fob.getWritten();
@@ -881,19 +1032,11 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
     for (size_t i = 0; i < regions.size(); i++)
     {   
         const ElfRegionTemplate<Types>& region = regions[i];
-        // fix alignment
-        uint64_t toFill = 0;
-        typename Types::Word ralign = (region.type==ElfRegionType::SECTION) ?
-                        region.section.align : 0;
-        ralign = std::max(region.align, ralign);
-        if (ralign > 1)
-        {
-            const uint64_t curOffset = (fob.getWritten()-startOffset);
-            if (ralign!=0 && (curOffset&(ralign-1))!=0)
-                toFill = ralign - (curOffset&(ralign-1));
-            fob.fill(toFill, 0);
-        }
-        assert(regionOffsets[i] == fob.getWritten()-startOffset);
+        // fix alignment (fill up to region offset computed by computeSize)
+        const uint64_t curOffset = fob.getWritten()-startOffset;
+        assert(regionOffsets[i] >= curOffset);
+        if (regionOffsets[i] != curOffset)
+            fob.fill(regionOffsets[i] - curOffset, 0);
         
         // write content
         if (region.type == ElfRegionType::PHDR_TABLE)
@@ -1199,8 +1342,6 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
             }
         }
     }
-    fob.flush();
-    fob.getOStream().flush();
     assert(size == fob.getWritten()-startOffset);
 }
 
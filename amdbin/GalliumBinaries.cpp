@@ -830,33 +830,13 @@ void GalliumBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char
 #endif
     /****
      * prepare for write binary to output
+     * array and vector are filled directly, without intermediate stream
      ****/
-    std::unique_ptr<std::ostream> outStreamHolder;
-    std::ostream* os = nullptr;
-    if (aPtr != nullptr)
-    {
-        aPtr->resize(binarySize);
-        outStreamHolder.reset(
-                new ArrayOStream(binarySize, reinterpret_cast<char*>(aPtr->data())));
-        os = outStreamHolder.get();
-    }
-    else if (vPtr != nullptr)
-    {
-        vPtr->resize(binarySize);
-        outStreamHolder.reset(new VectorOStream(*vPtr));
-        os = outStreamHolder.get();
-    }
-    else // from argument
-        os = osPtr;
-    
-    const std::ios::iostate oldExceptions = os->exceptions();
-    try
-    {
-    os->exceptions(std::ios::failbit | std::ios::badbit);
+    FastOutputBufferHolder fobHolder(size_t(binarySize), osPtr, vPtr, aPtr);
+    FastOutputBuffer& bos = fobHolder.getBuffer();
     /****
      * write binary to output
      ****/
-    FastOutputBuffer bos(256, *os);
     bos.writeObject<uint32_t>(LEV(kernelsNum));
     // write Gallium kernel info
     for (uint32_t korder: kernelsOrder)
@@ -893,13 +873,6 @@ void GalliumBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char
     else // 64-bit
         elfBinGen64->generate(bos);
     assert(bos.getWritten() == binarySize);
-    }
-    catch(...)
-    {
-        os->exceptions(oldExceptions);
-        throw;
-    }
-    os->exceptions(oldExceptions);
 }
 
 void GalliumBinGenerator::generate(Array<cxbyte>& array) const
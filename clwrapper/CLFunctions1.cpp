@@ -1334,13 +1334,22 @@ clrxclBuildProgram(cl_program           program,
                 return CL_INVALID_OPERATION;
             p->concurrentBuilds++;
             p->kernelArgFlagsInitialized = false;
+            if (pfn_notify!=nullptr)
+            {
+                // build status must be 'in progress' just after return from this call
+                p->asmProgEntries.reset();
+                p->asmState.store(CLRXAsmState::IN_PROGRESS);
+            }
+        }
+        if (pfn_notify!=nullptr)
+        {
+            // assemble in background, pfn_notify will be called after building
+            return clrxCompilerCallAsync(p, options, num_devices,
+                            (CLRXDevice* const*)device_list, pfn_notify, user_data);
         }
         // call own compiler
         cl_int error = clrxCompilerCall(p, options, num_devices,
                             (CLRXDevice* const*)device_list);
-        if (pfn_notify!=nullptr)
-            pfn_notify(program, user_data);
-        
         {
             std::lock_guard<std::mutex> lock(p->mutex);
             p->concurrentBuilds--;
@@ -26,6 +26,7 @@
 #include <utility>
 #include <thread>
 #include <mutex>
+#include <system_error>
 #include <cstring>
 #include <string>
 #include <climits>
@@ -63,6 +64,10 @@ clEnqueueMakeBuffersResidentAMD_fn amdOclEnqueueMakeBuffersResidentAMD = nullptr
 #endif
 CLRXpfn_clGetExtensionFunctionAddress amdOclGetExtensionFunctionAddress = nullptr;
 
+/* on-disk cache of assembled binaries (null if disabled).
+ * use pure pointer - cache must be available to end of program */
+static AsmBinaryCache* clrxBinaryCache = nullptr;
+
 /* extensions table - entries are sorted in function name's order */
 CLRXExtensionEntry clrxExtensionsTable[18] =
 {
@@ -352,6 +357,14 @@ void clrxWrapperInitialize()
     try
     {
         useCLRXWrapper = !parseEnvVariable<bool>("CLRX_FORCE_ORIGINAL_AMDOCL", false);
+        if (useCLRXWrapper)
+        {
+            // binary cache is enabled only if its directory is given
+            const std::string cacheDir = parseEnvVariable<std::string>(
+                    "CLRX_BINARY_CACHE_DIR", "");
+            if (!cacheDir.empty())
+                clrxBinaryCache = new AsmBinaryCache(cacheDir);
+        }
         std::string amdOclPath = findAmdOCL();
         /// set temporary amd ocl library
         tmpAmdOclLibrary.reset(new DynLibrary(amdOclPath.c_str(), DYNLIB_NOW));
@@ -1102,7 +1115,7 @@ CLRXProgram* clrxCreateCLRXProgram(CLRXContext* c, cl_program amdProgram,
         outProgram->context = c;
         error = clrxUpdateProgramAssocDevices(outProgram);
     }
-    catch(const std::bad_alloc& ex)
+    catch(const std::bad_alloc&)
     { error = CL_OUT_OF_HOST_MEMORY; }
     
     if (error != CL_SUCCESS)
@@ -1534,57 +1547,27 @@ static const char* stripCString(char* str)
     return str;
 }
 
-cl_int clrxCompilerCall(CLRXProgram* program, const char* compilerOptions,
-            cl_uint devicesNum, CLRXDevice* const* devices)
-try
+// options of CLRX compiler call
+struct CLRX_INTERNAL CLRXCompilerOptions
 {
-    std::lock_guard<std::mutex> lock(program->asmMutex);
-    if (devices==nullptr)
-    {
-        devicesNum = program->assocDevicesNum;
-        devices = program->assocDevices.get();
-    }
-    /* get source code */
-    size_t sourceCodeSize;
-    std::unique_ptr<char[]> sourceCode;
-    const cl_program amdp = program->amdOclProgram;
-    {
-        std::lock_guard<std::mutex> clock(program->mutex);
-        program->asmState.store(CLRXAsmState::IN_PROGRESS);
-        program->asmProgEntries.reset();
-    }
-    
-    cl_int error = amdp->dispatch->clGetProgramInfo(amdp, CL_PROGRAM_SOURCE,
-                    0, nullptr, &sourceCodeSize);
-    if (error!=CL_SUCCESS)
-        clrxAbort("Fatal error from clGetProgramInfo in clrxCompilerCall");
-    if (sourceCodeSize==0)
-    {
-        program->asmState.store(CLRXAsmState::FAILED);
-        return CL_INVALID_OPERATION;
-    }
-    
-    sourceCode.reset(new char[sourceCodeSize]);
-    error = amdp->dispatch->clGetProgramInfo(amdp, CL_PROGRAM_SOURCE, sourceCodeSize,
-                             sourceCode.get(), nullptr);
-    if (error!=CL_SUCCESS)
-        clrxAbort("Fatal error from clGetProgramInfo in clrxCompilerCall");
-    
-    Flags asmFlags = ASM_WARNINGS;
-    // parsing compile options
-    const char* co = compilerOptions;
+    Flags asmFlags;
     std::vector<CString> includePaths;
     std::vector<std::pair<CString, uint64_t> > defSyms;
+    bool useCL20Std;
+    bool useLegacy;
+};
+
+// parse compiler options, returns false if options are invalid
+static bool parseCompilerOptions(const char* compilerOptions, CLRXCompilerOptions& opts)
+try
+{
+    opts.asmFlags = ASM_WARNINGS;
+    opts.useCL20Std = false;
+    opts.useLegacy = false;
+    const char* co = compilerOptions;
     bool nextIsIncludePath = false;
     bool nextIsDefSym = false;
     bool nextIsLang = false;
-    bool useCL20Std = false;
-    bool useLegacy = false;
-    // drivers since 200406 version uses AmdCL2 binary format by default for >=GCN1.1
-    bool useCL2StdForGCN11 = detectAmdDriverVersion() >= 200406;
-    
-    try
-    {
     while(*co!=0)
     {
         while (*co!=0 && (*co==' ' || *co=='\t')) co++;
@@ -1597,12 +1580,12 @@ try
         if (nextIsIncludePath) // otherwise
         {
             nextIsIncludePath = false;
-            includePaths.push_back(word);
+            opts.includePaths.push_back(word);
         }
         else if (nextIsDefSym) // otherwise
         {
             nextIsDefSym = false;
-            defSyms.push_back(getDefSym(word));
+            opts.defSyms.push_back(getDefSym(word));
         }
         else if (nextIsLang) // otherwise
             nextIsLang = false;
@@ -1610,69 +1593,148 @@ try
         {
             // if option
             if (word == "-w")
-                asmFlags &= ~ASM_WARNINGS;
+                opts.asmFlags &= ~ASM_WARNINGS;
             else if (word == "-noMacroCase")
-                asmFlags |= ASM_MACRONOCASE;
+                opts.asmFlags |= ASM_MACRONOCASE;
             else if (word == "-legacy")
-            {
-                useCL2StdForGCN11 = false;
-                useLegacy = true;
-            }
+                opts.useLegacy = true;
             else if (word == "-forceAddSymbols")
-                asmFlags |= ASM_FORCE_ADD_SYMBOLS;
+                opts.asmFlags |= ASM_FORCE_ADD_SYMBOLS;
             else if (word == "-buggyFPLit")
-                asmFlags |= ASM_BUGGYFPLIT;
+                opts.asmFlags |= ASM_BUGGYFPLIT;
             else if (word == "-oldModParam")
-                asmFlags |= ASM_OLDMODPARAM;
+                opts.asmFlags |= ASM_OLDMODPARAM;
             else if (word == "-I" || word == "-includePath")
                 nextIsIncludePath = true;
             else if (word.compare(0, 2, "-I")==0)
-                includePaths.push_back(word.substr(2, word.size()-2));
+                opts.includePaths.push_back(word.substr(2, word.size()-2));
             else if (word.compare(0, 13, "-includePath=")==0)
-                includePaths.push_back(word.substr(13, word.size()-13));
+                opts.includePaths.push_back(word.substr(13, word.size()-13));
             else if (word == "-D" || word == "-defsym")
                 nextIsDefSym = true;
             else if (word.compare(0, 2, "-D")==0)
-                defSyms.push_back(getDefSym(word.substr(2, word.size()-2)));
+                opts.defSyms.push_back(getDefSym(word.substr(2, word.size()-2)));
             else if (word.compare(0, 8, "-defsym=")==0)
-                defSyms.push_back(getDefSym(word.substr(8, word.size()-8)));
+                opts.defSyms.push_back(getDefSym(word.substr(8, word.size()-8)));
             else if (word.compare(0, 8, "-cl-std=")==0)
             {
                 const CString stdName = word.substr(8, word.size()-8);
                 if (stdName=="CL2.0")
-                    useCL20Std = true;
+                    opts.useCL20Std = true;
                 else if (stdName!="CL1.1" && stdName!="CL1.1" && stdName!="CL1.2")
-                {
-                    program->asmState.store(CLRXAsmState::FAILED);
-                    return CL_INVALID_BUILD_OPTIONS;
-                }
+                    return false;
             }
             else if (word == "-x" )
                 nextIsLang = true;
             else if (word != "-xasm")
-            {
-                // if not language selection to asm
-                program->asmState.store(CLRXAsmState::FAILED);
-                return CL_INVALID_BUILD_OPTIONS;
-            }
+                return false; // if not language selection to asm
         }
         else
+            return false;
+    }
+    return !nextIsDefSym && !nextIsIncludePath && !nextIsLang;
+}
+catch(const Exception&)
+{ return false; } // invalid defsym
+
+// set failed assembler state with error status and log for all associated devices
+static void clrxSetCompilerCallFailure(CLRXProgram* program, const char* message)
+{
+    std::lock_guard<std::mutex> lock(program->mutex);
+    program->asmProgEntries.reset();
+    if (program->assocDevicesNum != 0)
+    {
+        RefPtr<CLProgLogEntry> log(new CLProgLogEntry(message));
+        program->asmProgEntries.reset(new ProgDeviceMapEntry[program->assocDevicesNum]);
+        for (cxuint i = 0; i < program->assocDevicesNum; i++)
         {
-            program->asmState.store(CLRXAsmState::FAILED);
-            return CL_INVALID_BUILD_OPTIONS;
+            program->asmProgEntries[i].first = program->assocDevices[i];
+            program->asmProgEntries[i].second.log = log;
+            program->asmProgEntries[i].second.status = CL_BUILD_ERROR;
         }
+        mapSort(program->asmProgEntries.get(), program->asmProgEntries.get() +
+                    program->assocDevicesNum);
     }
-    if (nextIsDefSym || nextIsIncludePath || nextIsLang)
+    program->asmState.store(CLRXAsmState::FAILED);
+}
+
+// check program, devices and options before assembling
+// (if failed, sets failed state, build status and log)
+static cl_int clrxCompilerCallCheck(CLRXProgram* program, const char* compilerOptions,
+            cl_uint devicesNum, CLRXDevice* const* devices, CLRXCompilerOptions& opts)
+{
+    const cl_program amdp = program->amdOclProgram;
+    size_t sourceCodeSize;
+    if (amdp->dispatch->clGetProgramInfo(amdp, CL_PROGRAM_SOURCE,
+                    0, nullptr, &sourceCodeSize) != CL_SUCCESS)
+        clrxAbort("Fatal error from clGetProgramInfo in clrxCompilerCallCheck");
+    if (sourceCodeSize==0)
     {
-        program->asmState.store(CLRXAsmState::FAILED);
-        return CL_INVALID_BUILD_OPTIONS;
+        clrxSetCompilerCallFailure(program, "Program has no source code");
+        return CL_INVALID_OPERATION;
     }
-    } // error
-    catch(const Exception& ex)
+    // devices must be in program context
+    const CLRXContext* context = program->context;
+    for (cl_uint i = 0; devices != nullptr && i < devicesNum; i++)
+        if (std::find(context->devices.get(), context->devices.get()+context->devicesNum,
+                    devices[i]) == context->devices.get()+context->devicesNum)
+        {
+            clrxSetCompilerCallFailure(program, "Device is not in program context");
+            return CL_INVALID_DEVICE;
+        }
+    if (!parseCompilerOptions(compilerOptions, opts))
     {
-        program->asmState.store(CLRXAsmState::FAILED);
+        clrxSetCompilerCallFailure(program, "Invalid build options");
         return CL_INVALID_BUILD_OPTIONS;
     }
+    return CL_SUCCESS;
+}
+
+cl_int clrxCompilerCall(CLRXProgram* program, const char* compilerOptions,
+            cl_uint devicesNum, CLRXDevice* const* devices)
+try
+{
+    std::lock_guard<std::mutex> lock(program->asmMutex);
+    if (devices==nullptr)
+    {
+        devicesNum = program->assocDevicesNum;
+        devices = program->assocDevices.get();
+    }
+    /* get source code */
+    size_t sourceCodeSize;
+    std::unique_ptr<char[]> sourceCode;
+    const cl_program amdp = program->amdOclProgram;
+    {
+        std::lock_guard<std::mutex> clock(program->mutex);
+        program->asmState.store(CLRXAsmState::IN_PROGRESS);
+        program->asmProgEntries.reset();
+    }
+    
+    CLRXCompilerOptions opts;
+    cl_int error = clrxCompilerCallCheck(program, compilerOptions, devicesNum, devices,
+                    opts);
+    if (error!=CL_SUCCESS)
+        return error;
+    
+    error = amdp->dispatch->clGetProgramInfo(amdp, CL_PROGRAM_SOURCE,
+                    0, nullptr, &sourceCodeSize);
+    if (error!=CL_SUCCESS)
+        clrxAbort("Fatal error from clGetProgramInfo in clrxCompilerCall");
+    
+    sourceCode.reset(new char[sourceCodeSize]);
+    error = amdp->dispatch->clGetProgramInfo(amdp, CL_PROGRAM_SOURCE, sourceCodeSize,
+                             sourceCode.get(), nullptr);
+    if (error!=CL_SUCCESS)
+        clrxAbort("Fatal error from clGetProgramInfo in clrxCompilerCall");
+    
+    const Flags asmFlags = opts.asmFlags;
+    const std::vector<CString>& includePaths = opts.includePaths;
+    const std::vector<std::pair<CString, uint64_t> >& defSyms = opts.defSyms;
+    const bool useCL20Std = opts.useCL20Std;
+    const bool useLegacy = opts.useLegacy;
+    const cxuint driverVersion = detectAmdDriverVersion();
+    // drivers since 200406 version uses AmdCL2 binary format by default for >=GCN1.1
+    const bool useCL2StdForGCN11 = driverVersion >= 200406 && !useLegacy;
     
     /* compiling programs */
     struct OutDevEntry {
@@ -1725,8 +1787,22 @@ try
     bool asmFailure = false;
     bool asmNotAvailable = false;
     cxuint prevDeviceType = -1;
+    // device types to assemble (first device of every type that is not in cache)
+    struct AsmJob
+    {
+        cxuint index;   // index of device entry
+        cxuint devType;
+        bool useCL20StdByDev;
+        bool is64Bit;
+        std::string cacheKey;
+        bool failed;
+    };
+    std::vector<AsmJob> asmJobs;
+    // if true, device have this same type as previous device (results will be copied)
+    std::unique_ptr<bool[]> sameAsPrevDevice(new bool[devicesNum]);
     for (cxuint i = 0; i < devicesNum; i++)
     {
+        sameAsPrevDevice[i] = false;
         const auto& entry = outDeviceIndexMap[i];
         ProgDeviceEntry& progDevEntry = progDeviceEntries[i];
         cxuint devType = -1;
@@ -1743,31 +1819,67 @@ try
         // make duplicate only if not first entry
         if (i!=0 && devType == prevDeviceType)
         {
-            // copy from previous device (if this same device type)
-            compiledProgBins[i] = compiledProgBins[i-1];
-            progDevEntry = progDeviceEntries[i-1];
+            // copy from previous device (if this same device type) after assembling
+            sameAsPrevDevice[i] = true;
             continue; // skip if this same architecture
         }
         prevDeviceType = devType;
-        // assemble it
-        ArrayIStream astream(sourceCodeSize-1, sourceCode.get());
-        std::string msgString;
-        StringOStream msgStream(msgString);
         /// determine whether use useCL20StdByDev
         bool useCL20StdByDev = (useCL20Std || (useCL2StdForGCN11 &&
                 getGPUArchitectureFromDeviceType(GPUDeviceType(devType))
                         >=GPUArchitecture::GCN1_1));
-        Assembler assembler("", astream, asmFlags,
-                    (useCL20StdByDev) ? BinaryFormat::AMDCL2 : BinaryFormat::AMD,
-                    GPUDeviceType(devType), msgStream);
-        
         // get address bit - for bitness
         cl_uint addressBits;
         error = amdp->dispatch->clGetDeviceInfo(entry.second,
                     CL_DEVICE_ADDRESS_BITS, sizeof(cl_uint), &addressBits, nullptr);
         if (error != CL_SUCCESS)
             clrxAbort("Fatal error at clCompilerCall (clGetDeviceInfo)");
-        assembler.set64Bit(addressBits==64);
+        
+        std::string cacheKey;
+        if (clrxBinaryCache != nullptr)
+        {
+            // key holds all inputs that have impact on binary
+            // (current directory, because include paths can be relative)
+            char keyHeader[96];
+            ::snprintf(keyHeader, 96, "CLRXWrapper %u %u %u %u %u\n", driverVersion,
+                    devType, cxuint(addressBits), cxuint(useCL20StdByDev),
+                    cxuint(asmFlags));
+            cacheKey.append(keyHeader).append(getAbsolutePath("")).append(1, '\n');
+            cacheKey.append(compilerOptions).append(1, '\n');
+            cacheKey.append(sourceCode.get(), sourceCodeSize-1);
+            Array<cxbyte> cachedBinary;
+            std::string cachedLog;
+            if (clrxBinaryCache->get(cacheKey, cachedBinary, cachedLog))
+            {
+                // skip assembler, binary and log are in cache
+                progDevEntry.log = RefPtr<CLProgLogEntry>(
+                            new CLProgLogEntry(std::move(cachedLog)));
+                progDevEntry.status = CL_BUILD_SUCCESS;
+                compiledProgBins[i] = RefPtr<CLProgBinEntry>(
+                            new CLProgBinEntry(std::move(cachedBinary)));
+                continue;
+            }
+        }
+        asmJobs.push_back({ i, devType, useCL20StdByDev, addressBits==64,
+                    std::move(cacheKey), false });
+    }
+    
+    /// assemble distinct device types concurrently
+    // one thread per job, but not more than hardware threads
+    const cxuint asmThreadsNum = std::min(asmJobs.size(),
+                size_t(std::max(std::thread::hardware_concurrency(), 1U)));
+    runInThreadPool(asmJobs.size(), asmThreadsNum, [&](size_t jobIndex)
+    {
+        AsmJob& job = asmJobs[jobIndex];
+        ProgDeviceEntry& progDevEntry = progDeviceEntries[job.index];
+        // assemble it
+        ArrayIStream astream(sourceCodeSize-1, sourceCode.get());
+        std::string msgString;
+        StringOStream msgStream(msgString);
+        Assembler assembler("", astream, asmFlags,
+                    (job.useCL20StdByDev) ? BinaryFormat::AMDCL2 : BinaryFormat::AMD,
+                    GPUDeviceType(job.devType), msgStream);
+        assembler.set64Bit(job.is64Bit);
         
         for (const CString& incPath: includePaths)
             assembler.addIncludeDir(incPath);
@@ -1783,8 +1895,8 @@ try
             progDevEntry.log = RefPtr<CLProgLogEntry>(
                             new CLProgLogEntry(std::move(msgString)));
             progDevEntry.status = CL_BUILD_ERROR;
-            asmFailure = true;
-            continue;
+            job.failed = true;
+            return;
         }
         /// set up logs
         progDevEntry.log = RefPtr<CLProgLogEntry>(
@@ -1797,26 +1909,44 @@ try
                 progDevEntry.status = CL_BUILD_SUCCESS;
                 Array<cxbyte> output;
                 assembler.writeBinary(output);
-                compiledProgBins[i] = RefPtr<CLProgBinEntry>(
+                if (clrxBinaryCache != nullptr)
+                {
+                    try
+                    { clrxBinaryCache->put(job.cacheKey, assembler.getDependencies(),
+                                assembler.getMissingDependencies(), output,
+                                progDevEntry.log->log); }
+                    catch(const Exception&)
+                    { } // ignore cache errors
+                }
+                compiledProgBins[job.index] = RefPtr<CLProgBinEntry>(
                             new CLProgBinEntry(std::move(output)));
             }
             catch(const Exception& ex)
             {
                 // if exception during writing binary
-                compiledProgBins[i].reset();
+                compiledProgBins[job.index].reset();
                 msgString.append(ex.what());
                 progDevEntry.log = RefPtr<CLProgLogEntry>(
                             new CLProgLogEntry(std::move(msgString)));
                 progDevEntry.status = CL_BUILD_ERROR;
-                asmFailure = true;
+                job.failed = true;
             }
         }
         else // error
         {
             progDevEntry.status = CL_BUILD_ERROR;
-            asmFailure = true;
+            job.failed = true;
+        }
+    });
+    for (const AsmJob& job: asmJobs)
+        asmFailure |= job.failed;
+    // copy results to next devices of this same type
+    for (cxuint i = 1; i < devicesNum; i++)
+        if (sameAsPrevDevice[i])
+        {
+            compiledProgBins[i] = compiledProgBins[i-1];
+            progDeviceEntries[i] = progDeviceEntries[i-1];
         }
-    }
     /* set program binaries in order of original devices list */
     std::unique_ptr<size_t[]> programBinSizes(new size_t[devicesNum]);
     std::unique_ptr<cxbyte*[]> programBinaries(new cxbyte*[devicesNum]);
@@ -1851,7 +1981,7 @@ try
         if (newAmdAsmP==nullptr)
         {
             // return error
-            program->asmState.store(CLRXAsmState::FAILED);
+            clrxSetCompilerCallFailure(program, "Can't create program from binaries");
             return error;
         }
         /// and build (errorLast holds last error to be returned)
@@ -1943,3 +2073,143 @@ catch(const std::exception& ex)
     clrxAbort("Fatal error at CLRX compiler call:", ex.what());
     return -1;
 }
+
+// threads of asynchronous compiler calls. Threads are joinable:
+// finished threads are joined while starting next thread, rest of threads
+// are joined at library unloading (code of the library must be alive)
+class CLRX_INTERNAL CLRXAsyncBuildThreads: NonCopyableAndNonMovable
+{
+private:
+    std::mutex mutex;
+    std::vector<std::thread> threads;
+    std::vector<std::thread::id> finishedIds;
+public:
+    CLRXAsyncBuildThreads()
+    { }
+    ~CLRXAsyncBuildThreads()
+    {
+        std::vector<std::thread> toJoin;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            toJoin.swap(threads);
+        }
+        for (std::thread& thread: toJoin)
+            thread.join();
+    }
+    
+    // start new thread (throws std::system_error if thread can not be created)
+    template<typename F, typename... Args>
+    void start(F&& func, Args&&... args)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // reserve space before creating thread (thread must not be lost)
+        threads.reserve(threads.size()+1);
+        finishedIds.reserve(threads.size()+1);
+        threads.emplace_back(std::forward<F>(func), std::forward<Args>(args)...);
+        // join finished threads (their ids are added at end of thread routine)
+        for (std::thread::id id: finishedIds)
+        {
+            auto it = std::find_if(threads.begin(), threads.end(),
+                    [id](const std::thread& t) { return t.get_id()==id; });
+            it->join();
+            threads.erase(it);
+        }
+        finishedIds.clear();
+    }
+    
+    // called by thread at end of its routine
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finishedIds.push_back(std::this_thread::get_id());
+    }
+};
+
+static CLRXAsyncBuildThreads clrxAsyncBuildThreads;
+
+// body of asynchronous compiler call (releases program at end)
+static void clrxCompilerCallJob(CLRXProgram* program, const std::string& compilerOptions,
+            const std::vector<CLRXDevice*>& devices,
+            void (CL_CALLBACK* pfnNotify)(cl_program, void*), void* userData)
+{
+    // result is available by build status and build log
+    bool failed = false;
+    try
+    {
+        clrxCompilerCall(program, compilerOptions.c_str(), devices.size(),
+                    (!devices.empty()) ? devices.data() : nullptr);
+    }
+    catch(...)
+    { failed = true; }
+    {
+        // state must be final before notify (callback can rebuild program)
+        std::lock_guard<std::mutex> lock(program->mutex);
+        program->concurrentBuilds--;
+        if (failed || program->asmState.load() == CLRXAsmState::IN_PROGRESS)
+            program->asmState.store(CLRXAsmState::FAILED);
+    }
+    pfnNotify(program, userData);
+    clrxclReleaseProgram(program);
+}
+
+// routine of thread of asynchronous compiler call
+static void clrxCompilerCallThread(CLRXProgram* program, const std::string& compilerOptions,
+            const std::vector<CLRXDevice*>& devices,
+            void (CL_CALLBACK* pfnNotify)(cl_program, void*), void* userData)
+{
+    clrxCompilerCallJob(program, compilerOptions, devices, pfnNotify, userData);
+    clrxAsyncBuildThreads.finish();
+}
+
+cl_int clrxCompilerCallAsync(CLRXProgram* program, const char* compilerOptions,
+            cl_uint devicesNum, CLRXDevice* const* devices,
+            void (CL_CALLBACK* pfnNotify)(cl_program, void*), void* userData)
+{
+    cl_int error = CL_SUCCESS;
+    try
+    {
+        // check in this thread, errors are returned by clBuildProgram
+        CLRXCompilerOptions opts;
+        error = clrxCompilerCallCheck(program, compilerOptions, devicesNum, devices, opts);
+    }
+    catch(const std::bad_alloc&)
+    { error = CL_OUT_OF_HOST_MEMORY; }
+    if (error != CL_SUCCESS)
+    {
+        std::lock_guard<std::mutex> lock(program->mutex);
+        program->concurrentBuilds--;
+        program->asmState.store(CLRXAsmState::FAILED);
+        return error;
+    }
+    
+    // program must be alive to end of building
+    if (clrxclRetainProgram(program) != CL_SUCCESS)
+        clrxAbort("Fatal error on clRetainProgram(program) in clrxCompilerCallAsync");
+    std::string options;
+    std::vector<CLRXDevice*> deviceList;
+    try
+    {
+        // copy options and devices (caller can free them after return)
+        options = compilerOptions;
+        if (devices != nullptr)
+            deviceList.assign(devices, devices + devicesNum);
+        clrxAsyncBuildThreads.start(clrxCompilerCallThread, program, options,
+                    deviceList, pfnNotify, userData);
+        return CL_SUCCESS;
+    }
+    catch(const std::system_error&)
+    { } // if thread can not be created, build in this thread
+    catch(...)
+    {
+        // undo retaining and counting build (build will not be done)
+        {
+            std::lock_guard<std::mutex> lock(program->mutex);
+            program->concurrentBuilds--;
+            program->asmState.store(CLRXAsmState::FAILED);
+        }
+        clrxclReleaseProgram(program);
+        return CL_OUT_OF_HOST_MEMORY;
+    }
+    clrxCompilerCallJob(program, options, deviceList, pfnNotify, userData);
+    return CL_SUCCESS;
+}
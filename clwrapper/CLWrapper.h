@@ -517,6 +517,14 @@ CLRX_INTERNAL bool detectCLRXCompilerCall(const char* compilerOptions);
 CLRX_INTERNAL cl_int clrxCompilerCall(CLRXProgram* program, const char* compilerOptions,
             cl_uint devicesNum, CLRXDevice* const* devices);
 
+/* asynchronous CLRX compiler call: program, devices and options are checked in
+ * this thread (error is returned and concurrentBuilds is decreased), assembling and
+ * building in background thread, after that concurrentBuilds is decreased
+ * and notify is called */
+CLRX_INTERNAL cl_int clrxCompilerCallAsync(CLRXProgram* program, const char* compilerOptions,
+            cl_uint devicesNum, CLRXDevice* const* devices,
+            void (CL_CALLBACK* pfnNotify)(cl_program, void*), void* userData);
+
 CLRX_INTERNAL void clrxAbort(const char* abortStr);
 CLRX_INTERNAL void clrxAbort(const char* abortStr, const char* exStr);
 
@@ -60,6 +60,8 @@ static const CLIOption programOptions[] =
     { "noMacroCase", 'm', CLIArgType::NONE, false, false,
         "do not ignore letter's case in macro names", nullptr },
     { "noWarnings", 'w', CLIArgType::NONE, false, false, "disable warnings", nullptr },
+    { "jobs", 'j', CLIArgType::UINT, false, false,
+        "assemble every input file separately in parallel", "JOBS" },
     CLRX_CLI_AUTOHELP
     { nullptr, 0 }
 };
@@ -136,14 +138,37 @@ try
     for (cxuint i = 0; i < argsNum; i++)
         filenames[i] = cli.getArgs()[i];
     
+    const bool batchMode = cli.hasShortOption('j');
+    if (batchMode && filenames.empty())
+        throw Exception("Parallel mode requires input files");
+    if (batchMode && filenames.size() > 1 && cli.hasShortOption('o'))
+        throw Exception("Output file can't be given for many input files "
+                    "in parallel mode");
+    
     std::unique_ptr<Assembler> assembler;
-    if (!filenames.empty())
+    Array<AsmBatchJob> batchJobs;
+    if (batchMode)
+    {
+        batchJobs.resize(filenames.size());
+        for (size_t i = 0; i < filenames.size(); i++)
+        {
+            AsmBatchJob& job = batchJobs[i];
+            job = AsmBatchJob(filenames[i], binFormat, deviceType, flags);
+            job.is64Bit = is64Bit;
+            job.driverVersion = driverVersion;
+            job.llvmVersion = llvmVersion;
+        }
+    }
+    else if (!filenames.empty())
         assembler.reset(new Assembler(filenames, flags, binFormat, deviceType));
     else // if from stdin
         assembler.reset(new Assembler(nullptr, std::cin, flags, binFormat, deviceType));
-    assembler->set64Bit(is64Bit);
-    assembler->setDriverVersion(driverVersion);
-    assembler->setLLVMVersion(llvmVersion);
+    if (assembler)
+    {
+        assembler->set64Bit(is64Bit);
+        assembler->setDriverVersion(driverVersion);
+        assembler->setLLVMVersion(llvmVersion);
+    }
     
     size_t defSymsNum = 0;
     const char* const* defSyms = nullptr;
@@ -155,7 +180,11 @@ try
         includePaths = cli.getShortOptArgArray<const char*>('I', includePathsNum);
     
     for (size_t i = 0; i < includePathsNum; i++)
-        assembler->addIncludeDir(includePaths[i]);
+        if (assembler)
+            assembler->addIncludeDir(includePaths[i]);
+        else
+            for (AsmBatchJob& job: batchJobs)
+                job.includeDirs.push_back(includePaths[i]);
     for (size_t i = 0; i < defSymsNum; i++)
     {
         const char* eqPlace = ::strchr(defSyms[i], '=');
@@ -193,7 +222,13 @@ try
         else
             symName = defSyms[i];
         if (verifySymbolName(symName))
-            assembler->addInitialDefSym(symName, value);
+        {
+            if (assembler)
+                assembler->addInitialDefSym(symName, value);
+            else
+                for (AsmBatchJob& job: batchJobs)
+                    job.defSyms.push_back(std::make_pair(symName, value));
+        }
         else
         {
             std::cerr << "Invalid symbol name '" << symName << "'" << std::endl;
@@ -203,6 +238,44 @@ try
     // exit if errors occurred
     if (ret!=0)
         return ret;
+    if (batchMode)
+    {
+        // assemble every file separately
+        Array<AsmBatchResult> results(batchJobs.size());
+        assembleBatch(batchJobs.size(), batchJobs.data(), results.data(),
+                    cli.getShortOptArg<cxuint>('j'));
+        for (size_t i = 0; i < batchJobs.size(); i++)
+        {
+            const AsmBatchResult& result = results[i];
+            std::cout << result.printOutput;
+            std::cerr << result.messages;
+            if (!result.good)
+            {
+                ret = 1;
+                continue;
+            }
+            // output name: given by option or input name with '.bin' extension
+            std::string outputName;
+            if (cli.hasShortOption('o'))
+                outputName = cli.getShortOptArg<const char*>('o');
+            else
+            {
+                outputName = batchJobs[i].filename.c_str();
+                const size_t dotPos = outputName.rfind('.');
+                const size_t slashPos = outputName.find_last_of("/\\");
+                if (dotPos != std::string::npos &&
+                    (slashPos == std::string::npos || dotPos > slashPos))
+                    outputName.resize(dotPos);
+                outputName += ".bin";
+            }
+            std::ofstream ofs(outputName.c_str(), std::ios::binary);
+            if (!ofs)
+                throw Exception(std::string("Can't open output file '")+
+                            outputName+"'");
+            ofs.write((const char*)result.binary.data(), result.binary.size());
+        }
+        return ret;
+    }
     /// run assembling
     if (!assembler->assemble())
         return 1;
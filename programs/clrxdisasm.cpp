@@ -54,6 +54,10 @@ static const CLIOption programOptions[] =
         "set LLVM version (for Gallium)", "VERSION" },
     { "buggyFPLit", 0, CLIArgType::NONE, false, false,
         "use old and buggy fplit rules", nullptr },
+    { "jobs", 'j', CLIArgType::UINT, false, false,
+        "disassemble code in parallel by JOBS threads", "JOBS" },
+    { "stream", 'S', CLIArgType::NONE, false, false,
+        "disassemble AMD binaries kernel by kernel (bounded memory)", nullptr },
     CLRX_CLI_AUTOHELP
     { nullptr, 0 }
 };
@@ -84,7 +88,8 @@ try
             (cli.hasShortOption('h')?DISASM_HEXCODE:0);
      disasmFlags |= (cli.hasShortOption('C')?DISASM_CONFIG:0) |
              (cli.hasLongOption("buggyFPLit")?DISASM_BUGGYFPLIT:0) |
-             (cli.hasShortOption('H')?DISASM_HSACONFIG:0);
+             (cli.hasShortOption('H')?DISASM_HSACONFIG:0) |
+             (cli.hasShortOption('S')?DISASM_STREAMING:0);
     
     GPUDeviceType gpuDeviceType = GPUDeviceType::CAPE_VERDE;
     const bool fromRawCode = cli.hasShortOption('r');
@@ -100,16 +105,19 @@ try
     cxuint llvmVersion = 0;
     if (cli.hasLongOption("llvmVersion"))
         llvmVersion = cli.getLongOptArg<cxuint>("llvmVersion");
+    cxuint threadsNum = 1;
+    if (cli.hasShortOption('j'))
+        threadsNum = cli.getShortOptArg<cxuint>('j');
     
     int ret = 0;
     for (const char* const* args = cli.getArgs();*args != nullptr; args++)
     {
         std::cout << "/* Disassembling '" << *args << "\' */" << std::endl;
-        Array<cxbyte> binaryData;
+        MappedFile binaryData;
         std::unique_ptr<AmdMainBinaryBase> base = nullptr;
         try
         {
-            binaryData = loadDataFromFile(*args);
+            binaryData.open(*args);
             
             if (!fromRawCode)
             {
@@ -123,17 +131,22 @@ try
                     binFlags |= AMDBIN_INNER_CREATE_CALNOTES;
                 if ((disasmFlags & (DISASM_METADATA|DISASM_CONFIG)) != 0)
                     binFlags |= AMDBIN_CREATE_INFOSTRINGS;
+                // in streaming mode kernels are parsed at first access
+                // and released after disassembling
+                if ((disasmFlags & DISASM_STREAMING) != 0)
+                    binFlags |= AMDBIN_CREATE_LAZY;
                 
-                if (isAmdBinary(binaryData.size(), binaryData.data()))
+                if (isAmdBinary(binaryData.getSize(), binaryData.getData()))
                 {
                     // if amd binary
-                    base.reset(createAmdBinaryFromCode(binaryData.size(),
-                            binaryData.data(), binFlags));
+                    base.reset(createAmdBinaryFromCode(binaryData.getSize(),
+                            binaryData.getData(), binFlags));
                     if (base->getType() == AmdMainType::GPU_BINARY)
                     {
                         AmdMainGPUBinary32* amdGpuBin =
                                 static_cast<AmdMainGPUBinary32*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else if (base->getType() == AmdMainType::GPU_64_BINARY)
@@ -141,25 +154,27 @@ try
                         AmdMainGPUBinary64* amdGpuBin =
                                 static_cast<AmdMainGPUBinary64*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else
                         throw Exception("This is not AMDGPU binary file!");
                 }
-                else if (isAmdCL2Binary(binaryData.size(), binaryData.data()))
+                else if (isAmdCL2Binary(binaryData.getSize(), binaryData.getData()))
                 {   // AMD OpenCL 2.0 binary
                     // extra (extra data) flags for OpenCL 2.0 disassembler
                     binFlags |= AMDCL2BIN_INNER_CREATE_KERNELDATA |
                                 AMDCL2BIN_INNER_CREATE_KERNELDATAMAP |
                                 AMDCL2BIN_INNER_CREATE_KERNELSTUBS;
-                    base.reset(createAmdCL2BinaryFromCode(binaryData.size(),
-                                           binaryData.data(), binFlags));
+                    base.reset(createAmdCL2BinaryFromCode(binaryData.getSize(),
+                                           binaryData.getData(), binFlags));
                     if (base->getType() == AmdMainType::GPU_CL2_BINARY)
                     {
                         AmdCL2MainGPUBinary32* amdGpuBin =
                                 static_cast<AmdCL2MainGPUBinary32*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags,
                                             driverVersion);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else if (base->getType() == AmdMainType::GPU_CL2_64_BINARY)
@@ -168,32 +183,37 @@ try
                                 static_cast<AmdCL2MainGPUBinary64*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags,
                                             driverVersion);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else
                         throw Exception("This is not AMDGPU binary file!");
                 }
-                else if (isROCmBinary(binaryData.size(), binaryData.data()))
+                else if (isROCmBinary(binaryData.getSize(), binaryData.getData()))
                 {
                     // ROCm binary
-                    ROCmBinary rocmBin(binaryData.size(), binaryData.data(), 0);
+                    ROCmBinary rocmBin(binaryData.getSize(), binaryData.getData(), 0);
                     Disassembler disasm(rocmBin, std::cout, disasmFlags);
+                    disasm.setThreadsNum(threadsNum);
                     disasm.disassemble();
                 }
                 else
                 {
                     // if gallium binary
-                    GalliumBinary galliumBin(binaryData.size(),binaryData.data(), 0);
+                    GalliumBinary galliumBin(binaryData.getSize(),
+                            binaryData.getData(), 0);
                     Disassembler disasm(gpuDeviceType, galliumBin, std::cout,
                             disasmFlags, llvmVersion);
+                    disasm.setThreadsNum(threadsNum);
                     disasm.disassemble();
                 }
             }
             else
             {
                 /* raw binaries */
-                Disassembler disasm(gpuDeviceType, binaryData.size(), binaryData.data(),
-                        std::cout, disasmFlags);
+                Disassembler disasm(gpuDeviceType, binaryData.getSize(),
+                        binaryData.getData(), std::cout, disasmFlags);
+                disasm.setThreadsNum(threadsNum);
                 disasm.disassemble();
             }
         }
@@ -0,0 +1,127 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <vector>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+struct AsmBatchTestCase
+{
+    const char* input;
+    BinaryFormat format;
+    GPUDeviceType deviceType;
+    bool good;
+};
+
+static const AsmBatchTestCase batchTestCasesTbl[] =
+{
+    { ".amd;.kernel xx;.config;.text;s_add_u32 s5,s0,s1\n"
+        "v_mul_f32 v36,v1,v2;s_endpgm\n", BinaryFormat::AMD,
+        GPUDeviceType::PITCAIRN, true },
+    { ".amdcl2;.kernel xx;.config;.text;v_add_f32_e64 v1, v2, v3\n"
+        "v_mov_b32_sdwa v1, v2 dst_sel:byte0;s_endpgm\n", BinaryFormat::AMDCL2,
+        GPUDeviceType::FIJI, true },
+    { ".gallium;.llvm_version 30800;.kernel xx;.config;.text\n"
+        "xx:v_readlane_b32 s43,v4,s5;s_endpgm\n",
+        BinaryFormat::GALLIUM, GPUDeviceType::BONAIRE, true },
+    { ".rocm;.kernel xx;.config;.text\nxx:.skip 256\n"
+        "v_mov_b32_dpp v1, v2 quad_perm:[3,2,1,0]\ns_endpgm\n", BinaryFormat::ROCM, GPUDeviceType::GFX900, true },
+    { "v_add_f32 v1, v2, v3\n.rept 100\ns_nop 1\nv_sub_f32 v1,v2,v3\n.endr\n",
+        BinaryFormat::RAWCODE, GPUDeviceType::TONGA, true },
+    { "v_unknown_insn v1, v2\n", BinaryFormat::RAWCODE, GPUDeviceType::TONGA, false },
+    { ".print \"hello\"\ns_endpgm\n", BinaryFormat::RAWCODE,
+        GPUDeviceType::HAWAII, true }
+};
+
+static const size_t batchTestCasesNum = sizeof(batchTestCasesTbl)/sizeof(AsmBatchTestCase);
+
+// assemble by single assembler in this thread (reference results)
+static void assembleSequential(const AsmBatchJob& job, AsmBatchResult& result)
+{
+    std::istringstream input(job.content);
+    std::ostringstream msgStream;
+    std::ostringstream printStream;
+    Assembler assembler(job.filename, input, job.flags, job.format, job.deviceType,
+                msgStream, printStream);
+    result.good = assembler.assemble();
+    if (result.good)
+        assembler.writeBinary(result.binary);
+    result.messages = msgStream.str();
+    result.printOutput = printStream.str();
+}
+
+static void testAsmBatch(cxuint threadsNum, cxuint repeats)
+{
+    char buf[40];
+    snprintf(buf, 40, "AsmBatch(threads=%u)", threadsNum);
+    const std::string testName(buf);
+    const size_t jobsNum = batchTestCasesNum*repeats;
+    std::vector<AsmBatchJob> jobs(jobsNum);
+    for (size_t i = 0; i < jobsNum; i++)
+    {
+        const AsmBatchTestCase& testCase = batchTestCasesTbl[i % batchTestCasesNum];
+        snprintf(buf, 40, "job%zu", i);
+        jobs[i] = AsmBatchJob(buf, testCase.format, testCase.deviceType);
+        jobs[i].content = testCase.input;
+    }
+    Array<AsmBatchResult> results(jobsNum);
+    assembleBatch(jobsNum, jobs.data(), results.data(), threadsNum);
+
+    for (size_t i = 0; i < jobsNum; i++)
+    {
+        const AsmBatchTestCase& testCase = batchTestCasesTbl[i % batchTestCasesNum];
+        snprintf(buf, 40, "Job=%zu.", i);
+        const std::string caseName(buf);
+        AsmBatchResult expected;
+        assembleSequential(jobs[i], expected);
+        const AsmBatchResult& result = results[i];
+        assertValue(testName, caseName+"good", testCase.good, result.good);
+        assertValue(testName, caseName+"goodSeq", expected.good, result.good);
+        assertTrue(testName, caseName+"binary", expected.binary.size() ==
+                result.binary.size() && std::equal(expected.binary.begin(),
+                expected.binary.end(), result.binary.begin()));
+        assertString(testName, caseName+"messages", expected.messages.c_str(),
+                    result.messages.c_str());
+        assertString(testName, caseName+"printOutput", expected.printOutput.c_str(),
+                    result.printOutput.c_str());
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    const cxuint threadsNums[] = { 1, 2, 4, 7 };
+    for (cxuint threadsNum: threadsNums)
+        try
+        { testAsmBatch(threadsNum, 20); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    return retVal;
+}
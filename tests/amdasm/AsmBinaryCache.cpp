@@ -0,0 +1,198 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* cacheDirName = "AsmBinaryCache.tmp.dir";
+static const char* includeFilename = "AsmBinaryCacheInc.tmp.s";
+static const char* binFilename = "AsmBinaryCacheBin.tmp.bin";
+static const char* incDir1Name = "AsmBinaryCacheInc1.tmp.dir";
+static const char* incDir2Name = "AsmBinaryCacheInc2.tmp.dir";
+
+static void writeFile(const char* filename, const char* content)
+{
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr)
+        throw Exception("Can't create temporary file");
+    fwrite(content, 1, ::strlen(content), file);
+    fclose(file);
+}
+
+struct AsmResult
+{
+    Array<cxbyte> binary;
+    std::vector<CString> dependencies;
+    std::vector<CString> missingFiles;
+    std::string log;
+};
+
+static bool assembleSource(const char* input, AsmResult& result,
+            const std::vector<CString>& includeDirs = {})
+{
+    std::istringstream iss(input);
+    std::ostringstream msgStream;
+    Assembler assembler("test.s", iss, ASM_ALL&~ASM_ALTMACRO, BinaryFormat::RAWCODE,
+            GPUDeviceType::PITCAIRN, msgStream);
+    for (const CString& incDir: includeDirs)
+        assembler.addIncludeDir(incDir);
+    if (!assembler.assemble())
+        return false;
+    assembler.writeBinary(result.binary);
+    result.dependencies = assembler.getDependencies();
+    result.missingFiles = assembler.getMissingDependencies();
+    result.log = msgStream.str();
+    return true;
+}
+
+// path of entry file in cache (hex of FNV-1a hash of key with CLRX version)
+static std::string getEntryPath(const std::string& key)
+{
+    const std::string fullKey = std::string("CLRX " CLRX_VERSION "\n") + key;
+    char name[24];
+    ::snprintf(name, 24, "%016llx", (unsigned long long)hashFNV1a64(fullKey.size(),
+                fullKey.c_str()));
+    return joinPaths(cacheDirName, name);
+}
+
+static void testBinaryCache()
+{
+    const std::string testName = "AsmBinaryCache";
+    const char* input = ".include \"AsmBinaryCacheInc.tmp.s\"\n"
+            ".int V\n.incbin \"AsmBinaryCacheBin.tmp.bin\"\ns_nop 1\n.warning \"xx\"\n";
+    writeFile(includeFilename, "V = 7\n");
+    writeFile(binFilename, "abc");
+    AsmResult result;
+    assertTrue(testName, "assemble", assembleSource(input, result));
+    assertValue(testName, "depsNum", size_t(2), result.dependencies.size());
+    assertString(testName, "dep0", includeFilename, result.dependencies[0]);
+    assertString(testName, "dep1", binFilename, result.dependencies[1]);
+    assertValue(testName, "missingNum", size_t(0), result.missingFiles.size());
+    assertTrue(testName, "log", result.log.find("xx") != std::string::npos);
+    
+    const std::string key = std::string("PITCAIRN\n") + input;
+    const std::string otherKey = std::string("TONGA\n") + input;
+    {
+        AsmBinaryCache cache(cacheDirName);
+        assertTrue(testName, "noDirBeforePut", !isFileExists(cacheDirName));
+        Array<cxbyte> cached;
+        std::string cachedLog;
+        assertTrue(testName, "emptyGet", !cache.get(key, cached, cachedLog));
+        cache.put(key, result.dependencies, result.missingFiles, result.binary,
+                  result.log);
+        assertTrue(testName, "dirAfterPut", isDirectory(cacheDirName));
+    }
+    // new cache object (as in new process) must see entry
+    AsmBinaryCache cache(cacheDirName);
+    Array<cxbyte> cached;
+    std::string cachedLog;
+    assertTrue(testName, "get", cache.get(key, cached, cachedLog));
+    assertTrue(testName, "getBinary", cached.size() == result.binary.size() &&
+                std::equal(cached.begin(), cached.end(), result.binary.begin()));
+    assertString(testName, "getLog", result.log.c_str(), cachedLog);
+    assertTrue(testName, "getOtherKey", !cache.get(otherKey, cached, cachedLog));
+    
+    // changed included files invalidate entry
+    writeFile(includeFilename, "V = 8\n");
+    assertTrue(testName, "getChangedInclude", !cache.get(key, cached, cachedLog));
+    writeFile(includeFilename, "V = 7\n");
+    assertTrue(testName, "getRestoredInclude", cache.get(key, cached, cachedLog));
+    writeFile(binFilename, "abcd");
+    assertTrue(testName, "getChangedIncBin", !cache.get(key, cached, cachedLog));
+    remove(binFilename);
+    assertTrue(testName, "getRemovedIncBin", !cache.get(key, cached, cachedLog));
+    writeFile(binFilename, "abc");
+    assertTrue(testName, "getRestoredIncBin", cache.get(key, cached, cachedLog));
+    
+    // entry replaced by newer put
+    const cxbyte newBinary[3] = { 1, 2, 3 };
+    cache.put(key, {}, {}, Array<cxbyte>(newBinary, newBinary+3), "");
+    assertTrue(testName, "getReplaced", cache.get(key, cached, cachedLog));
+    assertTrue(testName, "getReplacedBinary", cached.size() == 3 &&
+                std::equal(cached.begin(), cached.end(), newBinary));
+    assertString(testName, "getReplacedLog", "", cachedLog);
+    
+    // truncated entry must be ignored
+    const std::string entryPath = getEntryPath(key);
+    writeFile(entryPath.c_str(), "CLRXBINC\x02");
+    assertTrue(testName, "getTruncated", !cache.get(key, cached, cachedLog));
+    
+    remove(entryPath.c_str());
+    remove(includeFilename);
+    remove(binFilename);
+}
+
+// file created in earlier include path shadows included file
+static void testBinaryCacheShadowing()
+{
+    const std::string testName = "AsmBinaryCacheShadowing";
+    const char* input = ".include \"AsmBinaryCacheInc.tmp.s\"\n.int V\n";
+    makeDir(incDir1Name);
+    makeDir(incDir2Name);
+    const std::string incFile1 = joinPaths(incDir1Name, includeFilename);
+    const std::string incFile2 = joinPaths(incDir2Name, includeFilename);
+    writeFile(incFile2.c_str(), "V = 7\n");
+    AsmResult result;
+    assertTrue(testName, "assemble", assembleSource(input, result,
+                { incDir1Name, incDir2Name }));
+    assertValue(testName, "depsNum", size_t(1), result.dependencies.size());
+    assertString(testName, "dep0", incFile2.c_str(), result.dependencies[0]);
+    assertValue(testName, "missingNum", size_t(2), result.missingFiles.size());
+    assertString(testName, "missing0", includeFilename, result.missingFiles[0]);
+    assertString(testName, "missing1", incFile1.c_str(), result.missingFiles[1]);
+    
+    const std::string key = std::string("PITCAIRN\n") + input;
+    AsmBinaryCache cache(cacheDirName);
+    cache.put(key, result.dependencies, result.missingFiles, result.binary,
+              result.log);
+    Array<cxbyte> cached;
+    std::string cachedLog;
+    assertTrue(testName, "get", cache.get(key, cached, cachedLog));
+    writeFile(incFile1.c_str(), "V = 8\n");
+    assertTrue(testName, "getShadowed", !cache.get(key, cached, cachedLog));
+    remove(incFile1.c_str());
+    assertTrue(testName, "getNotShadowed", cache.get(key, cached, cachedLog));
+    
+    remove(getEntryPath(key).c_str());
+    remove(incFile2.c_str());
+    remove(incDir1Name);
+    remove(incDir2Name);
+    remove(cacheDirName);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testBinaryCache);
+    retVal |= callTest(testBinaryCacheShadowing);
+    return retVal;
+}
@@ -0,0 +1,200 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* includeHeaderFilename = "AsmIncludeCacheHdr.tmp.s";
+static const char* includeCacheFilename = "AsmIncludeCache.tmp.cache";
+
+struct IncludeCacheTestCase
+{
+    const char* header;
+    const char* input;
+    bool cacheable; // if header can be cached
+};
+
+static const IncludeCacheTestCase includeCacheTestCasesTbl[] =
+{
+    {   /* macros, symbols and reg-vars */
+        "COUNT = 4\n.set SHIFT, COUNT*2\n.equ MASK, (1<<SHIFT)-1\n.equiv ONE, 1\n"
+        ".macro addv dst, src1, src2=v0\n"
+        "    v_add_f32 \\dst, \\src1, \\src2\n.endm\n"
+        ".macro sums first, rest:vararg\n    .int \\first\n"
+        "  .ifnb \\rest\n    sums \\rest\n  .endif\n.endm\n"
+        ".regvar rx:v, ry:s:4\n",
+        ".include \"AsmIncludeCacheHdr.tmp.s\"\n"
+        "addv v1, v2\naddv v4, v5, v6\nsums COUNT, SHIFT, MASK, ONE\n"
+        "s_mov_b32 ry[1], rx\n.int COUNT+MASK\n",
+        true },
+    {   /* errors inside macro from included file */
+        ".macro bad x\n    v_add_f32 v1, \\x, xx\n"
+        "    v_mov_b32 v1, \\x\n.endm\n",
+        ".include \"AsmIncludeCacheHdr.tmp.s\"\n.include \"AsmIncludeCacheHdr.tmp.s\"\n"
+        "bad v3\nbad s5\n",
+        true },
+    {   /* symbols defined before inclusion (must be parsed normally) */
+        "A = 5\nB = A+1\n",
+        "A = 3\n.include \"AsmIncludeCacheHdr.tmp.s\"\n.int A, B\n",
+        true },
+    {   /* instructions in included file */
+        "s_nop 1\nX = 2\n",
+        ".include \"AsmIncludeCacheHdr.tmp.s\"\n.int X\n", false },
+    {   /* include guard */
+        ".ifndef HDR_GUARD\nHDR_GUARD = 1\n.macro m1\n  s_nop 2\n.endm\n.endif\n",
+        ".include \"AsmIncludeCacheHdr.tmp.s\"\n.include \"AsmIncludeCacheHdr.tmp.s\"\n"
+        "m1\n", false },
+    {   /* external symbol */
+        "Y = EXT+1\n", "EXT = 6\n.include \"AsmIncludeCacheHdr.tmp.s\"\n.int Y\n", false },
+    {   /* label */
+        "lab:\nZ = 1\n", ".include \"AsmIncludeCacheHdr.tmp.s\"\n.int Z\n", false },
+    {   /* unterminated macro */
+        ".macro m2\n  s_nop 3\n", ".include \"AsmIncludeCacheHdr.tmp.s\"\n"
+        "  s_nop 4\n.endm\nm2\n", false }
+};
+
+static void writeHeader(const char* content)
+{
+    FILE* file = fopen(includeHeaderFilename, "wb");
+    if (file == nullptr)
+        throw Exception("Can't create temporary file");
+    fwrite(content, 1, ::strlen(content), file);
+    fclose(file);
+}
+
+struct AsmResult
+{
+    bool good;
+    std::string binary;
+    std::string messages;
+};
+
+static AsmResult assembleWithCache(const char* input, AsmIncludeCache* cache,
+            uint64_t* paramsKey = nullptr)
+{
+    std::istringstream iss(input);
+    std::ostringstream msgStream, printStream;
+    Assembler assembler("test.s", iss, ASM_ALL&~ASM_ALTMACRO, BinaryFormat::RAWCODE,
+            GPUDeviceType::PITCAIRN, msgStream, printStream);
+    assembler.setIncludeCache(cache);
+    if (paramsKey != nullptr)
+        *paramsKey = assembler.getIncludeParamsKey();
+    AsmResult result;
+    result.good = assembler.assemble();
+    std::ostringstream binStream;
+    if (result.good)
+        assembler.writeBinary(binStream);
+    result.binary = binStream.str();
+    result.messages = msgStream.str();
+    return result;
+}
+
+static void assertResult(const std::string& testName, const std::string& caseName,
+            const AsmResult& expected, const AsmResult& result)
+{
+    assertValue(testName, caseName+"good", int(expected.good), int(result.good));
+    assertTrue(testName, caseName+"binary", expected.binary == result.binary);
+    assertString(testName, caseName+"messages", expected.messages.c_str(),
+                result.messages.c_str());
+}
+
+static void testIncludeCache(cxuint testId, const IncludeCacheTestCase& testCase)
+{
+    std::ostringstream oss;
+    oss << "AsmIncludeCache#" << testId;
+    const std::string testName = oss.str();
+    writeHeader(testCase.header);
+    const AsmResult expected = assembleWithCache(testCase.input, nullptr);
+    AsmIncludeCache cache;
+    // first pass fills cache, second pass uses it
+    const AsmResult result1 = assembleWithCache(testCase.input, &cache);
+    assertResult(testName, "first.", expected, result1);
+    assertValue(testName, "cacheSize", size_t(testCase.cacheable), cache.size());
+    const AsmResult result2 = assembleWithCache(testCase.input, &cache);
+    assertResult(testName, "second.", expected, result2);
+    
+    // saved and loaded cache
+    cache.saveToFile(includeCacheFilename);
+    AsmIncludeCache loadedCache;
+    loadedCache.loadFromFile(includeCacheFilename);
+    remove(includeCacheFilename);
+    assertValue(testName, "loadedCacheSize", cache.size(), loadedCache.size());
+    const AsmResult result3 = assembleWithCache(testCase.input, &loadedCache);
+    assertResult(testName, "loaded.", expected, result3);
+    remove(includeHeaderFilename);
+}
+
+// modified included file must not be loaded from cache
+static void testIncludeCacheModified()
+{
+    const std::string testName = "AsmIncludeCacheModified";
+    const char* input = ".include \"AsmIncludeCacheHdr.tmp.s\"\n.int V\nmv\n";
+    writeHeader("V = 7\n.macro mv\n  .byte 1\n.endm\n");
+    AsmIncludeCache cache;
+    uint64_t paramsKey = 0;
+    assembleWithCache(input, &cache, &paramsKey);
+    assertValue(testName, "cacheSize", size_t(1), cache.size());
+    // change file (and its timestamp)
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    writeHeader("V = 9\n.macro mv\n  .byte 2, 3\n.endm\n");
+    const AsmResult expected = assembleWithCache(input, nullptr);
+    const AsmResult result = assembleWithCache(input, &cache);
+    assertResult(testName, "modified.", expected, result);
+    assertTrue(testName, "content", expected.binary == std::string("\x09\0\0\0\x02\x03", 6));
+    
+    const uint64_t timestamp = getFileTimestamp(includeHeaderFilename);
+    Array<cxbyte> data;
+    assertTrue(testName, "getEntry", cache.get(includeHeaderFilename, timestamp,
+                paramsKey, data));
+    assertTrue(testName, "getEntryOtherParams", !cache.get(includeHeaderFilename,
+                timestamp, paramsKey^1, data));
+    // corrupted entry must be ignored
+    const cxbyte badData[6] = { 1, 0, 0, 0, 5, 0 };
+    cache.put(includeHeaderFilename, timestamp, paramsKey,
+                Array<cxbyte>(badData, badData+6));
+    assertResult(testName, "corrupted.", expected, assembleWithCache(input, &cache));
+    cache.clear();
+    assertValue(testName, "clearedSize", size_t(0), cache.size());
+    remove(includeHeaderFilename);
+    
+    assertCLRXException(testName, "noCacheFile", "File or directory doesn't exists",
+            [&cache]() { cache.loadFromFile("AsmIncludeCacheNotExist.tmp.cache"); });
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (cxuint i = 0; i < sizeof(includeCacheTestCasesTbl)/
+                sizeof(IncludeCacheTestCase); i++)
+        retVal |= callTest(testIncludeCache, i, includeCacheTestCasesTbl[i]);
+    retVal |= callTest(testIncludeCacheModified);
+    return retVal;
+}
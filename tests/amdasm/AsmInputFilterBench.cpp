@@ -0,0 +1,147 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* benchmark of the assembler input filter (reading source lines only)
+ * usage: AsmInputFilterBench [SIZEINMB [FILENAME]] */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+
+using namespace CLRX;
+
+// generate assembler source with instructions, comments and strings
+static void generateSource(const char* filename, size_t sizeInMB)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs)
+        throw Exception("Can't create source file");
+    const size_t size = sizeInMB<<20;
+    size_t written = 0;
+    uint32_t state = 0x1234567U;
+    char buf[160];
+    while (written < size)
+    {
+        state = state*1103515245U + 12345U;
+        const uint32_t v = state>>8;
+        int len = 0;
+        switch (v & 7)
+        {
+            case 0:
+                len = snprintf(buf, 160, "    v_mul_f32 v%u, v%u, v%u  # multiply "
+                    "values\n", v%100, (v>>4)%100, (v>>8)%100);
+                break;
+            case 1:
+                len = snprintf(buf, 160, "label%u: .ascii \"text;with#special/*chars\\\"\""
+                    "\n", v);
+                break;
+            case 2:
+                len = snprintf(buf, 160, "/* long comment about value %u\n"
+                    " * and other things */ s_nop %u\n", v, v&7);
+                break;
+            case 3:
+                len = snprintf(buf, 160, "\ts_add_u32 s%u, s%u, %u; s_nop 0\n",
+                    v%100, (v>>4)%100, v);
+                break;
+            default:
+                len = snprintf(buf, 160, "    v_add_f32 v%u, v%u, v%u\n",
+                    v%100, (v>>4)%100, (v>>8)%100);
+                break;
+        }
+        ofs.write(buf, len);
+        written += len;
+    }
+}
+
+static double benchmarkFilter(AsmInputFilter& filter, Assembler& assembler,
+            size_t& linesNum, size_t& charsNum)
+{
+    linesNum = charsNum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    size_t lineSize = 0;
+    while (filter.readLine(assembler, lineSize) != nullptr)
+    {
+        linesNum++;
+        charsNum += lineSize;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end-start).count();
+}
+
+int main(int argc, const char** argv)
+{
+    const size_t sizeInMB = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 100;
+    const char* filename = (argc >= 3) ? argv[2] : "AsmInputFilterBench.tmp.s";
+    if (sizeInMB == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    try
+    {
+        generateSource(filename, sizeInMB);
+        std::istringstream emptyInput("");
+        std::ostringstream msgStream;
+        Assembler assembler("", emptyInput, 0, BinaryFormat::RAWCODE,
+                    GPUDeviceType::CAPE_VERDE, msgStream);
+        
+        size_t mapLinesNum, mapCharsNum, linesNum, charsNum;
+        double mapTime = 1e100, streamTime = 1e100;
+        // get best time from three passes
+        for (cxuint pass = 0; pass < 3; pass++)
+        {
+            {
+                AsmStreamInputFilter filter(filename);
+                mapTime = std::min(mapTime, benchmarkFilter(filter, assembler,
+                            mapLinesNum, mapCharsNum));
+            }
+            {
+                std::ifstream ifs(filename, std::ios::binary);
+                AsmStreamInputFilter filter(ifs, filename);
+                streamTime = std::min(streamTime, benchmarkFilter(filter, assembler,
+                            linesNum, charsNum));
+            }
+        }
+        remove(filename);
+        std::cout << "Size: " << sizeInMB << " MB, lines: " << linesNum << "\n"
+            "Mapped file: " << mapTime << " s, " << (sizeInMB/mapTime) << " MB/s\n"
+            "Stream: " << streamTime << " s, " << (sizeInMB/streamTime) << " MB/s" <<
+            std::endl;
+        if (mapLinesNum != linesNum || mapCharsNum != charsNum)
+        {
+            std::cerr << "Mapped file and stream gives different lines!" << std::endl;
+            return 1;
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        remove(filename);
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+#include "AsmBasics.h"
+
+using namespace CLRX;
+
+static const char* mappedInputFilename = "AsmMappedInput.tmp.s";
+
+// inputs with mixed plain lines and lines that requires transformation
+static const char* mappedInputCasesTbl[] =
+{
+    "a = 1\nb = a+2; c = b*3\n  d = c/2   \ne = d\n",
+    "a = 1\r\nb = 2\r\n\t\tc = a+b\n\n\n;;\nd = 4",
+    "a = 1 # comment; x = 1\nb = 2 /* long\ncomment */ c = 3 ; d = 4\n"
+        "e = 5 // 2\nf = 6/*xx*/7\n",
+    "a = 1\\\n + 2\nb = 3 ; c = a+\\\nb\n.print \"a;b#c/*\\\nx\"\nd = 1\n",
+    ".print \"unterminated\nx = 1\n.print 'xx;'\n/* unterminated comment\n",
+    ".rept 3\n    s_nop 1\n\tv_mov_b32 v1, v2 ; v_mov_b32 v2, v3\n.endr\n"
+        ".macro mac a,b\n  .int \\a+\\b\n.endm\nmac 1,2\nmac 3/4, 5\n",
+    ""
+};
+
+// assemble source from mapped file and from stream and compare results
+static void testMappedInput(const std::string& testName, const char* input,
+            const Array<const char*>& includeDirs)
+{
+    FILE* file = fopen(mappedInputFilename, "wb");
+    if (file == nullptr)
+        throw Exception("Can't create temporary file");
+    fwrite(input, 1, ::strlen(input), file);
+    fclose(file);
+    
+    std::ostringstream mapErrorStream, mapPrintStream;
+    Array<CString> filenames(1);
+    filenames[0] = mappedInputFilename;
+    Assembler mapAssembler(filenames,
+            (ASM_ALL|ASM_TESTRUN)&~ASM_ALTMACRO, BinaryFormat::AMD,
+            GPUDeviceType::CAPE_VERDE, mapErrorStream, mapPrintStream);
+    std::istringstream iss(input);
+    std::ostringstream errorStream, printStream;
+    Assembler assembler(mappedInputFilename, iss, (ASM_ALL|ASM_TESTRUN)&~ASM_ALTMACRO,
+            BinaryFormat::AMD, GPUDeviceType::CAPE_VERDE, errorStream, printStream);
+    for (const char* incDir: includeDirs)
+    {
+        mapAssembler.addIncludeDir(incDir);
+        assembler.addIncludeDir(incDir);
+    }
+    const bool mapGood = mapAssembler.assemble();
+    const bool good = assembler.assemble();
+    remove(mappedInputFilename);
+    
+    assertValue(testName, "good", int(good), int(mapGood));
+    assertString(testName, "errorMessages", errorStream.str().c_str(),
+                mapErrorStream.str().c_str());
+    assertString(testName, "printMessages", printStream.str().c_str(),
+                mapPrintStream.str().c_str());
+    const std::vector<AsmSection>& sections = assembler.getSections();
+    const std::vector<AsmSection>& mapSections = mapAssembler.getSections();
+    assertValue(testName, "sections.length", sections.size(), mapSections.size());
+    for (size_t i = 0; i < sections.size(); i++)
+        assertTrue(testName, "section.content", sections[i].content ==
+                mapSections[i].content);
+    // compare values of global symbols
+    const AsmSymbolMap& symbolMap = assembler.getSymbolMap();
+    const AsmSymbolMap& mapSymbolMap = mapAssembler.getSymbolMap();
+    assertValue(testName, "symbols.length", symbolMap.size(), mapSymbolMap.size());
+    for (const AsmSymbolEntry& entry: symbolMap)
+    {
+        auto it = mapSymbolMap.find(entry.first);
+        assertTrue(testName, std::string("symbol ")+entry.first.c_str(),
+                it != mapSymbolMap.end() && it->second.value == entry.second.value &&
+                it->second.hasValue == entry.second.hasValue);
+    }
+}
+
+/* lines with comments, strings and escapes at different positions
+ * (checks scanning of line content by blocks) */
+static void testLongLines(bool fromFile)
+{
+    const std::string testName = fromFile ? "LongLines(file)" : "LongLines(stream)";
+    std::string input, expectedContent;
+    for (cxuint k = 0; k < 80; k++)
+    {
+        char buf[40];
+        snprintf(buf, 40, "s%u = ", k);
+        input += buf;
+        for (cxuint i = 0; i < k; i++)
+            input += "1+";
+        input += "1\t# comment ;x = 2\n.ascii \"";
+        input += std::string(k, 'a') + "\\\"b;#/*\\\\\"\n/* ";
+        expectedContent += std::string(k, 'a') + "\"b;#/*\\";
+        snprintf(buf, 40, " */ t%u = %u\n", k, k);
+        input += std::string(k, 'c') + buf;
+    }
+    
+    std::istringstream iss(input);
+    std::ostringstream errorStream, printStream;
+    std::unique_ptr<Assembler> assembler;
+    if (fromFile)
+    {
+        FILE* file = fopen(mappedInputFilename, "wb");
+        if (file == nullptr)
+            throw Exception("Can't create temporary file");
+        fwrite(input.c_str(), 1, input.size(), file);
+        fclose(file);
+        Array<CString> filenames(1);
+        filenames[0] = mappedInputFilename;
+        assembler.reset(new Assembler(filenames, ASM_ALL&~ASM_ALTMACRO,
+                BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream,
+                printStream));
+    }
+    else
+        assembler.reset(new Assembler(mappedInputFilename, iss, ASM_ALL&~ASM_ALTMACRO,
+                BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream,
+                printStream));
+    const bool good = assembler->assemble();
+    if (fromFile)
+        remove(mappedInputFilename);
+    assertValue(testName, "good", 1, int(good));
+    assertString(testName, "errorMessages", "", errorStream.str().c_str());
+    const std::vector<AsmSection>& sections = assembler->getSections();
+    assertValue(testName, "sections.length", size_t(1), sections.size());
+    assertString(testName, "content", expectedContent.c_str(),
+            std::string(sections[0].content.begin(), sections[0].content.end()).c_str());
+    const AsmSymbolMap& symbolMap = assembler->getSymbolMap();
+    for (cxuint k = 0; k < 80; k++)
+    {
+        char buf[20];
+        snprintf(buf, 20, "s%u", k);
+        auto it = symbolMap.find(buf);
+        assertTrue(testName, buf, it != symbolMap.end() && it->second.value == k+1);
+        snprintf(buf, 20, "t%u", k);
+        it = symbolMap.find(buf);
+        assertTrue(testName, buf, it != symbolMap.end() && it->second.value == k);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (size_t i = 0; mappedInputCasesTbl[i][0] != 0; i++)
+    {
+        char testName[40];
+        snprintf(testName, 40, "MappedInput #%zu", i);
+        retVal |= callTest(testMappedInput, std::string(testName),
+                    mappedInputCasesTbl[i], Array<const char*>());
+    }
+    retVal |= callTest(testLongLines, false);
+    retVal |= callTest(testLongLines, true);
+    const AsmTestCase* testCasesTbls[2] = { asmTestCases1Tbl, asmTestCases2Tbl };
+    for (cxuint k = 0; k < 2; k++)
+        for (size_t i = 0; testCasesTbls[k][i].input != nullptr; i++)
+        {
+            char testName[40];
+            snprintf(testName, 40, "MappedInput Basics%u #%zu", k+1, i);
+            retVal |= callTest(testMappedInput, std::string(testName),
+                    testCasesTbls[k][i].input, testCasesTbls[k][i].includeDirs);
+        }
+    return retVal;
+}
@@ -1040,6 +1040,179 @@ static void testCreateSSAData(cxuint i, const AsmSSADataCase& testCase)
     }
 }
 
+typedef AsmRegAllocator::InterGraph InterGraph;
+typedef AsmRegAllocator::ColoringEngine ColoringEngine;
+
+struct AsmColorGraphCase
+{
+    size_t nodesNum;
+    Array<std::pair<size_t, size_t> > edges;
+    Array<std::pair<size_t, cxuint> > precolored;
+    Array<Array<size_t> > equalSets;
+    Array<cxuint> expectedColors;
+    cxuint expectedColorsNum;
+};
+
+static const AsmColorGraphCase colorGraphTestCasesTbl[] =
+{
+    {   // 0 - two triangles joined by edge
+        6, { { 0, 1 }, { 0, 2 }, { 1, 2 }, { 2, 3 }, { 3, 4 }, { 4, 5 }, { 3, 5 } },
+        { }, { },
+        { 1, 2, 0, 1, 0, 2 }, 3
+    },
+    {   // 1 - with real registers
+        5, { { 0, 2 }, { 1, 3 }, { 2, 3 }, { 3, 4 }, { 2, 4 } },
+        { { 0, 0 }, { 1, 1 } }, { },
+        { 0, 1, 1, 0, 2 }, 3
+    },
+    {   // 2 - with equal sets
+        6, { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 4 }, { 4, 5 } },
+        { }, { { 0, 3 } },
+        { 2, 0, 1, 2, 0, 1 }, 3
+    }
+};
+
+static void checkColoring(const std::string& testName, const InterGraph& interGraph,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            const Array<cxuint>& gcMap)
+{
+    for (size_t node = 0; node < interGraph.size(); node++)
+    {
+        std::ostringstream oss;
+        oss << "node#" << node;
+        assertTrue(testName, oss.str() + ".colored", gcMap[node] != UINT_MAX);
+        for (size_t nb: interGraph[node])
+            assertTrue(testName, oss.str() + ".nbColor", gcMap[node] != gcMap[nb]);
+    }
+    for (const std::vector<size_t>& equalSet: equalSetList)
+        for (size_t node: equalSet)
+            assertValue(testName, "equalSet", gcMap[equalSet[0]], gcMap[node]);
+}
+
+static void colorGraphByEngines(const std::string& testName, const InterGraph& interGraph,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            const Array<cxuint>& initGcMap, cxuint initColorsNum,
+            Array<cxuint>& gcMap, cxuint& colorsNum)
+{
+    Array<cxuint> setGcMap(initGcMap);
+    const cxuint setColorsNum = AsmRegAllocator::colorGraph(ColoringEngine::SET,
+            interGraph, equalSetMap, equalSetList, 256, initColorsNum, setGcMap);
+    gcMap = initGcMap;
+    colorsNum = AsmRegAllocator::colorGraph(ColoringEngine::BUCKET,
+            interGraph, equalSetMap, equalSetList, 256, initColorsNum, gcMap);
+    assertValue(testName, "colorsNumEngines", setColorsNum, colorsNum);
+    assertArray(testName, "gcMapEngines", setGcMap, gcMap);
+    checkColoring(testName, interGraph, equalSetList, gcMap);
+}
+
+static void testColorGraph(cxuint i, const AsmColorGraphCase& testCase)
+{
+    std::ostringstream oss;
+    oss << "testColorGraph#" << i;
+    const std::string testName = oss.str();
+    InterGraph interGraph(testCase.nodesNum);
+    for (const std::pair<size_t, size_t>& edge: testCase.edges)
+        interGraph.addEdge(edge.first, edge.second);
+    interGraph.freeze();
+    Array<cxuint> initGcMap(testCase.nodesNum);
+    std::fill(initGcMap.begin(), initGcMap.end(), cxuint(UINT_MAX));
+    for (const std::pair<size_t, cxuint>& entry: testCase.precolored)
+        initGcMap[entry.first] = entry.second;
+    std::unordered_map<size_t, size_t> equalSetMap;
+    std::vector<std::vector<size_t> > equalSetList;
+    for (const Array<size_t>& equalSet: testCase.equalSets)
+    {
+        for (size_t node: equalSet)
+            equalSetMap[node] = equalSetList.size();
+        equalSetList.push_back(std::vector<size_t>(equalSet.begin(), equalSet.end()));
+    }
+    
+    Array<cxuint> gcMap;
+    cxuint colorsNum;
+    colorGraphByEngines(testName, interGraph, equalSetMap, equalSetList, initGcMap,
+                testCase.precolored.size(), gcMap, colorsNum);
+    assertValue(testName, "colorsNum", testCase.expectedColorsNum, colorsNum);
+    assertArray(testName, "gcMap", testCase.expectedColors, gcMap);
+}
+
+// node indices multiplied by scale (edges across bit matrix tiles if scale is big)
+static void testInterferenceGraph(size_t nodesNum, size_t scale)
+{
+    std::ostringstream oss;
+    oss << "testInterferenceGraph#" << nodesNum;
+    const std::string testName = oss.str();
+    InterGraph interGraph(nodesNum);
+    const size_t edges[][2] = { { 0, 1 }, { 5, 3 }, { 69, 0 }, { 64, 63 }, { 65, 1 },
+        { 3, 64 }, { 1, 0 }, { 40, 41 }, { 69, 68 } };
+    size_t addedNum = 0;
+    for (const size_t* edge: edges)
+        addedNum += interGraph.addEdge(edge[0]*scale, edge[1]*scale);
+    assertValue(testName, "added", size_t(8), addedNum);
+    assertTrue(testName, "noLoop", !interGraph.addEdge(7*scale, 7*scale));
+    assertTrue(testName, "hasEdge", interGraph.hasEdge(63*scale, 64*scale) &&
+            interGraph.hasEdge(0, 69*scale) && !interGraph.hasEdge(2*scale, 3*scale));
+    assertValue(testName, "degree1", size_t(2), interGraph.getDegree(scale));
+    interGraph.freeze();
+    assertTrue(testName, "frozen", interGraph.isFrozen());
+    assertTrue(testName, "hasEdgeFrozen", interGraph.hasEdge(64*scale, 3*scale) &&
+            interGraph.hasEdge(68*scale, 69*scale) &&
+            !interGraph.hasEdge(63*scale, 3*scale));
+    const size_t expNbs0[] = { 1*scale, 69*scale };
+    const size_t expNbs3[] = { 5*scale, 64*scale };
+    const size_t expNbs64[] = { 3*scale, 63*scale };
+    assertArray(testName, "nbs0", Array<size_t>(expNbs0, expNbs0+2),
+            Array<size_t>(interGraph[0].begin(), interGraph[0].end()));
+    assertArray(testName, "nbs3", Array<size_t>(expNbs3, expNbs3+2),
+            Array<size_t>(interGraph[3*scale].begin(), interGraph[3*scale].end()));
+    assertArray(testName, "nbs64", Array<size_t>(expNbs64, expNbs64+2),
+            Array<size_t>(interGraph[64*scale].begin(), interGraph[64*scale].end()));
+    assertValue(testName, "degree2", size_t(0), interGraph.getDegree(2*scale));
+}
+
+// compare engines on random graphs
+static void testColorGraphRandom(cxuint i, size_t nodesNum, size_t degree)
+{
+    std::ostringstream oss;
+    oss << "testColorGraphRandom#" << i;
+    const std::string testName = oss.str();
+    InterGraph interGraph(nodesNum);
+    uint32_t state = 0x1234567U + i;
+    auto nextRandom = [&state]()
+    {
+        state = state*1103515245U + 12345U;
+        return state>>8;
+    };
+    for (size_t node = 0; node < nodesNum; node++)
+        for (size_t k = 0; k < degree/2; k++)
+        {
+            // neighbors near node (like live ranges)
+            const size_t nb = (node + 1 + nextRandom() % (degree*2)) % nodesNum;
+            interGraph.addEdge(node, nb);
+        }
+    interGraph.freeze();
+    Array<cxuint> initGcMap(nodesNum);
+    std::fill(initGcMap.begin(), initGcMap.end(), cxuint(UINT_MAX));
+    const cxuint initColorsNum = std::min(nodesNum, size_t(4));
+    for (cxuint k = 0; k < initColorsNum; k++)
+        initGcMap[k*(nodesNum/initColorsNum)] = k;
+    std::unordered_map<size_t, size_t> equalSetMap;
+    std::vector<std::vector<size_t> > equalSetList;
+    for (size_t node = 0; node+3*degree < nodesNum; node += 7*degree)
+    {
+        const size_t node2 = node+3*degree;
+        if (interGraph.hasEdge(node, node2) ||
+            initGcMap[node] != UINT_MAX || initGcMap[node2] != UINT_MAX)
+            continue;
+        equalSetMap[node] = equalSetMap[node2] = equalSetList.size();
+        equalSetList.push_back({ node, node2 });
+    }
+    Array<cxuint> gcMap;
+    cxuint colorsNum;
+    colorGraphByEngines(testName, interGraph, equalSetMap, equalSetList, initGcMap,
+                initColorsNum, gcMap, colorsNum);
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -1059,5 +1232,26 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    retVal |= callTest(testInterferenceGraph, 70, 1);
+    // many tiles of bit matrix
+    retVal |= callTest(testInterferenceGraph, 70*300, 300);
+    for (size_t i = 0; i < sizeof(colorGraphTestCasesTbl)/sizeof(AsmColorGraphCase); i++)
+        try
+        { testColorGraph(i, colorGraphTestCasesTbl[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    const size_t randomGraphSizes[][2] = { { 10, 2 }, { 100, 6 }, { 1000, 12 },
+        { 5000, 30 }, { 10000, 20 } };
+    for (cxuint i = 0; i < sizeof(randomGraphSizes)/sizeof(randomGraphSizes[0]); i++)
+        try
+        { testColorGraphRandom(i, randomGraphSizes[i][0], randomGraphSizes[i][1]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
     return retVal;
 }
@@ -0,0 +1,87 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+struct TestArenaObject: FastRefCountable, AsmArenaObject
+{
+    size_t value;
+    explicit TestArenaObject(size_t v) : value(v)
+    { }
+};
+
+static void testAsmSharedArena()
+{
+    const std::string testName = "AsmSharedArena";
+    AsmSharedArena* arena = new AsmSharedArena(1024);
+    {
+        RefPtr<TestArenaObject> obj1(new(arena) TestArenaObject(11));
+        RefPtr<TestArenaObject> obj2(new TestArenaObject(12));
+        assertTrue(testName, "arena1", AsmArenaObject::getArena(obj1.get()) == arena);
+        assertTrue(testName, "arena2", AsmArenaObject::getArena(obj2.get()) == nullptr);
+        std::vector<size_t, AsmArenaAllocator<size_t> > vec{
+                    AsmArenaAllocator<size_t>(arena) };
+        for (size_t i = 0; i < 100; i++)
+            vec.push_back(i);
+        // release owner reference, objects and vector hold arena
+        assertTrue(testName, "notDeleted", !arena->unreference());
+        RefPtr<TestArenaObject> obj3(new(arena) TestArenaObject(13));
+        const void* obj1Ptr = obj1.get();
+        obj1.reset();
+        // released object memory is reused
+        RefPtr<TestArenaObject> obj4(new(arena) TestArenaObject(14));
+        assertTrue(testName, "reused", obj4.get() == obj1Ptr);
+        assertValue(testName, "vec", size_t(99), vec.back());
+        assertValue(testName, "obj2", size_t(12), obj2->value);
+        assertValue(testName, "obj3", size_t(13), obj3->value);
+        assertValue(testName, "obj4", size_t(14), obj4->value);
+        // move assignment moves allocator
+        std::vector<size_t, AsmArenaAllocator<size_t> > vec2;
+        vec2 = std::move(vec);
+        assertTrue(testName, "allocMoved", vec2.get_allocator() ==
+                    AsmArenaAllocator<size_t>(arena));
+        // copy assignment copies allocator
+        std::vector<size_t, AsmArenaAllocator<size_t> > vec3;
+        vec3 = vec2;
+        assertTrue(testName, "allocCopied", vec3.get_allocator() ==
+                    AsmArenaAllocator<size_t>(arena));
+        assertValue(testName, "vec3", size_t(99), vec3.back());
+        // move constructor takes reference from allocator
+        AsmArenaAllocator<size_t> alloc1(arena);
+        AsmArenaAllocator<size_t> alloc2(std::move(alloc1));
+        assertTrue(testName, "allocMoveCtor", alloc2 == AsmArenaAllocator<size_t>(arena) &&
+                    alloc1 == AsmArenaAllocator<size_t>());
+    }
+    // arena deleted with last object (checked by memory checkers)
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testAsmSharedArena);
+    return retVal;
+}
@@ -0,0 +1,145 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* benchmark of the AMD binary generators (main binary with nested inner binaries)
+ * usage: BinGenBench [KERNELSNUM [REPEATS [FILENAME]]] */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmFormats.h>
+#include <CLRX/amdbin/AmdBinGen.h>
+#include <CLRX/amdbin/AmdCL2BinGen.h>
+
+using namespace CLRX;
+
+// generate source with many kernels with configuration
+static std::string generateSource(bool cl2, size_t kernelsNum)
+{
+    std::ostringstream oss;
+    if (cl2)
+        oss << ".amdcl2\n.gpu Bonaire\n.64bit\n.driver_version 191205\n";
+    else
+        oss << ".amd\n.gpu Pitcairn\n.32bit\n.driver_version 200406\n";
+    for (size_t i = 0; i < kernelsNum; i++)
+        oss << ".kernel kernel" << i << "\n"
+            "    .config\n"
+            "        .dims xy\n"
+            "        .arg n, uint\n"
+            "        .arg out, uint*, global\n"
+            "    .text\n"
+            "        s_mov_b32 s" << (i&31) << ", " << i << "\n"
+            "        v_mov_b32 v1, s" << (i&31) << "\n"
+            "        s_endpgm\n";
+    return oss.str();
+}
+
+// generate binary to memory (array)
+template<typename BinGen, typename Input>
+static double benchmarkGenerator(const Input* input, cxuint repeats, size_t& binarySize)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (cxuint r = 0; r < repeats; r++)
+    {
+        Array<cxbyte> binary;
+        BinGen binGen(input);
+        binGen.generate(binary);
+        binarySize = binary.size();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end-start).count() / repeats;
+}
+
+// generate binary to file (through output stream)
+template<typename BinGen, typename Input>
+static double benchmarkGeneratorToFile(const Input* input, cxuint repeats,
+            const char* filename)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (cxuint r = 0; r < repeats; r++)
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        if (!ofs)
+            throw Exception("Can't create output file");
+        BinGen binGen(input);
+        binGen.generate(ofs);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end-start).count() / repeats;
+}
+
+template<typename Handler, typename BinGen>
+static bool runBenchmark(const char* name, bool cl2, size_t kernelsNum, cxuint repeats,
+            const char* filename)
+{
+    std::istringstream iss(generateSource(cl2, kernelsNum));
+    Assembler assembler("", iss, 0, cl2 ? BinaryFormat::AMDCL2 : BinaryFormat::AMD,
+                cl2 ? GPUDeviceType::BONAIRE : GPUDeviceType::PITCAIRN);
+    if (!assembler.assemble())
+    {
+        std::cerr << name << ": can't assemble source" << std::endl;
+        return false;
+    }
+    const Handler* handler = static_cast<const Handler*>(assembler.getFormatHandler());
+    size_t binarySize = 0;
+    const double time = benchmarkGenerator<BinGen>(handler->getOutput(), repeats,
+                binarySize);
+    const double fileTime = benchmarkGeneratorToFile<BinGen>(handler->getOutput(),
+                repeats, filename);
+    std::cout << name << ": kernels: " << kernelsNum << ", size: " << binarySize <<
+            ", memory: " << time << " s, file: " << fileTime << " s" << std::endl;
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    const size_t kernelsNum = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 2000;
+    const cxuint repeats = (argc >= 3) ? strtoul(argv[2], nullptr, 10) : 20;
+    const char* filename = (argc >= 4) ? argv[3] : "BinGenBench.tmp.bin";
+    if (kernelsNum == 0 || repeats == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    try
+    {
+        if (!runBenchmark<AsmAmdHandler, AmdGPUBinGenerator>("AMD OpenCL 1.2",
+                    false, kernelsNum, repeats, filename))
+            return 1;
+        if (!runBenchmark<AsmAmdCL2Handler, AmdCL2GPUBinGenerator>("AMD OpenCL 2.0",
+                    true, kernelsNum, repeats, filename))
+            return 1;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        ::remove(filename);
+        return 1;
+    }
+    ::remove(filename);
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* benchmark of the interference graph coloring engines
+ * usage: ColorGraphBench [NODESNUM [DEGREE [REPEATS]]] */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/utils/Containers.h>
+#if defined(HAVE_LINUX) || defined(HAVE_BSD)
+#include <sys/resource.h>
+#endif
+
+using namespace CLRX;
+
+typedef AsmRegAllocator::InterGraph InterGraph;
+typedef AsmRegAllocator::ColoringEngine ColoringEngine;
+
+// synthetic graph: nodes interfere with nodes near them (like live ranges)
+static void generateGraph(size_t nodesNum, size_t degree, InterGraph& interGraph,
+            std::unordered_map<size_t, size_t>& equalSetMap,
+            std::vector<std::vector<size_t> >& equalSetList)
+{
+    interGraph.resize(nodesNum);
+    uint32_t state = 0x1234567U;
+    for (size_t node = 0; node < nodesNum; node++)
+        for (size_t k = 0; k < degree/2; k++)
+        {
+            state = state*1103515245U + 12345U;
+            const size_t nb = (node + 1 + (state>>8) % (degree*2)) % nodesNum;
+            interGraph.addEdge(node, nb);
+        }
+    interGraph.freeze();
+    for (size_t node = 0; node+3*degree < nodesNum; node += 7*degree)
+    {
+        const size_t node2 = node+3*degree;
+        if (interGraph.hasEdge(node, node2))
+            continue;
+        equalSetMap[node] = equalSetMap[node2] = equalSetList.size();
+        equalSetList.push_back({ node, node2 });
+    }
+}
+
+// peak resident memory of this process in kilobytes (0 if unknown)
+static size_t getPeakRSS()
+{
+#if defined(HAVE_LINUX) || defined(HAVE_BSD)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return usage.ru_maxrss;
+#endif
+    return 0;
+}
+
+static double benchmarkEngine(ColoringEngine engine, const InterGraph& interGraph,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            cxuint repeats, Array<cxuint>& gcMap, cxuint& colorsNum)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (cxuint r = 0; r < repeats; r++)
+    {
+        gcMap.resize(interGraph.size());
+        std::fill(gcMap.begin(), gcMap.end(), cxuint(UINT_MAX));
+        colorsNum = AsmRegAllocator::colorGraph(engine, interGraph, equalSetMap,
+                    equalSetList, 1U<<16, 0, gcMap);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end-start).count() / repeats;
+}
+
+int main(int argc, const char** argv)
+{
+    const size_t nodesNum = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 20000;
+    const size_t degree = (argc >= 3) ? strtoull(argv[2], nullptr, 10) : 40;
+    const cxuint repeats = (argc >= 4) ? strtoul(argv[3], nullptr, 10) : 3;
+    if (nodesNum == 0 || degree == 0 || repeats == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    InterGraph interGraph;
+    std::unordered_map<size_t, size_t> equalSetMap;
+    std::vector<std::vector<size_t> > equalSetList;
+    const auto buildStart = std::chrono::steady_clock::now();
+    generateGraph(nodesNum, degree, interGraph, equalSetMap, equalSetList);
+    const double buildTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now()-buildStart).count();
+    const size_t buildPeakRSS = getPeakRSS();
+
+    Array<cxuint> setGcMap, bucketGcMap;
+    cxuint setColorsNum = 0, bucketColorsNum = 0;
+    const double setTime = benchmarkEngine(ColoringEngine::SET, interGraph,
+                equalSetMap, equalSetList, repeats, setGcMap, setColorsNum);
+    const double bucketTime = benchmarkEngine(ColoringEngine::BUCKET, interGraph,
+                equalSetMap, equalSetList, repeats, bucketGcMap, bucketColorsNum);
+
+    std::cout << "Nodes: " << nodesNum << ", degree: " << degree <<
+            ", repeats: " << repeats << "\n"
+            "Graph building: " << buildTime << " s, peak RSS: " << buildPeakRSS <<
+            " kB\n"
+            "SET engine: " << setTime << " s, colors: " << setColorsNum << "\n"
+            "BUCKET engine: " << bucketTime << " s, colors: " << bucketColorsNum << "\n"
+            "Speedup: " << (setTime / bucketTime) << std::endl;
+    if (setColorsNum != bucketColorsNum || !std::equal(setGcMap.begin(), setGcMap.end(),
+                bucketGcMap.begin()))
+    {
+        std::cerr << "Engines give different colorings!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/* benchmark of the collecting and sorting labels before disassembling
+ * usage: DisasmLabelsBench [SIZEINMB [REPEATS]] */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/MemAccess.h>
+#include <CLRX/amdasm/Disassembler.h>
+
+using namespace CLRX;
+
+// generate code with branches in every branchStep words
+static void generateCode(size_t wordsNum, size_t branchStep, std::vector<uint32_t>& code)
+{
+    code.assign(wordsNum, LEV(0x7e000301U)); // v_mov_b32 v0, v1
+    uint32_t state = 0x1234567U;
+    for (size_t pos = 0; pos < wordsNum; pos += branchStep)
+    {
+        state = state*1103515245U + 12345U;
+        int16_t offset = int16_t(state>>16);
+        if (ptrdiff_t(pos)+offset+1 < 0)
+            offset &= 0x7fff;
+        // s_branch or s_cbranch_scc0
+        code[pos] = LEV(((state&0x100) ? 0xbf820000U : 0xbf840000U) | uint16_t(offset));
+    }
+}
+
+template<typename F>
+static double measure(cxuint repeats, F&& func)
+{
+    double best = 1e100;
+    for (cxuint r = 0; r < repeats; r++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end-start).count());
+    }
+    return best;
+}
+
+int main(int argc, const char** argv)
+{
+    const size_t sizeInMB = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 16;
+    const cxuint repeats = (argc >= 3) ? strtoul(argv[2], nullptr, 10) : 3;
+    if (sizeInMB == 0 || repeats == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    std::vector<uint32_t> code;
+    // branch-dense and sparse code
+    for (size_t branchStep: { size_t(4), size_t(1024) })
+    {
+        generateCode(sizeInMB<<18, branchStep, code);
+        std::ostringstream disOss;
+        AmdDisasmInput input;
+        input.deviceType = GPUDeviceType::PITCAIRN;
+        input.is64BitMode = false;
+        Disassembler disasm(&input, disOss, 0);
+        GCNDisassembler gcnDisasm(disasm);
+        gcnDisasm.setInput(code.size()<<2, reinterpret_cast<const cxbyte*>(code.data()));
+        
+        // only collecting labels
+        const double analyzeTime = measure(repeats, [&]()
+        {
+            gcnDisasm.clearNumberedLabels();
+            gcnDisasm.analyzeBeforeDisassemble();
+        });
+        // reference: std::sort and std::unique
+        const std::vector<size_t> unsortedLabels = gcnDisasm.getLabels();
+        std::vector<size_t> refLabels;
+        const double refTime = measure(repeats, [&]()
+        {
+            refLabels = unsortedLabels;
+            std::sort(refLabels.begin(), refLabels.end());
+            refLabels.resize(std::unique(refLabels.begin(), refLabels.end()) -
+                        refLabels.begin());
+        });
+        // collecting and preparing labels
+        const double prepareTime = measure(repeats, [&]()
+        {
+            gcnDisasm.clearNumberedLabels();
+            gcnDisasm.analyzeBeforeDisassemble();
+            gcnDisasm.prepareLabelsAndRelocations();
+        }) - analyzeTime;
+        
+        std::cout << "Branch every " << branchStep << " words: labels: " <<
+                refLabels.size() << "\n  collecting: " << analyzeTime << " s\n"
+                "  sort+unique: " << refTime << " s\n"
+                "  prepareLabelsAndRelocations: " << prepareTime << " s\n"
+                "  speedup: " << (refTime / prepareTime) << std::endl;
+        if (gcnDisasm.getLabels() != refLabels)
+        {
+            std::cerr << "Different labels!" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,215 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* streamTestFiles[] =
+{
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/samplekernels.clo",
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/samplekernels_64.clo",
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/amd1.clo",
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/amdcl2.clo"
+};
+
+static const Flags streamTestFlags[] =
+{
+    DISASM_DUMPCODE,
+    DISASM_ALL,
+    DISASM_ALL|DISASM_CONFIG,
+    DISASM_ALL|DISASM_CONFIG|DISASM_HSACONFIG
+};
+
+// disassemble binary (repeatCount times to check reparsing kernel data released
+// by streaming in lazy binary)
+template<typename BinType>
+static std::string disassembleBinaryInt(BinType& binary, Flags flags, cxuint repeatCount)
+{
+    std::ostringstream disasmOss;
+    for (cxuint i = 0; i < repeatCount; i++)
+    {
+        Disassembler disasm(binary, disasmOss, flags);
+        disasm.disassemble();
+    }
+    return disasmOss.str();
+}
+
+static std::string disassembleBinary(Array<cxbyte>& binaryData, Flags flags,
+            bool lazy = false, cxuint repeatCount = 1)
+{
+    Flags binFlags = AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+            AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+            AMDBIN_CREATE_KERNELHEADERMAP | AMDBIN_INNER_CREATE_CALNOTES |
+            AMDBIN_CREATE_INFOSTRINGS;
+    if (lazy)
+        binFlags |= AMDBIN_CREATE_LAZY;
+    if (isAmdBinary(binaryData.size(), binaryData.data()))
+    {
+        std::unique_ptr<AmdMainBinaryBase> base(createAmdBinaryFromCode(
+                binaryData.size(), binaryData.data(), binFlags));
+        if (base->getType() == AmdMainType::GPU_64_BINARY)
+            return disassembleBinaryInt(*static_cast<AmdMainGPUBinary64*>(base.get()),
+                        flags, repeatCount);
+        else
+            return disassembleBinaryInt(*static_cast<AmdMainGPUBinary32*>(base.get()),
+                        flags, repeatCount);
+    }
+    else
+    {
+        AmdCL2MainGPUBinary64 amdBin(binaryData.size(), binaryData.data(),
+                binFlags | AMDCL2BIN_INNER_CREATE_KERNELDATA |
+                AMDCL2BIN_INNER_CREATE_KERNELDATAMAP | AMDCL2BIN_INNER_CREATE_KERNELSTUBS);
+        return disassembleBinaryInt(amdBin, flags, repeatCount);
+    }
+}
+
+// streaming disassembling must give same output as normal disassembling
+static void testDisasmStreaming(cxuint testId, const char* filename)
+{
+    Array<cxbyte> binaryData = loadDataFromFile(filename);
+    for (Flags flags: streamTestFlags)
+    {
+        std::ostringstream oss;
+        oss << "StreamTest #" << testId << ", flags=" << flags;
+        const std::string expected = disassembleBinary(binaryData, flags);
+        assertTrue(oss.str(), "output is not empty", !expected.empty());
+        const std::string result = disassembleBinary(binaryData, flags|DISASM_STREAMING);
+        assertString(oss.str(), "output", expected.c_str(), result);
+        // lazy binary: kernel data released after kernel must be parsed again
+        const std::string lazyResult = disassembleBinary(binaryData,
+                    flags|DISASM_STREAMING, true, 2);
+        assertString(oss.str(), "lazyOutput", (expected+expected).c_str(), lazyResult);
+    }
+}
+
+// released kernel informations and inner binaries of lazy binary must be
+// parsed again at next access
+static void testLazyRelease(cxuint testId, const char* filename)
+{
+    std::ostringstream oss;
+    oss << "LazyReleaseTest #" << testId;
+    const std::string testName = oss.str();
+    Array<cxbyte> binaryData = loadDataFromFile(filename);
+    if (!isAmdBinary(binaryData.size(), binaryData.data()))
+        return;
+    const Flags binFlags = AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_INNERBINMAP |
+            AMDBIN_CREATE_KERNELHEADERS;
+    std::unique_ptr<AmdMainBinaryBase> base(createAmdBinaryFromCode(
+                binaryData.size(), binaryData.data(), binFlags));
+    std::unique_ptr<AmdMainBinaryBase> lazyBase(createAmdBinaryFromCode(
+                binaryData.size(), binaryData.data(), binFlags|AMDBIN_CREATE_LAZY));
+    AmdMainGPUBinaryBase& binary = *static_cast<AmdMainGPUBinaryBase*>(base.get());
+    AmdMainGPUBinaryBase& lazyBinary = *static_cast<AmdMainGPUBinaryBase*>(
+                lazyBase.get());
+    assertValue(testName, "kernelInfosNum", binary.getKernelInfosNum(),
+                lazyBinary.getKernelInfosNum());
+    for (size_t i = 0; i < binary.getKernelInfosNum(); i++)
+    {
+        const KernelInfo& kernelInfo = binary.getKernelInfo(i);
+        for (cxuint k = 0; k < 2; k++)
+        {
+            const KernelInfo& lazyInfo = lazyBinary.getKernelInfo(i);
+            assertString(testName, "kernelName", kernelInfo.kernelName.c_str(),
+                        lazyInfo.kernelName);
+            assertValue(testName, "argsNum", kernelInfo.argInfos.size(),
+                        lazyInfo.argInfos.size());
+            for (size_t j = 0; j < kernelInfo.argInfos.size(); j++)
+                assertString(testName, "argName",
+                        kernelInfo.argInfos[j].argName.c_str(),
+                        lazyInfo.argInfos[j].argName);
+            lazyBinary.releaseKernelInfo(i);
+        }
+    }
+    for (size_t i = 0; i < binary.getInnerBinariesNum(); i++)
+        for (cxuint k = 0; k < 2; k++)
+        {
+            assertString(testName, "innerKernelName",
+                    binary.getInnerBinary(i).getKernelName().c_str(),
+                    lazyBinary.getInnerBinary(i).getKernelName());
+            assertValue(testName, "innerCALEncodingsNum",
+                    binary.getInnerBinary(i).getCALEncodingEntriesNum(),
+                    lazyBinary.getInnerBinary(i).getCALEncodingEntriesNum());
+            lazyBinary.releaseInnerBinary(i);
+        }
+}
+
+// streaming disassembling can not release kernel data of const binary
+static void testConstBinaryStreaming(cxuint testId, const char* filename)
+{
+    std::ostringstream oss;
+    oss << "ConstBinaryStreamingTest #" << testId;
+    Array<cxbyte> binaryData = loadDataFromFile(filename);
+    std::ostringstream disasmOss;
+    if (isAmdBinary(binaryData.size(), binaryData.data()))
+    {
+        std::unique_ptr<AmdMainBinaryBase> base(createAmdBinaryFromCode(
+                binaryData.size(), binaryData.data(), AMDBIN_CREATE_KERNELINFO |
+                AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_LAZY));
+        if (base->getType() == AmdMainType::GPU_64_BINARY)
+        {
+            const AmdMainGPUBinary64& binary =
+                    *static_cast<const AmdMainGPUBinary64*>(base.get());
+            assertCLRXException(oss.str(), "exception",
+                    "Streaming disassembling requires non-const binary",
+                    [&binary, &disasmOss]()
+                    { Disassembler(binary, disasmOss, DISASM_STREAMING); });
+        }
+        else
+        {
+            const AmdMainGPUBinary32& binary =
+                    *static_cast<const AmdMainGPUBinary32*>(base.get());
+            assertCLRXException(oss.str(), "exception",
+                    "Streaming disassembling requires non-const binary",
+                    [&binary, &disasmOss]()
+                    { Disassembler(binary, disasmOss, DISASM_STREAMING); });
+        }
+    }
+    else
+    {
+        const AmdCL2MainGPUBinary64 binary(binaryData.size(), binaryData.data(),
+                AMDBIN_CREATE_KERNELINFO);
+        assertCLRXException(oss.str(), "exception",
+                "Streaming disassembling requires non-const binary",
+                [&binary, &disasmOss]()
+                { Disassembler(binary, disasmOss, DISASM_STREAMING); });
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (cxuint i = 0; i < sizeof(streamTestFiles)/sizeof(const char*); i++)
+        retVal |= callTest(testDisasmStreaming, i, streamTestFiles[i]);
+    for (cxuint i = 0; i < sizeof(streamTestFiles)/sizeof(const char*); i++)
+        retVal |= callTest(testLazyRelease, i, streamTestFiles[i]);
+    for (cxuint i = 0; i < sizeof(streamTestFiles)/sizeof(const char*); i++)
+        retVal |= callTest(testConstBinaryStreaming, i, streamTestFiles[i]);
+    return retVal;
+}
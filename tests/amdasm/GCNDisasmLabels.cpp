@@ -21,6 +21,7 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <vector>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/amdasm/Disassembler.h>
@@ -220,11 +221,11 @@ static const GCNDisasmLabelCase decGCN12LabelCases[] =
       ".L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0x4934d715U, 0x3d4cU, 0xbf82fffdU },  /* VOP2 : V_VMADAK_F16 */
       "        s_branch        .L12_0\n.L4_0:\n        v_madmk_f16     "
-      "v154, v21, 0x3d4c /* 1.3242h */, v107\n"
+      "v154, v21, 0x3d4c /* 1.324h */, v107\n"
       ".L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0x4b34d715U, 0x3d4cU, 0xbf82fffdU },  /* VOP2 : V_VMADAK_F16 */
       "        s_branch        .L12_0\n.L4_0:\n        v_madak_f16     "
-      "v154, v21, v107, 0x3d4c /* 1.3242h */\n"
+      "v154, v21, v107, 0x3d4c /* 1.324h */\n"
       ".L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820001U, 0x7f3c0d4fU, 0xbf82fffeU },  /* VOP1 */
       "        s_branch        .L8_0\n.L4_0:\n        v_cvt_f32_u32   v158, v79\n"
@@ -237,7 +238,7 @@ static const GCNDisasmLabelCase decGCN12LabelCases[] =
       ".L8_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0x7c4192ffU, 0x3d4cU, 0xbf82fffdU },  /* VOPC with literal */
       "        s_branch        .L12_0\n.L4_0:\n        v_cmp_f_f16     "
-      "vcc, 0x3d4c /* 1.3242h */, v201\n.L12_0:\n        s_branch        .L4_0\n" },
+      "vcc, 0x3d4c /* 1.324h */, v201\n.L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0xd1d10037U, 0x07974d4fU, 0xbf82fffdU },  /* VOP3 */
       "        s_branch        .L12_0\n.L4_0:\n        v_min3_i32      v55, v79, v166, v229\n"
       ".L12_0:\n        s_branch        .L4_0\n" },
@@ -334,7 +335,7 @@ static void testDecGCNNamedLabels()
         "testLabel1=.-1\n"
         ".L4_0:\n"
         "nextInstr:\n"
-        "        v_sub_f32       v154, 0x11110000 /* 1.14384831e-28f */, v107\n"
+        "        v_sub_f32       v154, 0x11110000 /* 1.1438483e-28f */, v107\n"
         "        s_lshr_b32      s21, s2, s61\n"
         "        s_branch        nextInstr\n")
         throw Exception("FAILED namedLabelsTest: result: "+disOss.str());
@@ -468,6 +469,42 @@ static void testDecGCNRelocations()
         throw Exception("FAILED relocationTest: result: "+disOss.str());
 }
 
+// testing label sorting for many labels (bitmap and radix sort paths)
+static void testDecGCNManyLabels(cxuint id, size_t wordsNum, size_t branchStep,
+            size_t startOffset, bool beforeCode = false)
+{
+    std::vector<uint32_t> code(wordsNum, LEV(0xbf800000U)); // s_nop
+    std::vector<size_t> expected;
+    uint32_t state = 0x4321U + id;
+    for (size_t pos = 0; pos < wordsNum; pos += branchStep)
+    {
+        state = state*1103515245U + 12345U;
+        int16_t offset = int16_t(state>>16);
+        if (!beforeCode && ptrdiff_t(pos)+offset+1 < 0)
+            offset &= 0x7fff; // do not jump before code
+        code[pos] = LEV(0xbf820000U | uint16_t(offset)); // s_branch
+        expected.push_back(startOffset + ((pos+offset+1)<<2));
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.resize(std::unique(expected.begin(), expected.end()) - expected.begin());
+    
+    std::ostringstream disOss;
+    AmdDisasmInput input;
+    input.deviceType = GPUDeviceType::PITCAIRN;
+    input.is64BitMode = false;
+    Disassembler disasm(&input, disOss, 0);
+    GCNDisassembler gcnDisasm(disasm);
+    gcnDisasm.setInput(wordsNum<<2, reinterpret_cast<const cxbyte*>(code.data()),
+                startOffset);
+    gcnDisasm.beforeDisassemble();
+    if (gcnDisasm.getLabels() != expected)
+    {
+        std::ostringstream oss;
+        oss << "FAILED manyLabelsTest#" << id;
+        throw Exception(oss.str());
+    }
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -500,6 +537,11 @@ int main(int argc, const char** argv)
     {
         testDecGCNNamedLabels();
         testDecGCNRelocations();
+        testDecGCNManyLabels(0, 100000, 3, 0);
+        testDecGCNManyLabels(1, 100000, 3, 2); // unaligned labels
+        testDecGCNManyLabels(2, 2000000, 1000, 0); // sparse labels
+        testDecGCNManyLabels(3, 600, 2, 0); // few labels
+        testDecGCNManyLabels(4, 100000, 3, 0, true); // jumps before code
     }
     catch(const std::exception& ex)
     {
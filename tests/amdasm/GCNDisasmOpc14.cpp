@@ -241,10 +241,10 @@ const GCNDisasmOpcodeCase decGCNOpcodeGCN14Cases[] =
     { 0xd1780037U, 0x0000011bU, true, "        VOP3A_ill_376   v55, v27, s0, s0\n" },
     { 0x7f3c9b4fU, 0, false, "        v_cvt_norm_i16_f16 v158, v79\n" },
     { 0x7f3c9affU, 0x3d4c, true, "        v_cvt_norm_i16_f16 "
-            "v158, 0x3d4c /* 1.3242h */\n" },
+            "v158, 0x3d4c /* 1.324h */\n" },
     { 0x7f3c9d4fU, 0, false, "        v_cvt_norm_u16_f16 v158, v79\n" },
     { 0x7f3c9cffU, 0x3d4c, true, "        v_cvt_norm_u16_f16 "
-            "v158, 0x3d4c /* 1.3242h */\n" },
+            "v158, 0x3d4c /* 1.324h */\n" },
     { 0x7f3c9f4fU, 0, false, "        v_sat_pk_u8_i16 v158, v79\n" },
     { 0x7f3c9effU, 0x3d4c, true, "        v_sat_pk_u8_i16 v158, 0x3d4c\n" },
     { 0x7f3ca14fU, 0, false, "        v_writelane_regwr_b32 v158, v79\n" },
@@ -641,6 +641,9 @@ const GCNDisasmOpcodeCase decGCNOpcodeGCN14Cases[] =
         "v47, v187, s[49:50] inst_offset:1043 glc slc\n" },
     { 0xdc439413U, 0x2f3100bbU, true, "        global_load_ubyte "
         "v47, v187, s[49:50] inst_offset:-3053 glc slc\n" },
+    /* FLAT with reserved segment (3) - illegal */
+    { 0xdc53c000U, 0x2f3100bbU, true,
+        "        FLAT_ill_20     v47, v[187:188], v0 glc slc\n" },
     /* FLAT GLOBAL instructions */
     { 0xdc478000U, 0x2f3100bbU, true,
         "        global_load_sbyte v47, v187, s[49:50] glc slc\n" },
@@ -0,0 +1,152 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include <CLRX/utils/MemAccess.h>
+
+using namespace CLRX;
+
+static const char* relSymNames[] = { "sym0", "sym1", "sym2" };
+
+// generate pseudo-random code with branches, literals and zero fills
+static void generateCode(size_t wordsNum, uint32_t seed, std::vector<uint32_t>& code)
+{
+    code.resize(wordsNum);
+    uint32_t state = seed;
+    for (size_t i = 0; i < wordsNum; i++)
+    {
+        state = state*1103515245U + 12345U;
+        const uint32_t value = state ^ (state>>15);
+        switch ((value>>24) & 15)
+        {
+            case 0:
+                // s_branch with short offset
+                code[i] = LEV(0xbf820000U | ((value>>4)&0xff));
+                break;
+            case 1:
+                // s_cbranch_scc0 with backward offset
+                code[i] = LEV(0xbf84ff00U | ((value>>4)&0xff));
+                break;
+            case 2:
+                // v_sub_f32 with literal
+                code[i] = LEV(0x0934d6ffU);
+                if (i+1 < wordsNum)
+                    code[++i] = LEV(value);
+                break;
+            case 3:
+            {
+                // zero fill
+                const size_t count = std::min(size_t(value&15) + 1, wordsNum-i);
+                for (size_t k = 0; k < count; k++)
+                    code[i+k] = 0;
+                i += count-1;
+                break;
+            }
+            default:
+                code[i] = LEV(value);
+                break;
+        }
+    }
+}
+
+static std::string disassembleCode(GPUDeviceType deviceType,
+            const std::vector<uint32_t>& code, cxuint threadsNum)
+{
+    std::ostringstream disOss;
+    AmdDisasmInput input;
+    input.deviceType = deviceType;
+    input.is64BitMode = false;
+    Disassembler disasm(&input, disOss, DISASM_FLOATLITS|DISASM_HEXCODE|DISASM_CODEPOS);
+    disasm.setThreadsNum(threadsNum);
+    GCNDisassembler gcnDisasm(disasm);
+    gcnDisasm.setInput(code.size()*4, reinterpret_cast<const cxbyte*>(code.data()));
+    // named labels and relocations spread over whole code
+    for (size_t i = 0; i < code.size(); i += 9973)
+    {
+        char buf[32];
+        snprintf(buf, 32, "named%zu", i);
+        gcnDisasm.addNamedLabel(i*4, buf);
+        snprintf(buf, 32, "unaligned%zu", i);
+        gcnDisasm.addNamedLabel(i*4+1, buf);
+    }
+    for (const char* symName: relSymNames)
+        gcnDisasm.addRelSymbol(symName);
+    for (size_t i = 1; i < code.size(); i++)
+        if (code[i-1] == LEV(0x0934d6ffU) && (i % 7) == 0)
+            gcnDisasm.addRelocation(i*4, RELTYPE_VALUE, i%3, i&0xff);
+    gcnDisasm.beforeDisassemble();
+    gcnDisasm.disassemble();
+    return disOss.str();
+}
+
+static int testParallelDisasm(GPUDeviceType deviceType, size_t wordsNum, uint32_t seed)
+{
+    std::vector<uint32_t> code;
+    generateCode(wordsNum, seed, code);
+    const std::string expected = disassembleCode(deviceType, code, 1);
+    const cxuint threadsNums[] = { 2, 3, 4, 8, 0 };
+    int result = 0;
+    for (cxuint threadsNum: threadsNums)
+    {
+        const std::string output = disassembleCode(deviceType, code, threadsNum);
+        if (output != expected)
+        {
+            size_t diffPos = 0;
+            while (diffPos < output.size() && diffPos < expected.size() &&
+                    output[diffPos] == expected[diffPos])
+                diffPos++;
+            std::cerr << "FAILED for " << getGPUDeviceTypeName(deviceType) <<
+                    ", words=" << wordsNum << ", threads=" << threadsNum <<
+                    ": output differs at " << diffPos << "\nExpected:\n" <<
+                    expected.substr(diffPos > 200 ? diffPos-200 : 0, 400) <<
+                    "\nResult:\n" <<
+                    output.substr(diffPos > 200 ? diffPos-200 : 0, 400) << std::endl;
+            result = 1;
+        }
+    }
+    return result;
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    const GPUDeviceType deviceTypes[] = { GPUDeviceType::PITCAIRN,
+        GPUDeviceType::BONAIRE, GPUDeviceType::TONGA, GPUDeviceType::GFX900 };
+    for (GPUDeviceType deviceType: deviceTypes)
+        try
+        {
+            retVal |= testParallelDisasm(deviceType, 100, 1234);
+            retVal |= testParallelDisasm(deviceType, 70001, 5678);
+            retVal |= testParallelDisasm(deviceType, 200000, 91011);
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    return retVal;
+}
@@ -0,0 +1,280 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include <CLRX/utils/MemAccess.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const uint32_t recordsCode[] =
+{
+    LEV(0x90153d04U),   // s_lshr_b32 s21, s4, s61
+    LEV(0x0934d6ffU), LEV(0x11110000U), // v_sub_f32 v154, 0x11110000, v107
+    LEV(0xbf82fffcU),   // s_branch to start
+    0, 0, 0,
+    LEV(0x7e000301U)    // v_mov_b32 v0, v1
+};
+
+static void testGCNDisasmRecords()
+{
+    std::ostringstream disOss;
+    AmdDisasmInput input;
+    input.deviceType = GPUDeviceType::PITCAIRN;
+    input.is64BitMode = false;
+    Disassembler disasm(&input, disOss, 0);
+    GCNDisassembler gcnDisasm(disasm);
+    gcnDisasm.setInput(sizeof(recordsCode),
+                reinterpret_cast<const cxbyte*>(recordsCode), 0x100);
+    std::vector<GCNDisasmInsnRecord> records;
+    gcnDisasm.decodeInstructions(records);
+    const char* testName = "GCNDisasmRecords";
+    assertValue(testName, "recordsNum", size_t(5), records.size());
+    
+    const GCNDisasmInsnRecord& r0 = records[0];
+    assertValue(testName, "r0.offset", size_t(0x100), r0.offset);
+    assertString(testName, "r0.mnemonic", "s_lshr_b32",
+                GCNDisassembler::getInstructionMnemonic(r0.instrIndex));
+    assertString(testName, "r0.encoding", "SOP2",
+                GCNDisassembler::getEncodingName(r0.encoding));
+    assertValue(testName, "r0.flags", cxuint(0), cxuint(r0.flags));
+    assertValue(testName, "r0.dst", cxuint(21), cxuint(r0.operands[0]));
+    assertValue(testName, "r0.src0", cxuint(4), cxuint(r0.operands[1]));
+    assertValue(testName, "r0.src1", cxuint(61), cxuint(r0.operands[2]));
+    assertValue(testName, "r0.src2", cxuint(GCNDISASM_NO_OPERAND),
+                cxuint(r0.operands[3]));
+    
+    const GCNDisasmInsnRecord& r1 = records[1];
+    assertValue(testName, "r1.offset", size_t(0x104), r1.offset);
+    assertString(testName, "r1.mnemonic", "v_sub_f32",
+                GCNDisassembler::getInstructionMnemonic(r1.instrIndex));
+    assertValue(testName, "r1.flags", cxuint(GCNDISASM_REC_LITERAL), cxuint(r1.flags));
+    assertValue(testName, "r1.wordsNum", 2U, r1.wordsNum);
+    assertValue(testName, "r1.literal", 0x11110000U, r1.insnCode2);
+    assertValue(testName, "r1.dst", cxuint(256+154), cxuint(r1.operands[0]));
+    assertValue(testName, "r1.src0", cxuint(255), cxuint(r1.operands[1]));
+    assertValue(testName, "r1.src1", cxuint(256+107), cxuint(r1.operands[2]));
+    
+    const GCNDisasmInsnRecord& r2 = records[2];
+    assertString(testName, "r2.mnemonic", "s_branch",
+                GCNDisassembler::getInstructionMnemonic(r2.instrIndex));
+    assertValue(testName, "r2.flags", cxuint(GCNDISASM_REC_TARGET), cxuint(r2.flags));
+    assertValue(testName, "r2.target", size_t(0x100), r2.target);
+    
+    const GCNDisasmInsnRecord& r3 = records[3];
+    assertValue(testName, "r3.flags", cxuint(GCNDISASM_REC_FILL), cxuint(r3.flags));
+    assertValue(testName, "r3.offset", size_t(0x110), r3.offset);
+    assertValue(testName, "r3.wordsNum", 3U, r3.wordsNum);
+    
+    const GCNDisasmInsnRecord& r4 = records[4];
+    assertString(testName, "r4.mnemonic", "v_mov_b32",
+                GCNDisassembler::getInstructionMnemonic(r4.instrIndex));
+    assertValue(testName, "r4.dst", cxuint(256), cxuint(r4.operands[0]));
+    assertValue(testName, "r4.src0", cxuint(257), cxuint(r4.operands[1]));
+}
+
+// VOP3B instructions have second (scalar) destination
+static void testGCNVOP3BRecords()
+{
+    static const uint32_t code[] =
+    {
+        LEV(0xd24a0201U), LEV(0x00020b04U), // v_add_i32 v1, s[2:3], v4, v5
+        LEV(0xd2da6a01U), LEV(0x04120702U), // v_div_scale_f32 v1, vcc, v2, v3, v4
+        LEV(0xd2d60001U), LEV(0x00020b04U)  // v_mul_lo_i32 v1, v4, v5 (VOP3A)
+    };
+    std::ostringstream disOss;
+    AmdDisasmInput input;
+    input.deviceType = GPUDeviceType::PITCAIRN;
+    input.is64BitMode = false;
+    Disassembler disasm(&input, disOss, 0);
+    GCNDisassembler gcnDisasm(disasm);
+    // sink is available through ISADisassembler interface
+    ISADisassembler& isaDisasm = gcnDisasm;
+    isaDisasm.setInput(sizeof(code), reinterpret_cast<const cxbyte*>(code));
+    std::vector<GCNDisasmInsnRecord> records;
+    isaDisasm.decodeInstructions(records);
+    const char* testName = "GCNVOP3BRecords";
+    assertValue(testName, "recordsNum", size_t(3), records.size());
+    
+    const GCNDisasmInsnRecord& r0 = records[0];
+    assertString(testName, "r0.mnemonic", "v_add_i32",
+                GCNDisassembler::getInstructionMnemonic(r0.instrIndex));
+    assertString(testName, "r0.encoding", "VOP3B",
+                GCNDisassembler::getEncodingName(r0.encoding));
+    assertValue(testName, "r0.dst", cxuint(256+1), cxuint(r0.operands[0]));
+    assertValue(testName, "r0.src0", cxuint(256+4), cxuint(r0.operands[1]));
+    assertValue(testName, "r0.src1", cxuint(256+5), cxuint(r0.operands[2]));
+    assertValue(testName, "r0.src2", cxuint(0), cxuint(r0.operands[3]));
+    assertValue(testName, "r0.sdst", cxuint(2), cxuint(r0.operands[4]));
+    
+    const GCNDisasmInsnRecord& r1 = records[1];
+    assertString(testName, "r1.mnemonic", "v_div_scale_f32",
+                GCNDisassembler::getInstructionMnemonic(r1.instrIndex));
+    assertString(testName, "r1.encoding", "VOP3B",
+                GCNDisassembler::getEncodingName(r1.encoding));
+    assertValue(testName, "r1.dst", cxuint(256+1), cxuint(r1.operands[0]));
+    assertValue(testName, "r1.src0", cxuint(256+2), cxuint(r1.operands[1]));
+    assertValue(testName, "r1.src1", cxuint(256+3), cxuint(r1.operands[2]));
+    assertValue(testName, "r1.src2", cxuint(256+4), cxuint(r1.operands[3]));
+    assertValue(testName, "r1.sdst", cxuint(106), cxuint(r1.operands[4]));
+    
+    const GCNDisasmInsnRecord& r2 = records[2];
+    assertString(testName, "r2.mnemonic", "v_mul_lo_i32",
+                GCNDisassembler::getInstructionMnemonic(r2.instrIndex));
+    assertString(testName, "r2.encoding", "VOP3A",
+                GCNDisassembler::getEncodingName(r2.encoding));
+    assertValue(testName, "r2.dst", cxuint(1), cxuint(r2.operands[0]));
+    assertValue(testName, "r2.sdst", cxuint(GCNDISASM_NO_OPERAND),
+                cxuint(r2.operands[4]));
+}
+
+struct GCNRecordFlagsCase
+{
+    GPUDeviceType deviceType;
+    uint32_t insnCode;
+    uint32_t insnCode2;
+    cxbyte flags;
+    const char* mnemonic;
+};
+
+// flags of second instruction word: literal, SDWA/DPP word or part of encoding
+static const GCNRecordFlagsCase recordFlagsCases[] =
+{
+    { GPUDeviceType::PITCAIRN, 0x4334d715U, 0x567d0700U, GCNDISASM_REC_LITERAL,
+        "v_madak_f32" },
+    { GPUDeviceType::PITCAIRN, 0xba8048c3U, 0x45d2aU, GCNDISASM_REC_LITERAL,
+        "s_setreg_imm32_b32" },
+    { GPUDeviceType::TONGA, 0x2f34d715U, 0x567d0700U, GCNDISASM_REC_LITERAL,
+        "v_madmk_f32" },
+    { GPUDeviceType::TONGA, 0xba0048c3U, 0x45d2aU, GCNDISASM_REC_LITERAL,
+        "s_setreg_imm32_b32" },
+    { GPUDeviceType::TONGA, 0x2d34d6ffU, 0x40000000U, GCNDISASM_REC_LITERAL,
+        "v_mac_f32" },
+    { GPUDeviceType::TONGA, 0x0134d6f9U, 0x06060600U, GCNDISASM_REC_SDWA_DPP,
+        "v_cndmask_b32" },
+    { GPUDeviceType::TONGA, 0x0134d6faU, 0x10fbeU, GCNDISASM_REC_SDWA_DPP,
+        "v_cndmask_b32" },
+    { GPUDeviceType::TONGA, 0x7e0000faU, 0xc872beU, GCNDISASM_REC_SDWA_DPP, "v_nop" },
+    { GPUDeviceType::TONGA, 0x7dbf92f9U, 0x3d003dU, GCNDISASM_REC_SDWA_DPP,
+        "v_cmpx_tru_u32" },
+    { GPUDeviceType::TONGA, 0xd1170037U, 0x0002b41bU, 0, "v_madmk_f32" }
+};
+
+static void testGCNRecordFlags(cxuint testId, const GCNRecordFlagsCase& testCase)
+{
+    const uint32_t code[2] = { LEV(testCase.insnCode), LEV(testCase.insnCode2) };
+    std::ostringstream disOss;
+    AmdDisasmInput input;
+    input.deviceType = testCase.deviceType;
+    input.is64BitMode = false;
+    Disassembler disasm(&input, disOss, 0);
+    GCNDisassembler gcnDisasm(disasm);
+    gcnDisasm.setInput(sizeof(code), reinterpret_cast<const cxbyte*>(code));
+    std::vector<GCNDisasmInsnRecord> records;
+    gcnDisasm.decodeInstructions(records);
+    
+    std::ostringstream testNameOss;
+    testNameOss << "GCNRecordFlags#" << testId;
+    const std::string testName = testNameOss.str();
+    assertValue(testName, "recordsNum", size_t(1), records.size());
+    assertString(testName, "mnemonic", testCase.mnemonic,
+                GCNDisassembler::getInstructionMnemonic(records[0].instrIndex));
+    assertValue(testName, "wordsNum", 2U, records[0].wordsNum);
+    assertValue(testName, "insnCode2", testCase.insnCode2, records[0].insnCode2);
+    assertValue(testName, "flags", cxuint(testCase.flags), cxuint(records[0].flags));
+}
+
+// records must describe same instructions as text output
+static void testRecordsWithText(GPUDeviceType deviceType, size_t wordsNum, uint32_t seed)
+{
+    std::vector<uint32_t> code(wordsNum);
+    uint32_t state = seed;
+    for (size_t i = 0; i < wordsNum; i++)
+    {
+        state = state*1103515245U + 12345U;
+        const uint32_t value = state ^ (state>>15);
+        code[i] = ((value>>24) & 15) == 0 ? 0 : LEV(value);
+    }
+    std::ostringstream disOss;
+    AmdDisasmInput input;
+    input.deviceType = deviceType;
+    input.is64BitMode = false;
+    Disassembler disasm(&input, disOss, 0);
+    GCNDisassembler gcnDisasm(disasm);
+    gcnDisasm.setInput(wordsNum<<2, reinterpret_cast<const cxbyte*>(code.data()));
+    gcnDisasm.beforeDisassemble();
+    gcnDisasm.disassemble();
+    std::vector<GCNDisasmInsnRecord> records;
+    gcnDisasm.decodeInstructions(records);
+    
+    std::ostringstream testNameOss;
+    testNameOss << "RecordsWithText(" << getGPUDeviceTypeName(deviceType) << ")";
+    const std::string testName = testNameOss.str();
+    std::istringstream textIss(disOss.str());
+    std::string line;
+    size_t recordIndex = 0;
+    while (std::getline(textIss, line))
+    {
+        if (line.compare(0, 2, ".L") == 0 || line.compare(0, 5, ".org ") == 0 ||
+            line.compare(0, 10, "        /*") == 0)
+            continue; // skip labels, orgs and warnings
+        std::ostringstream caseOss;
+        caseOss << "record#" << recordIndex;
+        assertTrue(testName, caseOss.str()+".exists", recordIndex < records.size());
+        const GCNDisasmInsnRecord& record = records[recordIndex++];
+        if ((record.flags & GCNDISASM_REC_FILL) != 0)
+            assertTrue(testName, caseOss.str()+".fill", line.compare(0, 6, ".fill ") == 0);
+        else if (record.encoding == 0)
+            assertTrue(testName, caseOss.str()+".int",
+                    line.compare(0, 13, "        .int ") == 0);
+        else if ((record.flags & GCNDISASM_REC_ILLEGAL) != 0)
+            assertTrue(testName, caseOss.str()+".illegal",
+                    line.find("_ill_") != std::string::npos);
+        else
+        {
+            const size_t mnemonicEnd = line.find(' ', 8);
+            assertString(testName, caseOss.str()+".mnemonic",
+                    GCNDisassembler::getInstructionMnemonic(record.instrIndex),
+                    line.substr(8, mnemonicEnd-8));
+        }
+    }
+    assertValue(testName, "recordsNum", recordIndex, records.size());
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testGCNDisasmRecords);
+    retVal |= callTest(testGCNVOP3BRecords);
+    for (cxuint i = 0; i < sizeof(recordFlagsCases)/sizeof(GCNRecordFlagsCase); i++)
+        retVal |= callTest(testGCNRecordFlags, i, recordFlagsCases[i]);
+    retVal |= callTest(testRecordsWithText, GPUDeviceType::PITCAIRN, 200000, 11U);
+    retVal |= callTest(testRecordsWithText, GPUDeviceType::HAWAII, 200000, 12U);
+    retVal |= callTest(testRecordsWithText, GPUDeviceType::TONGA, 200000, 13U);
+    retVal |= callTest(testRecordsWithText, GPUDeviceType::GFX900, 200000, 14U);
+    return retVal;
+}
@@ -0,0 +1,192 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* benchmark of the GCN instruction length decoding
+ * usage: GCNInsnSizeBench [SIZEINMB [REPEATS]] */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/MemAccess.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/Disassembler.h>
+
+using namespace CLRX;
+
+// reference decoder: if/else chain (returns 0 for illegal encoding)
+static cxuint refInsnWordsNum(uint32_t insnCode, bool isGCN11, bool isGCN12)
+{
+    static const bool size11Table[16] = { false, false, false, false, true, false,
+        true, true, true, false, true, false, true, false, true, false };
+    static const bool size12Table[16] = { true, true, false, false, true, false,
+        true, true, true, false, true, false, true, false, false, false };
+    static const bool illegal11Table[16] = { false, false, false, true, false, true,
+        false, false, false, true, false, true, false, true, false, true };
+    static const bool illegal12Table[16] = { false, false, true, true, false, false,
+        false, false, false, true, false, true, false, true, true, true };
+    if ((insnCode & 0x80000000U) != 0)
+    {
+        if ((insnCode & 0x40000000U) == 0)
+        {
+            if  ((insnCode & 0x30000000U) == 0x30000000U)
+            {
+                const uint32_t encPart = (insnCode & 0x0f800000U);
+                if (encPart == 0x0e800000U) // SOP1
+                    return 1 + ((insnCode&0xff) == 0xff);
+                else if (encPart == 0x0f000000U) // SOPC
+                    return 1 + ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00);
+                else if (encPart == 0x0f800000U) // SOPP
+                    return 1;
+                // SOPK
+                const cxuint opcode = (insnCode>>23)&0x1f;
+                return 1 + ((!isGCN12 && opcode == 21) || (isGCN12 && opcode == 20));
+            }
+            // SOP2
+            return 1 + ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00);
+        }
+        const uint32_t encPart = (insnCode&0x3c000000U)>>26;
+        if (isGCN12)
+            return illegal12Table[encPart] ? 0 : 1 + size12Table[encPart];
+        if (illegal11Table[encPart] || (encPart == 7 && !isGCN11))
+            return 0;
+        return 1 + size11Table[encPart];
+    }
+    const bool extWord = (insnCode&0x1ff) == 0xff ||
+        (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa));
+    if ((insnCode & 0x7c000000U) == 0x7c000000U) // VOPC or VOP1
+        return 1 + extWord;
+    const cxuint opcode = (insnCode >> 25)&0x3f;
+    if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
+        (isGCN12 && (opcode == 23 || opcode == 24 || opcode == 36 || opcode == 37)))
+        return 2;
+    return 1 + extWord;
+}
+
+// random but valid code: legal encodings, literals after instructions that need it
+static void generateCode(size_t wordsNum, bool isGCN11, bool isGCN12,
+            std::vector<uint32_t>& code)
+{
+    code.resize(wordsNum);
+    uint32_t state = 0x13579bdU;
+    for (size_t i = 0; i < wordsNum; )
+    {
+        state ^= state<<13;
+        state ^= state>>17;
+        state ^= state<<5;
+        const uint32_t insnCode = state;
+        const cxuint wordsNumOfInsn = refInsnWordsNum(insnCode, isGCN11, isGCN12);
+        if (insnCode == 0 || wordsNumOfInsn == 0 || i + wordsNumOfInsn > wordsNum)
+        {
+            if (i + 1 == wordsNum)
+                code[i++] = LEV(0xbf800000U); // s_nop
+            continue;
+        }
+        code[i++] = LEV(insnCode);
+        if (wordsNumOfInsn == 2)
+            code[i++] = LEV(state*1103515245U + 12345U);
+    }
+}
+
+template<typename F>
+static double measure(cxuint repeats, F&& func)
+{
+    double best = 1e100;
+    for (cxuint r = 0; r < repeats; r++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end-start).count());
+    }
+    return best;
+}
+
+int main(int argc, const char** argv)
+{
+    const size_t sizeInMB = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 64;
+    const cxuint repeats = (argc >= 3) ? strtoul(argv[2], nullptr, 10) : 3;
+    if (sizeInMB == 0 || repeats == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    const GPUDeviceType deviceTypes[] = { GPUDeviceType::PITCAIRN,
+        GPUDeviceType::BONAIRE, GPUDeviceType::TONGA, GPUDeviceType::GFX900 };
+    std::vector<uint32_t> code;
+    for (GPUDeviceType deviceType: deviceTypes)
+    {
+        const GPUArchitecture arch = getGPUArchitectureFromDeviceType(deviceType);
+        const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
+        const bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
+        generateCode(sizeInMB<<18, isGCN11, isGCN12, code);
+        const size_t codeSize = code.size()<<2;
+        const cxbyte* codeBytes = reinterpret_cast<const cxbyte*>(code.data());
+        
+        size_t refInsnsNum = 0;
+        const double refTime = measure(repeats, [&]()
+        {
+            refInsnsNum = 0;
+            for (size_t pos = 0; pos < code.size(); refInsnsNum++)
+                pos += refInsnWordsNum(ULEV(code[pos]), isGCN11, isGCN12);
+        });
+        
+        std::istringstream emptyInput("");
+        std::ostringstream msgStream;
+        Assembler assembler("", emptyInput, 0, BinaryFormat::RAWCODE, deviceType,
+                    msgStream);
+        GCNAssembler gcnAsm(assembler);
+        size_t asmInsnsNum = 0;
+        const double asmTime = measure(repeats, [&]()
+        {
+            asmInsnsNum = 0;
+            for (size_t pos = 0; pos < codeSize; asmInsnsNum++)
+                pos += gcnAsm.getInstructionSize(codeSize-pos, codeBytes+pos);
+        });
+        
+        std::ostringstream disOss;
+        AmdDisasmInput input;
+        input.deviceType = deviceType;
+        input.is64BitMode = false;
+        Disassembler disasm(&input, disOss, 0);
+        GCNDisassembler gcnDisasm(disasm);
+        gcnDisasm.setInput(codeSize, codeBytes);
+        const double analyzeTime = measure(repeats, [&]()
+        {
+            gcnDisasm.clearNumberedLabels();
+            gcnDisasm.analyzeBeforeDisassemble();
+        });
+        
+        std::cout << getGPUDeviceTypeName(deviceType) << ": instructions: " <<
+                refInsnsNum << "\n  if/else chain: " << refTime << " s\n"
+                "  getInstructionSize: " << asmTime << " s\n"
+                "  analyzeBeforeDisassemble (with labels): " << analyzeTime <<
+                " s\n  speedup: " << (refTime / asmTime) << std::endl;
+        if (refInsnsNum != asmInsnsNum)
+        {
+            std::cerr << "Different number of instructions!" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
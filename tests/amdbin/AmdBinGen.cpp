@@ -18,6 +18,8 @@
  */
 
 #include <CLRX/Config.h>
+#include <cstring>
+#include <vector>
 #include <iostream>
 #include <sstream>
 #include <map>
@@ -674,6 +676,22 @@ static void testOrigBinary(cxuint testCase, const char* origBinaryFilename, bool
                     ": byte=" << i;
             throw Exception(oss.str());
         }
+    
+    // output to stream and vector must be same as output to memory of array
+    std::ostringstream streamOss;
+    binGen.generate(streamOss);
+    const std::string streamOutput = streamOss.str();
+    std::vector<char> vectorOutput;
+    binGen.generate(vectorOutput);
+    if (streamOutput.size() != output.size() || vectorOutput.size() != output.size() ||
+        ::memcmp(streamOutput.data(), output.data(), output.size()) != 0 ||
+        ::memcmp(vectorOutput.data(), output.data(), output.size()) != 0)
+    {
+        std::ostringstream oss;
+        oss << "Failed for #" << testCase << " file=" << origBinaryFilename <<
+                ": stream or vector output differs from array output";
+        throw Exception(oss.str());
+    }
 }
 
 int main(int argc, const char** argv)
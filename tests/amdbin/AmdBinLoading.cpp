@@ -491,6 +491,130 @@ static void testKernelArgs(const char* filename, const char* kernelName,
     }
 }
 
+static AmdMainBinaryBase* createAmdMainBinary(Array<cxbyte>& data, Flags creationFlags)
+{
+    if (isAmdCL2Binary(data.size(), data.data()))
+        return createAmdCL2BinaryFromCode(data.size(), data.data(), creationFlags);
+    return createAmdBinaryFromCode(data.size(), data.data(), creationFlags);
+}
+
+static void compareKernelInfos(const std::string& testName, const std::string& caseName,
+            const KernelInfo& expKernelInfo, const KernelInfo& kernelInfo)
+{
+    assertValue(testName, caseName+" kernelName", expKernelInfo.kernelName,
+                kernelInfo.kernelName);
+    assertValue(testName, caseName+" argInfosNum", expKernelInfo.argInfos.size(),
+                kernelInfo.argInfos.size());
+    for (size_t j = 0; j < expKernelInfo.argInfos.size(); j++)
+    {
+        std::ostringstream oss;
+        oss << caseName << " arg#" << j;
+        const std::string argCaseName = oss.str();
+        const AmdKernelArg& expArg = expKernelInfo.argInfos[j];
+        const AmdKernelArg& arg = kernelInfo.argInfos[j];
+        assertValue(testName, argCaseName+" argType", cxuint(expArg.argType),
+                    cxuint(arg.argType));
+        assertValue(testName, argCaseName+" ptrSpace", cxuint(expArg.ptrSpace),
+                    cxuint(arg.ptrSpace));
+        assertValue(testName, argCaseName+" ptrAccess", expArg.ptrAccess, arg.ptrAccess);
+        assertValue(testName, argCaseName+" argName", expArg.argName, arg.argName);
+        assertValue(testName, argCaseName+" typeName", expArg.typeName, arg.typeName);
+    }
+}
+
+// checking lazy parsing of kernel infos and inner binaries (compare with eager mode)
+static void testLazyKernelInfos(const char* filename)
+{
+    const std::string testName = std::string("testLazyKernelInfos:") + filename;
+    
+    Array<cxbyte> data = loadDataFromFile(filename);
+    std::unique_ptr<AmdMainBinaryBase> eager(createAmdMainBinary(data,
+                AMDBIN_CREATE_ALL));
+    std::unique_ptr<AmdMainBinaryBase> lazy(createAmdMainBinary(data,
+                AMDBIN_CREATE_ALL | AMDBIN_CREATE_LAZY));
+    
+    const size_t kernelsNum = eager->getKernelInfosNum();
+    assertValue(testName, "kernelInfosNum", kernelsNum, lazy->getKernelInfosNum());
+    // first access by name in reversed order
+    for (size_t i = kernelsNum; i > 0; i--)
+    {
+        const KernelInfo& expKernelInfo = eager->getKernelInfo(i-1);
+        std::ostringstream oss;
+        oss << "byName#" << (i-1);
+        compareKernelInfos(testName, oss.str(), expKernelInfo,
+                    lazy->getKernelInfo(expKernelInfo.kernelName.c_str()));
+    }
+    // next access by index must return same cached kernel infos
+    for (size_t i = 0; i < kernelsNum; i++)
+    {
+        std::ostringstream oss;
+        oss << "#" << i;
+        compareKernelInfos(testName, oss.str(), eager->getKernelInfo(i),
+                    lazy->getKernelInfo(i));
+        assertTrue(testName, oss.str()+" cached", &lazy->getKernelInfo(i) ==
+                    &lazy->getKernelInfo(lazy->getKernelInfo(i).kernelName.c_str()));
+        assertTrue(testName, oss.str()+" array", &lazy->getKernelInfo(i) ==
+                    lazy->getKernelInfos()+i);
+    }
+    
+    const AmdMainType mainType = eager->getType();
+    if (mainType == AmdMainType::GPU_BINARY || mainType == AmdMainType::GPU_64_BINARY)
+    {
+        const AmdMainGPUBinaryBase& eagerGPU =
+                static_cast<const AmdMainGPUBinaryBase&>(*eager);
+        const AmdMainGPUBinaryBase& lazyGPU =
+                static_cast<const AmdMainGPUBinaryBase&>(*lazy);
+        const size_t innerBinsNum = eagerGPU.getInnerBinariesNum();
+        assertValue(testName, "innerBinariesNum", innerBinsNum,
+                    lazyGPU.getInnerBinariesNum());
+        for (size_t i = 0; i < innerBinsNum; i++)
+        {
+            std::ostringstream oss;
+            oss << "inner#" << i;
+            const std::string caseName = oss.str();
+            const AmdInnerGPUBinary32& expInnerBin = eagerGPU.getInnerBinary(i);
+            const AmdInnerGPUBinary32& innerBin = lazyGPU.getInnerBinary(
+                        expInnerBin.getKernelName().c_str());
+            assertValue(testName, caseName+" kernelName", expInnerBin.getKernelName(),
+                        innerBin.getKernelName());
+            assertValue(testName, caseName+" size", expInnerBin.getSize(),
+                        innerBin.getSize());
+            assertTrue(testName, caseName+" code", expInnerBin.getBinaryCode() ==
+                        innerBin.getBinaryCode());
+            assertValue(testName, caseName+" encodingsNum",
+                        expInnerBin.getCALEncodingEntriesNum(),
+                        innerBin.getCALEncodingEntriesNum());
+            for (cxuint k = 0; k < expInnerBin.getCALEncodingEntriesNum(); k++)
+                assertValue(testName, caseName+" calNotesNum",
+                        expInnerBin.getCALNotesNum(k), innerBin.getCALNotesNum(k));
+            assertTrue(testName, caseName+" cached", &innerBin ==
+                        &lazyGPU.getInnerBinary(i));
+        }
+    }
+    else if (mainType == AmdMainType::GPU_CL2_BINARY ||
+            mainType == AmdMainType::GPU_CL2_64_BINARY)
+    {
+        const AmdCL2MainGPUBinaryBase& eagerCL2 =
+                static_cast<const AmdCL2MainGPUBinaryBase&>(*eager);
+        const AmdCL2MainGPUBinaryBase& lazyCL2 =
+                static_cast<const AmdCL2MainGPUBinaryBase&>(*lazy);
+        assertValue(testName, "driverVersion", eagerCL2.getDriverVersion(),
+                    lazyCL2.getDriverVersion());
+        for (size_t i = 0; i < kernelsNum; i++)
+        {
+            std::ostringstream oss;
+            oss << "header#" << i;
+            const std::string caseName = oss.str();
+            const AmdGPUKernelHeader& expHeader = eagerCL2.getKernelHeaderEntry(i);
+            const AmdGPUKernelHeader& header = lazyCL2.getKernelHeaderEntry(i);
+            assertValue(testName, caseName+" kernelName", expHeader.kernelName,
+                        header.kernelName);
+            assertValue(testName, caseName+" size", expHeader.size, header.size);
+            assertTrue(testName, caseName+" data", expHeader.data == header.data);
+        }
+    }
+}
+
 static const cxbyte defaultHeader[32] = { };
 
 static AmdMainGPUBinaryBase* genAmdBinWithMetadata(const std::string& metadata)
@@ -543,6 +667,76 @@ static void testAmdGPUMetadataGen()
 ;memory:hwregion:0
 ;pointer:theArray:u32:1:1:0:uv:12:4:RW:0:0
 ;value:stage:u32:1:)blaB");
+    assertCLRXException(testName, "Unknown type", "8: Can't parse type",
+        tryGenAmdBinWithMetadata, R"blaB(;ARGSTART:__OpenCL_bitonicSort_kernel
+;version:3:1:111
+;device:pitcairn
+;uniqueid:1024
+;memory:uavprivate:0
+;memory:hwlocal:0
+;memory:hwregion:0
+;value:stage:u24:1:1:0
+;reflection:0:uint)blaB");
+    assertCLRXException(testName, "Dupl arg", "9: Argument has been duplicated",
+        tryGenAmdBinWithMetadata, R"blaB(;ARGSTART:__OpenCL_bitonicSort_kernel
+;version:3:1:111
+;device:pitcairn
+;uniqueid:1024
+;memory:uavprivate:0
+;memory:hwlocal:0
+;memory:hwregion:0
+;pointer:theArray:u32:1:1:0:uav:12:4:RW:0:0
+;value:theArray:u32:1:1:0
+;reflection:0:uint*)blaB");
+}
+
+// unknown keywords are skipped, shortened keywords (prefixes) are accepted
+static void testAmdGPUMetadataKeywords()
+{
+    const std::string testName = "testAmdGPUMetadataKeywords";
+    std::unique_ptr<AmdMainGPUBinaryBase> binary(genAmdBinWithMetadata(
+            R"blaB(;ARGSTART:__OpenCL_myKernel0_kernel
+;version:3:1:111
+;device:pitcairn
+;uniqueid:1024
+;memory:uavprivate:0
+;x:1
+;q
+;valuex:bad:u32:1:1:0
+;val:stage:u32:1:1:0
+;v:count:i16:4:1:16
+;poin:theArray:u32:1:1:0:uav:12:4:RW:0:0
+;function:1:1028
+;privateid:8
+;reflection:0:uint
+;reflection:1:short4
+;reflection:2:uint*)blaB"));
+    const KernelInfo& kernelInfo = binary->getKernelInfo(size_t(0));
+    assertValue(testName, "argInfosNum", size_t(3), kernelInfo.argInfos.size());
+    const AmdKernelArg expKernelArgs[3] =
+    {
+        { KernelArgType::UINT, KernelPtrSpace::NONE, 0, "uint", "stage" },
+        { KernelArgType::SHORT4, KernelPtrSpace::NONE, 0, "short4", "count" },
+        { KernelArgType::POINTER, KernelPtrSpace::GLOBAL, KARG_PTR_NORMAL,
+            "uint*", "theArray" }
+    };
+    for (size_t i = 0; i < 3; i++)
+    {
+        std::ostringstream oss;
+        oss << "#" << i;
+        const std::string caseName = oss.str();
+        const AmdKernelArg& argInfo = kernelInfo.argInfos[i];
+        assertValue(testName, caseName+" argType", cxuint(expKernelArgs[i].argType),
+                    cxuint(argInfo.argType));
+        assertValue(testName, caseName+" ptrSpace", cxuint(expKernelArgs[i].ptrSpace),
+                    cxuint(argInfo.ptrSpace));
+        assertValue(testName, caseName+" ptrAccess", expKernelArgs[i].ptrAccess,
+                    argInfo.ptrAccess);
+        assertValue(testName, caseName+" argName", expKernelArgs[i].argName,
+                    argInfo.argName);
+        assertValue(testName, caseName+" typeName", expKernelArgs[i].typeName,
+                    argInfo.typeName);
+    }
 }
 
 struct BinLoadingFailCase
@@ -657,6 +851,21 @@ int main(int argc, const char** argv)
             "/tests/amdbin/amdbins/structkernel2_cpu64.clo", "myKernel1",
             sizeof(expectedCPUKernelArgs2)/sizeof(AmdKernelArg), expectedCPUKernelArgs2);
     retVal |= callTest(testAmdGPUMetadataGen);
+    retVal |= callTest(testAmdGPUMetadataKeywords);
+    retVal |= callTest(testLazyKernelInfos, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/alltypes.clo");
+    retVal |= callTest(testLazyKernelInfos, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/structkernel2_64.clo");
+    retVal |= callTest(testLazyKernelInfos, CLRX_SOURCE_DIR
+            "/tests/amdasm/amdbins/samplekernels.clo");
+    retVal |= callTest(testLazyKernelInfos, CLRX_SOURCE_DIR
+            "/tests/amdasm/amdbins/samplekernels_64.clo");
+    retVal |= callTest(testLazyKernelInfos, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/alltypes-15_7.clo");
+    retVal |= callTest(testLazyKernelInfos, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/test3-15_11.clo");
+    retVal |= callTest(testLazyKernelInfos, CLRX_SOURCE_DIR
+            "/tests/amdasm/amdbins/amdcl2.clo");
     
     for (cxuint i = 0; i < sizeof(binLoadingTestCases)/sizeof(BinLoadingFailCase); i++)
     {
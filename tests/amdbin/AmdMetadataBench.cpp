@@ -0,0 +1,91 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* benchmark of parsing kernel metadata of AMD main GPU binaries
+ * usage: AmdMetadataBench [REPEATS [FILENAME...]]
+ * by default, parses AMD OpenCL 1.2 binaries from tests/amdbin/amdbins */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+
+using namespace CLRX;
+
+static const char* defaultBinaryNames[] =
+{
+    "alltypes.clo", "alltypes_64.clo", "structkernel2.clo", "structkernel2_64.clo",
+    "prginfo1_14_12.clo.1_0.regen", "prginfo1_14_12_64.clo.1_0.regen",
+    "prginfo4_14_12.clo.1_0.regen", "prginfo4_14_12_64.clo.1_0.regen",
+    "prginfo7_14_12.clo.1_0.regen", "prginfo7_14_12_64.clo.1_0.regen",
+    "prginfo8_14_12.clo.1_0.regen", "prginfo8_14_12_64.clo.1_0.regen"
+};
+
+int main(int argc, const char** argv)
+{
+    const cxuint repeats = (argc >= 2) ? strtoul(argv[1], nullptr, 10) : 2000;
+    if (repeats == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    std::vector<Array<cxbyte> > binaries;
+    if (argc >= 3)
+        for (int i = 2; i < argc; i++)
+            binaries.push_back(loadDataFromFile(argv[i]));
+    else
+        for (const char* name: defaultBinaryNames)
+            binaries.push_back(loadDataFromFile((std::string(CLRX_SOURCE_DIR
+                        "/tests/amdbin/amdbins/") + name).c_str()));
+    
+    size_t kernelsNum = 0, argsNum = 0, metadataSize = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (cxuint r = 0; r < repeats; r++)
+        for (Array<cxbyte>& binary: binaries)
+        {
+            // inner binaries are not created in lazy mode, only metadatas are parsed
+            std::unique_ptr<AmdMainBinaryBase> mainBin(createAmdBinaryFromCode(
+                    binary.size(), binary.data(),
+                    AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_LAZY));
+            const AmdMainGPUBinaryBase& gpuBin =
+                    static_cast<const AmdMainGPUBinaryBase&>(*mainBin);
+            const KernelInfo* kernelInfos = gpuBin.getKernelInfos();
+            for (size_t i = 0; i < gpuBin.getKernelInfosNum(); i++)
+            {
+                argsNum += kernelInfos[i].argInfos.size();
+                metadataSize += gpuBin.getMetadataSize(i);
+            }
+            kernelsNum += gpuBin.getKernelInfosNum();
+        }
+    const auto end = std::chrono::steady_clock::now();
+    const double time = std::chrono::duration<double>(end-start).count();
+    
+    std::cout << "Binaries: " << binaries.size() << ", repeats: " << repeats << "\n"
+            "Kernels: " << kernelsNum << ", args: " << argsNum <<
+            ", metadata: " << metadataSize << " bytes\n"
+            "Time: " << time << " s, " << (metadataSize / time / 1e6) << " MB/s, " <<
+            (time / kernelsNum * 1e6) << " us per kernel" << std::endl;
+    return 0;
+}
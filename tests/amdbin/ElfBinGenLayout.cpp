@@ -0,0 +1,136 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdbin/ElfBinaries.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+struct ElfLayoutSection
+{
+    const char* name;
+    size_t size;
+    cxuint regionAlign;
+    cxuint sectionAlign;
+};
+
+struct ElfLayoutCase
+{
+    Array<ElfLayoutSection> sections;
+};
+
+/* sections with section alignment greater than region alignment are aligned in file
+ * by section alignment (as in generated content), other sections are placed
+ * as in previous layout (aligned by region alignment) */
+static const ElfLayoutCase elfLayoutTestCasesTbl[] =
+{
+    {   // 0 - section alignment not greater than region alignment
+        { { ".text1", 5, 1, 0 }, { ".text2", 7, 8, 4 }, { ".data", 3, 16, 16 },
+          { ".rodata", 11, 4, 1 } }
+    },
+    {   // 1 - section alignment greater than region alignment
+        { { ".text1", 5, 1, 0 }, { ".text2", 7, 1, 16 }, { ".data", 3, 1, 8 },
+          { ".rodata", 11, 4, 256 } }
+    },
+    {   // 2 - mixed
+        { { ".text1", 1, 1, 0 }, { ".text2", 9, 2, 64 }, { ".data", 30, 32, 4 },
+          { ".rodata", 2, 1, 2 }, { ".comment", 17, 1, 8 } }
+    }
+};
+
+static uint64_t alignOffset(uint64_t offset, uint64_t align)
+{
+    if (align > 1 && (offset & (align-1)) != 0)
+        offset += align - (offset & (align-1));
+    return offset;
+}
+
+static void testElfLayout(cxuint i, const ElfLayoutCase& testCase)
+{
+    std::ostringstream oss;
+    oss << "ElfBinGenLayout#" << i;
+    const std::string testName = oss.str();
+    
+    Array<Array<cxbyte> > contents(testCase.sections.size());
+    ElfBinaryGen64 elfBinGen({ 0U, 0U, 0x40, 0, ET_DYN, 0xe0, EV_CURRENT,
+                UINT_MAX, 0, 0 }, true, true, true, PHREGION_FILESTART);
+    for (size_t k = 0; k < testCase.sections.size(); k++)
+    {
+        const ElfLayoutSection& section = testCase.sections[k];
+        contents[k].resize(section.size);
+        for (size_t j = 0; j < section.size; j++)
+            contents[k][j] = cxbyte(k*31 + j + 1);
+        elfBinGen.addRegion(ElfRegion64(section.size, contents[k].data(),
+                section.regionAlign, section.name, SHT_PROGBITS, SHF_ALLOC,
+                0, 0, 0, 0, false, section.sectionAlign));
+    }
+    elfBinGen.addRegion(ElfRegion64::shstrtabSection());
+    elfBinGen.addRegion(ElfRegion64::sectionHeaderTable());
+    
+    const uint64_t binarySize = elfBinGen.countSize();
+    std::ostringstream binOss;
+    elfBinGen.generate(binOss);
+    const std::string out = binOss.str();
+    // planned size must be equal to written size
+    assertValue(testName, "binarySize", binarySize, uint64_t(out.size()));
+    
+    Array<cxbyte> binary(out.size());
+    std::copy(out.begin(), out.end(), binary.begin());
+    ElfBinary64 elfBin(binary.size(), binary.data(), ELF_CREATE_SECTIONMAP);
+    // first section starts after ELF header
+    uint64_t offset = sizeof(Elf64_Ehdr);
+    for (size_t k = 0; k < testCase.sections.size(); k++)
+    {
+        const ElfLayoutSection& section = testCase.sections[k];
+        const std::string caseName = std::string(section.name);
+        const Elf64_Shdr& shdr = elfBin.getSectionHeader(section.name);
+        offset = alignOffset(offset, std::max(section.regionAlign,
+                    section.sectionAlign));
+        assertValue(testName, caseName+".offset", offset, ULEV(shdr.sh_offset));
+        assertValue(testName, caseName+".size", uint64_t(section.size),
+                    ULEV(shdr.sh_size));
+        // content must be at offset given in section header
+        assertTrue(testName, caseName+".content", ::memcmp(
+                elfBin.getSectionContent(section.name), contents[k].data(),
+                section.size) == 0);
+        offset += section.size;
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (cxuint i = 0; i < sizeof(elfLayoutTestCasesTbl)/sizeof(ElfLayoutCase); i++)
+        try
+        { testElfLayout(i, elfLayoutTestCasesTbl[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    return retVal;
+}
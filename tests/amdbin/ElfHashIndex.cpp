@@ -0,0 +1,160 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdbin/ElfBinaries.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+// access to protected fields
+class TestElfBinary64: public ElfBinary64
+{
+public:
+    TestElfBinary64(size_t binaryCodeSize, cxbyte* binaryCode, Flags creationFlags)
+            : ElfBinary64(binaryCodeSize, binaryCode, creationFlags)
+    { }
+    
+    bool usesElfHashForDynSymbols() const
+    { return dynSymElfHash != nullptr; }
+    bool usesElfHashForSymbols() const
+    { return symbolElfHash != nullptr; }
+};
+
+static const cxbyte textData[16] = { };
+
+// generate ELF binary with many symbols, dynamic symbols and .hash section
+static Array<cxbyte> generateElfBinary(size_t symbolsNum,
+            std::vector<std::string>& symNames)
+{
+    symNames.clear();
+    for (size_t i = 0; i < symbolsNum; i++)
+        symNames.push_back("kernel_" + std::to_string(i*7919 % 100003) + "_metadata");
+    // duplicate name: lookup must return first symbol
+    symNames.push_back(symNames[3]);
+    
+    ElfBinaryGen64 elfBinGen({ 0U, 0U, 0x40, 0, ET_DYN, 0xe0, EV_CURRENT,
+                UINT_MAX, 0, 0 }, true, true, true, PHREGION_FILESTART);
+    elfBinGen.addRegion(ElfRegion64::dynsymSection());      // 1
+    elfBinGen.addRegion(ElfRegion64::hashSection(1));       // 2
+    elfBinGen.addRegion(ElfRegion64::dynstrSection());      // 3
+    elfBinGen.addRegion(ElfRegion64(sizeof textData, textData, 256, ".text",
+                SHT_PROGBITS, SHF_ALLOC|SHF_EXECINSTR));    // 4
+    elfBinGen.addRegion(ElfRegion64::symtabSection());      // 5
+    elfBinGen.addRegion(ElfRegion64::strtabSection());      // 6
+    elfBinGen.addRegion(ElfRegion64::shstrtabSection());    // 7
+    elfBinGen.addRegion(ElfRegion64::sectionHeaderTable());
+    for (size_t i = 0; i < symNames.size(); i++)
+    {
+        ElfSymbol64 sym(symNames[i].c_str(), 4, ELF64_ST_INFO(STB_GLOBAL, STT_FUNC),
+                0, false, i, 0);
+        elfBinGen.addSymbol(sym);
+        elfBinGen.addDynSymbol(sym);
+    }
+    Array<cxbyte> binary(elfBinGen.countSize());
+    std::ostringstream oss;
+    elfBinGen.generate(oss);
+    const std::string out = oss.str();
+    std::copy(out.begin(), out.end(), binary.begin());
+    return binary;
+}
+
+static void testHashIndex(size_t symbolsNum)
+{
+    std::ostringstream caseOss;
+    caseOss << "symbols" << symbolsNum;
+    const std::string caseName = caseOss.str();
+    std::vector<std::string> symNames;
+    Array<cxbyte> binary = generateElfBinary(symbolsNum, symNames);
+    
+    TestElfBinary64 sortedElf(binary.size(), binary.data(), ELF_CREATE_SECTIONMAP |
+                ELF_CREATE_SYMBOLMAP | ELF_CREATE_DYNSYMMAP);
+    TestElfBinary64 hashedElf(binary.size(), binary.data(), ELF_CREATE_ALL |
+                ELF_CREATE_HASHINDEX);
+    assertTrue("ElfHashIndex", caseName+".hasHashIndex", hashedElf.hasHashIndex());
+    assertTrue("ElfHashIndex", caseName+".noHashIndex", !sortedElf.hasHashIndex());
+    // hash index must be requested explicitly
+    TestElfBinary64 allElf(binary.size(), binary.data(), ELF_CREATE_ALL);
+    assertTrue("ElfHashIndex", caseName+".createAllNoHashIndex", !allElf.hasHashIndex());
+    // .hash section refers to dynamic symbols
+    assertTrue("ElfHashIndex", caseName+".dynElfHash",
+               hashedElf.usesElfHashForDynSymbols());
+    assertTrue("ElfHashIndex", caseName+".symNoElfHash",
+               !hashedElf.usesElfHashForSymbols());
+    
+    // sections
+    for (uint16_t i = 1; i < hashedElf.getSectionHeadersNum(); i++)
+    {
+        const char* name = hashedElf.getSectionName(i);
+        assertValue("ElfHashIndex", caseName+".section."+name, i,
+                    hashedElf.getSectionIndex(name));
+        assertValue("ElfHashIndex", caseName+".sectionIter."+name, size_t(i),
+                    hashedElf.getSectionIter(name)->second);
+        assertValue("ElfHashIndex", caseName+".sectionSorted."+name,
+                    sortedElf.getSectionIndex(name), hashedElf.getSectionIndex(name));
+    }
+    // symbols (first symbol is null symbol)
+    for (size_t i = 0; i < symNames.size(); i++)
+    {
+        const char* name = symNames[i].c_str();
+        const size_t expected = (i+1 == symNames.size()) ? 4 : i+1;
+        assertValue("ElfHashIndex", caseName+".symbol."+name, expected,
+                    size_t(hashedElf.getSymbolIndex(name)));
+        assertValue("ElfHashIndex", caseName+".dynSymbol."+name, expected,
+                    size_t(hashedElf.getDynSymbolIndex(name)));
+        assertValue("ElfHashIndex", caseName+".dynSymbolIter."+name, expected,
+                    hashedElf.getDynSymbolIter(name)->second);
+        assertString("ElfHashIndex", caseName+".symbolSorted."+name,
+                    sortedElf.getSymbolName(sortedElf.getSymbolIndex(name)),
+                    hashedElf.getSymbolName(hashedElf.getSymbolIndex(name)));
+    }
+    // null symbol (not in .hash chains)
+    assertValue("ElfHashIndex", caseName+".nullDynSymbol", size_t(0),
+                size_t(hashedElf.getDynSymbolIndex("")));
+    // not found
+    assertCLRXException("ElfHashIndex", caseName+".noSection",
+            "Can't find Elf64 Section", [&hashedElf]()
+            { hashedElf.getSectionIndex(".notsection"); });
+    assertCLRXException("ElfHashIndex", caseName+".noSymbol",
+            "Can't find Elf64 Symbol", [&hashedElf]()
+            { hashedElf.getSymbolIndex("kernel_x"); });
+    assertCLRXException("ElfHashIndex", caseName+".noDynSymbol",
+            "Can't find Elf64 DynSymbol", [&hashedElf]()
+            { hashedElf.getDynSymbolIndex("kernel_x"); });
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (size_t symbolsNum: { 10, 1000, 5000 })
+        try
+        { testHashIndex(symbolsNum); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    return retVal;
+}
@@ -0,0 +1,557 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* tests of CLRX assembler calls in CLRXWrapper (clBuildProgram with '-xasm'),
+ * CLRXWrapper uses mock of AMD OpenCL driver (MockAmdOCL) */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#include <CL/cl.h>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* cacheDirName = "CLWrapperCache.tmp.dir";
+static const char* includeFilename = "CLWrapperInc.tmp.s";
+static const char* incDir1Name = "CLWrapperInc1.tmp.dir";
+static const char* incDir2Name = "CLWrapperInc2.tmp.dir";
+
+// mock driver controls
+static void (*mockSetBuildGate)(int closed) = nullptr;
+
+static cl_platform_id platform = nullptr;
+static cl_uint devicesNum = 0;
+static cl_device_id devices[8];
+static cl_context context = nullptr;
+
+static void writeFile(const char* filename, const char* content)
+{
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr)
+        throw Exception("Can't create temporary file");
+    fwrite(content, 1, ::strlen(content), file);
+    fclose(file);
+}
+
+// get entries of binary cache (filename and modification time)
+static std::map<std::string, time_t> getCacheEntries()
+{
+    std::map<std::string, time_t> entries;
+    DIR* dir = opendir(cacheDirName);
+    if (dir == nullptr)
+        return entries;
+    while (struct dirent* dirEntry = readdir(dir))
+    {
+        const std::string name = dirEntry->d_name;
+        if (name == "." || name == ".." || name.find(".tmp") != std::string::npos)
+            continue;
+        struct stat st;
+        if (stat(joinPaths(cacheDirName, name).c_str(), &st) == 0)
+            entries[name] = st.st_mtime;
+    }
+    closedir(dir);
+    return entries;
+}
+
+// set old modification time (entry rewriting sets current time)
+static void setOldCacheEntryTimes()
+{
+    for (const auto& entry: getCacheEntries())
+    {
+        struct utimbuf times = { 1000000000, 1000000000 };
+        utime(joinPaths(cacheDirName, entry.first).c_str(), &times);
+    }
+}
+
+static void removeCacheEntries()
+{
+    for (const auto& entry: getCacheEntries())
+        remove(joinPaths(cacheDirName, entry.first).c_str());
+}
+
+static cl_program createProgram(const char* source)
+{
+    cl_int error;
+    cl_program program = clCreateProgramWithSource(context, 1, &source, nullptr, &error);
+    if (program == nullptr)
+        throw Exception("Can't create program");
+    return program;
+}
+
+// build results of program for every device of context
+struct BuildResult
+{
+    std::vector<cl_build_status> statuses;
+    std::vector<std::string> logs;
+    std::vector<std::vector<unsigned char> > binaries;
+};
+
+static BuildResult getBuildResult(cl_program program)
+{
+    BuildResult result;
+    for (cl_uint i = 0; i < devicesNum; i++)
+    {
+        cl_build_status status;
+        if (clGetProgramBuildInfo(program, devices[i], CL_PROGRAM_BUILD_STATUS,
+                    sizeof(cl_build_status), &status, nullptr) != CL_SUCCESS)
+            throw Exception("Can't get build status");
+        result.statuses.push_back(status);
+        size_t logSize;
+        if (clGetProgramBuildInfo(program, devices[i], CL_PROGRAM_BUILD_LOG,
+                    0, nullptr, &logSize) != CL_SUCCESS)
+            throw Exception("Can't get build log size");
+        std::vector<char> log(logSize);
+        if (clGetProgramBuildInfo(program, devices[i], CL_PROGRAM_BUILD_LOG,
+                    logSize, log.data(), nullptr) != CL_SUCCESS)
+            throw Exception("Can't get build log");
+        result.logs.push_back(log.data());
+    }
+    // binaries are in order of program devices
+    cl_uint progDevicesNum;
+    if (clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES, sizeof(cl_uint),
+                &progDevicesNum, nullptr) != CL_SUCCESS)
+        throw Exception("Can't get program devices number");
+    std::vector<cl_device_id> progDevices(progDevicesNum);
+    std::vector<size_t> binarySizes(progDevicesNum);
+    if (clGetProgramInfo(program, CL_PROGRAM_DEVICES, sizeof(cl_device_id)*progDevicesNum,
+                progDevices.data(), nullptr) != CL_SUCCESS ||
+        clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t)*progDevicesNum,
+                binarySizes.data(), nullptr) != CL_SUCCESS)
+        throw Exception("Can't get program devices");
+    std::vector<std::vector<unsigned char> > progBinaries(progDevicesNum);
+    std::vector<unsigned char*> binaryPtrs(progDevicesNum);
+    for (cl_uint i = 0; i < progDevicesNum; i++)
+    {
+        progBinaries[i].resize(binarySizes[i]);
+        binaryPtrs[i] = (binarySizes[i] != 0) ? progBinaries[i].data() : nullptr;
+    }
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES,
+                sizeof(unsigned char*)*progDevicesNum, binaryPtrs.data(),
+                nullptr) != CL_SUCCESS)
+        throw Exception("Can't get program binaries");
+    result.binaries.resize(devicesNum);
+    for (cl_uint i = 0; i < devicesNum; i++)
+    {
+        const auto it = std::find(progDevices.begin(), progDevices.end(), devices[i]);
+        if (it != progDevices.end())
+            result.binaries[i] = progBinaries[it - progDevices.begin()];
+    }
+    return result;
+}
+
+static const char* goodSource =
+        ".kernel test\n"
+        "    .config\n"
+        ".text\n"
+        "    s_endpgm\n"
+        "    .warning \"cached warning\"\n";
+
+// FLAT instructions are not available in GCN1.0 (Pitcairn)
+static const char* gcn11Source =
+        ".kernel test\n"
+        "    .config\n"
+        ".text\n"
+        "    flat_load_dword v1, v[2:3]\n"
+        "    s_endpgm\n";
+
+// devices of different types: Pitcairn, Bonaire, Tonga, Tonga
+static void testMultipleDevices()
+{
+    const std::string testName = "MultipleDevices";
+    cl_program program = createProgram(goodSource);
+    assertValue(testName, "buildGood", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr));
+    BuildResult result = getBuildResult(program);
+    for (cl_uint i = 0; i < devicesNum; i++)
+    {
+        const std::string caseName = std::string("good#") + std::to_string(i);
+        assertValue(testName, caseName+".status", cl_build_status(CL_BUILD_SUCCESS),
+                    result.statuses[i]);
+        assertTrue(testName, caseName+".log",
+                    result.logs[i].find("cached warning") != std::string::npos);
+        assertTrue(testName, caseName+".binary", result.binaries[i].size() > 4 &&
+                    ::memcmp(result.binaries[i].data(), "\177ELF", 4) == 0);
+    }
+    // 32-bit Pitcairn and 64-bit Bonaire have different binaries
+    assertTrue(testName, "good.binary0!=1", result.binaries[0] != result.binaries[1]);
+    // this same device type - this same binary
+    assertTrue(testName, "good.binary2==3", result.binaries[2] == result.binaries[3]);
+    clReleaseProgram(program);
+
+    // assembling fails only for Pitcairn
+    program = createProgram(gcn11Source);
+    assertValue(testName, "buildGCN11", cl_int(CL_BUILD_PROGRAM_FAILURE),
+                clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr));
+    result = getBuildResult(program);
+    assertValue(testName, "gcn11#0.status", cl_build_status(CL_BUILD_ERROR),
+                result.statuses[0]);
+    assertTrue(testName, "gcn11#0.log", result.logs[0].find("Error") != std::string::npos);
+    assertValue(testName, "gcn11#0.binary", size_t(0), result.binaries[0].size());
+    for (cl_uint i = 1; i < devicesNum; i++)
+    {
+        const std::string caseName = std::string("gcn11#") + std::to_string(i);
+        assertValue(testName, caseName+".status", cl_build_status(CL_BUILD_SUCCESS),
+                    result.statuses[i]);
+        assertTrue(testName, caseName+".binary", !result.binaries[i].empty());
+    }
+
+    // build only for Pitcairn and Tonga
+    const cl_device_id someDevices[2] = { devices[0], devices[2] };
+    assertValue(testName, "buildSome", cl_int(CL_BUILD_PROGRAM_FAILURE),
+                clBuildProgram(program, 2, someDevices, "-xasm", nullptr, nullptr));
+    cl_uint progDevicesNum;
+    clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES, sizeof(cl_uint),
+                &progDevicesNum, nullptr);
+    assertValue(testName, "someDevicesNum", cl_uint(2), progDevicesNum);
+    cl_build_status status;
+    clGetProgramBuildInfo(program, devices[2], CL_PROGRAM_BUILD_STATUS,
+                sizeof(cl_build_status), &status, nullptr);
+    assertValue(testName, "some#2.status", cl_build_status(CL_BUILD_SUCCESS), status);
+    assertValue(testName, "some#1.status", cl_int(CL_INVALID_DEVICE),
+                clGetProgramBuildInfo(program, devices[1], CL_PROGRAM_BUILD_STATUS,
+                sizeof(cl_build_status), &status, nullptr));
+    clReleaseProgram(program);
+}
+
+static void testBinaryCache()
+{
+    const std::string testName = "BinaryCache";
+    const char* source =
+        ".kernel test\n"
+        "    .config\n"
+        ".text\n"
+        "    s_mov_b32 s1, 7\n"
+        "    s_endpgm\n"
+        "    .warning \"cached warning\"\n";
+    const auto entriesBefore = getCacheEntries();
+    cl_program program = createProgram(source);
+    assertValue(testName, "buildMiss", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr));
+    const BuildResult missResult = getBuildResult(program);
+    // one entry per device type
+    assertValue(testName, "missEntriesNum", entriesBefore.size()+3,
+                getCacheEntries().size());
+
+    // entries are not rewritten if binaries were got from cache
+    setOldCacheEntryTimes();
+    const auto oldEntries = getCacheEntries();
+    assertValue(testName, "buildHit", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr));
+    const BuildResult hitResult = getBuildResult(program);
+    assertTrue(testName, "hitEntries", oldEntries == getCacheEntries());
+    assertTrue(testName, "hitStatuses", missResult.statuses == hitResult.statuses);
+    assertTrue(testName, "hitLogs", missResult.logs == hitResult.logs);
+    assertTrue(testName, "hitBinaries", missResult.binaries == hitResult.binaries);
+    clReleaseProgram(program);
+
+    // other program with this same source and options
+    program = createProgram(source);
+    assertValue(testName, "buildHit2", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr));
+    assertTrue(testName, "hit2Entries", oldEntries == getCacheEntries());
+    assertTrue(testName, "hit2Binaries",
+                missResult.binaries == getBuildResult(program).binaries);
+
+    // other options - other key
+    assertValue(testName, "buildOtherOptions", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm -w", nullptr, nullptr));
+    const BuildResult otherResult = getBuildResult(program);
+    assertValue(testName, "otherEntriesNum", oldEntries.size()+3,
+                getCacheEntries().size());
+    assertTrue(testName, "otherLog",
+                otherResult.logs[0].find("cached warning") == std::string::npos);
+    clReleaseProgram(program);
+}
+
+static std::string readFile(const std::string& path)
+{
+    const Array<cxbyte> content = loadDataFromFile(path.c_str());
+    return std::string(content.begin(), content.end());
+}
+
+// entries from other CLRX version or other format version must be ignored and replaced
+static void testBinaryCacheVersion()
+{
+    const std::string testName = "BinaryCacheVersion";
+    const char* source =
+        ".kernel test\n"
+        "    .config\n"
+        ".text\n"
+        "    s_mov_b32 s1, 8\n"
+        "    s_endpgm\n";
+    const auto entriesBefore = getCacheEntries();
+    cl_program program = createProgram(source);
+    assertValue(testName, "build", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr));
+    const BuildResult firstResult = getBuildResult(program);
+    std::vector<std::string> newEntries;
+    for (const auto& entry: getCacheEntries())
+        if (entriesBefore.find(entry.first) == entriesBefore.end())
+            newEntries.push_back(entry.first);
+    assertValue(testName, "newEntriesNum", size_t(3), newEntries.size());
+
+    std::vector<std::string> contents;
+    for (const std::string& name: newEntries)
+        contents.push_back(readFile(joinPaths(cacheDirName, name)));
+    const std::string version = "CLRX " CLRX_VERSION "\n";
+    // magic (8 bytes), format version (4 bytes), key size (8 bytes), key
+    for (const std::string& content: contents)
+        assertTrue(testName, "keyVersion", content.compare(20, version.size(),
+                    version) == 0);
+
+    // entry from other CLRX version: change last digit of version in key
+    {
+        std::string content = contents[0];
+        content[20+version.size()-2] = (content[20+version.size()-2] != '9') ? '9' : '8';
+        writeFile(joinPaths(cacheDirName, newEntries[0]).c_str(), content.c_str());
+    }
+    // entry in older format (changed format version)
+    {
+        std::string content = contents[1];
+        content[8] = char(content[8]-1);
+        FILE* file = fopen(joinPaths(cacheDirName, newEntries[1]).c_str(), "wb");
+        fwrite(content.data(), 1, content.size(), file);
+        fclose(file);
+    }
+    assertValue(testName, "rebuild", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr));
+    assertTrue(testName, "rebuildBinaries",
+                firstResult.binaries == getBuildResult(program).binaries);
+    // entries has been replaced by current version
+    for (size_t i = 0; i < 3; i++)
+        assertTrue(testName, "replaced#" + std::to_string(i),
+                readFile(joinPaths(cacheDirName, newEntries[i])) == contents[i]);
+    clReleaseProgram(program);
+}
+
+// file created in earlier include path shadows included file
+static void testBinaryCacheShadowing()
+{
+    const std::string testName = "BinaryCacheShadowing";
+    const char* source =
+        ".kernel test\n"
+        "    .config\n"
+        ".text\n"
+        "    .include \"CLWrapperInc.tmp.s\"\n"
+        "    s_mov_b32 s1, V\n"
+        "    s_endpgm\n";
+    const char* options = "-xasm -I CLWrapperInc1.tmp.dir -I CLWrapperInc2.tmp.dir";
+    makeDir(incDir1Name);
+    makeDir(incDir2Name);
+    const std::string incFile1 = joinPaths(incDir1Name, includeFilename);
+    const std::string incFile2 = joinPaths(incDir2Name, includeFilename);
+    writeFile(incFile2.c_str(), "V = 7\n");
+
+    cl_program program = createProgram(source);
+    assertValue(testName, "build", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, options, nullptr, nullptr));
+    const BuildResult firstResult = getBuildResult(program);
+    setOldCacheEntryTimes();
+    const auto oldEntries = getCacheEntries();
+    assertValue(testName, "buildHit", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, options, nullptr, nullptr));
+    assertTrue(testName, "hitEntries", oldEntries == getCacheEntries());
+
+    // new file in first include path
+    writeFile(incFile1.c_str(), "V = 8\n");
+    assertValue(testName, "buildShadowed", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, options, nullptr, nullptr));
+    const BuildResult shadowedResult = getBuildResult(program);
+    assertTrue(testName, "shadowedEntries", oldEntries != getCacheEntries());
+    for (cl_uint i = 0; i < devicesNum; i++)
+        assertTrue(testName, "shadowedBinary#" + std::to_string(i),
+                shadowedResult.binaries[i] != firstResult.binaries[i]);
+
+    // removed shadowing file
+    remove(incFile1.c_str());
+    assertValue(testName, "buildNotShadowed", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, options, nullptr, nullptr));
+    assertTrue(testName, "notShadowedBinaries",
+                firstResult.binaries == getBuildResult(program).binaries);
+    clReleaseProgram(program);
+
+    remove(incFile2.c_str());
+    remove(incDir1Name);
+    remove(incDir2Name);
+}
+
+// state of asynchronous build observed by notify callback
+struct AsyncBuildState
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    cxuint notifiesNum;
+    std::vector<cl_build_status> notifyStatuses;
+    bool notifyInOtherThread;
+    std::thread::id mainThreadId;
+};
+
+static void CL_CALLBACK asyncBuildNotify(cl_program program, void* userData)
+{
+    AsyncBuildState* state = static_cast<AsyncBuildState*>(userData);
+    std::vector<cl_build_status> statuses;
+    // build status must be final in callback
+    for (cl_uint i = 0; i < devicesNum; i++)
+    {
+        cl_build_status status = CL_BUILD_NONE;
+        clGetProgramBuildInfo(program, devices[i], CL_PROGRAM_BUILD_STATUS,
+                    sizeof(cl_build_status), &status, nullptr);
+        statuses.push_back(status);
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->notifiesNum++;
+    state->notifyStatuses = statuses;
+    state->notifyInOtherThread = std::this_thread::get_id() != state->mainThreadId;
+    state->cond.notify_all();
+}
+
+static void testAsyncBuild(const char* source, bool gcn11)
+{
+    const std::string testName = std::string("AsyncBuild") + (gcn11 ? "GCN11" : "");
+    cl_program program = createProgram(source);
+    AsyncBuildState state;
+    state.notifiesNum = 0;
+    state.notifyInOtherThread = false;
+    state.mainThreadId = std::this_thread::get_id();
+    // driver builds program after opening gate
+    mockSetBuildGate(1);
+    assertValue(testName, "build", cl_int(CL_SUCCESS),
+                clBuildProgram(program, 0, nullptr, "-xasm", asyncBuildNotify, &state));
+    for (cl_uint i = 0; i < devicesNum; i++)
+    {
+        cl_build_status status;
+        clGetProgramBuildInfo(program, devices[i], CL_PROGRAM_BUILD_STATUS,
+                    sizeof(cl_build_status), &status, nullptr);
+        assertValue(testName, "inProgress#" + std::to_string(i),
+                    cl_build_status(CL_BUILD_IN_PROGRESS), status);
+    }
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        assertValue(testName, "notifiesNumBeforeBuild", cxuint(0), state.notifiesNum);
+    }
+    mockSetBuildGate(0);
+    {
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.cond.wait_for(lock, std::chrono::seconds(60),
+                    [&state]() { return state.notifiesNum != 0; });
+    }
+    // wait for possible second (wrong) notify
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(state.mutex);
+    assertValue(testName, "notifiesNum", cxuint(1), state.notifiesNum);
+    assertTrue(testName, "notifyInOtherThread", state.notifyInOtherThread);
+    const BuildResult result = getBuildResult(program);
+    for (cl_uint i = 0; i < devicesNum; i++)
+    {
+        const std::string caseName = std::string("#") + std::to_string(i);
+        const cl_build_status expected = (gcn11 && i == 0) ? CL_BUILD_ERROR :
+                    CL_BUILD_SUCCESS;
+        assertValue(testName, caseName+".notifyStatus", expected,
+                    state.notifyStatuses[i]);
+        assertValue(testName, caseName+".status", expected, result.statuses[i]);
+    }
+    clReleaseProgram(program);
+}
+
+// invalid options are returned by clBuildProgram, notify is not called
+static void testAsyncBuildInvalidOptions()
+{
+    const std::string testName = "AsyncBuildInvalidOptions";
+    cl_program program = createProgram(goodSource);
+    AsyncBuildState state;
+    state.notifiesNum = 0;
+    assertValue(testName, "build", cl_int(CL_INVALID_BUILD_OPTIONS),
+                clBuildProgram(program, 0, nullptr, "-xasm -unknownOption",
+                    asyncBuildNotify, &state));
+    cl_build_status status;
+    clGetProgramBuildInfo(program, devices[0], CL_PROGRAM_BUILD_STATUS,
+                sizeof(cl_build_status), &status, nullptr);
+    assertValue(testName, "status", cl_build_status(CL_BUILD_ERROR), status);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(state.mutex);
+    assertValue(testName, "notifiesNum", cxuint(0), state.notifiesNum);
+    clReleaseProgram(program);
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: CLWrapperBuild MOCKAMDOCLPATH" << std::endl;
+        return 1;
+    }
+    // wrapper reads environment at first OpenCL call
+    setenv("CLRX_AMDOCL_PATH", argv[1], 1);
+    setenv("CLRX_BINARY_CACHE_DIR", cacheDirName, 1);
+    removeCacheEntries();
+    remove(joinPaths(incDir1Name, includeFilename).c_str());
+    remove(joinPaths(incDir2Name, includeFilename).c_str());
+    remove(incDir1Name);
+    remove(incDir2Name);
+
+    int retVal = 0;
+    try
+    {
+        DynLibrary mockLibrary(argv[1], DYNLIB_NOW);
+        mockSetBuildGate = (void (*)(int))mockLibrary.getSymbol("mockAmdOclSetBuildGate");
+
+        if (clGetPlatformIDs(1, &platform, nullptr) != CL_SUCCESS ||
+            clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 8, devices,
+                        &devicesNum) != CL_SUCCESS)
+            throw Exception("Can't get platform or devices");
+        cl_context_properties props[3] = { CL_CONTEXT_PLATFORM,
+                    (cl_context_properties)platform, 0 };
+        cl_int error;
+        context = clCreateContext(props, devicesNum, devices, nullptr, nullptr, &error);
+        if (context == nullptr)
+            throw Exception("Can't create context");
+
+        retVal |= callTest(testMultipleDevices);
+        retVal |= callTest(testBinaryCache);
+        retVal |= callTest(testBinaryCacheVersion);
+        retVal |= callTest(testBinaryCacheShadowing);
+        retVal |= callTest(testAsyncBuild, goodSource, false);
+        retVal |= callTest(testAsyncBuild, gcn11Source, true);
+        retVal |= callTest(testAsyncBuildInvalidOptions);
+        clReleaseContext(context);
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    removeCacheEntries();
+    remove(cacheDirName);
+    return retVal;
+}
@@ -0,0 +1,609 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* mock of AMD OpenCL driver (ICD) for CLRXWrapper tests:
+ * it provides one platform with few GPU devices, contexts and programs.
+ * Program from binaries is built successfully if binary is ELF file,
+ * program from source can not be built (no compiler). */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../../clwrapper/DispatchStruct.h"
+
+#ifdef _WIN32
+#  define MOCK_EXPORT __declspec(dllexport)
+#else
+#  define MOCK_EXPORT __attribute__((visibility("default")))
+#endif
+
+// driver version is detected by CLRX from this string in driver file
+static const char* mockVersion = "OpenCL 1.2 AMD-APP (1800.8)";
+static const char* mockExtensions = "cl_khr_icd cl_amd_device_attribute_query ";
+
+static CLRXIcdDispatch mockDispatch;
+
+struct MockPlatform: _cl_platform_id
+{ };
+
+struct MockDevice: _cl_device_id
+{
+    const char* name;
+    cl_uint addressBits;
+    
+    MockDevice(const char* _name, cl_uint _addressBits)
+            : name(_name), addressBits(_addressBits)
+    { dispatch = &mockDispatch; }
+};
+
+struct MockContext: _cl_context
+{
+    std::atomic<cl_uint> refCount;
+    std::vector<cl_device_id> devices;
+};
+
+struct MockProgram: _cl_program
+{
+    std::atomic<cl_uint> refCount;
+    MockContext* context;
+    bool fromBinary;
+    std::string source;
+    std::mutex mutex;
+    std::vector<cl_device_id> devices;
+    std::vector<std::vector<unsigned char> > binaries;
+    std::vector<cl_build_status> statuses;
+    std::string options;
+    std::string log;
+};
+
+static MockPlatform mockPlatform;
+
+static MockDevice mockDevices[4] =
+{
+    { "Pitcairn", 32 },
+    { "Bonaire", 64 },
+    { "Tonga", 64 },
+    { "Tonga", 64 }
+};
+
+static const cl_uint mockDevicesNum = sizeof(mockDevices)/sizeof(MockDevice);
+
+// build gate: clBuildProgram waits until gate is opened
+static std::mutex buildGateMutex;
+static std::condition_variable buildGateCond;
+static bool buildGateClosed = false;
+static std::atomic<cl_uint> buildsNum(0);
+
+static cl_int getInfo(size_t dataSize, const void* data, size_t paramValueSize,
+            void* paramValue, size_t* paramValueSizeRet)
+{
+    if (paramValue != nullptr)
+    {
+        if (paramValueSize < dataSize)
+            return CL_INVALID_VALUE;
+        ::memcpy(paramValue, data, dataSize);
+    }
+    if (paramValueSizeRet != nullptr)
+        *paramValueSizeRet = dataSize;
+    return CL_SUCCESS;
+}
+
+static cl_int getStringInfo(const char* str, size_t paramValueSize,
+            void* paramValue, size_t* paramValueSizeRet)
+{ return getInfo(::strlen(str)+1, str, paramValueSize, paramValue, paramValueSizeRet); }
+
+template<typename T>
+static cl_int getValueInfo(const T& value, size_t paramValueSize,
+            void* paramValue, size_t* paramValueSizeRet)
+{ return getInfo(sizeof(T), &value, paramValueSize, paramValue, paramValueSizeRet); }
+
+static bool isMockDevice(cl_device_id device)
+{
+    return std::find_if(mockDevices, mockDevices+mockDevicesNum,
+            [device](const MockDevice& d) { return &d == device; }) !=
+            mockDevices+mockDevicesNum;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockGetPlatformIDs(cl_uint numEntries,
+            cl_platform_id* platforms, cl_uint* numPlatforms)
+{
+    if (platforms != nullptr)
+    {
+        if (numEntries == 0)
+            return CL_INVALID_VALUE;
+        platforms[0] = &mockPlatform;
+    }
+    if (numPlatforms != nullptr)
+        *numPlatforms = 1;
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockGetPlatformInfo(cl_platform_id platform,
+            cl_platform_info paramName, size_t paramValueSize, void* paramValue,
+            size_t* paramValueSizeRet)
+{
+    if (platform != &mockPlatform)
+        return CL_INVALID_PLATFORM;
+    switch(paramName)
+    {
+        case CL_PLATFORM_PROFILE:
+            return getStringInfo("FULL_PROFILE", paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PLATFORM_VERSION:
+            return getStringInfo(mockVersion, paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PLATFORM_NAME:
+            return getStringInfo("AMD Accelerated Parallel Processing", paramValueSize,
+                        paramValue, paramValueSizeRet);
+        case CL_PLATFORM_VENDOR:
+            return getStringInfo("Advanced Micro Devices, Inc.", paramValueSize,
+                        paramValue, paramValueSizeRet);
+        case CL_PLATFORM_EXTENSIONS:
+            return getStringInfo(mockExtensions, paramValueSize, paramValue,
+                        paramValueSizeRet);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockGetDeviceIDs(cl_platform_id platform,
+            cl_device_type deviceType, cl_uint numEntries, cl_device_id* devices,
+            cl_uint* numDevices)
+{
+    if (platform != &mockPlatform)
+        return CL_INVALID_PLATFORM;
+    if ((deviceType & (CL_DEVICE_TYPE_GPU|CL_DEVICE_TYPE_DEFAULT)) == 0)
+        return CL_DEVICE_NOT_FOUND;
+    if (devices != nullptr)
+    {
+        if (numEntries == 0)
+            return CL_INVALID_VALUE;
+        for (cl_uint i = 0; i < std::min(numEntries, mockDevicesNum); i++)
+            devices[i] = mockDevices + i;
+    }
+    if (numDevices != nullptr)
+        *numDevices = mockDevicesNum;
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockGetDeviceInfo(cl_device_id device,
+            cl_device_info paramName, size_t paramValueSize, void* paramValue,
+            size_t* paramValueSizeRet)
+{
+    if (!isMockDevice(device))
+        return CL_INVALID_DEVICE;
+    const MockDevice* d = static_cast<const MockDevice*>(device);
+    switch(paramName)
+    {
+        case CL_DEVICE_TYPE:
+            return getValueInfo(cl_device_type(CL_DEVICE_TYPE_GPU), paramValueSize,
+                        paramValue, paramValueSizeRet);
+        case CL_DEVICE_ADDRESS_BITS:
+            return getValueInfo(d->addressBits, paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_DEVICE_AVAILABLE:
+            return getValueInfo(cl_bool(CL_TRUE), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_DEVICE_NAME:
+            return getStringInfo(d->name, paramValueSize, paramValue, paramValueSizeRet);
+        case CL_DEVICE_VERSION:
+            return getStringInfo(mockVersion, paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_DEVICE_EXTENSIONS:
+            return getStringInfo(mockExtensions, paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_DEVICE_PLATFORM:
+            return getValueInfo(cl_platform_id(&mockPlatform), paramValueSize,
+                        paramValue, paramValueSizeRet);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_context CL_API_CALL mockCreateContext(
+            const cl_context_properties* properties, cl_uint numDevices,
+            const cl_device_id* devices,
+            void (CL_CALLBACK* pfnNotify)(const char*, const void*, size_t, void*),
+            void* userData, cl_int* errcodeRet)
+{
+    cl_int error = CL_SUCCESS;
+    if (numDevices == 0 || devices == nullptr)
+        error = CL_INVALID_VALUE;
+    for (cl_uint i = 0; error == CL_SUCCESS && i < numDevices; i++)
+        if (!isMockDevice(devices[i]))
+            error = CL_INVALID_DEVICE;
+    if (error != CL_SUCCESS)
+    {
+        if (errcodeRet != nullptr)
+            *errcodeRet = error;
+        return nullptr;
+    }
+    MockContext* context = new MockContext;
+    context->dispatch = &mockDispatch;
+    context->refCount = 1;
+    context->devices.assign(devices, devices + numDevices);
+    if (errcodeRet != nullptr)
+        *errcodeRet = CL_SUCCESS;
+    return context;
+}
+
+static CL_API_ENTRY cl_context CL_API_CALL mockCreateContextFromType(
+            const cl_context_properties* properties, cl_device_type deviceType,
+            void (CL_CALLBACK* pfnNotify)(const char*, const void*, size_t, void*),
+            void* userData, cl_int* errcodeRet)
+{
+    cl_device_id devices[mockDevicesNum];
+    cl_uint devicesNum = 0;
+    const cl_int error = mockGetDeviceIDs(&mockPlatform, deviceType, mockDevicesNum,
+                devices, &devicesNum);
+    if (error != CL_SUCCESS)
+    {
+        if (errcodeRet != nullptr)
+            *errcodeRet = error;
+        return nullptr;
+    }
+    return mockCreateContext(properties, devicesNum, devices, pfnNotify, userData,
+                errcodeRet);
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockRetainContext(cl_context context)
+{
+    if (context == nullptr)
+        return CL_INVALID_CONTEXT;
+    static_cast<MockContext*>(context)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockReleaseContext(cl_context context)
+{
+    if (context == nullptr)
+        return CL_INVALID_CONTEXT;
+    MockContext* c = static_cast<MockContext*>(context);
+    if (c->refCount.fetch_sub(1) == 1)
+        delete c;
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockGetContextInfo(cl_context context,
+            cl_context_info paramName, size_t paramValueSize, void* paramValue,
+            size_t* paramValueSizeRet)
+{
+    if (context == nullptr)
+        return CL_INVALID_CONTEXT;
+    const MockContext* c = static_cast<const MockContext*>(context);
+    switch(paramName)
+    {
+        case CL_CONTEXT_REFERENCE_COUNT:
+            return getValueInfo(c->refCount.load(), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_CONTEXT_NUM_DEVICES:
+            return getValueInfo(cl_uint(c->devices.size()), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_CONTEXT_DEVICES:
+            return getInfo(sizeof(cl_device_id)*c->devices.size(), c->devices.data(),
+                        paramValueSize, paramValue, paramValueSizeRet);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static MockProgram* createProgram(MockContext* context, bool fromBinary)
+{
+    MockProgram* program = new MockProgram;
+    program->dispatch = &mockDispatch;
+    program->refCount = 1;
+    program->context = context;
+    program->fromBinary = fromBinary;
+    mockRetainContext(context);
+    return program;
+}
+
+static CL_API_ENTRY cl_program CL_API_CALL mockCreateProgramWithSource(
+            cl_context context, cl_uint count, const char** strings,
+            const size_t* lengths, cl_int* errcodeRet)
+{
+    if (context == nullptr || count == 0 || strings == nullptr)
+    {
+        if (errcodeRet != nullptr)
+            *errcodeRet = (context == nullptr) ? CL_INVALID_CONTEXT : CL_INVALID_VALUE;
+        return nullptr;
+    }
+    MockContext* c = static_cast<MockContext*>(context);
+    MockProgram* program = createProgram(c, false);
+    for (cl_uint i = 0; i < count; i++)
+        program->source.append(strings[i], (lengths != nullptr && lengths[i] != 0) ?
+                    lengths[i] : ::strlen(strings[i]));
+    program->devices = c->devices;
+    program->binaries.resize(c->devices.size());
+    program->statuses.assign(c->devices.size(), CL_BUILD_NONE);
+    if (errcodeRet != nullptr)
+        *errcodeRet = CL_SUCCESS;
+    return program;
+}
+
+static bool isELFBinary(const std::vector<unsigned char>& binary)
+{ return binary.size() >= 4 && ::memcmp(binary.data(), "\177ELF", 4) == 0; }
+
+static CL_API_ENTRY cl_program CL_API_CALL mockCreateProgramWithBinary(
+            cl_context context, cl_uint numDevices, const cl_device_id* devices,
+            const size_t* lengths, const unsigned char** binaries,
+            cl_int* binaryStatus, cl_int* errcodeRet)
+{
+    cl_int error = CL_SUCCESS;
+    if (context == nullptr)
+        error = CL_INVALID_CONTEXT;
+    else if (numDevices == 0 || devices == nullptr || lengths == nullptr ||
+            binaries == nullptr)
+        error = CL_INVALID_VALUE;
+    for (cl_uint i = 0; error == CL_SUCCESS && i < numDevices; i++)
+        if (!isMockDevice(devices[i]))
+            error = CL_INVALID_DEVICE;
+    if (error != CL_SUCCESS)
+    {
+        if (errcodeRet != nullptr)
+            *errcodeRet = error;
+        return nullptr;
+    }
+    MockProgram* program = createProgram(static_cast<MockContext*>(context), true);
+    program->devices.assign(devices, devices + numDevices);
+    program->statuses.assign(numDevices, CL_BUILD_NONE);
+    for (cl_uint i = 0; i < numDevices; i++)
+    {
+        program->binaries.emplace_back(binaries[i], binaries[i] + lengths[i]);
+        if (binaryStatus != nullptr)
+            binaryStatus[i] = isELFBinary(program->binaries.back()) ?
+                    CL_SUCCESS : CL_INVALID_BINARY;
+    }
+    if (errcodeRet != nullptr)
+        *errcodeRet = CL_SUCCESS;
+    return program;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockRetainProgram(cl_program program)
+{
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    static_cast<MockProgram*>(program)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockReleaseProgram(cl_program program)
+{
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    MockProgram* p = static_cast<MockProgram*>(program);
+    if (p->refCount.fetch_sub(1) == 1)
+    {
+        mockReleaseContext(p->context);
+        delete p;
+    }
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockBuildProgram(cl_program program,
+            cl_uint numDevices, const cl_device_id* devices, const char* options,
+            void (CL_CALLBACK* pfnNotify)(cl_program, void*), void* userData)
+{
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    {
+        // wait for opened gate
+        std::unique_lock<std::mutex> lock(buildGateMutex);
+        buildGateCond.wait(lock, []() { return !buildGateClosed; });
+    }
+    buildsNum.fetch_add(1);
+    MockProgram* p = static_cast<MockProgram*>(program);
+    cl_int error = CL_SUCCESS;
+    {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        p->options = (options != nullptr) ? options : "";
+        p->log.clear();
+        for (size_t i = 0; i < p->devices.size(); i++)
+        {
+            if (devices != nullptr && std::find(devices, devices+numDevices,
+                        p->devices[i]) == devices+numDevices)
+                continue;
+            if (p->fromBinary && isELFBinary(p->binaries[i]))
+                p->statuses[i] = CL_BUILD_SUCCESS;
+            else
+            {
+                p->statuses[i] = CL_BUILD_ERROR;
+                p->log = (p->fromBinary) ? "Invalid binary" : "Compiler is not available";
+                error = CL_BUILD_PROGRAM_FAILURE;
+            }
+        }
+    }
+    if (pfnNotify != nullptr)
+        pfnNotify(program, userData);
+    return error;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockGetProgramInfo(cl_program program,
+            cl_program_info paramName, size_t paramValueSize, void* paramValue,
+            size_t* paramValueSizeRet)
+{
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    MockProgram* p = static_cast<MockProgram*>(program);
+    std::lock_guard<std::mutex> lock(p->mutex);
+    switch(paramName)
+    {
+        case CL_PROGRAM_REFERENCE_COUNT:
+            return getValueInfo(p->refCount.load(), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_CONTEXT:
+            return getValueInfo(cl_context(p->context), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_NUM_DEVICES:
+            return getValueInfo(cl_uint(p->devices.size()), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_DEVICES:
+            return getInfo(sizeof(cl_device_id)*p->devices.size(), p->devices.data(),
+                        paramValueSize, paramValue, paramValueSizeRet);
+        case CL_PROGRAM_SOURCE:
+            // program from binaries has no source
+            if (p->fromBinary)
+                return getInfo(0, nullptr, paramValueSize, paramValue,
+                            paramValueSizeRet);
+            return getStringInfo(p->source.c_str(), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_BINARY_SIZES:
+        {
+            std::vector<size_t> sizes;
+            for (size_t i = 0; i < p->devices.size(); i++)
+                sizes.push_back((p->statuses[i] == CL_BUILD_SUCCESS) ?
+                        p->binaries[i].size() : 0);
+            return getInfo(sizeof(size_t)*sizes.size(), sizes.data(), paramValueSize,
+                        paramValue, paramValueSizeRet);
+        }
+        case CL_PROGRAM_BINARIES:
+        {
+            const size_t dataSize = sizeof(unsigned char*)*p->devices.size();
+            if (paramValue != nullptr)
+            {
+                if (paramValueSize < dataSize)
+                    return CL_INVALID_VALUE;
+                unsigned char** outBinaries = static_cast<unsigned char**>(paramValue);
+                for (size_t i = 0; i < p->devices.size(); i++)
+                    if (outBinaries[i] != nullptr && p->statuses[i] == CL_BUILD_SUCCESS)
+                        std::copy(p->binaries[i].begin(), p->binaries[i].end(),
+                                outBinaries[i]);
+            }
+            if (paramValueSizeRet != nullptr)
+                *paramValueSizeRet = dataSize;
+            return CL_SUCCESS;
+        }
+        case CL_PROGRAM_NUM_KERNELS:
+            return getValueInfo(size_t(0), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_KERNEL_NAMES:
+            return getStringInfo("", paramValueSize, paramValue, paramValueSizeRet);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockGetProgramBuildInfo(cl_program program,
+            cl_device_id device, cl_program_build_info paramName, size_t paramValueSize,
+            void* paramValue, size_t* paramValueSizeRet)
+{
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    MockProgram* p = static_cast<MockProgram*>(program);
+    std::lock_guard<std::mutex> lock(p->mutex);
+    const size_t index = std::find(p->devices.begin(), p->devices.end(), device) -
+                p->devices.begin();
+    if (index == p->devices.size())
+        return CL_INVALID_DEVICE;
+    switch(paramName)
+    {
+        case CL_PROGRAM_BUILD_STATUS:
+            return getValueInfo(p->statuses[index], paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_BUILD_OPTIONS:
+            return getStringInfo(p->options.c_str(), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_BUILD_LOG:
+            return getStringInfo(p->log.c_str(), paramValueSize, paramValue,
+                        paramValueSizeRet);
+        case CL_PROGRAM_BINARY_TYPE:
+            return getValueInfo(cl_program_binary_type(
+                    (p->statuses[index] == CL_BUILD_SUCCESS) ?
+                    CL_PROGRAM_BINARY_TYPE_EXECUTABLE : CL_PROGRAM_BINARY_TYPE_NONE),
+                    paramValueSize, paramValue, paramValueSizeRet);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY void* CL_API_CALL mockGetExtensionFunctionAddressForPlatform(
+            cl_platform_id platform, const char* funcName)
+{ return nullptr; }
+
+static std::once_flag mockInitFlag;
+
+static void mockInitialize()
+{
+    mockDispatch.clGetPlatformIDs = mockGetPlatformIDs;
+    mockDispatch.clGetPlatformInfo = mockGetPlatformInfo;
+    mockDispatch.clGetDeviceIDs = mockGetDeviceIDs;
+    mockDispatch.clGetDeviceInfo = mockGetDeviceInfo;
+    mockDispatch.clCreateContext = mockCreateContext;
+    mockDispatch.clCreateContextFromType = mockCreateContextFromType;
+    mockDispatch.clRetainContext = mockRetainContext;
+    mockDispatch.clReleaseContext = mockReleaseContext;
+    mockDispatch.clGetContextInfo = mockGetContextInfo;
+    mockDispatch.clCreateProgramWithSource = mockCreateProgramWithSource;
+    mockDispatch.clCreateProgramWithBinary = mockCreateProgramWithBinary;
+    mockDispatch.clRetainProgram = mockRetainProgram;
+    mockDispatch.clReleaseProgram = mockReleaseProgram;
+    mockDispatch.clBuildProgram = mockBuildProgram;
+    mockDispatch.clGetProgramInfo = mockGetProgramInfo;
+    mockDispatch.clGetProgramBuildInfo = mockGetProgramBuildInfo;
+#ifdef CL_VERSION_1_2
+    mockDispatch.clGetExtensionFunctionAddressForPlatform =
+            mockGetExtensionFunctionAddressForPlatform;
+#endif
+    mockPlatform.dispatch = &mockDispatch;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL mockIcdGetPlatformIDs(cl_uint numEntries,
+            cl_platform_id* platforms, cl_uint* numPlatforms)
+{
+    std::call_once(mockInitFlag, mockInitialize);
+    return mockGetPlatformIDs(numEntries, platforms, numPlatforms);
+}
+
+extern "C"
+{
+
+MOCK_EXPORT CL_API_ENTRY cl_int CL_API_CALL clGetPlatformIDs(cl_uint numEntries,
+            cl_platform_id* platforms, cl_uint* numPlatforms)
+{ return mockIcdGetPlatformIDs(numEntries, platforms, numPlatforms); }
+
+MOCK_EXPORT CL_API_ENTRY void* CL_API_CALL clGetExtensionFunctionAddress(
+            const char* funcName)
+{
+    if (::strcmp(funcName, "clIcdGetPlatformIDsKHR") == 0)
+        return (void*)mockIcdGetPlatformIDs;
+    return nullptr;
+}
+
+/* control of mock from tests */
+
+// close or open build gate (clBuildProgram waits while gate is closed)
+MOCK_EXPORT void mockAmdOclSetBuildGate(int closed)
+{
+    {
+        std::lock_guard<std::mutex> lock(buildGateMutex);
+        buildGateClosed = closed != 0;
+    }
+    buildGateCond.notify_all();
+}
+
+// number of clBuildProgram calls
+MOCK_EXPORT cl_uint mockAmdOclGetBuildsNum()
+{ return buildsNum.load(); }
+
+}
@@ -0,0 +1,99 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* mappedFileNames[] =
+{
+    CLRX_SOURCE_DIR "/tests/amdbin/amdbins/alltypes.clo",
+    CLRX_SOURCE_DIR "/tests/amdbin/amdbins/alltypes.cl",
+    CLRX_SOURCE_DIR "/tests/amdbin/amdbins/alltypes_64.clo"
+};
+
+// compare mapped content with content loaded by loadDataFromFile
+static void testMappedFile(cxuint testId, const char* filename)
+{
+    std::ostringstream oss;
+    oss << "MappedFile#" << testId;
+    const std::string testName = oss.str();
+    const Array<cxbyte> expected = loadDataFromFile(filename);
+    MappedFile mappedFile(filename);
+    assertTrue(testName, "isMapped", mappedFile.isMapped());
+    assertValue(testName, "size", expected.size(), mappedFile.getSize());
+    assertTrue(testName, "content", std::equal(expected.begin(), expected.end(),
+                mappedFile.getData()));
+    // binary parsers works directly on mapped content (copy-on-write)
+    if (isAmdBinary(mappedFile.getSize(), mappedFile.getData()))
+    {
+        std::unique_ptr<AmdMainBinaryBase> base(createAmdBinaryFromCode(
+                mappedFile.getSize(), mappedFile.getData(), AMDBIN_CREATE_KERNELINFO));
+        Array<cxbyte> binCopy(expected);
+        std::unique_ptr<AmdMainBinaryBase> base2(createAmdBinaryFromCode(
+                binCopy.size(), binCopy.data(), AMDBIN_CREATE_KERNELINFO));
+        assertValue(testName, "kernelInfosNum", base2->getKernelInfosNum(),
+                    base->getKernelInfosNum());
+    }
+    mappedFile.close();
+    assertTrue(testName, "closed", mappedFile.getData() == nullptr &&
+                mappedFile.getSize() == 0);
+}
+
+static void testMappedFileErrors()
+{
+    const std::string testName = "MappedFileErrors";
+    // empty file is not mapped but loaded
+    const char* emptyName = "MappedFileEmpty.tmp";
+    FILE* file = fopen(emptyName, "wb");
+    if (file == nullptr)
+        throw Exception("Can't create temporary file");
+    fclose(file);
+    {
+        MappedFile mappedFile(emptyName);
+        assertTrue(testName, "emptyNotMapped", !mappedFile.isMapped());
+        assertValue(testName, "emptySize", size_t(0), mappedFile.getSize());
+    }
+    remove(emptyName);
+
+    assertCLRXException(testName, "directory", "This is directory!",
+            [](){ MappedFile mappedFile(CLRX_SOURCE_DIR "/tests"); });
+    assertCLRXException(testName, "noFile", "File or directory doesn't exists",
+            [](){ MappedFile mappedFile(CLRX_SOURCE_DIR "/tests/xxxxNotExist"); });
+    MappedFile mappedFile(mappedFileNames[0]);
+    assertCLRXException(testName, "reopen", "MappedFile already opened",
+            [&mappedFile](){ mappedFile.open(mappedFileNames[1]); });
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (cxuint i = 0; i < sizeof(mappedFileNames)/sizeof(const char*); i++)
+        retVal |= callTest(testMappedFile, i, mappedFileNames[i]);
+    retVal |= callTest(testMappedFileErrors);
+    return retVal;
+}
@@ -0,0 +1,80 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void testMemoryArena()
+{
+    const std::string testName = "MemoryArena";
+    MemoryArena arena(1024);
+    std::vector<std::pair<cxbyte*, size_t> > allocs;
+    for (size_t i = 0; i < 300; i++)
+    {
+        // mix of small and big (own block) allocations
+        const size_t size = (i % 37 == 0) ? 700 + i : (i*7) % 100 + 1;
+        cxbyte* ptr = reinterpret_cast<cxbyte*>(arena.allocate(size));
+        assertTrue(testName, "aligned", (uintptr_t(ptr) & 15) == 0);
+        ::memset(ptr, int(i&0xff), size);
+        allocs.push_back(std::make_pair(ptr, size));
+    }
+    assertValue(testName, "allocsNum", size_t(300), arena.getAllocationsNum());
+    // check whether any allocation has not been overwritten
+    for (size_t i = 0; i < allocs.size(); i++)
+        for (size_t j = 0; j < allocs[i].second; j++)
+            if (allocs[i].first[j] != cxbyte(i&0xff))
+                throw Exception("Allocation has been overwritten");
+    
+    // release last allocation (LIFO) reuses memory
+    void* ptr1 = arena.allocate(40);
+    arena.release(ptr1, 40);
+    void* ptr2 = arena.allocate(33);
+    assertTrue(testName, "reused", ptr1 == ptr2);
+    // release not last allocation puts it to free list for its size
+    void* ptr3 = arena.allocate(16);
+    arena.release(ptr2, 33);
+    void* ptr4 = arena.allocate(16);
+    assertTrue(testName, "notReused", ptr3 != ptr4 && ptr2 != ptr4);
+    void* ptr6 = arena.allocate(48);
+    assertTrue(testName, "reusedFromFreeList", ptr2 == ptr6);
+    void* ptr7 = arena.allocate(48);
+    assertTrue(testName, "freeListEmpty", ptr7 != ptr2 && ptr7 != ptr6);
+    // big allocations are not reused
+    void* ptr8 = arena.allocate(300);
+    arena.allocate(16);
+    arena.release(ptr8, 300);
+    assertTrue(testName, "bigNotReused", arena.allocate(300) != ptr8);
+    
+    arena.clear();
+    void* ptr5 = arena.allocate(10);
+    assertTrue(testName, "afterClear", ptr5 != nullptr);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testMemoryArena);
+    return retVal;
+}
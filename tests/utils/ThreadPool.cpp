@@ -0,0 +1,97 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <CLRX/Config.h>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+// run jobs and check whether every job is run once by not more threads than given
+static void testThreadPoolCase(size_t jobsNum, cxuint threadsNum, size_t maxThreadsNum)
+{
+    char testName[64];
+    snprintf(testName, 64, "ThreadPool jobs=%zu threads=%u", jobsNum, threadsNum);
+    std::unique_ptr<std::atomic<cxuint>[]> counts(new std::atomic<cxuint>[jobsNum]);
+    for (size_t i = 0; i < jobsNum; i++)
+        counts[i] = 0;
+    std::mutex mutex;
+    std::set<std::thread::id> threadIds;
+    runInThreadPool(jobsNum, threadsNum, [&](size_t i)
+    {
+        counts[i]++;
+        std::lock_guard<std::mutex> lock(mutex);
+        threadIds.insert(std::this_thread::get_id());
+    });
+    for (size_t i = 0; i < jobsNum; i++)
+        assertValue(testName, "jobRunOnce", cxuint(1), cxuint(counts[i]));
+    assertTrue(testName, "threadsNum", threadIds.size() <= maxThreadsNum);
+}
+
+static void testThreadPool()
+{
+    const cxuint hwThreadsNum = std::max(std::thread::hardware_concurrency(), 1U);
+    testThreadPoolCase(0, 0, 0);
+    testThreadPoolCase(1, 0, 1);
+    testThreadPoolCase(3, 0, std::min(size_t(3), size_t(hwThreadsNum)));
+    // more threads than jobs - threads limited to jobs
+    testThreadPoolCase(2, 16, 2);
+    testThreadPoolCase(1000, 4, 4);
+    testThreadPoolCase(1000, 0, hwThreadsNum);
+}
+
+static void testThreadPoolException()
+{
+    const std::string testName = "ThreadPoolException";
+    std::atomic<cxuint> jobsDone(0);
+    bool thrown = false;
+    try
+    {
+        runInThreadPool(100, 4, [&](size_t i)
+        {
+            jobsDone++;
+            if (i == 37)
+                throw Exception("job failed");
+        });
+    }
+    catch(const Exception& ex)
+    {
+        thrown = true;
+        assertString(testName, "message", "job failed", ex.what());
+    }
+    assertTrue(testName, "thrown", thrown);
+    // other jobs are still done
+    assertValue(testName, "jobsDone", cxuint(100), cxuint(jobsDone));
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testThreadPool);
+    retVal |= callTest(testThreadPoolException);
+    return retVal;
+}
@@ -0,0 +1,132 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* benchmark of the floating point literal parsing
+ * usage: cstrtofXBench [LITERALSNUM [REPEATS]] */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+
+using namespace CLRX;
+
+// literals likes in constant tables: different precisions and exponents
+static void generateLiterals(size_t literalsNum, int precision, int maxExp10,
+            std::vector<std::string>& literals)
+{
+    literals.resize(literalsNum);
+    uint32_t state = 0x2468aceU;
+    for (size_t i = 0; i < literalsNum; i++)
+    {
+        state = state*1103515245U + 12345U;
+        const double mant = double(state>>8) / double(1U<<24);
+        state = state*1103515245U + 12345U;
+        const int exp10 = int((state>>8) % (2*maxExp10+1)) - maxExp10;
+        char buf[64];
+        snprintf(buf, 64, "%.*g", precision, (mant+0.1)*std::pow(10.0, exp10));
+        literals[i] = buf;
+    }
+}
+
+template<typename T>
+static double benchmarkParse(const std::vector<std::string>& literals, cxuint repeats,
+            T (*parse)(const char* str, const char* inend, const char*& outend),
+            double& checkSum)
+{
+    double best = 1e100;
+    for (cxuint r = 0; r < repeats; r++)
+    {
+        checkSum = 0.0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const std::string& literal: literals)
+        {
+            const char* outend;
+            checkSum += double(parse(literal.c_str(),
+                    literal.c_str()+literal.size(), outend));
+        }
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end-start).count());
+    }
+    return best*1e9 / literals.size();
+}
+
+static float parseFloat(const char* str, const char* inend, const char*& outend)
+{ return cstrtovCStyle<float>(str, inend, outend); }
+
+static double parseDouble(const char* str, const char* inend, const char*& outend)
+{ return cstrtovCStyle<double>(str, inend, outend); }
+
+static double parseStrtod(const char* str, const char* inend, const char*& outend)
+{
+    char* end;
+    const double v = ::strtod(str, &end);
+    outend = end;
+    return v;
+}
+
+int main(int argc, const char** argv)
+{
+    const size_t literalsNum = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 200000;
+    const cxuint repeats = (argc >= 3) ? strtoul(argv[2], nullptr, 10) : 3;
+    if (literalsNum == 0 || repeats == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    struct LiteralSet
+    {
+        const char* name;
+        int precision;
+        int maxExp10;
+    };
+    const LiteralSet literalSets[] =
+    {
+        { "short (6 digits)", 6, 5 },
+        { "float (9 digits)", 9, 10 },
+        { "double (17 digits)", 17, 20 },
+        { "wide exponents", 9, 35 }
+    };
+    for (const LiteralSet& set: literalSets)
+    {
+        std::vector<std::string> literals;
+        generateLiterals(literalsNum, set.precision, set.maxExp10, literals);
+        double checkFloat, checkDouble, checkStrtod;
+        const double floatTime = benchmarkParse(literals, repeats, parseFloat,
+                    checkFloat);
+        const double doubleTime = benchmarkParse(literals, repeats, parseDouble,
+                    checkDouble);
+        const double strtodTime = benchmarkParse(literals, repeats, parseStrtod,
+                    checkStrtod);
+        std::cout << set.name << ": float: " << floatTime << " ns, double: " <<
+                doubleTime << " ns, strtod: " << strtodTime << " ns" << std::endl;
+        if (checkDouble != checkStrtod)
+        {
+            std::cerr << "Double results differ from strtod!" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
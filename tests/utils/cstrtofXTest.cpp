@@ -21,7 +21,10 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <cmath>
 #include <climits>
 #include <CLRX/utils/Utilities.h>
 
@@ -119,6 +122,76 @@ static void testCStrtofX(cxuint testId, const CStrtofXTestCase& testCase)
     }
 }
 
+struct FXtocstrTestCase
+{
+    FloatType type;
+    uint64_t value;
+    bool scientific;
+    const char* expected;
+};
+
+static const FXtocstrTestCase fXtocstrTestCases[] =
+{
+    { FT_H, 0x3d4c, false, "1.324" },
+    { FT_H, 0x7bff, false, "6.55e+4" },
+    { FT_H, 0x5bff, false, "255.9" },
+    { FT_H, 0x0001, false, "6e-8" },
+    { FT_H, 0x3555, false, "0.3333" },
+    { FT_H, 0xc100, true, "-2.5e+0" },
+    { FT_F, 0x3dcccccd, false, "0.1" },
+    { FT_F, 0x38d1b717, false, "0.0001" },
+    { FT_F, 0x3727c5ac, false, "0.00001" },
+    { FT_F, 0x358637bd, false, "1e-6" },
+    { FT_F, 0x42c80000, false, "100" },
+    { FT_F, 0x42c80000, true, "1e+2" },
+    { FT_F, 0x4b800001, false, "16777218" },
+    { FT_F, 0x4c680cb2, false, "60830408" },
+    { FT_F, 0x4e000004, false, "5.368712e+8" },
+    { FT_F, 0x11110000, false, "1.1438483e-28" },
+    { FT_F, 0x567d0700, false, "6.9551627e+13" },
+    { FT_F, 0x00000011, false, "2.4e-44" },
+    { FT_F, 0x00000001, false, "1e-45" },
+    { FT_F, 0x7f7fffff, false, "3.4028235e+38" },
+    { FT_F, 0xbeaaaaab, false, "-0.33333334" },
+    { FT_D, 0x3fb999999999999aULL, false, "0.1" },
+    { FT_D, 0x3fd5555555555555ULL, false, "0.3333333333333333" },
+    { FT_D, 0x40fe240c9fbe76c9ULL, false, "123456.789" },
+    { FT_D, 0x43b0000000000000ULL, false, "1.152921504606847e+18" },
+    { FT_D, 0x4340000000000001ULL, false, "9007199254740994" },
+    { FT_D, 0x0000000000000001ULL, false, "5e-324" },
+    { FT_D, 0x7fefffffffffffffULL, false, "1.7976931348623157e+308" },
+    { FT_D, 0x44b52d02c7e14af6ULL, false, "1e+23" },
+    { FT_D, 0x3ff0000000000000ULL, true, "1e+0" }
+};
+
+static void testFXtocstr(cxuint testId, const FXtocstrTestCase& testCase)
+{
+    char buf[64];
+    switch (testCase.type)
+    {
+        case FT_H:
+            htocstrCStyle(testCase.value, buf, 64, testCase.scientific);
+            break;
+        case FT_F:
+            fXtocstrCStyle(testCase.value, buf, 64, testCase.scientific, 8, 23);
+            break;
+        case FT_D:
+            fXtocstrCStyle(testCase.value, buf, 64, testCase.scientific, 11, 52);
+            break;
+        default:
+            throw Exception("Unknown type");
+            break;
+    }
+    if (::strcmp(buf, testCase.expected) != 0)
+    {
+        std::ostringstream oss;
+        oss << "Failed fXtocstr for #" << testId << " with value=0x" << std::hex <<
+                testCase.value << ". Result: '" << buf << "'!='" <<
+                testCase.expected << "'";
+        throw Exception(oss.str());
+    }
+}
+
 // testing floating point tripping between conversion from/to string
 static void testTripping(cxuint testId, const CStrtofXTestCase& testCase)
 {
@@ -1388,6 +1461,227 @@ static const CStrtofXTestCase cstrtofXTestCases[] =
             0x4c20000000000001ULL },
 };
 
+/* randomized tests: results are compared with results of the C library strtod/strtof
+ * (that are correctly rounded) and with values before formatting */
+
+static uint64_t randomState = 0x123456789abcdefULL;
+
+static uint64_t nextRandom()
+{
+    // xorshift64*
+    randomState ^= randomState>>12;
+    randomState ^= randomState<<25;
+    randomState ^= randomState>>27;
+    return randomState*2685821657736338717ULL;
+}
+
+// generate random decimal literal (in form, DIGITS.DIGITSeEXP)
+static void generateDecimalLiteral(char* buf, int maxExp10)
+{
+    const cxuint digitsNum = 1 + nextRandom()%20;
+    const cxuint pointPos = nextRandom()%(digitsNum+1);
+    char* p = buf;
+    for (cxuint i = 0; i < digitsNum; i++)
+    {
+        if (i == pointPos)
+            *p++ = '.';
+        // sometimes more zeroes (exact values)
+        *p++ = ((nextRandom()&3) == 0) ? '0' : '0' + nextRandom()%10;
+    }
+    if ((nextRandom()&1) != 0)
+        snprintf(p, 16, "e%d", int(nextRandom()%(2*maxExp10+1)) - maxExp10);
+    else
+        *p = 0;
+}
+
+static float halfToFloat(uint16_t h)
+{
+    const int exponent = (h>>10)&31;
+    const float value = (exponent != 0) ? ldexpf(float(1024 + (h&1023)), exponent-25) :
+            ldexpf(float(h&1023), -24);
+    return (h&0x8000) ? -value : value;
+}
+
+static void throwRandomFailure(const char* typeName, const char* string,
+            uint64_t expected, uint64_t result)
+{
+    std::ostringstream oss;
+    oss << "Failed random test with string='" << string << "' and type=" <<
+            typeName << ". Result: 0x" << std::hex << expected << "!=0x" << result;
+    throw Exception(oss.str());
+}
+
+static void testRandomCStrtofX(cxuint testsNum)
+{
+    char buf[64];
+    const char* end;
+    for (cxuint i = 0; i < testsNum; i++)
+    {
+        // random double values with shortest and random precision
+        DoubleUnion dv;
+        do {
+            dv.u = nextRandom();
+        } while (((dv.u>>52)&0x7ff) == 0x7ff);
+        snprintf(buf, 64, "%.17g", dv.d);
+        DoubleUnion result;
+        result.d = cstrtovCStyle<double>(buf, buf+::strlen(buf), end);
+        if (result.u != dv.u)
+            throwRandomFailure("double", buf, dv.u, result.u);
+        snprintf(buf, 64, "%.*g", int(1+nextRandom()%17), dv.d);
+        dv.d = strtod(buf, nullptr);
+        if (std::isinf(dv.d))
+            continue;
+        result.d = cstrtovCStyle<double>(buf, buf+::strlen(buf), end);
+        if (result.u != dv.u)
+            throwRandomFailure("double", buf, dv.u, result.u);
+    }
+    for (cxuint i = 0; i < testsNum; i++)
+    {
+        // random float values with shortest and random precision
+        FloatUnion fv;
+        do {
+            fv.u = nextRandom();
+        } while (((fv.u>>23)&0xff) == 0xff);
+        snprintf(buf, 64, "%.9g", fv.f);
+        FloatUnion result;
+        result.f = cstrtovCStyle<float>(buf, buf+::strlen(buf), end);
+        if (result.u != fv.u)
+            throwRandomFailure("float", buf, fv.u, result.u);
+        snprintf(buf, 64, "%.*g", int(1+nextRandom()%9), fv.f);
+        fv.f = strtof(buf, nullptr);
+        if (std::isinf(fv.f))
+            continue;
+        result.f = cstrtovCStyle<float>(buf, buf+::strlen(buf), end);
+        if (result.u != fv.u)
+            throwRandomFailure("float", buf, fv.u, result.u);
+    }
+    for (cxuint i = 0; i < testsNum; i++)
+    {
+        // random decimal literals (many digits, zeroes, small exponents)
+        generateDecimalLiteral(buf, 40);
+        DoubleUnion dv, dresult;
+        dv.d = strtod(buf, nullptr);
+        dresult.d = cstrtovCStyle<double>(buf, buf+::strlen(buf), end);
+        if (dresult.u != dv.u)
+            throwRandomFailure("double", buf, dv.u, dresult.u);
+        FloatUnion fv, fresult;
+        fv.f = strtof(buf, nullptr);
+        if (std::isinf(fv.f))
+            continue;
+        fresult.f = cstrtovCStyle<float>(buf, buf+::strlen(buf), end);
+        if (fresult.u != fv.u)
+            throwRandomFailure("float", buf, fv.u, fresult.u);
+    }
+    for (cxuint i = 0; i < testsNum; i++)
+    {
+        // random half values
+        uint16_t hv;
+        do {
+            hv = nextRandom();
+        } while (((hv>>10)&31) == 31);
+        snprintf(buf, 64, "%.5g", halfToFloat(hv));
+        const uint16_t result = cstrtohCStyle(buf, buf+::strlen(buf), end);
+        if (result != hv)
+            throwRandomFailure("half", buf, hv, result);
+    }
+}
+
+// number of significant digits in scientific form (D.DDDe+X)
+static cxuint sciDigitsNum(const char* str)
+{
+    cxuint digitsNum = 0;
+    for (; *str != 'e' && *str != 0; str++)
+        if (*str >= '0' && *str <= '9')
+            digitsNum++;
+    return digitsNum;
+}
+
+/* random values formatted by fXtocstrCStyle must be parsed back bit-exactly and
+ * must be not longer than shortest representation that found by libc */
+static void testRandomFXtocstr(cxuint testsNum)
+{
+    char buf[64], buf2[64];
+    const char* end;
+    for (cxuint i = 0; i < testsNum; i++)
+    {
+        DoubleUnion dv, result;
+        do {
+            dv.u = nextRandom();
+            if ((i&3) == 0) // powers of two and near them
+                dv.u &= 0xfff000000000000fULL;
+        } while (((dv.u>>52)&0x7ff) == 0x7ff);
+        for (bool scientific: { false, true })
+        {
+            dtocstrCStyle(dv.d, buf, 64, scientific);
+            result.d = cstrtovCStyle<double>(buf, buf+::strlen(buf), end);
+            if (result.u != dv.u)
+                throwRandomFailure("double", buf, dv.u, result.u);
+        }
+        cxuint precision = 1;
+        for (; precision < 17; precision++)
+        {
+            snprintf(buf2, 64, "%.*e", precision-1, dv.d);
+            if (strtod(buf2, nullptr) == dv.d)
+                break;
+        }
+        if (sciDigitsNum(buf) > precision)
+            throwRandomFailure("double(shortest)", buf, dv.u, result.u);
+    }
+    for (cxuint i = 0; i < testsNum; i++)
+    {
+        FloatUnion fv, result;
+        do {
+            fv.u = nextRandom();
+            if ((i&3) == 0) // powers of two and near them
+                fv.u &= 0xff800007U;
+        } while (((fv.u>>23)&0xff) == 0xff);
+        for (bool scientific: { false, true })
+        {
+            ftocstrCStyle(fv.f, buf, 64, scientific);
+            result.f = cstrtovCStyle<float>(buf, buf+::strlen(buf), end);
+            if (result.u != fv.u)
+                throwRandomFailure("float", buf, fv.u, result.u);
+        }
+        cxuint precision = 1;
+        for (; precision < 9; precision++)
+        {
+            snprintf(buf2, 64, "%.*e", precision-1, fv.f);
+            if (strtof(buf2, nullptr) == fv.f)
+                break;
+        }
+        if (sciDigitsNum(buf) > precision)
+            throwRandomFailure("float(shortest)", buf, fv.u, result.u);
+    }
+    // all half values
+    for (cxuint hv = 0; hv < 0x10000; hv++)
+    {
+        if (((hv>>10)&31) == 31)
+            continue;
+        for (bool scientific: { false, true })
+        {
+            htocstrCStyle(hv, buf, 64, scientific);
+            const uint16_t result = cstrtohCStyle(buf, buf+::strlen(buf), end);
+            if (result != hv)
+                throwRandomFailure("half", buf, hv, result);
+        }
+        cxuint precision = 1;
+        for (; precision < 5; precision++)
+        {
+            snprintf(buf2, 64, "%.*e", precision-1, halfToFloat(hv));
+            try
+            {
+                if (cstrtohCStyle(buf2, buf2+::strlen(buf2), end) == hv)
+                    break;
+            }
+            catch(const ParseException& ex)
+            { } // if rounded value is too big
+
+        }
+        if (sciDigitsNum(buf) > precision)
+            throwRandomFailure("half(shortest)", buf, hv, hv);
+    }
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -1407,5 +1701,27 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    try
+    { testRandomCStrtofX(200000); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    for (cxuint i = 0; i < sizeof(fXtocstrTestCases)/sizeof(FXtocstrTestCase); i++)
+        try
+        { testFXtocstr(i, fXtocstrTestCases[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    try
+    { testRandomFXtocstr(100000); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
     return retVal;
 }
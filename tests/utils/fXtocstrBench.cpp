@@ -0,0 +1,103 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2017 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* benchmark of the floating point value formatting
+ * usage: fXtocstrBench [VALUESNUM [REPEATS]] */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+
+using namespace CLRX;
+
+// random bit patterns (without infinities and nans)
+static void generateValues(size_t valuesNum, cxuint expBits, cxuint mantisaBits,
+            std::vector<uint64_t>& values)
+{
+    values.resize(valuesNum);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    const uint64_t mask = (1ULL<<(expBits+mantisaBits))-1U;
+    const uint64_t expMask = (1ULL<<expBits)-1U;
+    for (size_t i = 0; i < valuesNum; )
+    {
+        state ^= state<<13;
+        state ^= state>>7;
+        state ^= state<<17;
+        if (((state>>mantisaBits) & expMask) != expMask)
+            values[i++] = state & mask;
+    }
+}
+
+static double benchmarkFormat(const std::vector<uint64_t>& values, cxuint repeats,
+            cxuint expBits, cxuint mantisaBits, size_t& checkSum)
+{
+    double best = 1e100;
+    for (cxuint r = 0; r < repeats; r++)
+    {
+        checkSum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t value: values)
+        {
+            char buf[40];
+            checkSum += fXtocstrCStyle(value, buf, 40, false, expBits, mantisaBits);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end-start).count());
+    }
+    return best*1e9 / values.size();
+}
+
+int main(int argc, const char** argv)
+{
+    const size_t valuesNum = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 200000;
+    const cxuint repeats = (argc >= 3) ? strtoul(argv[2], nullptr, 10) : 3;
+    if (valuesNum == 0 || repeats == 0)
+    {
+        std::cerr << "Wrong parameters" << std::endl;
+        return 1;
+    }
+    struct FormatSet
+    {
+        const char* name;
+        cxuint expBits;
+        cxuint mantisaBits;
+    };
+    const FormatSet formatSets[] =
+    {
+        { "half", 5, 10 },
+        { "float", 8, 23 },
+        { "double", 11, 52 }
+    };
+    for (const FormatSet& set: formatSets)
+    {
+        std::vector<uint64_t> values;
+        generateValues(valuesNum, set.expBits, set.mantisaBits, values);
+        size_t checkSum;
+        const double time = benchmarkFormat(values, repeats, set.expBits,
+                    set.mantisaBits, checkSum);
+        std::cout << set.name << ": " << time << " ns, average length: " <<
+                double(checkSum) / values.size() << std::endl;
+    }
+    return 0;
+}
@@ -36,6 +36,7 @@
 #include <cstdlib>
 #endif
 #include <climits>
+#include <cfloat>
 #include <cstddef>
 #include <CLRX/utils/Utilities.h>
 
@@ -782,6 +783,113 @@ static const uint64_t power10sTable[20] =
     10000000000000000000ULL
 };
 
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#  define CSTRTOFX_FAST_PATH 1
+
+/// exact powers of 10 in double precision
+static const double exactPower10sTable[23] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Clinger's fast path: if decimal mantisa and power of 10 are exactly representable
+ * in double precision, then single multiplication or division gives correctly rounded
+ * double value. Smaller formats are rounded from that double value, and that double
+ * rounding is correct except when double value lies exactly at half between two
+ * values of smaller format. digits are parsed in single pass.
+ * returns false if value can not be determined by this way (for example, value is
+ * denormalized in destination format), then value must be parsed by exact method */
+static bool cstrtofXFastPath(const char* p, const char* inend, const char*& outend,
+            cxuint expBits, cxuint mantisaBits, uint64_t& out)
+{
+    if (expBits > 11 || mantisaBits > 52)
+        return false;
+    uint64_t value = 0;
+    cxint digitsNum = 0; // significant digits
+    int64_t exp10 = 0;
+    bool haveDigits = false;
+    for (; p != inend && isDigit(*p); p++)
+    {
+        haveDigits = true;
+        if (value != 0 || *p != '0')
+        {
+            if (++digitsNum > 19)
+                return false; // too many digits
+            value = value*10 + *p-'0';
+        }
+    }
+    if (p != inend && *p == '.')
+        for (p++; p != inend && isDigit(*p); p++)
+        {
+            haveDigits = true;
+            exp10--;
+            if (value != 0 || *p != '0')
+            {
+                if (++digitsNum > 19)
+                    return false; // too many digits
+                value = value*10 + *p-'0';
+            }
+        }
+    if (!haveDigits)
+        return false;
+    if (p != inend && (*p == 'e' || *p == 'E')) // we found exponent
+    {
+        p++;
+        outend = p; // set out end
+        if (p == inend)
+            throw ParseException("End of floating point at exponent");
+        exp10 += parseFloatExponent(outend, inend);
+    }
+    else
+        outend = p;
+    
+    if (value == 0 || value > (1ULL<<53) || exp10 < -22 || exp10 > 22)
+        return false;
+    union
+    {
+        double d;
+        uint64_t u;
+    } dv;
+    dv.d = double(value);
+    if (exp10 < 0)
+        dv.d /= exactPower10sTable[-exp10];
+    else
+        dv.d *= exactPower10sTable[exp10];
+    
+    // value is always normalized double
+    cxint exponent = cxint((dv.u>>52) & 0x7ff) - 1023;
+    const cxint minExpNonDenorm = -((1U<<(expBits-1))-2);
+    const cxint maxExp = (1U<<(expBits-1))-1;
+    if (exponent < minExpNonDenorm || exponent > maxExp)
+        return false;
+    uint64_t fpMantisa = dv.u & ((1ULL<<52)-1ULL);
+    const cxuint shift = 52-mantisaBits;
+    if (shift != 0)
+    {
+        // round to nearest
+        const uint64_t half = 1ULL<<(shift-1);
+        const uint64_t subValue = fpMantisa & ((1ULL<<shift)-1ULL);
+        if (subValue == half)
+            return false; // exact half, rounding can be wrong
+        fpMantisa >>= shift;
+        if (subValue > half)
+        {
+            fpMantisa++;
+            // check promotion to next exponent
+            if (fpMantisa == (1ULL<<mantisaBits))
+            {
+                fpMantisa = 0;
+                if (++exponent > maxExp)
+                    return false;
+            }
+        }
+    }
+    out |= fpMantisa | (uint64_t(exponent+maxExp)<<mantisaBits);
+    return true;
+}
+#endif
+
 #ifdef CSTRTOFX_DUMP_IRRESULTS
 static void dumpIntermediateResults(cxuint bigSize, const uint64_t* bigValue,
         const uint64_t* bigRescaled, cxint binaryExp, cxint powerof5, cxuint maxDigits,
@@ -1017,6 +1125,10 @@ uint64_t CLRX::cstrtofXCStyle(const char* str, const char* inend,
     else
     {
         // in decimal format
+#ifdef CSTRTOFX_FAST_PATH
+        if (cstrtofXFastPath(p, inend, outend, expBits, mantisaBits, out))
+            return out;
+#endif
         cxint decimalExp = 0;
         const char* expstr = p;
         bool comma = false;
@@ -1525,6 +1637,397 @@ uint64_t CLRX::cstrtofXCStyle(const char* str, const char* inend,
     return out;
 }
 
+/*
+ * shortest representation of floating point value (for fXtocstrCStyle)
+ */
+
+struct CLRX_INTERNAL CachedPow10Entry
+{
+    uint64_t significand;
+    int16_t binaryExp;
+    int16_t decimalExp;
+};
+
+/* normalized powers of 10 (rounded to nearest) from 10^-348 to 10^340 with step 8,
+ * used by Grisu3 algorithm */
+static const CachedPow10Entry cachedPow10sTable[87] =
+{
+    { 0xfa8fd5a0081c0288ULL, -1220, -348 },
+    { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+    { 0x8b16fb203055ac76ULL, -1166, -332 },
+    { 0xcf42894a5dce35eaULL, -1140, -324 },
+    { 0x9a6bb0aa55653b2dULL, -1113, -316 },
+    { 0xe61acf033d1a45dfULL, -1087, -308 },
+    { 0xab70fe17c79ac6caULL, -1060, -300 },
+    { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+    { 0xbe5691ef416bd60cULL, -1007, -284 },
+    { 0x8dd01fad907ffc3cULL, -980, -276 },
+    { 0xd3515c2831559a83ULL, -954, -268 },
+    { 0x9d71ac8fada6c9b5ULL, -927, -260 },
+    { 0xea9c227723ee8bcbULL, -901, -252 },
+    { 0xaecc49914078536dULL, -874, -244 },
+    { 0x823c12795db6ce57ULL, -847, -236 },
+    { 0xc21094364dfb5637ULL, -821, -228 },
+    { 0x9096ea6f3848984fULL, -794, -220 },
+    { 0xd77485cb25823ac7ULL, -768, -212 },
+    { 0xa086cfcd97bf97f4ULL, -741, -204 },
+    { 0xef340a98172aace5ULL, -715, -196 },
+    { 0xb23867fb2a35b28eULL, -688, -188 },
+    { 0x84c8d4dfd2c63f3bULL, -661, -180 },
+    { 0xc5dd44271ad3cdbaULL, -635, -172 },
+    { 0x936b9fcebb25c996ULL, -608, -164 },
+    { 0xdbac6c247d62a584ULL, -582, -156 },
+    { 0xa3ab66580d5fdaf6ULL, -555, -148 },
+    { 0xf3e2f893dec3f126ULL, -529, -140 },
+    { 0xb5b5ada8aaff80b8ULL, -502, -132 },
+    { 0x87625f056c7c4a8bULL, -475, -124 },
+    { 0xc9bcff6034c13053ULL, -449, -116 },
+    { 0x964e858c91ba2655ULL, -422, -108 },
+    { 0xdff9772470297ebdULL, -396, -100 },
+    { 0xa6dfbd9fb8e5b88fULL, -369, -92 },
+    { 0xf8a95fcf88747d94ULL, -343, -84 },
+    { 0xb94470938fa89bcfULL, -316, -76 },
+    { 0x8a08f0f8bf0f156bULL, -289, -68 },
+    { 0xcdb02555653131b6ULL, -263, -60 },
+    { 0x993fe2c6d07b7facULL, -236, -52 },
+    { 0xe45c10c42a2b3b06ULL, -210, -44 },
+    { 0xaa242499697392d3ULL, -183, -36 },
+    { 0xfd87b5f28300ca0eULL, -157, -28 },
+    { 0xbce5086492111aebULL, -130, -20 },
+    { 0x8cbccc096f5088ccULL, -103, -12 },
+    { 0xd1b71758e219652cULL, -77, -4 },
+    { 0x9c40000000000000ULL, -50, 4 },
+    { 0xe8d4a51000000000ULL, -24, 12 },
+    { 0xad78ebc5ac620000ULL, 3, 20 },
+    { 0x813f3978f8940984ULL, 30, 28 },
+    { 0xc097ce7bc90715b3ULL, 56, 36 },
+    { 0x8f7e32ce7bea5c70ULL, 83, 44 },
+    { 0xd5d238a4abe98068ULL, 109, 52 },
+    { 0x9f4f2726179a2245ULL, 136, 60 },
+    { 0xed63a231d4c4fb27ULL, 162, 68 },
+    { 0xb0de65388cc8ada8ULL, 189, 76 },
+    { 0x83c7088e1aab65dbULL, 216, 84 },
+    { 0xc45d1df942711d9aULL, 242, 92 },
+    { 0x924d692ca61be758ULL, 269, 100 },
+    { 0xda01ee641a708deaULL, 295, 108 },
+    { 0xa26da3999aef774aULL, 322, 116 },
+    { 0xf209787bb47d6b85ULL, 348, 124 },
+    { 0xb454e4a179dd1877ULL, 375, 132 },
+    { 0x865b86925b9bc5c2ULL, 402, 140 },
+    { 0xc83553c5c8965d3dULL, 428, 148 },
+    { 0x952ab45cfa97a0b3ULL, 455, 156 },
+    { 0xde469fbd99a05fe3ULL, 481, 164 },
+    { 0xa59bc234db398c25ULL, 508, 172 },
+    { 0xf6c69a72a3989f5cULL, 534, 180 },
+    { 0xb7dcbf5354e9beceULL, 561, 188 },
+    { 0x88fcf317f22241e2ULL, 588, 196 },
+    { 0xcc20ce9bd35c78a5ULL, 614, 204 },
+    { 0x98165af37b2153dfULL, 641, 212 },
+    { 0xe2a0b5dc971f303aULL, 667, 220 },
+    { 0xa8d9d1535ce3b396ULL, 694, 228 },
+    { 0xfb9b7cd9a4a7443cULL, 720, 236 },
+    { 0xbb764c4ca7a44410ULL, 747, 244 },
+    { 0x8bab8eefb6409c1aULL, 774, 252 },
+    { 0xd01fef10a657842cULL, 800, 260 },
+    { 0x9b10a4e5e9913129ULL, 827, 268 },
+    { 0xe7109bfba19c0c9dULL, 853, 276 },
+    { 0xac2820d9623bf429ULL, 880, 284 },
+    { 0x80444b5e7aa7cf85ULL, 907, 292 },
+    { 0xbf21e44003acdd2dULL, 933, 300 },
+    { 0x8e679c2f5e44ff8fULL, 960, 308 },
+    { 0xd433179d9c8cb841ULL, 986, 316 },
+    { 0x9e19db92b4e31ba9ULL, 1013, 324 },
+    { 0xeb96bf6ebadf77d9ULL, 1039, 332 },
+    { 0xaf87023b9bf0ee6bULL, 1066, 340 }
+};
+
+/// floating point value in form: f*2^e (without hidden bit)
+struct CLRX_INTERNAL DiyFp
+{
+    uint64_t f;
+    cxint e;
+};
+
+static inline DiyFp diyFpNormalize(const DiyFp& v)
+{
+    const cxuint shift = CLZ64(v.f);
+    return { v.f<<shift, v.e-cxint(shift) };
+}
+
+// multiply and round to nearest 64 higher bits
+static inline DiyFp diyFpMul(const DiyFp& a, const DiyFp& b)
+{
+    uint64_t c[2];
+    mul64Full(a.f, b.f, c);
+    return { c[1] + (c[0]>>63), a.e + b.e + 64 };
+}
+
+/* round last digit towards value (Grisu3 weeding). returns false if result can not be
+ * proven as correct and as closest shortest representation */
+static bool grisuRoundWeed(char* digits, cxuint digitsNum, uint64_t distTooHighW,
+            uint64_t unsafeInterval, uint64_t rest, uint64_t tenKappa, uint64_t unit)
+{
+    const uint64_t smallDist = distTooHighW - unit;
+    const uint64_t bigDist = distTooHighW + unit;
+    while (rest < smallDist && unsafeInterval - rest >= tenKappa &&
+           (rest + tenKappa < smallDist ||
+            smallDist - rest >= rest + tenKappa - smallDist))
+    {
+        digits[digitsNum-1]--;
+        rest += tenKappa;
+    }
+    if (rest < bigDist && unsafeInterval - rest >= tenKappa &&
+        (rest + tenKappa < bigDist || bigDist - rest > rest + tenKappa - bigDist))
+        return false;
+    return (2*unit <= rest) && (rest <= unsafeInterval - 4*unit);
+}
+
+/* generate digits from high boundary until the rest will be inside unsafe interval.
+ * low, w and high must have same exponent in range -60..-32 */
+static bool grisuDigitGen(const DiyFp& low, const DiyFp& w, const DiyFp& high,
+            char* digits, cxuint& digitsNum, cxint& kappa)
+{
+    uint64_t unit = 1;
+    const uint64_t tooLow = low.f - unit;
+    const uint64_t tooHigh = high.f + unit;
+    uint64_t unsafeInterval = tooHigh - tooLow;
+    const cxuint oneShift = -w.e;
+    const uint64_t oneMask = (1ULL<<oneShift)-1U;
+    uint32_t integrals = tooHigh >> oneShift;
+    uint64_t fractionals = tooHigh & oneMask;
+    
+    // split integrals to digits (constant divisions are faster)
+    cxbyte intDigits[10];
+    cxuint intDigitsNum = 0;
+    for (uint32_t tmp = integrals; tmp != 0; tmp /= 10)
+        intDigits[intDigitsNum++] = tmp%10;
+    
+    digitsNum = 0;
+    for (kappa = intDigitsNum; kappa > 0; )
+    {
+        const uint32_t digit = intDigits[--kappa];
+        const uint64_t divisor = power10sTable[kappa];
+        digits[digitsNum++] = '0' + digit;
+        integrals -= digit*divisor;
+        const uint64_t rest = (uint64_t(integrals)<<oneShift) + fractionals;
+        if (rest < unsafeInterval)
+            return grisuRoundWeed(digits, digitsNum, tooHigh - w.f, unsafeInterval,
+                        rest, divisor<<oneShift, unit);
+    }
+    while (digitsNum < 20)
+    {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        digits[digitsNum++] = '0' + (fractionals >> oneShift);
+        fractionals &= oneMask;
+        kappa--;
+        if (fractionals < unsafeInterval)
+            return grisuRoundWeed(digits, digitsNum, (tooHigh - w.f)*unit,
+                        unsafeInterval, fractionals, 1ULL<<oneShift, unit);
+    }
+    return false;
+}
+
+/* generate shortest digits of mantisa*2^binExp by Grisu3 algorithm. lowerCloser - if
+ * lower boundary is closer (power of two). decExp - decimal exponent of last digit.
+ * returns false if algorithm fails (rarely for double precision) */
+static bool fXShortestDigitsGrisu(uint64_t mantisa, cxint binExp, bool lowerCloser,
+            char* digits, cxuint& digitsNum, cxint& decExp)
+{
+    const DiyFp w = diyFpNormalize({ mantisa, binExp });
+    // boundaries (halfway to neighbours), mPlus have same exponent as w
+    const DiyFp mPlus = diyFpNormalize({ (mantisa<<1)+1, binExp-1 });
+    DiyFp mMinus = lowerCloser ? DiyFp{ (mantisa<<2)-1, binExp-2 } :
+                DiyFp{ (mantisa<<1)-1, binExp-1 };
+    mMinus.f <<= mMinus.e - mPlus.e;
+    mMinus.e = mPlus.e;
+    
+    // choose cached power, scaled exponent should be in range -60..-32
+    const cxint k = log2ByLog10Ceil(-60 - (w.e + 64) + 63);
+    const CachedPow10Entry& cached = cachedPow10sTable[(348 + k - 1) / 8 + 1];
+    const DiyFp cachedPow = { cached.significand, cached.binaryExp };
+    const DiyFp scaledW = diyFpMul(w, cachedPow);
+    if (scaledW.e < -60 || scaledW.e > -32)
+        return false;
+    cxint kappa;
+    if (!grisuDigitGen(diyFpMul(mMinus, cachedPow), scaledW, diyFpMul(mPlus, cachedPow),
+                digits, digitsNum, kappa))
+        return false;
+    decExp = kappa - cached.decimalExp;
+    return true;
+}
+
+/* simple big number for exact shortest digits generation */
+struct CLRX_INTERNAL FXBigNum
+{
+    cxuint size;
+    uint64_t d[24];
+};
+
+static inline void fxBigSet(FXBigNum& a, uint64_t v)
+{
+    a.d[0] = v;
+    a.size = (v != 0);
+}
+
+static void fxBigShiftLeft(FXBigNum& a, cxuint shift)
+{
+    if (a.size == 0)
+        return;
+    const cxuint words = shift>>6;
+    const cxuint bits = shift&63;
+    a.d[a.size] = 0;
+    for (cxuint i = a.size+1; i > 0; i--)
+    {
+        uint64_t v = a.d[i-1]<<bits;
+        if (bits != 0 && i > 1)
+            v |= a.d[i-2]>>(64-bits);
+        a.d[i-1+words] = v;
+    }
+    std::fill(a.d, a.d+words, uint64_t(0));
+    a.size += words+1;
+    if (a.d[a.size-1] == 0)
+        a.size--;
+}
+
+static void fxBigMulSmall(FXBigNum& a, uint64_t m)
+{
+    uint64_t carry = 0;
+    for (cxuint i = 0; i < a.size; i++)
+    {
+        uint64_t prod[2];
+        mul64Full(a.d[i], m, prod);
+        prod[0] += carry;
+        a.d[i] = prod[0];
+        carry = prod[1] + (prod[0] < carry);
+    }
+    if (carry != 0)
+        a.d[a.size++] = carry;
+}
+
+static void fxBigMulPow10(FXBigNum& a, cxuint power)
+{
+    for (; power >= 19; power -= 19)
+        fxBigMulSmall(a, power10sTable[19]);
+    if (power != 0)
+        fxBigMulSmall(a, power10sTable[power]);
+}
+
+static int fxBigCompare(const FXBigNum& a, const FXBigNum& b)
+{
+    if (a.size != b.size)
+        return a.size < b.size ? -1 : 1;
+    for (cxuint i = a.size; i > 0; i--)
+        if (a.d[i-1] != b.d[i-1])
+            return a.d[i-1] < b.d[i-1] ? -1 : 1;
+    return 0;
+}
+
+// c = a + b
+static void fxBigAdd(FXBigNum& c, const FXBigNum& a, const FXBigNum& b)
+{
+    const FXBigNum& bigger = (a.size >= b.size) ? a : b;
+    const FXBigNum& smaller = (a.size >= b.size) ? b : a;
+    c.size = bigger.size;
+    std::copy(bigger.d, bigger.d+bigger.size, c.d);
+    if (bigAdd(c.size, c.d, smaller.size, smaller.d))
+        c.d[c.size++] = 1;
+}
+
+// a = a - b (a >= b)
+static void fxBigSub(FXBigNum& a, const FXBigNum& b)
+{
+    bigSub(a.size, a.d, b.size, b.d);
+    while (a.size != 0 && a.d[a.size-1] == 0)
+        a.size--;
+}
+
+/* generate shortest digits of mantisa*2^binExp by exact method (Steele-White, Dragon4)
+ * used if Grisu3 fails. digits are closest to value and inside rounding interval.
+ * boundaries are included for even mantisa (round half to even in cstrtofXCStyle) */
+static void fXShortestDigitsExact(uint64_t mantisa, cxint binExp, bool lowerCloser,
+            char* digits, cxuint& digitsNum, cxint& decExp)
+{
+    /* value = r/s, mPlus/s and mMinus/s - distances to boundaries
+     * (halfway to neighbours) */
+    FXBigNum r, s, mPlus, mMinus, high;
+    const int inclusive = (mantisa&1)==0;
+    fxBigSet(r, mantisa<<(lowerCloser ? 2 : 1));
+    fxBigSet(s, lowerCloser ? 4 : 2);
+    fxBigSet(mPlus, lowerCloser ? 2 : 1);
+    fxBigSet(mMinus, 1);
+    if (binExp >= 0)
+    {
+        fxBigShiftLeft(r, binExp);
+        fxBigShiftLeft(mPlus, binExp);
+        fxBigShiftLeft(mMinus, binExp);
+    }
+    else
+        fxBigShiftLeft(s, -binExp);
+    
+    // estimate k: 10^(k-1) < high boundary <= 10^k
+    cxint k = log2ByLog10Floor(binExp + 63 - CLZ64(mantisa)) + 1;
+    if (k >= 0)
+        fxBigMulPow10(s, k);
+    else
+    {
+        fxBigMulPow10(r, -k);
+        fxBigMulPow10(mPlus, -k);
+        fxBigMulPow10(mMinus, -k);
+    }
+    // fix estimation
+    while (true)
+    {
+        fxBigAdd(high, r, mPlus);
+        if (fxBigCompare(high, s) < 1-inclusive)
+            break;
+        fxBigMulSmall(s, 10);
+        k++;
+    }
+    while (true)
+    {
+        fxBigAdd(high, r, mPlus);
+        fxBigMulSmall(high, 10);
+        if (fxBigCompare(high, s) > -inclusive)
+            break;
+        fxBigMulSmall(r, 10);
+        fxBigMulSmall(mPlus, 10);
+        fxBigMulSmall(mMinus, 10);
+        k--;
+    }
+    
+    digitsNum = 0;
+    while (true)
+    {
+        fxBigMulSmall(r, 10);
+        fxBigMulSmall(mPlus, 10);
+        fxBigMulSmall(mMinus, 10);
+        cxuint digit = 0;
+        for (; fxBigCompare(r, s) >= 0; digit++)
+            fxBigSub(r, s);
+        // check whether digits or digits+1 is inside rounding interval
+        const bool inLow = fxBigCompare(r, mMinus) < inclusive;
+        fxBigAdd(high, r, mPlus);
+        const bool inHigh = fxBigCompare(high, s) > -inclusive;
+        if (inLow && inHigh)
+        {
+            // choose closer to value (even digit if tie)
+            FXBigNum r2;
+            fxBigAdd(r2, r, r);
+            const int cmp = fxBigCompare(r2, s);
+            if (cmp > 0 || (cmp == 0 && (digit&1) != 0))
+                digit++;
+        }
+        else if (inHigh)
+            digit++;
+        digits[digitsNum++] = '0' + digit;
+        if (inLow || inHigh)
+            break;
+    }
+    decExp = k - digitsNum;
+}
+
 size_t CLRX::fXtocstrCStyle(uint64_t value, char* str, size_t maxSize,
         bool scientific, cxuint expBits, cxuint mantisaBits)
 {
@@ -1591,15 +2094,8 @@ size_t CLRX::fXtocstrCStyle(uint64_t value, char* str, size_t maxSize,
         return p-str;
     }
     
-    cxuint significantBits = 0;
     if (binaryExp >= minExpNonDenorm)
-    {
-        /* normalized value */
-        significantBits = mantisaBits;
-        mantisa |= 1ULL<<mantisaBits;
-    }
-    else /* if value is denormalized */
-        significantBits = 63 - CLZ64(mantisa);
+        mantisa |= 1ULL<<mantisaBits; // normalized value
     
     /* binExpOfValue - exponent for binaryValue (in integer form).
      * binaryExp - mantisaBits - for normalized values
@@ -1607,133 +2103,30 @@ size_t CLRX::fXtocstrCStyle(uint64_t value, char* str, size_t maxSize,
      *   denormalized value is in fraction part (mantisa) binaryExp is -expMask/2.
      */
     const int binExpOfValue = binaryExp-mantisaBits+(binaryExp < minExpNonDenorm);
-    // decimal exponent for value plus one for extraneous digit
-    const int decExpOfValue = log2ByLog10Round(binExpOfValue)-1;
-    // binary exponent for
-    const int reqBinExpOfValue = log10ByLog2Floor(decExpOfValue);
-    const cxuint mantisaShift = (62-significantBits);
-    mantisa = mantisa<<mantisaShift;
+    // lower boundary is closer if value is power of two (except smallest normalized)
+    const bool lowerCloser = (value&mantisaMask)==0 && binaryExp > minExpNonDenorm;
     
-    cxuint oneBitPos = mantisaShift - (binExpOfValue-reqBinExpOfValue);
+    /* print without exponent if integer part of value fits to precision of format
+     * (decimal exponent of value is less than 2 + number of mantisa digits) */
+    const bool positional = !scientific && log2ByLog10Round(binExpOfValue) <= 1;
     
-    uint64_t pow5[2];
-    uint64_t rescaled[4];
-    cxuint powSize;
-    cxint pow5Exp;
-    // generate rescaled value
-    if (decExpOfValue != 0)
-    {
-        const uint64_t inMantisa[2] = { 0, mantisa };
-        bigPow5(-decExpOfValue, 2, powSize, pow5Exp, pow5);
-        bigMul(powSize, pow5, 2, inMantisa, rescaled);
-        rescaled[powSize+1] += mantisa;
-        oneBitPos++;
-    }
-    else
-    {
-        /* if one */
-        powSize = 1;
-        pow5[0] = 0;
-        rescaled[0] = rescaled[1] = 0;
-        rescaled[2] = mantisa;
-    }
-    
-    const uint64_t oneValue = 1ULL<<oneBitPos;
-    uint64_t decValue = rescaled[powSize+1]>>oneBitPos;
-    char buffer[20];
+    /* generate shortest digits that will be parsed back to same value
+     * (most significant digit first). lastDigitExp - decimal exponent of last digit */
+    char buffer[32];
     cxuint digitsNum = 0;
-    
-    bool roundingFix = false;
-    /* fix for rounding to ten */
-    const cxuint mod = (decValue) % 100;
-    /* check rounding digits */
-    /* for latest two values >= 82 or <= 18 and not zeros, and binary mantisa is not zero
-     * then try to apply rounding. do not if binary mantisa is zero, because
-     * next exponent have different value threshold and that can makes trip of rounding */
-    if ((mod >= 82 || (mod <= 18 && mod != 0)) && (value&mantisaMask)!=0)
-    {
-        // check higher round
-        uint64_t rescaledHalf[4];
-        // rescaled half (ULP) minus rescaled max error + 1
-        rescaledHalf[0] = 0;
-        rescaledHalf[1] = pow5[0]<<(mantisaShift-1);
-        rescaledHalf[2] = pow5[0]>>(64-mantisaShift+1);
-        if (powSize == 2)
-        {
-            rescaledHalf[2] |= pow5[1]<<(mantisaShift-1);
-            rescaledHalf[3] = pow5[1]>>(64-mantisaShift+1);
-        }
-        rescaledHalf[powSize+1] |= (1ULL<<(mantisaShift-1));
-        
-        if (-decExpOfValue < 0 || -decExpOfValue > 55)
-        {
-            // if not exact pow5 (rescaled value is not exact value)
-            // compute max error of rescaled value ((0.5 + 2**-29)*mantisa)
-            const uint64_t maxRescaledError[2] = 
-            { mantisa<<(64-30), (mantisa>>1) + (mantisa>>30) };
-            bigSub(powSize+2, rescaledHalf, 2, maxRescaledError);
-        }
-        const uint64_t one64 = 1; // preserve rounding for exact half case
-        bigSub(powSize+2, rescaledHalf, 1, &one64);
-        
-        if (mod >= 82)
-        {
-            // we must add some bits
-            uint64_t toAdd[4] = { 0, 0, 0, 0 };
-            // (100-mod) - (rest from value beginning one) - value to add
-            toAdd[powSize+1] = ((100ULL-uint64_t(mod))<<oneBitPos) +
-                    (rescaled[powSize+1] & ~(oneValue-1));
-            bigSub(2+powSize, toAdd, 2+powSize, rescaled);
-            // check if half changed
-            if (!bigSub(2+powSize, rescaledHalf, 2+powSize, toAdd))
-            {
-                // if toAdd is smaller than rescaledHalf
-                decValue += (100-mod);
-                roundingFix = true;
-            }
-        }
-        else if (mod <= 18)
-        {
-            // we must subtract some bits
-            uint64_t toSub[4];
-            // value to subtract
-            toSub[powSize+1] = (uint64_t(mod)<<oneBitPos) |
-                    (rescaled[powSize+1]&(oneValue-1));
-            toSub[0] = rescaled[0];
-            if (powSize == 2)
-                toSub[1] = rescaled[1];
-            toSub[powSize] = rescaled[powSize];
-            // check if half changed
-            if (!bigSub(2+powSize, rescaledHalf, 2+powSize, toSub))
-            {
-                // if toSub is smaller than rescaledHalf
-                decValue -= mod;
-                roundingFix = true;
-            }
-        }
-    }
-    
-    /* fix for rounding to one (to nearest decimal value) (if not rounding zeros)
-     * if needed apply rounding to nearest (to decimal value) if lowest 2 two digits
-     * is not zero or mantisa is zero (just print in highest precision) */
-    if (!roundingFix && (mod != 0 || (value&mantisaMask)==0) &&
-        ((rescaled[powSize+1] & (oneValue-1)) >= (oneValue>>1)))
-        decValue++;
-    
-    for (uint64_t tmpVal = decValue; tmpVal != 0; )
+    cxint lastDigitExp = 0;
+    if (positional && binExpOfValue >= 0)
     {
-        const uint64_t tmp = tmpVal/10u;
-        const cxuint digit = tmpVal - tmp*10U;
-        buffer[digitsNum++] = '0'+digit;
-        tmpVal = tmp;
+        /* integer value: print exactly (it is never longer than
+         * shortest digits padded by zeros) */
+        for (uint64_t tmpVal = mantisa<<binExpOfValue; tmpVal != 0; tmpVal /= 10)
+            buffer[digitsNum++] = '0' + (tmpVal%10);
+        std::reverse(buffer, buffer+digitsNum);
     }
-    
-    cxuint roundPos = 0;
-    // count roundPos
-    for (roundPos = 0; buffer[roundPos] == '0' && roundPos < digitsNum; roundPos++);
-    
-    if (digitsNum-roundPos > maxSize)
-        throw Exception("Max size is too small");
+    else if (!fXShortestDigitsGrisu(mantisa, binExpOfValue, lowerCloser, buffer,
+                digitsNum, lastDigitExp))
+        fXShortestDigitsExact(mantisa, binExpOfValue, lowerCloser, buffer, digitsNum,
+                lastDigitExp);
     
     const char* strend = str + maxSize-1;
     
@@ -1744,47 +2137,54 @@ size_t CLRX::fXtocstrCStyle(uint64_t value, char* str, size_t maxSize,
         *p++ = '-';
     }
     
-    cxuint commaPos = digitsNum-1;
-    cxint decExponent = decExpOfValue + digitsNum - 1;
+    cxint decExponent = lastDigitExp + digitsNum - 1;
+    bool printExponent = true;
     if (!scientific)
     {
         if (decExponent >= -5 && decExponent < 0)
         {
             // over same number
-            if (p+2 > strend)
+            if (p + 1 - decExponent + digitsNum > strend)
                 throw Exception("Max size is too small");
             *p++ = '0';
             *p++ = '.';
             for (cxint dx = -1; dx > decExponent; dx--)
-            {
-                if (p >= strend)
-                    throw Exception("Max size is too small");
                 *p++ = '0';
-            }
-            commaPos = digitsNum;
+            std::copy(buffer, buffer+digitsNum, p);
+            p += digitsNum;
+            printExponent = false;
         }
-        else if (decExponent >= 0 && decExponent <= int(digitsNum-1))
+        else if (decExponent >= 0 && positional)
         {
-            commaPos = digitsNum - decExponent - 1;
-            roundPos = std::min(commaPos, roundPos);
+            const cxuint intDigitsNum = decExponent+1;
+            if (p + std::max(intDigitsNum, digitsNum) +
+                        (digitsNum > intDigitsNum) > strend)
+                throw Exception("Max size is too small");
+            for (cxuint pos = 0; pos < intDigitsNum; pos++)
+                *p++ = (pos < digitsNum) ? buffer[pos] : '0';
+            if (digitsNum > intDigitsNum)
+            {
+                *p++ = '.';
+                std::copy(buffer+intDigitsNum, buffer+digitsNum, p);
+                p += digitsNum-intDigitsNum;
+            }
+            printExponent = false;
         }
     }
-    /* put to string */
-    if (p + digitsNum-roundPos > strend) // out of string
-        throw Exception("Max size is too small");
     
-    for (cxuint pos = digitsNum; pos > roundPos; pos--)
+    if (printExponent)
     {
-        *p++ = buffer[pos-1];
-        if (pos-1 == commaPos && pos-1 > roundPos)
+        /* put to string */
+        if (p + digitsNum + (digitsNum > 1) > strend) // out of string
+            throw Exception("Max size is too small");
+        *p++ = buffer[0];
+        if (digitsNum > 1)
+        {
             *p++ = '.';
-    }
-    
-    if (p > strend) // out of string
-        throw Exception("Max size is too small");
+            std::copy(buffer+1, buffer+digitsNum, p);
+            p += digitsNum-1;
+        }
         
-    if (scientific || decExponent < -5 || decExponent > int(digitsNum-1))
-    {
         /* print exponent */
         if (p >= strend) // out of string
             throw Exception("Max size is too small");
@@ -30,12 +30,18 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
 #endif
 #include <fstream>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <mutex>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <exception>
 #include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 #include <climits>
@@ -80,6 +86,66 @@ ParseException::ParseException(LineNo lineNo, ColNo charNo, const std::string& m
  * then use global mutex   to secure these operations */
 std::mutex CLRX::DynLibrary::mutex;
 
+struct CLRX_INTERNAL MemoryArena::Block
+{
+    Block* prev;
+};
+
+// size of block header (keeps 16-byte alignment)
+static const size_t memArenaHeaderSize = 16;
+
+MemoryArena::MemoryArena(size_t _blockSize) : lastBlock(nullptr), blockStart(nullptr),
+        current(nullptr), end(nullptr), blockSize(_blockSize), allocsNum(0)
+{
+    std::fill(freeLists, freeLists+freeListsNum, nullptr);
+}
+
+MemoryArena::~MemoryArena()
+{
+    clear();
+}
+
+void* MemoryArena::allocateSlow(size_t size)
+{
+    if (size > (blockSize>>2))
+    {
+        // big allocation: put to own block after the current block
+        Block* block = reinterpret_cast<Block*>(
+                    ::operator new(size + memArenaHeaderSize));
+        if (lastBlock != nullptr)
+        {
+            block->prev = lastBlock->prev;
+            lastBlock->prev = block;
+        }
+        else
+        {
+            block->prev = nullptr;
+            lastBlock = block;
+        }
+        return reinterpret_cast<cxbyte*>(block) + memArenaHeaderSize;
+    }
+    // new block
+    Block* block = reinterpret_cast<Block*>(::operator new(blockSize));
+    block->prev = lastBlock;
+    lastBlock = block;
+    blockStart = reinterpret_cast<cxbyte*>(block) + memArenaHeaderSize;
+    current = blockStart + size;
+    end = reinterpret_cast<cxbyte*>(block) + blockSize;
+    return blockStart;
+}
+
+void MemoryArena::clear()
+{
+    while (lastBlock != nullptr)
+    {
+        Block* prev = lastBlock->prev;
+        ::operator delete(lastBlock);
+        lastBlock = prev;
+    }
+    blockStart = current = end = nullptr;
+    std::fill(freeLists, freeLists+freeListsNum, nullptr);
+}
+
 DynLibrary::DynLibrary() : handle(nullptr)
 { }
 
@@ -463,6 +529,107 @@ Array<cxbyte> CLRX::loadDataFromFile(const char* filename)
     return buf;
 }
 
+MappedFile::MappedFile() : content(nullptr), contentSize(0), mapped(false)
+#ifdef HAVE_WINDOWS
+        , mapHandle(nullptr)
+#endif
+{ }
+
+MappedFile::MappedFile(const char* filename) : content(nullptr), contentSize(0),
+        mapped(false)
+#ifdef HAVE_WINDOWS
+        , mapHandle(nullptr)
+#endif
+{
+    open(filename);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::open(const char* filename)
+{
+    if (content != nullptr || !loadedData.empty())
+        throw Exception("MappedFile already opened");
+    if (isDirectory(filename))
+        throw Exception("This is directory!");
+#ifndef HAVE_WINDOWS
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        throw Exception("Can't open file");
+    struct stat stBuf;
+    if (::fstat(fd, &stBuf) == 0 && S_ISREG(stBuf.st_mode) && stBuf.st_size > 0 &&
+        uint64_t(stBuf.st_size) <= SIZE_MAX)
+    {
+        // private mapping: pages are shared until binary parser modifies them
+        void* ptr = ::mmap(nullptr, stBuf.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE,
+                    fd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            content = reinterpret_cast<cxbyte*>(ptr);
+            contentSize = stBuf.st_size;
+            mapped = true;
+        }
+    }
+    ::close(fd);
+#else
+    HANDLE fileHandle = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        throw Exception("Can't open file");
+    LARGE_INTEGER fileSize;
+    if (GetFileType(fileHandle) == FILE_TYPE_DISK &&
+        GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0 &&
+        uint64_t(fileSize.QuadPart) <= SIZE_MAX)
+    {
+        mapHandle = CreateFileMapping(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapHandle != nullptr)
+        {
+            void* ptr = MapViewOfFile(mapHandle, FILE_MAP_COPY, 0, 0, 0);
+            if (ptr != nullptr)
+            {
+                content = reinterpret_cast<cxbyte*>(ptr);
+                contentSize = fileSize.QuadPart;
+                mapped = true;
+            }
+            else
+            {
+                CloseHandle(mapHandle);
+                mapHandle = nullptr;
+            }
+        }
+    }
+    CloseHandle(fileHandle);
+#endif
+    if (!mapped)
+    {
+        // fallback (pipe, device or empty file)
+        loadedData = loadDataFromFile(filename);
+        content = loadedData.data();
+        contentSize = loadedData.size();
+    }
+}
+
+void MappedFile::close()
+{
+    if (mapped)
+    {
+#ifndef HAVE_WINDOWS
+        ::munmap(content, contentSize);
+#else
+        UnmapViewOfFile(content);
+        CloseHandle(mapHandle);
+        mapHandle = nullptr;
+#endif
+    }
+    loadedData.clear();
+    content = nullptr;
+    contentSize = 0;
+    mapped = false;
+}
+
 void CLRX::filesystemPath(char* path)
 {
     while (*path != 0)  // change to native dir separator
@@ -497,6 +664,27 @@ std::string CLRX::joinPaths(const std::string& path1, const std::string& path2)
     return outPath;
 }
 
+std::string CLRX::getAbsolutePath(const std::string& path)
+{
+#ifndef HAVE_WINDOWS
+    if (!path.empty() && path.front() == '/')
+        return path;
+    std::vector<char> cwd(256);
+    while (::getcwd(cwd.data(), cwd.size()) == nullptr)
+    {
+        if (errno != ERANGE)
+            throw Exception("Can't get current directory");
+        cwd.resize(cwd.size()<<1);
+    }
+    return (!path.empty()) ? joinPaths(cwd.data(), path) : std::string(cwd.data());
+#else
+    char absPath[MAX_PATH];
+    if (::_fullpath(absPath, path.c_str(), MAX_PATH) == nullptr)
+        throw Exception("Can't get absolute path");
+    return std::string(absPath);
+#endif
+}
+
 uint64_t CLRX::getFileTimestamp(const char* filename)
 {
     struct stat stBuf;
@@ -804,3 +992,111 @@ std::string CLRX::findLLVMConfig()
     }
     return "";
 }
+
+// job queue of single thread (range of job indices)
+struct CLRX_INTERNAL ThreadJobQueue
+{
+    std::mutex mutex;
+    size_t start, end;
+};
+
+void CLRX::runInThreadPool(size_t jobsNum, cxuint threadsNum,
+            const std::function<void(size_t)>& jobFunc)
+{
+    if (threadsNum == 0)
+        threadsNum = std::max(std::thread::hardware_concurrency(), 1U);
+    if (threadsNum > jobsNum)
+        threadsNum = jobsNum;
+    if (threadsNum <= 1)
+    {
+        // run in this thread
+        for (size_t i = 0; i < jobsNum; i++)
+            jobFunc(i);
+        return;
+    }
+    
+    std::unique_ptr<ThreadJobQueue[]> queues(new ThreadJobQueue[threadsNum]);
+    // initial division of jobs
+    for (cxuint t = 0; t < threadsNum; t++)
+    {
+        queues[t].start = jobsNum*t / threadsNum;
+        queues[t].end = jobsNum*(t+1) / threadsNum;
+    }
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+    
+    auto workerFunc = [&](cxuint t)
+    {
+        while (true)
+        {
+            size_t jobIndex = SIZE_MAX;
+            {
+                // get job from own queue
+                std::lock_guard<std::mutex> lock(queues[t].mutex);
+                if (queues[t].start < queues[t].end)
+                    jobIndex = queues[t].start++;
+            }
+            if (jobIndex == SIZE_MAX)
+            {
+                // steal half of jobs from end of queue of other thread
+                for (cxuint k = 1; k < threadsNum && jobIndex == SIZE_MAX; k++)
+                {
+                    ThreadJobQueue& victim = queues[(t+k) % threadsNum];
+                    size_t stolenStart = 0, stolenEnd = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(victim.mutex);
+                        if (victim.start < victim.end)
+                        {
+                            stolenStart = victim.end - ((victim.end-victim.start+1)>>1);
+                            stolenEnd = victim.end;
+                            victim.end = stolenStart;
+                        }
+                    }
+                    if (stolenStart < stolenEnd)
+                    {
+                        std::lock_guard<std::mutex> lock(queues[t].mutex);
+                        jobIndex = stolenStart;
+                        queues[t].start = stolenStart+1;
+                        queues[t].end = stolenEnd;
+                    }
+                }
+                if (jobIndex == SIZE_MAX)
+                    return; // no jobs
+            }
+            try
+            { jobFunc(jobIndex); }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    threads.reserve(threadsNum-1);
+    try
+    {
+        for (cxuint t = 1; t < threadsNum; t++)
+            threads.push_back(std::thread(workerFunc, t));
+    }
+    catch(...)
+    {
+        /* can not create more threads: started threads and this thread steal
+         * jobs of not started threads, hence all jobs will be done */
+    }
+    try
+    { workerFunc(0); }
+    catch(...)
+    {
+        // started threads must be joined before leaving (otherwise terminate)
+        for (std::thread& thread: threads)
+            thread.join();
+        throw;
+    }
+    for (std::thread& thread: threads)
+        thread.join();
+    if (exception)
+        std::rethrow_exception(exception);
+}